@@ -63,7 +63,8 @@ paraview_server_manager_process(
   TARGET <target>
   [INSTALL_EXPORT <export>]
   [FILES <file>...]
-  [XML_FILES  <variable>])
+  [XML_FILES  <variable>]
+  [BINARY_DEFINITIONS])
 ```
 
 The `MODULES` argument contains the modules to include in the server manager
@@ -77,10 +78,12 @@ variable.
 
 If `INSTALL_EXPORT` is given, the interface target will be added to the given
 export set.
+
+`BINARY_DEFINITIONS` is passed on to `paraview_server_manager_process_files`.
 #]==]
 function (paraview_server_manager_process)
   cmake_parse_arguments(_paraview_sm_process
-    ""
+    "BINARY_DEFINITIONS"
     "TARGET;XML_FILES;INSTALL_EXPORT"
     "MODULES;FILES"
     ${ARGN})
@@ -118,6 +121,10 @@ function (paraview_server_manager_process)
     list(APPEND _paraview_sm_process_export_args
       INSTALL_EXPORT "${_paraview_sm_process_INSTALL_EXPORT}")
   endif ()
+  if (_paraview_sm_process_BINARY_DEFINITIONS)
+    list(APPEND _paraview_sm_process_export_args
+      BINARY_DEFINITIONS)
+  endif ()
 
   paraview_server_manager_process_files(
     TARGET  ${_paraview_sm_process_TARGET}
@@ -138,7 +145,8 @@ The second way to process XML files directly.
 paraview_server_manager_process_files(
   FILES <file>...
   TARGET <target>
-  [INSTALL_EXPORT <export>])
+  [INSTALL_EXPORT <export>]
+  [BINARY_DEFINITIONS])
 ```
 
 The files passed to the `FILES` argument will be processed in to functions
@@ -152,10 +160,16 @@ will allow the generated header to be included.
 
 If `INSTALL_EXPORT` is given, the interface target will be added to the given
 export set.
+
+If `BINARY_DEFINITIONS` is given, the proxy definitions are also parsed at
+build time and embedded in binary form (see
+`vtkSIProxyDefinitionManager::SaveBinaryDefinitions`). They are available
+through a function named `<TARGET>_binary_definitions`, which provides no data
+otherwise. This requires the `ParaView::ProcessProxyDefinitions` tool.
 #]==]
 function (paraview_server_manager_process_files)
   cmake_parse_arguments(_paraview_sm_process_files
-    ""
+    "BINARY_DEFINITIONS"
     "TARGET;INSTALL_EXPORT"
     "FILES"
     ${ARGN})
@@ -197,9 +211,26 @@ function (paraview_server_manager_process_files)
             "GetInterfaces"
             "@${_paraview_sm_process_files_response_file}"
     COMMENT "Generating server manager headers for ${_paraview_sm_process_files_TARGET}.")
+  set(_paraview_sm_process_files_binary_output)
+  if (_paraview_sm_process_files_BINARY_DEFINITIONS)
+    set(_paraview_sm_process_files_binary_output
+      "${_paraview_sm_process_files_output_dir}/${_paraview_sm_process_files_TARGET}_binary.h")
+    add_custom_command(
+      OUTPUT  "${_paraview_sm_process_files_binary_output}"
+      DEPENDS ${_paraview_sm_process_files_FILES}
+              "$<TARGET_FILE:ParaView::ProcessProxyDefinitions>"
+              "${_paraview_sm_process_files_response_file}"
+      COMMAND ${CMAKE_CROSSCOMPILING_EMULATOR}
+              $<TARGET_FILE:ParaView::ProcessProxyDefinitions>
+              "${_paraview_sm_process_files_binary_output}"
+              "${_paraview_sm_process_files_TARGET}_binary"
+              "@${_paraview_sm_process_files_response_file}"
+      COMMENT "Generating binary proxy definitions for ${_paraview_sm_process_files_TARGET}.")
+  endif ()
   add_custom_target("${_paraview_sm_process_files_TARGET}_xml_content"
     DEPENDS
-      "${_paraview_sm_process_files_output}")
+      "${_paraview_sm_process_files_output}"
+      ${_paraview_sm_process_files_binary_output})
 
   set(_paraview_sm_process_files_init_content
     "#ifndef ${_paraview_sm_process_files_TARGET}_h
@@ -221,8 +252,30 @@ void ${_paraview_sm_process_files_TARGET}_initialize(std::vector<std::string>& x
   }\n")
   endforeach ()
   string(APPEND _paraview_sm_process_files_init_content
-    "}
-
+    "}\n")
+  if (_paraview_sm_process_files_BINARY_DEFINITIONS)
+    string(APPEND _paraview_sm_process_files_init_content
+      "
+#include \"${_paraview_sm_process_files_TARGET}_binary.h\"
+
+void ${_paraview_sm_process_files_TARGET}_binary_definitions(const char*& data, size_t& size)
+{
+  data = reinterpret_cast<const char*>(${_paraview_sm_process_files_TARGET}_binary);
+  size = sizeof(${_paraview_sm_process_files_TARGET}_binary);
+}
+")
+  else ()
+    string(APPEND _paraview_sm_process_files_init_content
+      "
+void ${_paraview_sm_process_files_TARGET}_binary_definitions(const char*& data, size_t& size)
+{
+  data = nullptr;
+  size = 0;
+}
+")
+  endif ()
+  string(APPEND _paraview_sm_process_files_init_content
+    "
 #endif\n")
 
   file(GENERATE
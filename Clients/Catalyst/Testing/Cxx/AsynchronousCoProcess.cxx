@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    AsynchronousCoProcess.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that asynchronous co-processing executes the pipelines on the data
+// given at each time step, even though the simulation modifies it once
+// CoProcess() returns, that shallow copied inputs are released, and that the
+// global controller used by the simulation is left unchanged.
+
+#include "vtkCPAsynchronousExecutor.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// records the value of the "value" array of its input at each time step.
+class vtkSlowPipeline : public vtkCPPipeline
+{
+public:
+  static vtkSlowPipeline* New();
+  vtkTypeMacro(vtkSlowPipeline, vtkCPPipeline);
+
+  int RequestDataDescription(vtkCPDataDescription* dataDescription) override
+  {
+    dataDescription->GetInputDescriptionByName("input")->AllFieldsOn();
+    dataDescription->GetInputDescriptionByName("input")->GenerateMeshOn();
+    return 1;
+  }
+
+  int CoProcess(vtkCPDataDescription* dataDescription) override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    vtkImageData* image =
+      vtkImageData::SafeDownCast(dataDescription->GetInputDescriptionByName("input")->GetGrid());
+    vtkDataArray* array = image ? image->GetPointData()->GetArray("value") : nullptr;
+    this->Values.push_back(array ? array->GetTuple1(0) : -1);
+    return 1;
+  }
+
+  std::vector<double> Values;
+
+protected:
+  vtkSlowPipeline() = default;
+};
+vtkStandardNewMacro(vtkSlowPipeline);
+
+void Release(vtkIdType, double, void* clientData)
+{
+  ++(*static_cast<int*>(clientData));
+}
+}
+
+int AsynchronousCoProcess(int, char* [])
+{
+  const int numberOfSteps = 6;
+  vtkNew<vtkCPProcessor> processor;
+  processor->Initialize();
+  vtkNew<vtkSlowPipeline> pipeline;
+  processor->AddPipeline(pipeline);
+  processor->AsynchronousOn();
+  processor->SetMaximumNumberOfStepsInFlight(2);
+  int released = 0;
+  processor->SetReleaseCallback(Release, &released);
+  vtkMultiProcessController* globalController = vtkMultiProcessController::GetGlobalController();
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(16, 16, 16);
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("value");
+  array->SetNumberOfTuples(image->GetNumberOfPoints());
+  image->GetPointData()->AddArray(array);
+
+  int immutableSteps = 0;
+  for (int step = 0; step < numberOfSteps; ++step)
+  {
+    // odd steps hand over a new buffer, that the simulation does not modify.
+    vtkSmartPointer<vtkImageData> grid = image.GetPointer();
+    const bool immutable = (step % 2 == 1);
+    if (immutable)
+    {
+      grid = vtkSmartPointer<vtkImageData>::New();
+      grid->DeepCopy(image);
+      ++immutableSteps;
+    }
+    grid->GetPointData()->GetArray("value")->Fill(step);
+
+    vtkNew<vtkCPDataDescription> dataDescription;
+    dataDescription->AddInput("input");
+    dataDescription->SetTimeData(step, step);
+    if (!processor->RequestDataDescription(dataDescription))
+    {
+      cerr << "ERROR: no co-processing requested." << endl;
+      return EXIT_FAILURE;
+    }
+    dataDescription->GetInputDescriptionByName("input")->SetGrid(grid);
+    dataDescription->GetInputDescriptionByName("input")->SetGridIsImmutable(immutable);
+    if (!processor->CoProcess(dataDescription))
+    {
+      cerr << "ERROR: CoProcess failed at step " << step << endl;
+      return EXIT_FAILURE;
+    }
+
+    // the simulation overwrites its buffer right away.
+    array->Fill(-2);
+
+    if (vtkMultiProcessController::GetGlobalController() != globalController)
+    {
+      cerr << "ERROR: the global controller changed." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!processor->WaitForCompletion())
+  {
+    cerr << "ERROR: a time step failed." << endl;
+    return EXIT_FAILURE;
+  }
+  if (pipeline->Values.size() != numberOfSteps)
+  {
+    cerr << "ERROR: " << pipeline->Values.size() << " time steps executed." << endl;
+    return EXIT_FAILURE;
+  }
+  for (int step = 0; step < numberOfSteps; ++step)
+  {
+    if (pipeline->Values[step] != step)
+    {
+      cerr << "ERROR: time step " << step << " saw " << pipeline->Values[step] << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (released != immutableSteps)
+  {
+    cerr << "ERROR: " << released << " time steps released instead of " << immutableSteps
+         << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkCPAsynchronousExecutor* executor = processor->GetAsynchronousExecutor();
+  if (executor->IsRunning() && executor->GetExecutionTime() <= 0)
+  {
+    cerr << "ERROR: no execution time reported." << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "Copy: " << executor->GetCopyTime() << "s, execution: " << executor->GetExecutionTime()
+       << "s, wait: " << executor->GetWaitTime()
+       << "s, overlap efficiency: " << executor->GetOverlapEfficiency() << endl;
+
+  processor->Finalize();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPAsynchronousExecutor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPAsynchronousExecutor.h"
+
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVLogger.h"
+#include "vtkTimerLog.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class vtkCPAsynchronousExecutor::vtkInternals
+{
+public:
+  std::thread Thread;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+
+  // steps that are queued or executing; a step is removed once it completes.
+  std::deque<std::function<bool()> > Steps;
+  bool Stopping = false;
+  bool Failed = false;
+  bool Unavailable = false;
+
+  double ExecutionTime = 0.0;
+  double WaitTime = 0.0;
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    while (true)
+    {
+      this->Condition.wait(lock, [this]() { return this->Stopping || !this->Steps.empty(); });
+      if (this->Steps.empty())
+      {
+        break;
+      }
+      std::function<bool()> step = this->Steps.front();
+      lock.unlock();
+
+      const double start = vtkTimerLog::GetUniversalTime();
+      const bool success = step();
+      const double elapsed = vtkTimerLog::GetUniversalTime() - start;
+
+      lock.lock();
+      this->Steps.pop_front();
+      this->ExecutionTime += elapsed;
+      this->Failed = this->Failed || !success;
+      this->Condition.notify_all();
+    }
+  }
+
+  // Waits until at most `count` steps are in flight, and returns the time
+  // spent waiting. `lock` must hold the mutex.
+  double Wait(std::unique_lock<std::mutex>& lock, size_t count)
+  {
+    const double start = vtkTimerLog::GetUniversalTime();
+    this->Condition.wait(lock, [this, count]() { return this->Steps.size() <= count; });
+    const double elapsed = vtkTimerLog::GetUniversalTime() - start;
+    this->WaitTime += elapsed;
+    return elapsed;
+  }
+};
+
+vtkStandardNewMacro(vtkCPAsynchronousExecutor);
+//----------------------------------------------------------------------------
+vtkCPAsynchronousExecutor::vtkCPAsynchronousExecutor()
+  : MaximumNumberOfStepsInFlight(1)
+  , NumberOfSteps(0)
+  , CopyTime(0.0)
+  , Internals(new vtkCPAsynchronousExecutor::vtkInternals())
+{
+}
+
+//----------------------------------------------------------------------------
+vtkCPAsynchronousExecutor::~vtkCPAsynchronousExecutor()
+{
+  this->Stop();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPAsynchronousExecutor::Start()
+{
+  auto& internals = *this->Internals;
+  if (internals.Thread.joinable())
+  {
+    return true;
+  }
+  if (internals.Unavailable)
+  {
+    return false;
+  }
+
+  // the pipelines communicate through the global controller, which the
+  // simulation keeps using while they execute.
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  if (controller && controller->GetNumberOfProcesses() > 1)
+  {
+    vtkWarningMacro("Asynchronous co-processing is not supported with more than one process. "
+                    "Co-processing steps are executed synchronously.");
+    internals.Unavailable = true;
+    return false;
+  }
+
+  internals.Stopping = false;
+  internals.Thread = std::thread(&vtkCPAsynchronousExecutor::vtkInternals::Run, &internals);
+  vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(),
+    "asynchronous co-processing started, up to %d step(s) in flight",
+    this->MaximumNumberOfStepsInFlight);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPAsynchronousExecutor::Stop()
+{
+  auto& internals = *this->Internals;
+  if (!internals.Thread.joinable())
+  {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(internals.Mutex);
+    internals.Wait(lock, 0);
+    internals.Stopping = true;
+    internals.Condition.notify_all();
+  }
+  internals.Thread.join();
+
+  vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(),
+    "asynchronous co-processing stopped: %lld step(s), copy %gs, execution %gs, wait %gs, "
+    "overlap efficiency %g",
+    static_cast<long long>(this->NumberOfSteps), this->CopyTime, this->GetExecutionTime(),
+    this->GetWaitTime(), this->GetOverlapEfficiency());
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPAsynchronousExecutor::IsRunning()
+{
+  return this->Internals->Thread.joinable();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPAsynchronousExecutor::Submit(std::function<bool()> step)
+{
+  auto& internals = *this->Internals;
+  ++this->NumberOfSteps;
+  if (!this->Start())
+  {
+    return step();
+  }
+
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  internals.Wait(lock, static_cast<size_t>(this->MaximumNumberOfStepsInFlight - 1));
+  internals.Steps.push_back(std::move(step));
+  internals.Condition.notify_all();
+
+  const bool failed = internals.Failed;
+  internals.Failed = false;
+  return !failed;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPAsynchronousExecutor::WaitForCompletion()
+{
+  auto& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  internals.Wait(lock, 0);
+  const bool failed = internals.Failed;
+  internals.Failed = false;
+  return !failed;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPAsynchronousExecutor::AddCopyTime(double seconds)
+{
+  this->CopyTime += seconds;
+}
+
+//----------------------------------------------------------------------------
+double vtkCPAsynchronousExecutor::GetExecutionTime()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->ExecutionTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkCPAsynchronousExecutor::GetWaitTime()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->WaitTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkCPAsynchronousExecutor::GetOverlapEfficiency()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  const auto& internals = *this->Internals;
+  if (internals.ExecutionTime <= 0.0)
+  {
+    return 0.0;
+  }
+  const double hidden = 1.0 - internals.WaitTime / internals.ExecutionTime;
+  return hidden < 0.0 ? 0.0 : hidden;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPAsynchronousExecutor::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->ExecutionTime = 0.0;
+  this->Internals->WaitTime = 0.0;
+  this->NumberOfSteps = 0;
+  this->CopyTime = 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPAsynchronousExecutor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfStepsInFlight: " << this->MaximumNumberOfStepsInFlight << "\n";
+  os << indent << "NumberOfSteps: " << this->NumberOfSteps << "\n";
+  os << indent << "CopyTime: " << this->CopyTime << "\n";
+  os << indent << "ExecutionTime: " << this->GetExecutionTime() << "\n";
+  os << indent << "WaitTime: " << this->GetWaitTime() << "\n";
+  os << indent << "OverlapEfficiency: " << this->GetOverlapEfficiency() << "\n";
+}
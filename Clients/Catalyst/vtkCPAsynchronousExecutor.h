@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPAsynchronousExecutor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPAsynchronousExecutor_h
+#define vtkCPAsynchronousExecutor_h
+
+#include "vtkObject.h"
+#include "vtkPVCatalystModule.h" // For windows import/export of shared libraries
+
+#ifndef __VTK_WRAP__
+#include <functional> // for std::function
+#endif
+#include <memory> // for std::unique_ptr
+
+/// @ingroup CoProcessing
+/// Executes co-processing steps on a dedicated thread so that the simulation
+/// does not wait for the pipelines. It is used by vtkCPProcessor and
+/// vtkInSituInitializationHelper when asynchronous execution is enabled.
+///
+/// Steps are executed in the order they are submitted. Submit() returns as
+/// soon as the step is queued, unless MaximumNumberOfStepsInFlight steps are
+/// already queued or executing, in which case it waits for the oldest one to
+/// complete (back-pressure). The caller is responsible for giving the step its
+/// own copy of the simulation data.
+///
+/// The pipelines would share the global controller with the simulation
+/// thread, so steps are only executed asynchronously when running on a single
+/// process; otherwise Start() fails and steps are executed in the calling
+/// thread.
+class VTKPVCATALYST_EXPORT vtkCPAsynchronousExecutor : public vtkObject
+{
+public:
+  static vtkCPAsynchronousExecutor* New();
+  vtkTypeMacro(vtkCPAsynchronousExecutor, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Maximum number of steps queued or executing. Default is 1, i.e. a step
+  /// executes while the simulation computes the next one.
+  vtkSetClampMacro(MaximumNumberOfStepsInFlight, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfStepsInFlight, int);
+
+  /// Starts the execution thread. Returns false if steps cannot be executed
+  /// asynchronously. Called by Submit() if needed.
+  bool Start();
+
+  /// Waits for the submitted steps to complete and stops the execution
+  /// thread.
+  void Stop();
+
+  /// Returns true if the execution thread is running.
+  bool IsRunning();
+
+#ifndef __VTK_WRAP__
+  /// Queues a step for execution. The step returns false on failure. Returns
+  /// false if a step submitted earlier has failed since the last call, or if
+  /// the step was executed right away and failed.
+  bool Submit(std::function<bool()> step);
+#endif
+
+  /// Waits for all submitted steps to complete. Returns false if one of them
+  /// failed since the last call to Submit() or WaitForCompletion().
+  bool WaitForCompletion();
+
+  /// Adds the time the caller spent copying the simulation data for a step,
+  /// so that it is included in the statistics.
+  void AddCopyTime(double seconds);
+
+  /// Statistics, in seconds: the time spent executing steps on the execution
+  /// thread, the time the simulation waited for steps to complete, and the
+  /// time spent copying data. The overlap efficiency is the fraction of the
+  /// execution time that was hidden from the simulation, from 0 to 1.
+  vtkGetMacro(NumberOfSteps, vtkIdType);
+  double GetExecutionTime();
+  double GetWaitTime();
+  vtkGetMacro(CopyTime, double);
+  double GetOverlapEfficiency();
+  void ResetStatistics();
+
+protected:
+  vtkCPAsynchronousExecutor();
+  ~vtkCPAsynchronousExecutor() override;
+
+  int MaximumNumberOfStepsInFlight;
+  vtkIdType NumberOfSteps;
+  double CopyTime;
+
+private:
+  vtkCPAsynchronousExecutor(const vtkCPAsynchronousExecutor&) = delete;
+  void operator=(const vtkCPAsynchronousExecutor&) = delete;
+
+  class vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+};
+
+#endif
@@ -47,6 +47,7 @@ vtkCPInputDataDescription::vtkCPInputDataDescription()
   this->WholeExtent[0] = this->WholeExtent[2] = this->WholeExtent[4] = 0;
   this->WholeExtent[1] = this->WholeExtent[3] = this->WholeExtent[5] = -1;
   this->TemporalCache = nullptr;
+  this->GridIsImmutable = false;
 }
 
 //----------------------------------------------------------------------------
@@ -178,6 +179,7 @@ void vtkCPInputDataDescription::ShallowCopy(vtkCPInputDataDescription* idd)
   memcpy(this->WholeExtent, idd->WholeExtent, 6 * sizeof(int));
   this->Internals->Fields = idd->Internals->Fields;
   this->SetTemporalCache(idd->TemporalCache);
+  this->GridIsImmutable = idd->GridIsImmutable;
 }
 
 //----------------------------------------------------------------------------
@@ -186,6 +188,7 @@ void vtkCPInputDataDescription::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "AllFields: " << this->AllFields << "\n";
   os << indent << "GenerateMesh: " << this->GenerateMesh << "\n";
+  os << indent << "GridIsImmutable: " << this->GridIsImmutable << "\n";
   if (this->Grid)
   {
     os << indent << "Grid: " << this->Grid << "\n";
@@ -108,6 +108,16 @@ public:
   // Get the temporal cache.
   vtkGetObjectMacro(TemporalCache, vtkSMSourceProxy);
 
+  // Description:
+  // Set to true when the adaptor guarantees that the arrays of the grids it
+  // passes are never modified afterwards, e.g. because the simulation
+  // allocates new buffers at each time step. The temporal cache then keeps
+  // references to the arrays instead of copies. Off by default. Unlike the
+  // other flags, Reset() does not change it.
+  vtkSetMacro(GridIsImmutable, bool);
+  vtkGetMacro(GridIsImmutable, bool);
+  vtkBooleanMacro(GridIsImmutable, bool);
+
 protected:
   vtkCPInputDataDescription();
   ~vtkCPInputDataDescription() override;
@@ -128,6 +138,10 @@ protected:
   // The temporal cache associated with grid. The cache is not owned by the object.
   vtkSMSourceProxy* TemporalCache;
 
+  // Description:
+  // On when the arrays of the grid are not modified by the adaptor.
+  bool GridIsImmutable;
+
 private:
   vtkCPInputDataDescription(const vtkCPInputDataDescription&) = delete;
   void operator=(const vtkCPInputDataDescription&) = delete;
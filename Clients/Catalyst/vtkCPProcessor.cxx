@@ -16,6 +16,7 @@
 
 #include "vtkPVConfig.h" // need ParaView defines before MPI stuff
 
+#include "vtkCPAsynchronousExecutor.h"
 #include "vtkCPCxxHelper.h"
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
@@ -35,15 +36,18 @@
 #include "vtkPassArrays.h"
 #include "vtkSMIntVectorProperty.h"
 #include "vtkSMProxy.h"
+#include "vtkSMPropertyHelper.h"
 #include "vtkSMProxyManager.h"
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSMSourceProxy.h"
 #include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
 #include "vtkTemporalDataSetCache.h"
+#include "vtkTimerLog.h"
 
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vtksys/SystemTools.hxx>
 
@@ -56,6 +60,46 @@ struct vtkCPProcessorInternals
   typedef std::map<std::string, vtkSmartPointer<vtkSMSourceProxy> > CacheList;
   typedef CacheList::iterator CacheListIterator;
   CacheList TemporalCaches;
+  std::string TemporalCacheSpillDirectory;
+
+  vtkNew<vtkCPAsynchronousExecutor> Executor;
+  vtkCPProcessor::ReleaseCallbackType ReleaseCallback = nullptr;
+  void* ReleaseCallbackData = nullptr;
+  bool WarnedAboutPythonPipelines = false;
+
+  // Serializes the accesses to the pipeline list: in asynchronous mode, a
+  // time step iterates over it on the execution thread while the simulation
+  // thread calls RequestDataDescription() or adds and removes pipelines. It is
+  // not held while the pipelines execute so that the simulation does not wait
+  // for them.
+  std::mutex PipelinesMutex;
+
+  // Python pipelines cannot be executed asynchronously: their
+  // RequestDataDescription() would run Python on the simulation thread while
+  // the execution thread runs Python for the previous time step.
+  bool HasPythonPipelines()
+  {
+    for (auto& pipeline : this->Pipelines)
+    {
+      if (pipeline->IsA("vtkCPPythonPipeline"))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Applies the processor settings to a temporal cache. The settings other
+  // than the size only exist for CatalystTemporalCache proxies.
+  void ConfigureTemporalCache(vtkSMSourceProxy* cache, int size, vtkTypeInt64 memoryLimit)
+  {
+    // a memory limit alone does not limit the number of timesteps.
+    vtkSMPropertyHelper(cache, "CacheSize").Set(size <= 0 && memoryLimit > 0 ? VTK_INT_MAX : size);
+    vtkSMPropertyHelper(cache, "MemoryLimit", true).Set(static_cast<vtkIdType>(memoryLimit));
+    vtkSMPropertyHelper(cache, "SpillDirectory", true)
+      .Set(this->TemporalCacheSpillDirectory.c_str());
+    cache->UpdateVTKObjects();
+  }
 };
 
 vtkStandardNewMacro(vtkCPProcessor);
@@ -67,6 +111,7 @@ vtkCPProcessor::vtkCPProcessor()
   this->InitializationHelper = nullptr;
   this->WorkingDirectory = nullptr;
   this->TemporalCacheSize = 0;
+  this->TemporalCacheMemoryLimit = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -74,6 +119,7 @@ vtkCPProcessor::~vtkCPProcessor()
 {
   // in case the adaptor failed to call `vtkCPProcessor::Finalize()`
   // see paraview/paraview#20154
+  this->Internal->Executor->Stop();
   this->FinalizeAndRemovePipelines();
   if (this->Internal)
   {
@@ -98,6 +144,7 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
     return 0;
   }
 
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   this->Internal->Pipelines.push_back(pipeline);
   return 1;
 }
@@ -105,6 +152,7 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
 //----------------------------------------------------------------------------
 int vtkCPProcessor::GetNumberOfPipelines()
 {
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   return static_cast<int>(this->Internal->Pipelines.size());
 }
 
@@ -115,6 +163,7 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
   {
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   int counter = 0;
   vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
   while (counter <= which)
@@ -132,12 +181,14 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemovePipeline(vtkCPPipeline* pipeline)
 {
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   this->Internal->Pipelines.remove(pipeline);
 }
 
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemoveAllPipelines()
 {
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   this->Internal->Pipelines.clear();
 }
 
@@ -228,6 +279,7 @@ int vtkCPProcessor::RequestDataDescription(vtkCPDataDescription* dataDescription
 
   dataDescription->ResetInputDescriptions();
   int doCoProcessing = 0;
+  std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
   for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
        iter != this->Internal->Pipelines.end(); iter++)
   {
@@ -247,6 +299,73 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
   }
+  bool asynchronous = this->Asynchronous;
+  if (asynchronous)
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
+    asynchronous = !this->Internal->HasPythonPipelines();
+  }
+  if (this->Asynchronous && !asynchronous && !this->Internal->WarnedAboutPythonPipelines)
+  {
+    vtkWarningMacro("Python pipelines cannot be executed asynchronously. "
+                    "Co-processing steps are executed synchronously.");
+    this->Internal->WarnedAboutPythonPipelines = true;
+  }
+  if (!asynchronous)
+  {
+    // time steps queued before a Python pipeline was added go first.
+    this->Internal->Executor->WaitForCompletion();
+    return this->CoProcessStep(dataDescription);
+  }
+
+  // the time step gets its own copy of the inputs since the simulation
+  // modifies them as soon as we return.
+  const double start = vtkTimerLog::GetUniversalTime();
+  vtkSmartPointer<vtkCPDataDescription> snapshot = vtkSmartPointer<vtkCPDataDescription>::New();
+  snapshot->Copy(dataDescription);
+  bool shallowCopies = false;
+  for (unsigned int i = 0; i < snapshot->GetNumberOfInputDescriptions(); i++)
+  {
+    vtkCPInputDataDescription* idd = snapshot->GetInputDescription(i);
+    if (vtkDataObject* grid = idd->GetGrid())
+    {
+      vtkSmartPointer<vtkDataObject> copy;
+      copy.TakeReference(grid->NewInstance());
+      if (idd->GetGridIsImmutable())
+      {
+        copy->ShallowCopy(grid);
+        shallowCopies = true;
+      }
+      else
+      {
+        copy->DeepCopy(grid);
+      }
+      idd->SetGrid(copy);
+    }
+  }
+  vtkCPAsynchronousExecutor* executor = this->Internal->Executor;
+  executor->AddCopyTime(vtkTimerLog::GetUniversalTime() - start);
+
+  ReleaseCallbackType callback = shallowCopies ? this->Internal->ReleaseCallback : nullptr;
+  void* callbackData = this->Internal->ReleaseCallbackData;
+  const bool success = executor->Submit([this, snapshot, callback, callbackData]() {
+    const int status = this->CoProcessStep(snapshot);
+    if (callback)
+    {
+      callback(snapshot->GetTimeStep(), snapshot->GetTime(), callbackData);
+    }
+    return status != 0;
+  });
+
+  // we want to reset everything here to make sure that new information
+  // is properly passed in the next time.
+  dataDescription->ResetAll();
+  return success ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::CoProcessStep(vtkCPDataDescription* dataDescription)
+{
   int success = 1;
   // We need to add in information like channel name and time value here to the
   // field data. The channel name is used to automatically keep track of which
@@ -271,12 +390,15 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
       input->GetFieldData()->AddArray(time);
 
       input->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), dataDescription->GetTime());
-      if (this->GetTemporalCacheSize() > 0)
+      if (this->GetTemporalCacheSize() > 0 || this->GetTemporalCacheMemoryLimit() > 0)
       {
         vtkSMSourceProxy* cacheForInput =
           this->GetTemporalCache(dataDescription->GetInputDescriptionName(i));
         if (cacheForInput)
         {
+          vtkSMPropertyHelper(cacheForInput, "ShallowCopyInput", true)
+            .Set(dataDescription->GetInputDescription(i)->GetGridIsImmutable() ? 1 : 0);
+          cacheForInput->UpdateVTKObjects();
           vtkTemporalDataSetCache* tc =
             vtkTemporalDataSetCache::SafeDownCast(cacheForInput->GetClientSideObject());
           tc->SetInputDataObject(input);
@@ -293,8 +415,15 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     originalWorkingDirectory = vtksys::SystemTools::GetCurrentWorkingDirectory();
     vtksys::SystemTools::ChangeDirectory(this->WorkingDirectory);
   }
-  for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
-       iter != this->Internal->Pipelines.end(); iter++)
+  // pipelines added or removed meanwhile are taken into account at the next
+  // time step.
+  vtkCPProcessorInternals::PipelineList pipelines;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->PipelinesMutex);
+    pipelines = this->Internal->Pipelines;
+  }
+  for (vtkCPProcessorInternals::PipelineListIterator iter = pipelines.begin();
+       iter != pipelines.end(); iter++)
   {
     // Reset dataDescription so that we can check each pipeline again
     // before calling CoProcess to make sure which pipelines should
@@ -308,7 +437,7 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
       // now we need to filter out arrays that are not needed by this pipeline
       // but were requested by other pipelines at this time step
       vtkSmartPointer<vtkCPDataDescription> dataDescriptionCopy = dataDescription;
-      if (this->Internal->Pipelines.size() > 1)
+      if (pipelines.size() > 1)
       {
         // if there's only one pipeline we don't have to worry about getting
         // more arrays than we requesting arrays
@@ -354,6 +483,7 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  this->Internal->Executor->Stop();
   if (this->Controller)
   {
     this->Controller->SetGlobalController(nullptr);
@@ -380,10 +510,63 @@ void vtkCPProcessor::FinalizeAndRemovePipelines()
   this->RemoveAllPipelines();
 }
 
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetAsynchronous(bool asynchronous)
+{
+  if (this->Asynchronous == asynchronous)
+  {
+    return;
+  }
+  this->Asynchronous = asynchronous;
+  if (!asynchronous)
+  {
+    this->Internal->Executor->Stop();
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetMaximumNumberOfStepsInFlight(int count)
+{
+  if (this->Internal->Executor->GetMaximumNumberOfStepsInFlight() != count)
+  {
+    this->Internal->Executor->SetMaximumNumberOfStepsInFlight(count);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::GetMaximumNumberOfStepsInFlight()
+{
+  return this->Internal->Executor->GetMaximumNumberOfStepsInFlight();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetReleaseCallback(ReleaseCallbackType callback, void* clientData)
+{
+  this->Internal->ReleaseCallback = callback;
+  this->Internal->ReleaseCallbackData = clientData;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::WaitForCompletion()
+{
+  return this->Internal->Executor->WaitForCompletion() ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkCPAsynchronousExecutor* vtkCPProcessor::GetAsynchronousExecutor()
+{
+  return this->Internal->Executor;
+}
+
 //----------------------------------------------------------------------------
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Asynchronous: " << this->Asynchronous << "\n";
+  os << indent << "MaximumNumberOfStepsInFlight: " << this->GetMaximumNumberOfStepsInFlight()
+     << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -397,13 +580,55 @@ void vtkCPProcessor::SetTemporalCacheSize(int nv)
   for (vtkCPProcessorInternals::CacheListIterator it = this->Internal->TemporalCaches.begin();
        it != this->Internal->TemporalCaches.end(); it++)
   {
-    vtkTemporalDataSetCache* tc =
-      vtkTemporalDataSetCache::SafeDownCast(it->second.GetPointer()->GetClientSideObject());
-    tc->SetCacheSize(this->TemporalCacheSize);
+    this->Internal->ConfigureTemporalCache(
+      it->second, this->TemporalCacheSize, this->TemporalCacheMemoryLimit);
   }
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetTemporalCacheMemoryLimit(vtkTypeInt64 nv)
+{
+  if (this->TemporalCacheMemoryLimit == nv)
+  {
+    return;
+  }
+  this->TemporalCacheMemoryLimit = nv;
+  for (vtkCPProcessorInternals::CacheListIterator it = this->Internal->TemporalCaches.begin();
+       it != this->Internal->TemporalCaches.end(); it++)
+  {
+    this->Internal->ConfigureTemporalCache(
+      it->second, this->TemporalCacheSize, this->TemporalCacheMemoryLimit);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetTemporalCacheSpillDirectory(const char* directory)
+{
+  const std::string nv = directory ? directory : "";
+  if (this->Internal->TemporalCacheSpillDirectory == nv)
+  {
+    return;
+  }
+  this->Internal->TemporalCacheSpillDirectory = nv;
+  for (vtkCPProcessorInternals::CacheListIterator it = this->Internal->TemporalCaches.begin();
+       it != this->Internal->TemporalCaches.end(); it++)
+  {
+    this->Internal->ConfigureTemporalCache(
+      it->second, this->TemporalCacheSize, this->TemporalCacheMemoryLimit);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCPProcessor::GetTemporalCacheSpillDirectory()
+{
+  return this->Internal->TemporalCacheSpillDirectory.empty()
+    ? nullptr
+    : this->Internal->TemporalCacheSpillDirectory.c_str();
+}
+
 //----------------------------------------------------------------------------
 void vtkCPProcessor::MakeTemporalCache(const char* name)
 {
@@ -422,14 +647,21 @@ void vtkCPProcessor::MakeTemporalCache(const char* name)
   {
     return;
   }
+  // CatalystTemporalCache supports the memory limit, spilling and shallow
+  // copies. It is not available when ParaView is built without the
+  // VTKExtensionsFiltersGeneral module.
+  const char* cacheName = sessionProxyManager->HasDefinition("sources", "CatalystTemporalCache")
+    ? "CatalystTemporalCache"
+    : "TemporalCache";
   vtkSmartPointer<vtkSMSourceProxy> producer;
   producer.TakeReference(vtkSMSourceProxy::SafeDownCast(
-    sessionProxyManager->NewProxy("sources", "TemporalCache"))); // note: source
+    sessionProxyManager->NewProxy("sources", cacheName))); // note: source
   producer->UpdateVTKObjects();
   vtkTemporalDataSetCache* tc =
     vtkTemporalDataSetCache::SafeDownCast(producer->GetClientSideObject());
-  tc->SetCacheSize(this->TemporalCacheSize);
   tc->CacheInMemkindOn();
+  this->Internal->ConfigureTemporalCache(
+    producer, this->TemporalCacheSize, this->TemporalCacheMemoryLimit);
   this->Internal->TemporalCaches[name] = producer;
 }
 
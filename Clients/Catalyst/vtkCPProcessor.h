@@ -19,6 +19,7 @@
 #include "vtkPVCatalystModule.h" // For windows import/export of shared libraries
 
 struct vtkCPProcessorInternals;
+class vtkCPAsynchronousExecutor;
 class vtkCPDataDescription;
 class vtkCPPipeline;
 class vtkMPICommunicatorOpaqueComm;
@@ -81,6 +82,20 @@ public:
   virtual void SetTemporalCacheSize(int);
   vtkGetMacro(TemporalCacheSize, int);
 
+  // Controls the memory, in bytes, used by the timesteps each temporal
+  // cache keeps in memory. Default is zero, which means no limit. Caching
+  // is enabled when either this or the cache size is set. Inputs whose
+  // grids are immutable (see vtkCPInputDataDescription::SetGridIsImmutable)
+  // are cached without copying their arrays.
+  virtual void SetTemporalCacheMemoryLimit(vtkTypeInt64);
+  vtkGetMacro(TemporalCacheMemoryLimit, vtkTypeInt64);
+
+  // Directory, ideally on a node-local disk, where temporal caches write
+  // the timesteps they evict from memory. Not set by default, in which case
+  // evicted timesteps are discarded.
+  virtual void SetTemporalCacheSpillDirectory(const char*);
+  virtual const char* GetTemporalCacheSpillDirectory();
+
   // Accessor to specific temporal cache. Names match CPInputData names
   virtual void MakeTemporalCache(const char* name);
   virtual vtkSMSourceProxy* GetTemporalCache(const char* name);
@@ -123,6 +138,40 @@ public:
   /// implementation an opportunity to clean up, before it is destroyed.
   virtual int Finalize();
 
+  /// Asynchronous mode. When on, CoProcess() copies the inputs, queues the
+  /// time step and returns; the pipelines are executed on a separate thread
+  /// (see vtkCPAsynchronousExecutor) while the simulation proceeds. Inputs
+  /// whose grids are immutable (see vtkCPInputDataDescription::SetGridIsImmutable)
+  /// are shallow copied, and the release callback is called once the time
+  /// step no longer uses them. CoProcess() then returns 0 if a previous time
+  /// step failed. RequestDataDescription() keeps running in the calling
+  /// thread, possibly while a time step executes the pipelines.
+  /// Time steps are executed synchronously while Python pipelines are
+  /// registered, and when running on more than one process. Default is off.
+  /// Turning it off waits for the queued time steps.
+  virtual void SetAsynchronous(bool);
+  vtkGetMacro(Asynchronous, bool);
+  vtkBooleanMacro(Asynchronous, bool);
+
+  /// Maximum number of time steps queued or executing in asynchronous mode.
+  /// CoProcess() waits when this number is reached. Default is 1.
+  virtual void SetMaximumNumberOfStepsInFlight(int);
+  virtual int GetMaximumNumberOfStepsInFlight();
+
+  /// Function called, from the execution thread, once an asynchronous time
+  /// step no longer uses the shallow copied inputs, with the time step, the
+  /// time and `clientData`.
+  typedef void (*ReleaseCallbackType)(vtkIdType timeStep, double time, void* clientData);
+  void SetReleaseCallback(ReleaseCallbackType callback, void* clientData);
+
+  /// Waits for the time steps queued in asynchronous mode to complete.
+  /// Returns 0 if one of them failed, 1 otherwise.
+  virtual int WaitForCompletion();
+
+  /// Executor for the asynchronous mode, which reports the time spent
+  /// executing, waiting and copying and the overlap efficiency.
+  vtkCPAsynchronousExecutor* GetAsynchronousExecutor();
+
   /// Get the current working directory for outputting Catalyst files.
   /// If not set then Catalyst output files will be relative to the
   /// current working directory. This will not affect where Catalyst
@@ -147,6 +196,12 @@ protected:
    */
   void FinalizeAndRemovePipelines();
 
+  /**
+   * Executes the pipelines for a time step. This is what CoProcess() does
+   * in synchronous mode.
+   */
+  virtual int CoProcessStep(vtkCPDataDescription* dataDescription);
+
 private:
   vtkCPProcessor(const vtkCPProcessor&) = delete;
   void operator=(const vtkCPProcessor&) = delete;
@@ -156,6 +211,8 @@ private:
   static vtkMultiProcessController* Controller;
   char* WorkingDirectory;
   int TemporalCacheSize = 0;
+  vtkTypeInt64 TemporalCacheMemoryLimit = 0;
+  bool Asynchronous = false;
 };
 
 #endif
@@ -26,11 +26,18 @@
 #include "vtkSMProxyManager.h"
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSMSourceProxy.h"
+#include "vtkTimerLog.h"
 
 #if VTK_MODULE_ENABLE_VTK_ParallelMPI
 #include "vtkMPI.h"
 #endif
 
+#include <memory>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, std::shared_ptr<conduit::Node> > > MeshCopiesType;
+
 static bool update_producer_mesh_blueprint(
   const std::string& channel_name, const conduit::Node* node)
 {
@@ -112,6 +119,18 @@ void catalyst_initialize(const conduit_node* params)
     vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(),
       "No Catalyst Python scripts specified. No analysis pipelines will be executed.");
   }
+
+  if (cpp_params.has_path("catalyst/asynchronous") &&
+    cpp_params["catalyst/asynchronous"].to_int64() != 0)
+  {
+    if (cpp_params.has_path("catalyst/max_steps_in_flight"))
+    {
+      vtkInSituInitializationHelper::SetMaximumNumberOfStepsInFlight(
+        static_cast<int>(cpp_params["catalyst/max_steps_in_flight"].to_int64()));
+    }
+    vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(), "Pipelines are executed asynchronously.");
+    vtkInSituInitializationHelper::SetAsynchronous(true);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -143,6 +162,12 @@ void catalyst_execute(const conduit_node* params)
   vtkVLogScopeF(
     PARAVIEW_LOG_CATALYST_VERBOSITY(), "co-processing for timestep=%d, time=%f", timestep, time);
 
+  // in asynchronous mode, the meshes are copied and handed to the producers
+  // on the execution thread.
+  const bool asynchronous = vtkInSituInitializationHelper::GetAsynchronous();
+  auto meshCopies = std::make_shared<MeshCopiesType>();
+  const double start = vtkTimerLog::GetUniversalTime();
+
   // catalyst/channels are used to communicate meshes.
   if (root.has_child("channels"))
   {
@@ -161,7 +186,16 @@ void catalyst_execute(const conduit_node* params)
         {
           vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(),
             "Conduit Mesh blueprint validation succeeded for channel (%s)", channel_name.c_str());
-          update_producer_mesh_blueprint(channel_name, &mesh_node);
+          if (asynchronous)
+          {
+            auto copy = std::make_shared<conduit::Node>();
+            copy->set(mesh_node);
+            meshCopies->push_back(std::make_pair(channel_name, copy));
+          }
+          else
+          {
+            update_producer_mesh_blueprint(channel_name, &mesh_node);
+          }
         }
         else
         {
@@ -182,7 +216,22 @@ void catalyst_execute(const conduit_node* params)
                                                 "No meshes will be processed.");
   }
 
-  vtkInSituInitializationHelper::ExecutePipelines(timestep, time);
+  if (asynchronous)
+  {
+    vtkInSituInitializationHelper::GetAsynchronousExecutor()->AddCopyTime(
+      vtkTimerLog::GetUniversalTime() - start);
+    // the copies are owned by the time step, and released once it completes.
+    vtkInSituInitializationHelper::ExecutePipelines(timestep, time, [meshCopies]() {
+      for (const auto& item : *meshCopies)
+      {
+        update_producer_mesh_blueprint(item.first, item.second.get());
+      }
+    });
+  }
+  else
+  {
+    vtkInSituInitializationHelper::ExecutePipelines(timestep, time);
+  }
 }
 
 //-----------------------------------------------------------------------------
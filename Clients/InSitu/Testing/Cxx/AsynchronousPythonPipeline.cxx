@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    AsynchronousPythonPipeline.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that time steps are executed synchronously, in the calling thread,
+// when asynchronous mode is on and a Python pipeline is added.
+
+#include "vtkCPAsynchronousExecutor.h"
+#include "vtkInSituInitializationHelper.h"
+#include "vtkTestUtilities.h"
+
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+#include "vtkMPI.h"
+#endif
+
+#include <vtksys/SystemTools.hxx>
+
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+int Run(const std::string& tempDir)
+{
+  const int numberOfSteps = 3;
+  const std::string script = tempDir + "/AsynchronousPythonPipeline.py";
+  for (int step = 0; step < numberOfSteps; ++step)
+  {
+    vtksys::SystemTools::RemoveFile(tempDir + "/AsynchronousPythonPipeline_" +
+      std::to_string(step) + ".txt");
+  }
+  {
+    std::ofstream file(script.c_str());
+    file << "import os\n"
+         << "from paraview.catalyst import Options\n"
+         << "options = Options()\n"
+         << "def catalyst_execute(info):\n"
+         << "    name = 'AsynchronousPythonPipeline_%d.txt' % info.timestep\n"
+         << "    with open(os.path.join(r'" << tempDir << "', name), 'w') as f:\n"
+         << "        f.write(str(info.time))\n";
+  }
+
+  vtkInSituInitializationHelper::AddPipeline(script);
+  vtkInSituInitializationHelper::SetAsynchronous(true);
+
+  const std::thread::id simulationThread = std::this_thread::get_id();
+  for (int step = 0; step < numberOfSteps; ++step)
+  {
+    bool prepared = false;
+    vtkInSituInitializationHelper::ExecutePipelines(step, step, [&]() {
+      prepared = (std::this_thread::get_id() == simulationThread);
+    });
+    if (!prepared)
+    {
+      cerr << "ERROR: time step " << step << " was not executed in the calling thread." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkCPAsynchronousExecutor* executor = vtkInSituInitializationHelper::GetAsynchronousExecutor();
+  if (executor->IsRunning() || executor->GetNumberOfSteps() != 0)
+  {
+    cerr << "ERROR: the execution thread was used." << endl;
+    return EXIT_FAILURE;
+  }
+
+  if (vtkInSituInitializationHelper::IsPythonSupported())
+  {
+    for (int step = 0; step < numberOfSteps; ++step)
+    {
+      const std::string output =
+        tempDir + "/AsynchronousPythonPipeline_" + std::to_string(step) + ".txt";
+      if (!vtksys::SystemTools::FileExists(output))
+      {
+        cerr << "ERROR: the Python pipeline did not execute time step " << step << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int AsynchronousPythonPipeline(int argc, char* argv[])
+{
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+  MPI_Init(&argc, &argv);
+  const vtkTypeUInt64 comm = static_cast<vtkTypeUInt64>(MPI_Comm_c2f(MPI_COMM_WORLD));
+#else
+  const vtkTypeUInt64 comm = 0;
+#endif
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+
+  vtkInSituInitializationHelper::Initialize(comm);
+  const int result = Run(tempDir);
+  vtkInSituInitializationHelper::Finalize();
+  delete[] tempDir;
+
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+  MPI_Finalize();
+#endif
+  return result;
+}
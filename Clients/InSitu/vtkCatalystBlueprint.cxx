@@ -83,6 +83,14 @@ bool verify(const std::string& protocol, const conduit::Node& n)
       return false;
     }
   }
+  for (const char* name : { "asynchronous", "max_steps_in_flight" })
+  {
+    if (n.has_child(name) && !n[name].dtype().is_integer())
+    {
+      vtkLogF(ERROR, "'%s' must be an integer.", name);
+      return false;
+    }
+  }
   return true;
 }
 
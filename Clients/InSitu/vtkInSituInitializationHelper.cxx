@@ -14,9 +14,11 @@
 =========================================================================*/
 #include "vtkInSituInitializationHelper.h"
 
+#include "vtkCPAsynchronousExecutor.h"
 #include "vtkCPCxxHelper.h"
 #include "vtkInSituPipelinePython.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPSystemTools.h"
 #include "vtkPVLogger.h"
@@ -59,6 +61,55 @@ public:
   bool InExecutePipelines = false;
   int TimeStep = 0;
   double Time = 0.0;
+
+  bool Asynchronous = false;
+  bool WarnedAboutPythonPipelines = false;
+  vtkNew<vtkCPAsynchronousExecutor> Executor;
+
+  // `prepare` function of the time step executing asynchronously. It holds
+  // the data handed to the producers, e.g. copies of the simulation meshes,
+  // which is released once the time step completes.
+  std::function<void()> Prepare;
+
+  // Python pipelines cannot be executed asynchronously: the interpreter is
+  // not guaranteed to support being driven from the execution thread.
+  bool HasPythonPipelines()
+  {
+    for (const auto& item : this->Pipelines)
+    {
+      if (item.Pipeline->IsA("vtkInSituPipelinePython"))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Execute(int timestep, double time)
+  {
+    this->InExecutePipelines = true;
+    this->TimeStep = timestep;
+    this->Time = time;
+
+    for (auto& item : this->Pipelines)
+    {
+      if (!item.Initialized)
+      {
+        item.InitializationFailed = !item.Pipeline->Initialize();
+        item.Initialized = true;
+      }
+
+      if (!item.InitializationFailed && !item.ExecuteFailed)
+      {
+        // If `Initialize` failed, don't call `Execute` on the Pipeline.
+        // If Execute fails even once, we no longer call Execute on this pipeline
+        // in subsequent calls to `ExecutePipelines`.
+        item.ExecuteFailed = !item.Pipeline->Execute(timestep, time);
+      }
+    }
+
+    this->InExecutePipelines = false;
+  }
 };
 
 int vtkInSituInitializationHelper::WasInitializedOnce;
@@ -151,7 +202,9 @@ void vtkInSituInitializationHelper::Finalize()
   }
 
   // finalize pipelines.
-  const auto& internals = (*vtkInSituInitializationHelper::Internals);
+  auto& internals = (*vtkInSituInitializationHelper::Internals);
+  internals.Executor->Stop();
+  internals.Prepare = nullptr;
   for (auto& item : internals.Pipelines)
   {
     if (item.Initialized && !item.InitializationFailed)
@@ -191,6 +244,8 @@ void vtkInSituInitializationHelper::AddPipeline(const std::string& path)
   pipeline->SetPipelinePath(path.c_str());
 
   auto& internals = (*vtkInSituInitializationHelper::Internals);
+  // the execution thread may be iterating over the pipelines.
+  internals.Executor->WaitForCompletion();
   internals.Pipelines.push_back(vtkInternals::PipelineInfo{ pipeline, false, false, false });
 }
 
@@ -281,44 +336,110 @@ void vtkInSituInitializationHelper::MarkProducerModified(vtkSMSourceProxy* produ
 
 //----------------------------------------------------------------------------
 bool vtkInSituInitializationHelper::ExecutePipelines(int timestep, double time)
+{
+  return vtkInSituInitializationHelper::ExecutePipelines(timestep, time, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkInSituInitializationHelper::ExecutePipelines(
+  int timestep, double time, std::function<void()> prepare)
 {
   if (vtkInSituInitializationHelper::Internals == nullptr)
   {
-    vtkLogF(ERROR, "'vtkInSituInitializationHelper::MarkProducerModified' cannot be called before "
+    vtkLogF(ERROR, "'vtkInSituInitializationHelper::ExecutePipelines' cannot be called before "
                    "'Initialize'.");
     return false;
   }
 
   auto& internals = (*vtkInSituInitializationHelper::Internals);
+  const bool asynchronous = internals.Asynchronous && !internals.HasPythonPipelines();
+  if (internals.Asynchronous && !asynchronous && !internals.WarnedAboutPythonPipelines)
+  {
+    vtkLogF(WARNING, "Python pipelines cannot be executed asynchronously. "
+                     "Pipelines are executed synchronously.");
+    internals.WarnedAboutPythonPipelines = true;
+  }
+  if (asynchronous)
+  {
+    return internals.Executor->Submit([&internals, timestep, time, prepare]() mutable {
+      internals.Prepare = std::move(prepare);
+      if (internals.Prepare)
+      {
+        internals.Prepare();
+      }
+      internals.Execute(timestep, time);
+      internals.Prepare = nullptr;
+      return true;
+    });
+  }
+
   if (internals.InExecutePipelines)
   {
     vtkLogF(ERROR, "Recursive call to 'ExecutePipelines' not supported!");
     return false;
   }
 
-  internals.InExecutePipelines = true;
-  internals.TimeStep = timestep;
-  internals.Time = time;
+  // time steps queued before a Python pipeline was added go first.
+  const bool success = internals.Executor->WaitForCompletion();
+  if (prepare)
+  {
+    prepare();
+  }
+  internals.Execute(timestep, time);
+  return success;
+}
 
-  for (auto& item : internals.Pipelines)
+//----------------------------------------------------------------------------
+void vtkInSituInitializationHelper::SetAsynchronous(bool asynchronous)
+{
+  if (vtkInSituInitializationHelper::Internals == nullptr)
   {
-    if (!item.Initialized)
-    {
-      item.InitializationFailed = !item.Pipeline->Initialize();
-      item.Initialized = true;
-    }
+    vtkLogF(ERROR, "'vtkInSituInitializationHelper::SetAsynchronous' cannot be called before "
+                   "'Initialize'.");
+    return;
+  }
 
-    if (!item.InitializationFailed && !item.ExecuteFailed)
-    {
-      // If `Initialize` failed, don't call `Execute` on the Pipeline.
-      // If Execute fails even once, we no longer call Execute on this pipeline
-      // in subsequent calls to `ExecutePipelines`.
-      item.ExecuteFailed = !item.Pipeline->Execute(timestep, time);
-    }
+  auto& internals = (*vtkInSituInitializationHelper::Internals);
+  internals.Asynchronous = asynchronous;
+  if (!asynchronous)
+  {
+    internals.Executor->Stop();
   }
+}
 
-  internals.InExecutePipelines = false;
-  return true;
+//----------------------------------------------------------------------------
+bool vtkInSituInitializationHelper::GetAsynchronous()
+{
+  return vtkInSituInitializationHelper::Internals != nullptr &&
+    vtkInSituInitializationHelper::Internals->Asynchronous;
+}
+
+//----------------------------------------------------------------------------
+void vtkInSituInitializationHelper::SetMaximumNumberOfStepsInFlight(int count)
+{
+  if (auto executor = vtkInSituInitializationHelper::GetAsynchronousExecutor())
+  {
+    executor->SetMaximumNumberOfStepsInFlight(count);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkInSituInitializationHelper::WaitForPipelines()
+{
+  auto executor = vtkInSituInitializationHelper::GetAsynchronousExecutor();
+  return executor ? executor->WaitForCompletion() : false;
+}
+
+//----------------------------------------------------------------------------
+vtkCPAsynchronousExecutor* vtkInSituInitializationHelper::GetAsynchronousExecutor()
+{
+  if (vtkInSituInitializationHelper::Internals == nullptr)
+  {
+    vtkLogF(ERROR, "'vtkInSituInitializationHelper::GetAsynchronousExecutor' cannot be called "
+                   "before 'Initialize'.");
+    return nullptr;
+  }
+  return vtkInSituInitializationHelper::Internals->Executor;
 }
 
 //----------------------------------------------------------------------------
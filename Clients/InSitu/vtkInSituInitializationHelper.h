@@ -46,9 +46,13 @@
 #include "vtkObject.h"
 #include "vtkPVInSituModule.h" // For windows import/export of shared libraries
 
+class vtkCPAsynchronousExecutor;
 class vtkCPCxxHelper;
 class vtkSMSourceProxy;
 
+#ifndef __VTK_WRAP__
+#include <functional> // for std::function
+#endif
 #include <string> // for std::string
 
 class VTKPVINSITU_EXPORT vtkInSituInitializationHelper : public vtkObject
@@ -119,6 +123,45 @@ public:
    */
   static bool ExecutePipelines(int timestep, double time);
 
+#ifndef __VTK_WRAP__
+  /**
+   * Executes pipelines after calling `prepare`, which typically passes the
+   * simulation data to the producers. In asynchronous mode, both are done on
+   * the execution thread and this returns as soon as the time step is queued,
+   * so `prepare` must only use data that the simulation does not modify
+   * afterwards, e.g. a copy that it captures. `prepare`, and the data it
+   * captures, is released once the time step completes. The return value
+   * then reports failures of previous time steps.
+   */
+  static bool ExecutePipelines(int timestep, double time, std::function<void()> prepare);
+#endif
+
+  //@{
+  /**
+   * Asynchronous mode. When on, pipelines are executed on a separate thread
+   * (see vtkCPAsynchronousExecutor), with up to MaximumNumberOfStepsInFlight
+   * time steps queued or executing. Turning it off, or finalizing, waits for
+   * the queued time steps. Time steps are executed synchronously while Python
+   * pipelines are added, and when running on more than one process. Default
+   * is off.
+   */
+  static void SetAsynchronous(bool asynchronous);
+  static bool GetAsynchronous();
+  static void SetMaximumNumberOfStepsInFlight(int count);
+  //@}
+
+  /**
+   * Waits for the time steps queued in asynchronous mode to complete. Returns
+   * false if one of them failed.
+   */
+  static bool WaitForPipelines();
+
+  /**
+   * Executor for the asynchronous mode, which reports the time spent
+   * executing, waiting and copying and the overlap efficiency.
+   */
+  static vtkCPAsynchronousExecutor* GetAsynchronousExecutor();
+
   //@{
   /**
    * Provides access to current time and timestep during `ExecutePipelines`
@@ -40,6 +40,11 @@ class vtkPVInitializerPlugin : public vtkPVPlugin, public vtkPVServerManagerPlug
     paraview_server_manager_initialize(xmls);
   }
 
+  void GetBinaryDefinitions(const char*& data, size_t& size) override
+  {
+    paraview_server_manager_binary_definitions(data, size);
+  }
+
   vtkClientServerInterpreterInitializer::InterpreterInitializationCallback
   GetInitializeInterpreterCallback() override
   {
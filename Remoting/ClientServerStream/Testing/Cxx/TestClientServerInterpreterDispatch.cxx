@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestClientServerInterpreterDispatch.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkClientServerInterpreter dispatches Invoke messages to the
+// command function of the class that implements the method, including
+// repeated calls and overloads, and reports the number of calls per second.
+// The command functions mimic the ones generated by vtkWrapClientServer: each
+// compares the method name with the methods of its class and then tries its
+// superclass.
+// Pass `--calls N` to change the number of messages in the stream.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerStream.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+const int NumberOfMethodsPerClass = 64;
+
+struct ClassLevel
+{
+  const char* Name;
+  const char* SuperClass;
+  std::string Methods[NumberOfMethodsPerClass];
+};
+
+ClassLevel Levels[] = { { "vtkDoubleArray", "vtkDataArray", {} },
+  { "vtkDataArray", "vtkAbstractArray", {} }, { "vtkAbstractArray", "vtkObject", {} },
+  { "vtkObject", nullptr, {} } };
+
+int Calls[4] = { 0, 0, 0, 0 };
+
+int DispatchCommand(vtkClientServerInterpreter* arlu, vtkObjectBase* ob, const char* method,
+  const vtkClientServerStream& msg, vtkClientServerStream& resultStream, void* ctx)
+{
+  const int level = static_cast<int>(reinterpret_cast<size_t>(ctx));
+  vtkDoubleArray* op = vtkDoubleArray::SafeDownCast(ob);
+  for (int cc = 0; cc < NumberOfMethodsPerClass; ++cc)
+  {
+    if (!strcmp(Levels[level].Methods[cc].c_str(), method) && msg.GetNumberOfArguments(0) == 2)
+    {
+      ++Calls[level];
+      resultStream.Reset();
+      resultStream << vtkClientServerStream::Reply << level << vtkClientServerStream::End;
+      return 1;
+    }
+  }
+
+  // one real method per level, with overloads on the argument type.
+  if (level == 1 && !strcmp("SetNumberOfComponents", method) && msg.GetNumberOfArguments(0) == 3)
+  {
+    int temp0;
+    if (msg.GetArgument(0, 2, &temp0))
+    {
+      ++Calls[level];
+      op->SetNumberOfComponents(temp0);
+      return 1;
+    }
+  }
+  // overloads on the array length: level 0 takes 3 values, level 2 any number.
+  if ((level == 0 || level == 2) && !strcmp("SetRange", method) &&
+    msg.GetNumberOfArguments(0) == 3)
+  {
+    vtkTypeUInt32 length;
+    if (msg.GetArgumentLength(0, 2, &length) && (level == 2 || length == 3))
+    {
+      ++Calls[level];
+      resultStream.Reset();
+      resultStream << vtkClientServerStream::Reply << level << vtkClientServerStream::End;
+      return 1;
+    }
+  }
+  if (level == 3 && !strcmp("Modified", method) && msg.GetNumberOfArguments(0) == 2)
+  {
+    ++Calls[level];
+    op->Modified();
+    return 1;
+  }
+
+  if (const char* commandName = Levels[level].SuperClass)
+  {
+    if (arlu->HasCommandFunction(commandName) &&
+      arlu->CallCommandFunction(commandName, op, method, msg, resultStream))
+    {
+      return 1;
+    }
+  }
+  resultStream.Reset();
+  resultStream << vtkClientServerStream::Error << "could not find requested method"
+               << vtkClientServerStream::End;
+  return 0;
+}
+
+vtkObjectBase* NewDoubleArray(void*)
+{
+  return vtkDoubleArray::New();
+}
+}
+
+int TestClientServerInterpreterDispatch(int argc, char* argv[])
+{
+  int numberOfCalls = 100000;
+  for (int cc = 1; cc + 1 < argc; ++cc)
+  {
+    if (strcmp(argv[cc], "--calls") == 0)
+    {
+      numberOfCalls = atoi(argv[cc + 1]);
+    }
+  }
+
+  vtkNew<vtkClientServerInterpreter> interp;
+  for (int level = 0; level < 4; ++level)
+  {
+    for (int cc = 0; cc < NumberOfMethodsPerClass; ++cc)
+    {
+      Levels[level].Methods[cc] = std::string("Method") + Levels[level].Name + std::to_string(cc);
+    }
+    interp->AddCommandFunction(
+      Levels[level].Name, DispatchCommand, reinterpret_cast<void*>(static_cast<size_t>(level)));
+  }
+  interp->AddNewInstanceFunction("vtkDoubleArray", NewDoubleArray);
+
+  vtkClientServerID id(1);
+  vtkClientServerStream setup;
+  setup << vtkClientServerStream::New << "vtkDoubleArray" << id << vtkClientServerStream::End;
+  if (!interp->ProcessStream(setup))
+  {
+    cerr << "ERROR: failed to create the object." << endl;
+    return EXIT_FAILURE;
+  }
+  vtkDoubleArray* array = vtkDoubleArray::SafeDownCast(interp->GetObjectFromID(id));
+
+  // a method is found at the level that implements it, on every call.
+  for (int level = 0; level < 4; ++level)
+  {
+    for (int cc = 0; cc < 2; ++cc)
+    {
+      vtkClientServerStream css;
+      css << vtkClientServerStream::Invoke << id << Levels[level].Methods[7].c_str()
+          << vtkClientServerStream::End;
+      int result = -1;
+      if (!interp->ProcessStream(css) || !interp->GetLastResult().GetArgument(0, 0, &result) ||
+        result != level)
+      {
+        cerr << "ERROR: " << Levels[level].Methods[7] << " dispatched to level " << result
+             << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // an overload with other argument types is not taken for the cached one.
+  vtkClientServerStream bad;
+  bad << vtkClientServerStream::Invoke << id << "SetNumberOfComponents" << "3"
+      << vtkClientServerStream::End;
+  vtkClientServerStream good;
+  good << vtkClientServerStream::Invoke << id << "SetNumberOfComponents" << 3
+       << vtkClientServerStream::End;
+  if (!interp->ProcessStream(good) || array->GetNumberOfComponents() != 3 ||
+    interp->ProcessStream(bad))
+  {
+    cerr << "ERROR: SetNumberOfComponents was not dispatched correctly." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // an overload for another array length is not taken for the cached one.
+  const double values[5] = { 0, 1, 2, 3, 4 };
+  const int lengths[2][2] = { { 5, 2 }, { 3, 0 } };
+  for (const auto& length : lengths)
+  {
+    vtkClientServerStream css;
+    css << vtkClientServerStream::Invoke << id << "SetRange"
+        << vtkClientServerStream::InsertArray(values, length[0]) << vtkClientServerStream::End;
+    int result = -1;
+    if (!interp->ProcessStream(css) || !interp->GetLastResult().GetArgument(0, 0, &result) ||
+      result != length[1])
+    {
+      cerr << "ERROR: SetRange with " << length[0] << " values dispatched to level " << result
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // replay a stream of calls to a method implemented by the last superclass.
+  vtkClientServerStream stream;
+  for (int cc = 0; cc < numberOfCalls; ++cc)
+  {
+    stream << vtkClientServerStream::Invoke << id << "Modified" << vtkClientServerStream::End;
+  }
+  const vtkMTimeType mtime = array->GetMTime();
+  Calls[3] = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  const int status = interp->ProcessStream(stream);
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (!status || Calls[3] != numberOfCalls || array->GetMTime() <= mtime)
+  {
+    cerr << "ERROR: replaying the stream failed." << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "Calls: " << numberOfCalls << " in " << elapsed.count() << "s, "
+       << (elapsed.count() > 0 ? numberOfCalls / elapsed.count() : 0.0) << " calls/s" << endl;
+  return EXIT_SUCCESS;
+}
@@ -4,6 +4,8 @@
 #include "vtkStringArray.h"
 #include "vtkVariantArray.h"
 
+#include <utility>
+
 static double dblIni[] = { 904., 906., 917. };
 static const char* strIni[] = { "901", "Turbo", "Targa" };
 
@@ -337,6 +339,52 @@ bool do_test()
     cerr << "FAILED: (Get/Set)Data did not copy stream properly." << endl;
     return false;
   }
+
+  // Refer to the data of another stream, then modify the view.
+  vtkClientServerStream css6;
+  {
+    const unsigned char* data;
+    size_t length;
+    css5.GetData(&data, &length);
+    if (!css6.SetDataView(data, length) || !do_check(css6))
+    {
+      cerr << "FAILED: SetDataView did not parse stream properly." << endl;
+      return false;
+    }
+    const unsigned char* viewData;
+    css6.GetData(&viewData, nullptr);
+    if (viewData != data)
+    {
+      cerr << "FAILED: SetDataView copied the data." << endl;
+      return false;
+    }
+    css6 << vtkClientServerStream::Reply << "789" << vtkClientServerStream::End;
+    css6.GetData(&viewData, nullptr);
+    if (viewData == data || css6.GetNumberOfMessages() != 2)
+    {
+      cerr << "FAILED: modifying a view did not copy the data." << endl;
+      return false;
+    }
+  }
+
+  // Move the stream in various ways.
+  vtkClientServerStream css7(std::move(css2));
+  vtkClientServerStream css8;
+  css8 = std::move(css7);
+  if (!do_check(css8) || css7.GetNumberOfMessages() != 0 || css2.GetNumberOfMessages() != 0)
+  {
+    cerr << "FAILED: move did not move stream properly." << endl;
+    return false;
+  }
+
+  // Reuse a stream after a reset.
+  css1.Reset();
+  do_store(css1);
+  if (!do_check(css1))
+  {
+    cerr << "FAILED: stream could not be reused after Reset." << endl;
+    return false;
+  }
   return true;
 }
 
@@ -22,9 +22,11 @@
 #include "vtksys/FStream.hxx"
 #include "vtksys/SystemTools.hxx"
 
+#include <cstring>
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 vtkStandardNewMacro(vtkClientServerInterpreter);
@@ -70,12 +72,106 @@ public:
   };
   typedef FunctionWithContext<vtkClientServerNewInstanceFunction> NewInstanceFunction;
   typedef FunctionWithContext<vtkClientServerCommandFunction> CommandFunction;
-  typedef std::map<std::string, const NewInstanceFunction*> NewInstanceFunctionsType;
-  typedef std::map<std::string, const CommandFunction*> ClassToFunctionMapType;
+  typedef std::unordered_map<std::string, const NewInstanceFunction*> NewInstanceFunctionsType;
+  typedef std::unordered_map<std::string, const CommandFunction*> ClassToFunctionMapType;
   typedef std::map<vtkTypeUInt32, vtkClientServerStream*> IDToMessageMapType;
+
+  // Key of ResolvedMethods, see GetResolvedMethodKey().
+  struct ResolvedMethodKey
+  {
+    vtkTypeUInt64 Hash;
+    int NumberOfArguments;
+
+    bool operator==(const ResolvedMethodKey& other) const
+    {
+      return this->Hash == other.Hash && this->NumberOfArguments == other.NumberOfArguments;
+    }
+  };
+  struct ResolvedMethodKeyHash
+  {
+    size_t operator()(const ResolvedMethodKey& key) const { return static_cast<size_t>(key.Hash); }
+  };
+  typedef std::unordered_map<ResolvedMethodKey, const CommandFunction*, ResolvedMethodKeyHash>
+    ResolvedMethodsType;
   NewInstanceFunctionsType NewInstanceFunctions;
   ClassToFunctionMapType ClassToFunctionMap;
   IDToMessageMapType IDToMessageMap;
+
+  // The command function of a class first looks for the method among the
+  // methods of the class and then calls the command functions of its
+  // superclasses. For each class, method and argument signature, this
+  // remembers the command function that handled the call so that later calls
+  // go there directly.
+  ResolvedMethodsType ResolvedMethods;
+
+  // Innermost command function that succeeded during the current call.
+  const CommandFunction* LastCalledFunction = nullptr;
+
+  const CommandFunction* FindCommandFunction(const char* cname) const
+  {
+    ClassToFunctionMapType::const_iterator iter = this->ClassToFunctionMap.find(cname);
+    return iter != this->ClassToFunctionMap.end() ? iter->second : nullptr;
+  }
+
+  int Call(const CommandFunction* n, vtkClientServerInterpreter* self, vtkObjectBase* ptr,
+    const char* method, const vtkClientServerStream& msg, vtkClientServerStream& result)
+  {
+    void* ctx = n->Context ? n->Context->Context : 0;
+    const int success = n->Function(self, ptr, method, msg, result, ctx);
+    if (success && !this->LastCalledFunction)
+    {
+      this->LastCalledFunction = n;
+    }
+    return success;
+  }
+
+  static void HashBytes(vtkTypeUInt64& hash, const void* data, size_t length)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t cc = 0; cc < length; ++cc)
+    {
+      hash = (hash ^ bytes[cc]) * 0x100000001b3ULL;
+    }
+  }
+
+  static void HashString(vtkTypeUInt64& hash, const char* str)
+  {
+    // the terminating null character separates consecutive strings.
+    HashBytes(hash, str, strlen(str) + 1);
+  }
+
+  // Key of ResolvedMethods. Overloads are resolved by the wrappers using the
+  // type of the arguments, the length of array arguments and the class of
+  // object arguments. The key is a hash of those, so a collision may send a
+  // call to a command function that does not handle it; that call then
+  // fails and the command function of the class is used instead.
+  static ResolvedMethodKey GetResolvedMethodKey(
+    const char* cname, const char* method, const vtkClientServerStream& msg)
+  {
+    ResolvedMethodKey key;
+    key.Hash = 0xcbf29ce484222325ULL;
+    key.NumberOfArguments = msg.GetNumberOfArguments(0);
+    HashString(key.Hash, cname);
+    HashString(key.Hash, method);
+    for (int a = 2; a < key.NumberOfArguments; ++a)
+    {
+      const vtkClientServerStream::Types type = msg.GetArgumentType(0, a);
+      const unsigned char typeId = static_cast<unsigned char>(type);
+      HashBytes(key.Hash, &typeId, sizeof(typeId));
+      vtkTypeUInt32 length;
+      if (type == vtkClientServerStream::vtk_object_pointer)
+      {
+        vtkObjectBase* arg = 0;
+        msg.GetArgument(0, a, &arg);
+        HashString(key.Hash, arg ? arg->GetClassName() : "");
+      }
+      else if (msg.GetArgumentLength(0, a, &length))
+      {
+        HashBytes(key.Hash, &length, sizeof(length));
+      }
+    }
+    return key;
+  }
 };
 
 //----------------------------------------------------------------------------
@@ -223,7 +319,7 @@ void vtkClientServerInterpreter::SetLogStream(ostream* ostr)
 int vtkClientServerInterpreter::ProcessStream(const unsigned char* msg, size_t msgLength)
 {
   vtkClientServerStream css;
-  css.SetData(msg, msgLength);
+  css.SetDataView(msg, msgLength);
   return this->ProcessStream(css);
 }
 
@@ -350,10 +446,11 @@ int vtkClientServerInterpreter::ProcessCommandNew(const vtkClientServerStream& c
 
     // Find a NewInstance function that knows about the class.
     int created = 0;
-    if (this->Internal->NewInstanceFunctions.count(cname))
+    vtkClientServerInterpreterInternals::NewInstanceFunctionsType::const_iterator ni =
+      this->Internal->NewInstanceFunctions.find(cname);
+    if (ni != this->Internal->NewInstanceFunctions.end())
     {
-      const vtkClientServerInterpreterInternals::NewInstanceFunction* n =
-        this->Internal->NewInstanceFunctions[cname];
+      const vtkClientServerInterpreterInternals::NewInstanceFunction* n = ni->second;
       vtkClientServerNewInstanceFunction function = n->Function;
       void* ctx = n->Context ? n->Context->Context : 0;
       this->NewInstance(function(ctx), id);
@@ -419,11 +516,46 @@ int vtkClientServerInterpreter::ProcessCommandInvoke(const vtkClientServerStream
     }
 
     // Find the command function for this object's type.
-    if (obj && this->HasCommandFunction(obj->GetClassName()))
+    const vtkClientServerInterpreterInternals::CommandFunction* function =
+      obj ? this->Internal->FindCommandFunction(obj->GetClassName()) : nullptr;
+    if (function)
     {
-      if (this->CallCommandFunction(
-            obj->GetClassName(), obj, method, msg, *this->LastResultMessage))
+      // Methods may invoke the interpreter again, keep track of the
+      // command function that succeeded for this call only.
+      const vtkClientServerInterpreterInternals::CommandFunction* previous =
+        this->Internal->LastCalledFunction;
+      const vtkClientServerInterpreterInternals::ResolvedMethodKey key =
+        vtkClientServerInterpreterInternals::GetResolvedMethodKey(obj->GetClassName(), method, msg);
+
+      // Go directly to the command function that handled the same call
+      // before, if any.
+      vtkClientServerInterpreterInternals::ResolvedMethodsType::const_iterator resolved =
+        this->Internal->ResolvedMethods.find(key);
+      if (resolved != this->Internal->ResolvedMethods.end())
       {
+        this->Internal->LastCalledFunction = nullptr;
+        const int success = this->Internal->Call(
+          resolved->second, this, obj, method, msg, *this->LastResultMessage);
+        this->Internal->LastCalledFunction = previous;
+        if (success)
+        {
+          return 1;
+        }
+        this->LastResultMessage->Reset();
+      }
+
+      this->Internal->LastCalledFunction = nullptr;
+      const int success =
+        this->Internal->Call(function, this, obj, method, msg, *this->LastResultMessage);
+      const vtkClientServerInterpreterInternals::CommandFunction* handler =
+        this->Internal->LastCalledFunction;
+      this->Internal->LastCalledFunction = previous;
+      if (success)
+      {
+        if (handler)
+        {
+          this->Internal->ResolvedMethods[key] = handler;
+        }
         return 1;
       }
     }
@@ -777,6 +909,9 @@ void vtkClientServerInterpreter::AddCommandFunction(const char* cname,
 
   this->Internal->ClassToFunctionMap[cname] =
     new vtkClientServerInterpreterInternals::CommandFunction(func, context);
+
+  // The new function may be used by classes for which calls were resolved.
+  this->Internal->ResolvedMethods.clear();
 }
 
 //----------------------------------------------------------------------------
@@ -793,20 +928,16 @@ bool vtkClientServerInterpreter::HasCommandFunction(const char* cname)
 int vtkClientServerInterpreter::CallCommandFunction(const char* cname, vtkObjectBase* ptr,
   const char* method, const vtkClientServerStream& msg, vtkClientServerStream& result)
 {
-  vtkClientServerInterpreterInternals::ClassToFunctionMapType::const_iterator f =
-    this->Internal->ClassToFunctionMap.find(cname);
+  const vtkClientServerInterpreterInternals::CommandFunction* n =
+    this->Internal->FindCommandFunction(cname);
 
-  if (f == this->Internal->ClassToFunctionMap.end())
+  if (!n)
   {
     vtkErrorMacro("Cannot find command function for \"" << cname << "\".");
     return 1;
   }
 
-  const vtkClientServerInterpreterInternals::CommandFunction* n = f->second;
-
-  vtkClientServerCommandFunction function = n->Function;
-  void* ctx = n->Context ? n->Context->Context : 0;
-  return function(this, ptr, method, msg, result, ctx);
+  return this->Internal->Call(n, this, ptr, method, msg, result);
 }
 
 void vtkClientServerInterpreter::AddNewInstanceFunction(const char* name,
@@ -24,9 +24,11 @@
 #include "vtkVariantExtract.h"
 
 #include <algorithm>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 
 //----------------------------------------------------------------------------
@@ -137,21 +139,37 @@ public:
     : Objects(owner)
   {
   }
-  vtkClientServerStreamInternals(const vtkClientServerStreamInternals& r, vtkObjectBase* owner)
-    : Data(r.Data)
-    , ValueOffsets(r.ValueOffsets)
-    , MessageIndexes(r.MessageIndexes)
-    , Objects(r.Objects, owner)
-    , StartIndex(r.StartIndex)
-    , Invalid(r.Invalid)
-    , String(r.String)
-  {
-  }
 
   // Actual binary data in the stream.
   typedef std::vector<unsigned char> DataType;
   DataType Data;
 
+  // Data given to SetDataView, used instead of Data until the stream is
+  // modified.
+  const unsigned char* View = nullptr;
+  size_t ViewLength = 0;
+
+  const unsigned char* GetBegin() const
+  {
+    return this->View ? this->View : this->Data.data();
+  }
+  size_t GetSize() const { return this->View ? this->ViewLength : this->Data.size(); }
+
+  // Copy the data of a view so that they can be modified.
+  void Materialize()
+  {
+    if (this->View)
+    {
+      this->Data.assign(this->View, this->View + this->ViewLength);
+      this->View = nullptr;
+      this->ViewLength = 0;
+    }
+  }
+
+  // Reset keeps buffers up to this capacity so that the stream can be
+  // refilled without reallocating them.
+  static const size_t MaximumRetainedCapacity = 64 * 1024;
+
   // Offset to each value stored in the stream.
   typedef std::vector<DataType::difference_type> ValueOffsetsType;
   ValueOffsetsType ValueOffsets;
@@ -173,18 +191,6 @@ public:
       : Owner(owner)
     {
     }
-    ObjectsType(const ObjectsType& r, vtkObjectBase* owner)
-      : Superclass(r)
-      , Owner(owner)
-    {
-      if (this->Owner)
-      {
-        for (Superclass::iterator i = this->begin(); i != this->end(); ++i)
-        {
-          (*i)->Register(this->Owner);
-        }
-      }
-    }
     ~ObjectsType() { this->Clear(); }
     ObjectsType& operator=(const ObjectsType& that)
     {
@@ -223,6 +229,27 @@ public:
       }
       this->erase(this->begin(), this->end());
     }
+
+    // Transfer the references to the objects to another owner.
+    void SetOwner(vtkObjectBase* owner)
+    {
+      if (owner == this->Owner)
+      {
+        return;
+      }
+      for (Superclass::iterator i = this->begin(); i != this->end(); ++i)
+      {
+        if (owner)
+        {
+          (*i)->Register(owner);
+        }
+        if (this->Owner)
+        {
+          (*i)->UnRegister(this->Owner);
+        }
+      }
+      this->Owner = owner;
+    }
   };
   ObjectsType Objects;
 
@@ -252,11 +279,81 @@ const vtkClientServerStreamInternals::ValueOffsetsType::size_type
   vtkClientServerStreamInternals::InvalidStartIndex =
     static_cast<vtkClientServerStreamInternals::ValueOffsetsType::size_type>(-1);
 
+//----------------------------------------------------------------------------
+// Streams are created and destroyed for every message sent, e.g. for every
+// property push. Their internal representations are recycled along with the
+// capacity of their buffers instead of being allocated for each stream.
+namespace
+{
+// Set when the pool is destroyed at exit, streams destroyed later delete
+// their internal representation directly.
+bool vtkClientServerStreamInternalsPoolDestroyed = false;
+
+class vtkClientServerStreamInternalsPool
+{
+public:
+  ~vtkClientServerStreamInternalsPool()
+  {
+    for (vtkClientServerStreamInternals* internals : this->Free)
+    {
+      delete internals;
+    }
+    vtkClientServerStreamInternalsPoolDestroyed = true;
+  }
+
+  static vtkClientServerStreamInternals* Acquire(vtkObjectBase* owner)
+  {
+    if (!vtkClientServerStreamInternalsPoolDestroyed)
+    {
+      vtkClientServerStreamInternalsPool& pool = vtkClientServerStreamInternalsPool::GetInstance();
+      std::lock_guard<std::mutex> lock(pool.Mutex);
+      if (!pool.Free.empty())
+      {
+        vtkClientServerStreamInternals* internals = pool.Free.back();
+        pool.Free.pop_back();
+        internals->Objects.Owner = owner;
+        return internals;
+      }
+    }
+    return new vtkClientServerStreamInternals(owner);
+  }
+
+  // The internal representation must have been reset.
+  static void Release(vtkClientServerStreamInternals* internals)
+  {
+    if (!vtkClientServerStreamInternalsPoolDestroyed)
+    {
+      vtkClientServerStreamInternalsPool& pool = vtkClientServerStreamInternalsPool::GetInstance();
+      std::lock_guard<std::mutex> lock(pool.Mutex);
+      if (pool.Free.size() < MaximumSize)
+      {
+        internals->String.clear();
+        pool.Free.push_back(internals);
+        return;
+      }
+    }
+    delete internals;
+  }
+
+private:
+  static const size_t MaximumSize = 64;
+
+  static vtkClientServerStreamInternalsPool& GetInstance()
+  {
+    static vtkClientServerStreamInternalsPool pool;
+    return pool;
+  }
+
+  std::mutex Mutex;
+  std::vector<vtkClientServerStreamInternals*> Free;
+};
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 {
   // Initialize the internal representation of the stream.
-  this->Internal = new vtkClientServerStreamInternals(owner);
+  this->Internal = vtkClientServerStreamInternalsPool::Acquire(owner);
   this->Reserve(1024);
   this->Reset();
 }
@@ -264,20 +361,57 @@ vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 //----------------------------------------------------------------------------
 vtkClientServerStream::~vtkClientServerStream()
 {
-  delete this->Internal;
+  this->Reset();
+  vtkClientServerStreamInternalsPool::Release(this->Internal);
 }
 
 //----------------------------------------------------------------------------
 vtkClientServerStream::vtkClientServerStream(const vtkClientServerStream& r, vtkObjectBase* owner)
 {
   // Allocate and copy the internal representation of the stream.
-  this->Internal = new vtkClientServerStreamInternals(*r.Internal, owner);
+  this->Internal = vtkClientServerStreamInternalsPool::Acquire(owner);
+  *this = r;
 }
 
 //----------------------------------------------------------------------------
 vtkClientServerStream& vtkClientServerStream::operator=(const vtkClientServerStream& that)
 {
-  *this->Internal = *that.Internal;
+  if (this != &that)
+  {
+    // Release the references to objects held by this stream.
+    this->Internal->Objects.Clear();
+    *this->Internal = *that.Internal;
+
+    // Do not share the data of a view.
+    this->Internal->Materialize();
+  }
+  return *this;
+}
+
+//----------------------------------------------------------------------------
+vtkClientServerStream::vtkClientServerStream(vtkClientServerStream&& r, vtkObjectBase* owner)
+{
+  // Take the internal representation and give an empty one to the source.
+  vtkObjectBase* sourceOwner = r.Internal->Objects.Owner;
+  this->Internal = r.Internal;
+  this->Internal->Objects.SetOwner(owner);
+  r.Internal = vtkClientServerStreamInternalsPool::Acquire(sourceOwner);
+  r.Reset();
+}
+
+//----------------------------------------------------------------------------
+vtkClientServerStream& vtkClientServerStream::operator=(vtkClientServerStream&& that)
+{
+  if (this != &that)
+  {
+    // Exchange the internal representations, each stream keeps its owner.
+    vtkObjectBase* owner = this->Internal->Objects.Owner;
+    vtkObjectBase* thatOwner = that.Internal->Objects.Owner;
+    std::swap(this->Internal, that.Internal);
+    this->Internal->Objects.SetOwner(owner);
+    that.Internal->Objects.SetOwner(thatOwner);
+    that.Reset();
+  }
   return *this;
 }
 
@@ -302,6 +436,7 @@ vtkClientServerStream& vtkClientServerStream::Write(const void* data, size_t len
   }
 
   // Copy the value into the data.
+  this->Internal->Materialize();
   this->Internal->Data.resize(this->Internal->Data.size() + length);
   memcpy(&*(this->Internal->Data.end() - length), data, length);
   return *this;
@@ -310,14 +445,25 @@ vtkClientServerStream& vtkClientServerStream::Write(const void* data, size_t len
 //----------------------------------------------------------------------------
 void vtkClientServerStream::Reserve(size_t size)
 {
+  this->Internal->Materialize();
   this->Internal->Data.reserve(size);
 }
 
 //----------------------------------------------------------------------------
 void vtkClientServerStream::Reset()
 {
-  // Empty the entire stream.
-  vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  // Empty the entire stream. Buffers that are not too large are kept for
+  // the data to come.
+  this->Internal->View = nullptr;
+  this->Internal->ViewLength = 0;
+  if (this->Internal->Data.capacity() > vtkClientServerStreamInternals::MaximumRetainedCapacity)
+  {
+    vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  }
+  else
+  {
+    this->Internal->Data.clear();
+  }
 
   this->Internal->ValueOffsets.erase(
     this->Internal->ValueOffsets.begin(), this->Internal->ValueOffsets.end());
@@ -354,7 +500,7 @@ vtkClientServerStream& vtkClientServerStream::operator<<(vtkClientServerStream::
   this->Internal->StartIndex = this->Internal->ValueOffsets.size();
 
   // The command counts as the first value in the message.
-  this->Internal->ValueOffsets.push_back(this->Internal->Data.end() - this->Internal->Data.begin());
+  this->Internal->ValueOffsets.push_back(this->Internal->GetSize());
 
   // Store the command in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -385,7 +531,7 @@ vtkClientServerStream& vtkClientServerStream::operator<<(vtkClientServerStream::
 
   // All values write their type first.  Mark the start of this type
   // and optional value.
-  this->Internal->ValueOffsets.push_back(this->Internal->Data.end() - this->Internal->Data.begin());
+  this->Internal->ValueOffsets.push_back(this->Internal->GetSize());
 
   // Store the type in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -398,8 +544,7 @@ vtkClientServerStream& vtkClientServerStream::operator<<(vtkClientServerStream::
   if (a.Data && a.Size)
   {
     // Mark the start of this type and optional value.
-    this->Internal->ValueOffsets.push_back(
-      this->Internal->Data.end() - this->Internal->Data.begin());
+    this->Internal->ValueOffsets.push_back(this->Internal->GetSize());
 
     // If the argument is a vtk_object_pointer, we need to store a
     // reference to the object.
@@ -1481,12 +1626,12 @@ int vtkClientServerStream::GetData(const unsigned char** data, size_t* length) c
   {
     if (data)
     {
-      *data = &*this->Internal->Data.begin();
+      *data = this->Internal->GetBegin();
     }
 
     if (length)
     {
-      *length = this->Internal->Data.size();
+      *length = this->Internal->GetSize();
     }
     return 1;
   }
@@ -1538,19 +1683,49 @@ int vtkClientServerStream::SetData(const unsigned char* data, size_t length)
   }
 }
 
+//----------------------------------------------------------------------------
+int vtkClientServerStream::SetDataView(const unsigned char* data, size_t length)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const unsigned char order = vtkClientServerStream::BigEndian;
+#else
+  const unsigned char order = vtkClientServerStream::LittleEndian;
+#endif
+
+  // Data in the other byte order are swapped in place, they must be copied.
+  if (!data || length == 0 || data[0] != order)
+  {
+    return this->SetData(data, length);
+  }
+
+  this->Reset();
+  this->Internal->View = data;
+  this->Internal->ViewLength = length;
+  if (this->ParseData())
+  {
+    return 1;
+  }
+  else
+  {
+    this->Reset();
+    return 0;
+  }
+}
+
 //----------------------------------------------------------------------------
 int vtkClientServerStream::ParseData()
 {
   // Make sure we have at least one byte.
-  if (this->Internal->Data.empty())
+  if (this->Internal->GetSize() == 0)
   {
     return 0;
   }
 
   // We are not modifying the vector size.  It is safe to use pointers
-  // into it.
-  unsigned char* begin = &*this->Internal->Data.begin();
-  unsigned char* end = begin + this->Internal->Data.size();
+  // into it.  The data of a view are in the native byte order, they are
+  // not modified by the byte swapping.
+  unsigned char* begin = const_cast<unsigned char*>(this->Internal->GetBegin());
+  unsigned char* end = begin + this->Internal->GetSize();
 
   // Save the byte order.
   int order = *begin;
@@ -1867,7 +2042,7 @@ const unsigned char* vtkClientServerStream::GetValue(int message, int value) con
       this->Internal->MessageIndexes[message];
 
     // Return a pointer to the value-th value in the message.
-    const unsigned char* data = &*this->Internal->Data.begin();
+    const unsigned char* data = this->Internal->GetBegin();
     return data + this->Internal->ValueOffsets[index + value];
   }
   else
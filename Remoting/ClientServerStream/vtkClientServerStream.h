@@ -52,6 +52,15 @@ public:
   vtkClientServerStream& operator=(const vtkClientServerStream&);
   //@}
 
+  //@{
+  /**
+   * Move constructor and assignment operator take the stream data without
+   * copying them.  The source stream is left empty.
+   */
+  vtkClientServerStream(vtkClientServerStream&&, vtkObjectBase* owner = 0);
+  vtkClientServerStream& operator=(vtkClientServerStream&&);
+  //@}
+
   /**
    * Enumeration of message types that may be stored in a stream.
    * This must be kept in sync with the string table in this class's
@@ -111,7 +120,8 @@ public:
   void Reserve(size_t size);
 
   /**
-   * Reset the stream to an empty state.
+   * Reset the stream to an empty state.  The allocated memory is kept for
+   * the next values unless it is large.
    */
   void Reset();
 
@@ -335,6 +345,14 @@ public:
    */
   int SetData(const unsigned char* data, size_t length);
 
+  /**
+   * Same as SetData, but the stream refers to the given data instead of
+   * copying them when they are in the native byte order.  The data must
+   * stay valid and unchanged until the stream is reset, destroyed or given
+   * other data.  Adding values to the stream makes it copy the data first.
+   */
+  int SetDataView(const unsigned char* data, size_t length);
+
   //--------------------------------------------------------------------------
   // Utility methods:
 
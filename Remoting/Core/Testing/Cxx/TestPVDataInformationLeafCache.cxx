@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVDataInformationLeafCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDoubleArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> GetPolyData(double center)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(center, 0, 0);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> pd = sphere->GetOutput();
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("values");
+  array->SetNumberOfTuples(pd->GetNumberOfPoints());
+  array->FillComponent(0, center);
+  pd->GetPointData()->AddArray(array);
+  return pd;
+}
+
+bool CheckRange(vtkPVDataInformation* info, double min, double max)
+{
+  vtkPVArrayInformation* ainfo = info->GetArrayInformation("values", vtkDataObject::POINT);
+  if (ainfo == nullptr)
+  {
+    cerr << "ERROR: failed to find `values`." << endl;
+    return false;
+  }
+  double* range = ainfo->GetComponentRange(0);
+  if (range[0] != min || range[1] != max)
+  {
+    cerr << "ERROR: unexpected range [" << range[0] << ", " << range[1] << "], expected [" << min
+         << ", " << max << "]." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestPVDataInformationLeafCache(int, char* [])
+{
+  vtkNew<vtkMultiBlockDataSet> data;
+  data->SetBlock(0, GetPolyData(0));
+  data->SetBlock(1, GetPolyData(1));
+
+  vtkNew<vtkPVDataInformation> info;
+  info->CopyFromObject(data);
+  if (!CheckRange(info, 0, 1))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // gathering again on unmodified data must give the same result.
+  vtkNew<vtkPVDataInformation> info2;
+  info2->CopyFromObject(data);
+  if (!CheckRange(info2, 0, 1) || info2->GetNumberOfPoints() != info->GetNumberOfPoints())
+  {
+    return EXIT_FAILURE;
+  }
+
+  // modifying a single block must be picked up.
+  vtkDataArray* values =
+    vtkPolyData::SafeDownCast(data->GetBlock(1))->GetPointData()->GetArray("values");
+  values->SetComponent(0, 0, 10);
+  values->Modified();
+  vtkNew<vtkPVDataInformation> info3;
+  info3->CopyFromObject(data);
+  if (!CheckRange(info3, 0, 10))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // counts and bounds only.
+  vtkNew<vtkPVDataInformation> info4;
+  info4->SetInformationLevel(vtkPVDataInformation::COUNTS_AND_BOUNDS);
+  info4->CopyFromObject(data);
+  if (info4->GetNumberOfPoints() != info->GetNumberOfPoints() ||
+    info4->GetBounds()[1] != info->GetBounds()[1] ||
+    info4->GetPointDataInformation()->GetNumberOfArrays() != 0)
+  {
+    cerr << "ERROR: unexpected information with COUNTS_AND_BOUNDS." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // and back to full information on the same data.
+  vtkNew<vtkPVDataInformation> info5;
+  info5->CopyFromObject(data);
+  if (!CheckRange(info5, 0, 10))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
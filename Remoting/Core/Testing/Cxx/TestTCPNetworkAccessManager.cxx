@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTCPNetworkAccessManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkTCPNetworkAccessManager::ProcessEvents() handles the messages
+// of a client without blocking on another client that stays quiet, and that
+// the connections of both are reported closed once the clients disconnect.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkTCPNetworkAccessManager.h"
+#include "vtkTimerLog.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+const int RMI_TAG = 8700;
+const int NUMBER_OF_MESSAGES = 10;
+
+std::atomic<bool> Done(false);
+
+void CountRMI(void* localArg, void*, int, int)
+{
+  ++(*static_cast<int*>(localArg));
+}
+
+void CountClosed(vtkObject*, unsigned long, void* clientData, void*)
+{
+  ++(*static_cast<int*>(clientData));
+}
+
+// connects to the server, sends `numberOfMessages` RMIs and stays connected
+// until the test is done.
+void RunClient(const std::string& url, int numberOfMessages)
+{
+  vtkNew<vtkTCPNetworkAccessManager> manager;
+  vtkSmartPointer<vtkMultiProcessController> controller;
+  controller.TakeReference(manager->NewConnection(url.c_str()));
+  if (!controller)
+  {
+    return;
+  }
+  for (int cc = 0; cc < numberOfMessages; ++cc)
+  {
+    controller->TriggerRMI(1, RMI_TAG);
+  }
+  while (!Done)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+int FindPort()
+{
+  for (int port = 22000; port < 22100; ++port)
+  {
+    vtkNew<vtkServerSocket> socket;
+    if (socket->CreateServer(port) == 0)
+    {
+      socket->CloseSocket();
+      return port;
+    }
+  }
+  return -1;
+}
+}
+
+int TestTCPNetworkAccessManager(int, char* [])
+{
+  const int port = FindPort();
+  if (port == -1)
+  {
+    cerr << "ERROR: no port available." << endl;
+    return EXIT_FAILURE;
+  }
+  std::ostringstream clientURL;
+  clientURL << "tcp://localhost:" << port << "?timeout=10";
+  std::ostringstream serverURL;
+  serverURL << "tcp://localhost:" << port << "?listen=true&multiple=true";
+
+  vtkNew<vtkTCPNetworkAccessManager> manager;
+  manager->DisableFurtherConnections(port, false);
+
+  // the quiet client connects first.
+  std::thread quietClient(RunClient, clientURL.str(), 0);
+  vtkSmartPointer<vtkMultiProcessController> quiet;
+  quiet.TakeReference(manager->NewConnection(serverURL.str().c_str()));
+  std::thread activeClient(RunClient, clientURL.str(), NUMBER_OF_MESSAGES);
+  vtkSmartPointer<vtkMultiProcessController> active;
+  active.TakeReference(manager->NewConnection(serverURL.str().c_str()));
+  if (!quiet || !active)
+  {
+    cerr << "ERROR: clients failed to connect." << endl;
+    Done = true;
+    quietClient.join();
+    activeClient.join();
+    return EXIT_FAILURE;
+  }
+  manager->DisableFurtherConnections(port, true);
+
+  int received = 0;
+  active->AddRMICallback(CountRMI, &received, RMI_TAG);
+  quiet->AddRMICallback(CountRMI, &received, RMI_TAG);
+  int closed = 0;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(CountClosed);
+  observer->SetClientData(&closed);
+  manager->AddObserver(vtkCommand::ConnectionClosedEvent, observer);
+
+  // a quiet client must not delay the processing of the other one.
+  const double start = vtkTimerLog::GetUniversalTime();
+  while (received < NUMBER_OF_MESSAGES && vtkTimerLog::GetUniversalTime() - start < 10)
+  {
+    manager->ProcessEvents(100);
+  }
+  bool success = true;
+  if (received != NUMBER_OF_MESSAGES)
+  {
+    cerr << "ERROR: " << received << " messages received instead of " << NUMBER_OF_MESSAGES
+         << endl;
+    success = false;
+  }
+  if (manager->GetNumberOfProcessedEvents(quiet) != 0)
+  {
+    cerr << "ERROR: events processed for the quiet client." << endl;
+    success = false;
+  }
+  if (manager->GetNumberOfProcessedEvents(active) == 0)
+  {
+    cerr << "ERROR: no events processed for the active client." << endl;
+    success = false;
+  }
+  manager->Print(cout);
+
+  // both connections close at the same time.
+  Done = true;
+  quietClient.join();
+  activeClient.join();
+  const double closeStart = vtkTimerLog::GetUniversalTime();
+  while (closed < 2 && vtkTimerLog::GetUniversalTime() - closeStart < 10)
+  {
+    if (manager->ProcessEvents(100) == -1)
+    {
+      break;
+    }
+  }
+  if (closed != 2)
+  {
+    cerr << "ERROR: " << closed << " connections reported closed instead of 2." << endl;
+    success = false;
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -15,19 +15,28 @@
 #include "vtkPVArrayInformation.h"
 
 #include "vtkAbstractArray.h"
+#include "vtkArrayDispatch.h"
 #include "vtkClientServerStream.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
 #include "vtkInformation.h"
+#include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationInformationVectorKey.h"
 #include "vtkInformationIterator.h"
 #include "vtkInformationKey.h"
+#include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <set>
 #include <sstream>
@@ -44,6 +53,207 @@ struct vtkPVArrayInformationInformationKey
 };
 
 typedef std::vector<vtkPVArrayInformationInformationKey> vtkInternalInformationKeysBase;
+
+// Computes the component ranges, the finite component ranges and the
+// (finite) range of the L2 norm in a single threaded pass over the tuples.
+// The results are laid out like vtkPVArrayInformation::Ranges i.e. for
+// multi-component arrays the magnitude range comes first.
+class vtkComputeRangesFunctor
+{
+public:
+  std::vector<double> Ranges;
+  std::vector<double> FiniteRanges;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array, const unsigned char* ghosts, unsigned char ghostsToSkip)
+  {
+    Worker<ArrayT> worker(array, ghosts, ghostsToSkip);
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), worker);
+    this->Ranges = std::move(worker.Ranges);
+    this->FiniteRanges = std::move(worker.FiniteRanges);
+  }
+
+private:
+  template <typename ArrayT>
+  class Worker
+  {
+    ArrayT* Array;
+    const unsigned char* Ghosts;
+    unsigned char GhostsToSkip;
+    int NumberOfComponents;
+    // per thread: component ranges followed by the magnitude range, first for
+    // all values, then for finite values only.
+    vtkSMPThreadLocal<std::vector<double> > LocalRanges;
+
+  public:
+    std::vector<double> Ranges;
+    std::vector<double> FiniteRanges;
+
+    Worker(ArrayT* array, const unsigned char* ghosts, unsigned char ghostsToSkip)
+      : Array(array)
+      , Ghosts(ghosts)
+      , GhostsToSkip(ghostsToSkip)
+      , NumberOfComponents(array->GetNumberOfComponents())
+    {
+    }
+
+    void Initialize()
+    {
+      std::vector<double>& ranges = this->LocalRanges.Local();
+      ranges.resize(4 * (this->NumberOfComponents + 1));
+      for (size_t cc = 0; cc < ranges.size(); cc += 2)
+      {
+        ranges[cc] = VTK_DOUBLE_MAX;
+        ranges[cc + 1] = -VTK_DOUBLE_MAX;
+      }
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const int numComps = this->NumberOfComponents;
+      double* range = this->LocalRanges.Local().data();
+      double* finiteRange = range + 2 * (numComps + 1);
+      const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
+      for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+      {
+        if (this->Ghosts && (this->Ghosts[tupleIdx] & this->GhostsToSkip))
+        {
+          continue;
+        }
+        const auto tuple = tuples[tupleIdx - begin];
+        double squaredNorm = 0.0;
+        for (int comp = 0; comp < numComps; ++comp)
+        {
+          const double value = static_cast<double>(tuple[comp]);
+          squaredNorm += value * value;
+          // NaNs are ignored, same as vtkDataArray::GetRange().
+          if (std::isnan(value))
+          {
+            continue;
+          }
+          range[2 * comp] = std::min(range[2 * comp], value);
+          range[2 * comp + 1] = std::max(range[2 * comp + 1], value);
+          if (std::isfinite(value))
+          {
+            finiteRange[2 * comp] = std::min(finiteRange[2 * comp], value);
+            finiteRange[2 * comp + 1] = std::max(finiteRange[2 * comp + 1], value);
+          }
+        }
+        if (numComps > 1 && !std::isnan(squaredNorm))
+        {
+          const double norm = std::sqrt(squaredNorm);
+          range[2 * numComps] = std::min(range[2 * numComps], norm);
+          range[2 * numComps + 1] = std::max(range[2 * numComps + 1], norm);
+          if (std::isfinite(squaredNorm))
+          {
+            finiteRange[2 * numComps] = std::min(finiteRange[2 * numComps], norm);
+            finiteRange[2 * numComps + 1] = std::max(finiteRange[2 * numComps + 1], norm);
+          }
+        }
+      }
+    }
+
+    void Reduce()
+    {
+      const int numComps = this->NumberOfComponents;
+      const int numRanges = numComps > 1 ? numComps + 1 : numComps;
+      this->Ranges.assign(2 * numRanges, VTK_DOUBLE_MAX);
+      this->FiniteRanges.assign(2 * numRanges, VTK_DOUBLE_MAX);
+      for (int cc = 0; cc < numRanges; ++cc)
+      {
+        this->Ranges[2 * cc + 1] = -VTK_DOUBLE_MAX;
+        this->FiniteRanges[2 * cc + 1] = -VTK_DOUBLE_MAX;
+      }
+
+      for (const std::vector<double>& local : this->LocalRanges)
+      {
+        const double* finiteLocal = local.data() + 2 * (numComps + 1);
+        for (int cc = 0; cc < numRanges; ++cc)
+        {
+          // magnitude is stored last in the thread local ranges but first in
+          // the result.
+          const int src = numComps > 1 ? (cc == 0 ? numComps : cc - 1) : cc;
+          this->Ranges[2 * cc] = std::min(this->Ranges[2 * cc], local[2 * src]);
+          this->Ranges[2 * cc + 1] = std::max(this->Ranges[2 * cc + 1], local[2 * src + 1]);
+          this->FiniteRanges[2 * cc] = std::min(this->FiniteRanges[2 * cc], finiteLocal[2 * src]);
+          this->FiniteRanges[2 * cc + 1] =
+            std::max(this->FiniteRanges[2 * cc + 1], finiteLocal[2 * src + 1]);
+        }
+      }
+    }
+  };
+};
+
+// Returns true if the ranges cached in the array's information by
+// vtkDataArray::GetRange() (or GetFiniteRange()) are present and up-to-date
+// for all components and, for multi-component arrays, the magnitude.
+bool vtkHasCachedRanges(vtkDataArray* array, bool finite)
+{
+  if (!array->HasInformation())
+  {
+    return false;
+  }
+  vtkInformation* info = array->GetInformation();
+  const vtkMTimeType mtime = array->GetMTime();
+  const int numComps = array->GetNumberOfComponents();
+  if (numComps > 1)
+  {
+    vtkInformationDoubleVectorKey* key =
+      finite ? vtkDataArray::L2_NORM_FINITE_RANGE() : vtkDataArray::L2_NORM_RANGE();
+    if (!info->Has(key) || info->GetMTime() < mtime)
+    {
+      return false;
+    }
+  }
+  vtkInformationVector* components =
+    info->Get(finite ? vtkDataArray::PER_FINITE_COMPONENT() : vtkDataArray::PER_COMPONENT());
+  if (!components || components->GetNumberOfInformationObjects() < numComps)
+  {
+    return false;
+  }
+  for (int comp = 0; comp < numComps; ++comp)
+  {
+    vtkInformation* compInfo = components->GetInformationObject(comp);
+    if (!compInfo || !compInfo->Has(vtkDataArray::COMPONENT_RANGE()) ||
+      compInfo->GetMTime() < mtime)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Stores ranges computed by vtkComputeRangesFunctor in the array's
+// information so that later calls to vtkDataArray::GetRange() can reuse them.
+void vtkSetCachedRanges(vtkDataArray* array, bool finite, const double* ranges)
+{
+  vtkInformation* info = array->GetInformation();
+  const int numComps = array->GetNumberOfComponents();
+  if (numComps > 1)
+  {
+    info->Set(finite ? vtkDataArray::L2_NORM_FINITE_RANGE() : vtkDataArray::L2_NORM_RANGE(),
+      ranges, 2);
+    ranges += 2;
+  }
+  vtkInformationInformationVectorKey* key =
+    finite ? vtkDataArray::PER_FINITE_COMPONENT() : vtkDataArray::PER_COMPONENT();
+  vtkInformationVector* components = info->Get(key);
+  if (!components)
+  {
+    vtkNew<vtkInformationVector> newComponents;
+    info->Set(key, newComponents);
+    components = newComponents;
+  }
+  if (components->GetNumberOfInformationObjects() < numComps)
+  {
+    components->SetNumberOfInformationObjects(numComps);
+  }
+  for (int comp = 0; comp < numComps; ++comp)
+  {
+    components->GetInformationObject(comp)->Set(
+      vtkDataArray::COMPONENT_RANGE(), ranges + 2 * comp, 2);
+  }
+}
 }
 
 class vtkPVArrayInformation::vtkInternalComponentNames : public vtkInternalComponentNameBase
@@ -611,7 +821,13 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
     this->Initialize();
     return;
   }
+  this->CopyFromArray(array, nullptr, 0);
+}
 
+//----------------------------------------------------------------------------
+void vtkPVArrayInformation::CopyFromArray(
+  vtkAbstractArray* array, vtkUnsignedCharArray* ghosts, unsigned char ghostsToSkip)
+{
   this->SetName(array->GetName());
   this->DataType = array->GetDataType();
   this->SetNumberOfComponents(array->GetNumberOfComponents());
@@ -632,39 +848,42 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
     }
   }
 
-  if (vtkDataArray* const data_array = vtkDataArray::SafeDownCast(obj))
+  if (vtkDataArray* const data_array = vtkDataArray::SafeDownCast(array))
   {
-    double range[2];
-    double* ptr;
-    int idx;
-
-    ptr = this->Ranges;
-    if (this->NumberOfComponents > 1)
-    {
-      // First store range of vector magnitude.
-      data_array->GetRange(range, -1);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
-    }
-    for (idx = 0; idx < this->NumberOfComponents; ++idx)
+    const int numRanges =
+      this->NumberOfComponents > 1 ? this->NumberOfComponents + 1 : this->NumberOfComponents;
+    const unsigned char* ghostPtr = nullptr;
+    if (ghosts && ghostsToSkip != 0 && ghosts->GetNumberOfTuples() == array->GetNumberOfTuples())
     {
-      data_array->GetRange(range, idx);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
+      ghostPtr = ghosts->GetPointer(0);
     }
-    ptr = this->FiniteRanges;
-    if (this->NumberOfComponents > 1)
+
+    if (!ghostPtr && vtkHasCachedRanges(data_array, false) && vtkHasCachedRanges(data_array, true))
     {
-      // First store range of vector magnitude.
-      data_array->GetFiniteRange(range, -1);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
+      // ranges cached on the array are still valid, just use them.
+      double* ptr = this->Ranges;
+      double* finitePtr = this->FiniteRanges;
+      for (int idx = (this->NumberOfComponents > 1 ? -1 : 0); idx < this->NumberOfComponents;
+           ++idx, ptr += 2, finitePtr += 2)
+      {
+        data_array->GetRange(ptr, idx);
+        data_array->GetFiniteRange(finitePtr, idx);
+      }
     }
-    for (idx = 0; idx < this->NumberOfComponents; ++idx)
+    else
     {
-      data_array->GetFiniteRange(range, idx);
-      *ptr++ = range[0];
-      *ptr++ = range[1];
+      vtkComputeRangesFunctor functor;
+      if (!vtkArrayDispatch::Dispatch::Execute(data_array, functor, ghostPtr, ghostsToSkip))
+      {
+        functor(data_array, ghostPtr, ghostsToSkip);
+      }
+      std::copy_n(functor.Ranges.begin(), 2 * numRanges, this->Ranges);
+      std::copy_n(functor.FiniteRanges.begin(), 2 * numRanges, this->FiniteRanges);
+      if (!ghostPtr && data_array->GetNumberOfTuples() > 0)
+      {
+        vtkSetCachedRanges(data_array, false, this->Ranges);
+        vtkSetCachedRanges(data_array, true, this->FiniteRanges);
+      }
     }
   }
 
@@ -35,6 +35,7 @@
 class vtkAbstractArray;
 class vtkClientServerStream;
 class vtkStringArray;
+class vtkUnsignedCharArray;
 
 class VTKREMOTINGCORE_EXPORT vtkPVArrayInformation : public vtkPVInformation
 {
@@ -145,6 +146,18 @@ public:
    */
   void CopyFromObject(vtkObject*) override;
 
+  /**
+   * Same as CopyFromObject() except that tuples for which `ghosts` has any
+   * of the bits in `ghostsToSkip` set are not included in the ranges.
+   * `ghosts` is ignored if it does not have as many tuples as `array`.
+   *
+   * Ranges are computed in a single multithreaded pass. When no ghosts are
+   * skipped, ranges already cached on the array by vtkDataArray::GetRange()
+   * are reused if still valid and newly computed ranges are cached on it.
+   */
+  void CopyFromArray(
+    vtkAbstractArray* array, vtkUnsignedCharArray* ghosts, unsigned char ghostsToSkip);
+
   /**
    * Merge another information object.
    */
@@ -52,6 +52,7 @@ vtkPVCompositeDataInformation::vtkPVCompositeDataInformation()
   this->DataIsMultiPiece = 0;
   this->NumberOfPieces = 0;
   this->NumberOfAMRLevels = 0;
+  this->InformationLevel = vtkPVDataInformation::FULL_INFORMATION;
   // DON'T FORGET TO UPDATE Initialize().
 }
 
@@ -219,6 +220,7 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     if (curDO)
     {
       childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
+      childInfo->SetInformationLevel(this->InformationLevel);
       childInfo->CopyFromObject(curDO);
     }
     this->Internal->ChildrenInformation.resize(index + 1);
@@ -256,6 +258,7 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
   // we use this to "simulate" a composite tree from AMR
   vtkNew<vtkMultiPieceDataSet> tempMultiPiece;
   vtkNew<vtkPVDataInformation> tempDSInfo;
+  tempDSInfo->SetInformationLevel(this->InformationLevel);
 
   for (unsigned int level = 0; level < this->NumberOfAMRLevels; level++)
   {
@@ -263,6 +266,7 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
     tempMultiPiece->SetNumberOfPieces(num_datasets);
 
     vtkNew<vtkPVDataInformation> levelInfo;
+    levelInfo->SetInformationLevel(this->InformationLevel);
     levelInfo->CopyFromCompositeDataSetInitialize(tempMultiPiece.GetPointer());
 
     // now fill up levelInfo with meta-data about arrays.
@@ -129,6 +129,10 @@ protected:
 
   unsigned int NumberOfAMRLevels;
 
+  // vtkPVDataInformation::InformationLevel to use for the children. Set by
+  // vtkPVDataInformation before gathering.
+  int InformationLevel;
+
   friend class vtkPVDataInformation;
   vtkPVDataInformation* GetDataInformationForCompositeIndex(int* index);
 
@@ -29,6 +29,7 @@
 #include "vtkDataSet.h"
 #include "vtkExecutive.h"
 #include "vtkExplicitStructuredGrid.h"
+#include "vtkFieldData.h"
 #include "vtkGenericDataSet.h"
 #include "vtkGraph.h"
 #include "vtkHyperTreeGrid.h"
@@ -48,13 +49,18 @@
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
 #include "vtkUniformGrid.h"
+#include "vtkWeakPointer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -63,6 +69,86 @@ vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+std::atomic<bool> CacheLeafInformation(true);
+
+// Caches the information gathered for non-composite data objects. Entries are
+// keyed by the data object and are valid for as long as the data object is
+// alive and has not been modified since.
+class vtkLeafInformationCache
+{
+public:
+  vtkSmartPointer<vtkPVDataInformation> Find(vtkDataObject* dobj, int level)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    auto iter = this->Entries.find(dobj);
+    if (iter == this->Entries.end())
+    {
+      return nullptr;
+    }
+    const Entry& entry = iter->second;
+    if (entry.DataObject != dobj || entry.MTime != vtkLeafInformationCache::GetMTime(dobj) ||
+      entry.InformationLevel != level)
+    {
+      this->Entries.erase(iter);
+      return nullptr;
+    }
+    return entry.Information;
+  }
+
+  void Add(vtkDataObject* dobj, int level, vtkPVDataInformation* info)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    Entry& entry = this->Entries[dobj];
+    entry.DataObject = dobj;
+    entry.MTime = vtkLeafInformationCache::GetMTime(dobj);
+    entry.InformationLevel = level;
+    entry.Information = info;
+
+    // drop entries for released data objects once the cache grows.
+    if (this->Entries.size() > this->PurgeThreshold)
+    {
+      for (auto iter = this->Entries.begin(); iter != this->Entries.end();)
+      {
+        iter = iter->second.DataObject == nullptr ? this->Entries.erase(iter) : std::next(iter);
+      }
+      this->PurgeThreshold = std::max<size_t>(1024, 2 * this->Entries.size());
+    }
+  }
+
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Entries.clear();
+  }
+
+private:
+  static vtkMTimeType GetMTime(vtkDataObject* dobj)
+  {
+    vtkFieldData* fd = dobj->GetFieldData();
+    return fd ? std::max(dobj->GetMTime(), fd->GetMTime()) : dobj->GetMTime();
+  }
+
+  struct Entry
+  {
+    vtkWeakPointer<vtkDataObject> DataObject;
+    vtkMTimeType MTime = 0;
+    int InformationLevel = 0;
+    vtkSmartPointer<vtkPVDataInformation> Information;
+  };
+  std::map<vtkDataObject*, Entry> Entries;
+  size_t PurgeThreshold = 1024;
+  std::mutex Mutex;
+};
+
+vtkLeafInformationCache& GetLeafInformationCache()
+{
+  static vtkLeafInformationCache cache;
+  return cache;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -114,14 +200,14 @@ vtkPVDataInformation::~vtkPVDataInformation()
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersToStream(vtkMultiProcessStream& str)
 {
-  str << 828792 << this->PortNumber;
+  str << 828792 << this->PortNumber << this->InformationLevel;
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
 {
   int magic_number;
-  str >> magic_number >> this->PortNumber;
+  str >> magic_number >> this->PortNumber >> this->InformationLevel;
   if (magic_number != 828792)
   {
     vtkErrorMacro("Magic number mismatch.");
@@ -135,6 +221,7 @@ void vtkPVDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "PortNumber: " << this->PortNumber << endl;
+  os << indent << "InformationLevel: " << this->InformationLevel << endl;
   os << indent << "DataSetType: " << this->DataSetType << endl;
   os << indent << "CompositeDataSetType: " << this->CompositeDataSetType << endl;
   os << indent << "NumberOfPoints: " << this->NumberOfPoints << endl;
@@ -343,6 +430,7 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
     if (dobj)
     {
       vtkPVDataInformation* dinf = vtkPVDataInformation::New();
+      dinf->SetInformationLevel(this->InformationLevel);
       dinf->CopyFromObject(dobj);
       dinf->SetDataClassName(dobj->GetClassName());
       dinf->DataSetType = dobj->GetDataObjectType();
@@ -357,6 +445,7 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
 void vtkPVDataInformation::CopyFromCompositeDataSetInitialize(vtkCompositeDataSet* data)
 {
   this->Initialize();
+  this->CompositeDataInformation->InformationLevel = this->InformationLevel;
   this->CompositeDataInformation->CopyFromObject(data);
 }
 
@@ -375,7 +464,8 @@ void vtkPVDataInformation::CopyFromCompositeDataSetFinalize(vtkCompositeDataSet*
 
   // Copy Field Data information, if any
   vtkFieldData* fd = data->GetFieldData();
-  if (fd && fd->GetNumberOfArrays() > 0)
+  if (fd && fd->GetNumberOfArrays() > 0 &&
+    this->InformationLevel == vtkPVDataInformation::FULL_INFORMATION)
   {
     if (this->FieldDataInformation->GetNumberOfArrays() > 0)
     {
@@ -554,6 +644,11 @@ void vtkPVDataInformation::CopyFromDataSet(vtkDataSet* data)
   }
   this->MemorySize = data->GetActualMemorySize();
 
+  if (this->InformationLevel == vtkPVDataInformation::COUNTS_AND_BOUNDS)
+  {
+    return;
+  }
+
   vtkPointSet* ps = vtkPointSet::SafeDownCast(data);
   if (ps && ps->GetPoints())
   {
@@ -614,6 +709,11 @@ void vtkPVDataInformation::CopyFromGenericDataSet(vtkGenericDataSet* data)
       break;
   }
 
+  if (this->InformationLevel == vtkPVDataInformation::COUNTS_AND_BOUNDS)
+  {
+    return;
+  }
+
   // Copy Point Data information
   if (this->NumberOfPoints > 0)
   {
@@ -641,7 +741,10 @@ void vtkPVDataInformation::CopyFromSelection(vtkSelection* data)
   this->NumberOfCells = 0;
   this->NumberOfPoints = 0;
 
-  this->FieldDataInformation->CopyFromFieldData(data->GetFieldData());
+  if (this->InformationLevel == vtkPVDataInformation::FULL_INFORMATION)
+  {
+    this->FieldDataInformation->CopyFromFieldData(data->GetFieldData());
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -662,6 +765,11 @@ void vtkPVDataInformation::CopyFromGraph(vtkGraph* data)
   this->NumberOfVertices = data->GetNumberOfVertices();
   this->NumberOfRows = 0;
 
+  if (this->InformationLevel == vtkPVDataInformation::COUNTS_AND_BOUNDS)
+  {
+    return;
+  }
+
   if (this->NumberOfVertices > 0)
   {
     this->VertexDataInformation->CopyFromFieldData(data->GetVertexData());
@@ -687,6 +795,11 @@ void vtkPVDataInformation::CopyFromTable(vtkTable* data)
   this->NumberOfPoints = 0;
   this->NumberOfRows = data->GetNumberOfRows();
 
+  if (this->InformationLevel == vtkPVDataInformation::COUNTS_AND_BOUNDS)
+  {
+    return;
+  }
+
   if (this->NumberOfRows > 0)
   {
     this->RowDataInformation->CopyFromFieldData(data->GetRowData());
@@ -716,6 +829,11 @@ void vtkPVDataInformation::CopyFromHyperTreeGrid(vtkHyperTreeGrid* data)
   }
   this->MemorySize = data->GetActualMemorySize();
 
+  if (this->InformationLevel == vtkPVDataInformation::COUNTS_AND_BOUNDS)
+  {
+    return;
+  }
+
   this->CellDataInformation->CopyFromDataSetAttributes(data->GetCellData());
 
   // Copy Field Data information, if any
@@ -786,19 +904,65 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
     return;
   }
 
+  // Information for non-composite data objects is cached and reused as long
+  // as the data object is not modified. This avoids recomputing bounds, array
+  // ranges etc. for the unchanged blocks of composite datasets.
+  // Subclasses may gather additional information, so only plain instances
+  // share the cache.
+  const bool useCache =
+    CacheLeafInformation && strcmp(this->GetClassName(), "vtkPVDataInformation") == 0;
+  vtkLeafInformationCache& cache = GetLeafInformationCache();
+  vtkSmartPointer<vtkPVDataInformation> cached =
+    useCache ? cache.Find(dobj, this->InformationLevel) : nullptr;
+  if (cached)
+  {
+    this->Initialize();
+    this->DeepCopy(cached, /*copyCompositeInformation=*/false);
+  }
+  else
+  {
+    this->CopyFromLeafDataObject(dobj);
+    if (useCache)
+    {
+      vtkNew<vtkPVDataInformation> snapshot;
+      snapshot->SetInformationLevel(this->InformationLevel);
+      snapshot->DeepCopy(this, /*copyCompositeInformation=*/false);
+      cache.Add(dobj, this->InformationLevel, snapshot);
+    }
+  }
+  this->CopyCommonMetaData(dobj, info);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::SetCacheLeafInformation(bool enable)
+{
+  CacheLeafInformation = enable;
+  if (!enable)
+  {
+    GetLeafInformationCache().Clear();
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataInformation::GetCacheLeafInformation()
+{
+  return CacheLeafInformation;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromLeafDataObject(vtkDataObject* dobj)
+{
   // vtkHyperTreeGrid inherits vtkDataSet, so we check for it first:
   vtkHyperTreeGrid* htg = vtkHyperTreeGrid::SafeDownCast(dobj);
   if (htg)
   {
     this->CopyFromHyperTreeGrid(htg);
-    this->CopyCommonMetaData(htg, info);
   }
 
   vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
   if (ds)
   {
     this->CopyFromDataSet(ds);
-    this->CopyCommonMetaData(dobj, info);
     return;
   }
 
@@ -806,7 +970,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   if (ads)
   {
     this->CopyFromGenericDataSet(ads);
-    this->CopyCommonMetaData(dobj, info);
     return;
   }
 
@@ -814,7 +977,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   if (graph)
   {
     this->CopyFromGraph(graph);
-    this->CopyCommonMetaData(dobj, info);
     return;
   }
 
@@ -822,7 +984,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   if (table)
   {
     this->CopyFromTable(table);
-    this->CopyCommonMetaData(dobj, info);
     return;
   }
 
@@ -830,7 +991,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   if (selection)
   {
     this->CopyFromSelection(selection);
-    this->CopyCommonMetaData(dobj, info);
     return;
   }
 
@@ -839,7 +999,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   if (dhelper)
   {
     dhelper->CopyFromDataObject(this, dobj);
-    this->CopyCommonMetaData(dobj, info);
     dhelper->Delete();
     return;
   }
@@ -848,7 +1007,6 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
   // object types, this isn't an error condition - just
   // display the name of the data object and return quietly.
   this->SetDataClassName(dobj->GetClassName());
-  this->CopyCommonMetaData(dobj, info);
 }
 
 //----------------------------------------------------------------------------
@@ -76,6 +76,37 @@ public:
   vtkGetMacro(PortNumber, int);
   //@}
 
+  enum InformationLevels
+  {
+    FULL_INFORMATION = 0,
+    COUNTS_AND_BOUNDS = 1
+  };
+
+  //@{
+  /**
+   * Controls how much information is gathered. With COUNTS_AND_BOUNDS only
+   * the data type, number of points/cells/etc., bounds, extents and memory
+   * size are collected; array information is skipped which is considerably
+   * faster for datasets with many arrays or many blocks. Default is
+   * FULL_INFORMATION. Like PortNumber, this can be set on the client-side
+   * before gathering the information.
+   */
+  vtkSetClampMacro(InformationLevel, int, FULL_INFORMATION, COUNTS_AND_BOUNDS);
+  vtkGetMacro(InformationLevel, int);
+  //@}
+
+  //@{
+  /**
+   * When enabled (default), the information gathered for each non-composite
+   * data object (e.g. each leaf of a multiblock dataset) is cached and reused
+   * until that data object is modified or released. This makes repeated
+   * gathers on large composite datasets where only a few blocks change
+   * proportional to the number of changed blocks.
+   */
+  static void SetCacheLeafInformation(bool);
+  static bool GetCacheLeafInformation();
+  //@}
+
   /**
    * Transfer information about a single object into this object.
    */
@@ -314,6 +345,12 @@ protected:
   void CopyFromSelection(vtkSelection* selection);
   void CopyCommonMetaData(vtkDataObject*, vtkInformation*);
 
+  /**
+   * Dispatches to the appropriate CopyFrom* method for a non-composite data
+   * object. Does not handle meta-data, see CopyCommonMetaData.
+   */
+  void CopyFromLeafDataObject(vtkDataObject* dobj);
+
   static vtkPVDataInformationHelper* FindHelper(const char* classname);
 
   // Data information collected from remote processes.
@@ -369,6 +406,7 @@ private:
   void operator=(const vtkPVDataInformation&) = delete;
 
   int PortNumber = -1;
+  int InformationLevel = FULL_INFORMATION;
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "vtkPVArrayInformation.h"
 #include "vtkPVGenericAttributeInformation.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 
 #include <algorithm>
 #include <map>
@@ -135,6 +136,13 @@ void vtkPVDataSetAttributesInformation::DeepCopy(vtkPVDataSetAttributesInformati
 
 //----------------------------------------------------------------------------
 void vtkPVDataSetAttributesInformation::CopyFromFieldData(vtkFieldData* da)
+{
+  this->CopyFromFieldData(da, nullptr, 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataSetAttributesInformation::CopyFromFieldData(
+  vtkFieldData* da, vtkUnsignedCharArray* ghosts, unsigned char ghostsToSkip)
 {
   vtkInternals& internals = (*this->Internals);
 
@@ -151,7 +159,7 @@ void vtkPVDataSetAttributesInformation::CopyFromFieldData(vtkFieldData* da)
     if (array != NULL && !vtkSkipArray(array->GetName()))
     {
       vtkNew<vtkPVArrayInformation> info;
-      info->CopyFromObject(array);
+      info->CopyFromArray(array, ghosts, ghostsToSkip);
       internals.ArrayInformation[array->GetName()] = info.Get();
     }
   }
@@ -160,7 +168,21 @@ void vtkPVDataSetAttributesInformation::CopyFromFieldData(vtkFieldData* da)
 //----------------------------------------------------------------------------
 void vtkPVDataSetAttributesInformation::CopyFromDataSetAttributes(vtkDataSetAttributes* da)
 {
-  this->CopyFromFieldData(da);
+  // Duplicate points/cells are owned by another piece, skip them when
+  // computing ranges.
+  unsigned char ghostsToSkip = 0;
+  if (this->FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+  {
+    ghostsToSkip = vtkDataSetAttributes::DUPLICATEPOINT;
+  }
+  else if (this->FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+  {
+    ghostsToSkip = vtkDataSetAttributes::DUPLICATECELL;
+  }
+  vtkUnsignedCharArray* ghosts = ghostsToSkip
+    ? vtkArrayDownCast<vtkUnsignedCharArray>(da->GetArray(vtkDataSetAttributes::GhostArrayName()))
+    : nullptr;
+  this->CopyFromFieldData(da, ghosts, ghostsToSkip);
 
   // update attribute information.
   vtkInternals& internals = (*this->Internals);
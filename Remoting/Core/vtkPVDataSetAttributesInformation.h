@@ -34,6 +34,7 @@ class vtkDataSetAttributes;
 class vtkFieldData;
 class vtkPVArrayInformation;
 class vtkGenericAttributeCollection;
+class vtkUnsignedCharArray;
 
 class VTKREMOTINGCORE_EXPORT vtkPVDataSetAttributesInformation : public vtkPVInformation
 {
@@ -117,6 +118,13 @@ protected:
   vtkPVDataSetAttributesInformation();
   ~vtkPVDataSetAttributesInformation() override;
 
+  /**
+   * Same as CopyFromFieldData() except that tuples flagged with any of the
+   * bits in `ghostsToSkip` in `ghosts` are excluded from the array ranges.
+   */
+  void CopyFromFieldData(
+    vtkFieldData* data, vtkUnsignedCharArray* ghosts, unsigned char ghostsToSkip);
+
   // Standard cell attributes.
   int FieldAssociation;
 
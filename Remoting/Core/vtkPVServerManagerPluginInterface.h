@@ -38,6 +38,18 @@ public:
    */
   virtual void GetXMLs(std::vector<std::string>& vtkNotUsed(xmls)) = 0;
 
+  /**
+   * Obtain the definitions of GetXMLs() in the binary form saved by
+   * vtkSIProxyDefinitionManager::SaveBinaryDefinitions(), if any. `data` must
+   * remain valid for the lifetime of the process. Only the definitions of the
+   * ParaView core are provided in this form.
+   */
+  virtual void GetBinaryDefinitions(const char*& data, size_t& size)
+  {
+    data = nullptr;
+    size = 0;
+  }
+
   //@{
   /**
    * Returns the callback function to call to initialize the interpretor for the
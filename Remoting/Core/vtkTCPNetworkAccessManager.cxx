@@ -29,6 +29,7 @@
 #include <vtksys/SystemInformation.hxx>
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <sstream>
@@ -39,15 +40,189 @@
 // communication.
 #define GENERATE_DEBUG_LOG 0
 
-#define MAX_SOCKETS 256
+// On Linux, sockets are watched with epoll instead of select(). Set the
+// PARAVIEW_TCP_USE_SELECT environment variable to use select() anyway.
+#if defined(__linux__)
+#define USE_EPOLL 1
+#include <cerrno>
+#include <cstddef>
+#include <linux/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#else
+#define USE_EPOLL 0
+#endif
 
 class vtkTCPNetworkAccessManager::vtkInternals
 {
 public:
-  typedef std::vector<vtkWeakPointer<vtkSocketController> > VectorOfControllers;
+  struct ConnectionStatistics
+  {
+    vtkTypeUInt64 NumberOfEvents = 0;
+    double TotalLatency = 0.0;
+    double MaximumLatency = 0.0;
+  };
+
+  struct Connection
+  {
+    vtkWeakPointer<vtkSocketController> Controller;
+    ConnectionStatistics Statistics;
+  };
+
+  typedef std::vector<Connection> VectorOfControllers;
   VectorOfControllers Controllers;
   typedef std::map<int, vtkSmartPointer<vtkServerSocket> > MapToServerSockets;
   MapToServerSockets ServerSockets;
+
+  Connection* FindConnection(vtkMultiProcessController* controller)
+  {
+    for (auto& connection : this->Controllers)
+    {
+      if (controller && connection.Controller.GetPointer() == controller)
+      {
+        return &connection;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns true if the controller or server socket is still handled by the
+  // manager, i.e. it was not closed or released while processing another
+  // socket.
+  bool IsWatched(vtkObject* controller_or_server_socket)
+  {
+    if (vtkServerSocket* ss = vtkServerSocket::SafeDownCast(controller_or_server_socket))
+    {
+      for (auto& item : this->ServerSockets)
+      {
+        if (item.second.GetPointer() == ss)
+        {
+          return ss->GetConnected() != 0;
+        }
+      }
+      return false;
+    }
+    Connection* connection =
+      this->FindConnection(vtkMultiProcessController::SafeDownCast(controller_or_server_socket));
+    if (!connection)
+    {
+      return false;
+    }
+    vtkSocketCommunicator* comm =
+      vtkSocketCommunicator::SafeDownCast(connection->Controller->GetCommunicator());
+    return comm && comm->GetSocket() && comm->GetSocket()->GetConnected();
+  }
+
+#if USE_EPOLL
+  vtkInternals()
+  {
+    if (!vtksys::SystemTools::HasEnv("PARAVIEW_TCP_USE_SELECT"))
+    {
+      this->EpollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    }
+  }
+
+  ~vtkInternals()
+  {
+    if (this->EpollDescriptor != -1)
+    {
+      close(this->EpollDescriptor);
+    }
+  }
+
+  // Adds the sockets to the epoll instance and removes the ones that are not
+  // watched anymore. A descriptor registered for a socket that was since
+  // deleted or closed may have been reused for another socket, it is
+  // registered again in that case.
+  bool UpdateEpoll(const std::vector<int>& descriptors, const std::vector<vtkSocket*>& sockets)
+  {
+    std::map<int, vtkWeakPointer<vtkSocket> > registered;
+    for (size_t cc = 0; cc < descriptors.size(); ++cc)
+    {
+      const int fd = descriptors[cc];
+      auto iter = this->Registered.find(fd);
+      if (iter == this->Registered.end() || iter->second.GetPointer() != sockets[cc])
+      {
+        if (iter != this->Registered.end())
+        {
+          epoll_ctl(this->EpollDescriptor, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(this->EpollDescriptor, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+          return false;
+        }
+      }
+      registered[fd] = sockets[cc];
+    }
+    for (auto& item : this->Registered)
+    {
+      if (registered.find(item.first) == registered.end())
+      {
+        // fails if the descriptor was closed, which removed it already.
+        epoll_ctl(this->EpollDescriptor, EPOLL_CTL_DEL, item.first, nullptr);
+      }
+    }
+    this->Registered.swap(registered);
+    return true;
+  }
+
+  // Waits for activity on the registered sockets. Returns the number of
+  // sockets ready for reading, 0 on timeout and -1 on error.
+  int WaitEpoll(unsigned long timeout_msecs, std::vector<int>& ready)
+  {
+    this->Events.resize(std::max<size_t>(this->Registered.size(), 1));
+    // for select(), a timeout of 0 means no timeout.
+    const int timeout = timeout_msecs > 0 ? static_cast<int>(timeout_msecs) : -1;
+    const int count = epoll_wait(
+      this->EpollDescriptor, this->Events.data(), static_cast<int>(this->Events.size()), timeout);
+    if (count < 0)
+    {
+      return errno == EINTR ? 0 : -1;
+    }
+    ready.clear();
+    for (int cc = 0; cc < count; ++cc)
+    {
+      ready.push_back(this->Events[cc].data.fd);
+    }
+    return count;
+  }
+
+  // Returns true if the controller or server socket can be processed without
+  // blocking: processing the sockets handled before it in the same call may
+  // have consumed its data, e.g. when an RMI handler communicates on it.
+  static bool IsStillReady(vtkObject* controller_or_server_socket)
+  {
+    vtkSocket* socket = vtkServerSocket::SafeDownCast(controller_or_server_socket);
+    if (auto controller = vtkSocketController::SafeDownCast(controller_or_server_socket))
+    {
+      vtkSocketCommunicator* comm =
+        vtkSocketCommunicator::SafeDownCast(controller->GetCommunicator());
+      if (comm->HasBufferredMessages())
+      {
+        return true;
+      }
+      socket = comm->GetSocket();
+    }
+    if (!socket)
+    {
+      return false;
+    }
+    struct pollfd descriptor;
+    descriptor.fd = socket->GetSocketDescriptor();
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    return poll(&descriptor, 1, 0) > 0;
+  }
+
+  int EpollDescriptor = -1;
+  std::map<int, vtkWeakPointer<vtkSocket> > Registered;
+  std::vector<struct epoll_event> Events;
+#endif
 };
 
 vtkStandardNewMacro(vtkTCPNetworkAccessManager);
@@ -192,16 +367,16 @@ int vtkTCPNetworkAccessManager::ProcessEvents(unsigned long timeout_msecs)
 int vtkTCPNetworkAccessManager::ProcessEventsInternal(
   unsigned long timeout_msecs, bool do_processing)
 {
-  int sockets_to_select[MAX_SOCKETS];
-  vtkObject* controller_or_server_socket[MAX_SOCKETS];
+  std::vector<int> sockets_to_select;
+  std::vector<vtkSocket*> sockets;
+  std::vector<vtkObject*> controller_or_server_socket;
 
   vtkSocketController* ctrlWithBufferToEmpty = NULL;
-  int size = 0;
   vtkInternals::VectorOfControllers::iterator iter1;
   for (iter1 = this->Internals->Controllers.begin(); iter1 != this->Internals->Controllers.end();
        ++iter1)
   {
-    vtkSocketController* controller = iter1->GetPointer();
+    vtkSocketController* controller = iter1->Controller.GetPointer();
     if (!controller)
     {
       // skip null controllers.
@@ -212,8 +387,9 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     vtkSocket* socket = comm->GetSocket();
     if (socket && socket->GetConnected())
     {
-      sockets_to_select[size] = socket->GetSocketDescriptor();
-      controller_or_server_socket[size] = controller;
+      sockets_to_select.push_back(socket->GetSocketDescriptor());
+      sockets.push_back(socket);
+      controller_or_server_socket.push_back(controller);
       if (comm->HasBufferredMessages())
       {
         ctrlWithBufferToEmpty = controller;
@@ -224,12 +400,11 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
           return 1;
         }
       }
-      size++;
     }
   }
 
   // Only one client connected, so if it fails, just quit...
-  bool can_quit_if_error = (size == 1);
+  bool can_quit_if_error = (sockets_to_select.size() == 1);
 
   // Now add server sockets.
   vtkInternals::MapToServerSockets::iterator iter2;
@@ -238,13 +413,13 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
   {
     if (iter2->second.GetPointer() && iter2->second.GetPointer()->GetConnected())
     {
-      sockets_to_select[size] = iter2->second.GetPointer()->GetSocketDescriptor();
-      controller_or_server_socket[size] = iter2->second.GetPointer();
-      size++;
+      sockets_to_select.push_back(iter2->second.GetPointer()->GetSocketDescriptor());
+      sockets.push_back(iter2->second.GetPointer());
+      controller_or_server_socket.push_back(iter2->second.GetPointer());
     }
   }
 
-  if (size == 0 || this->AbortPendingConnectionFlag)
+  if (sockets_to_select.empty() || this->AbortPendingConnectionFlag)
   {
     // Connection failed / aborted.
     return -1;
@@ -257,8 +432,55 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     return 1;
   }
 
+#if USE_EPOLL
+  if (this->Internals->EpollDescriptor != -1 &&
+    this->Internals->UpdateEpoll(sockets_to_select, sockets))
+  {
+    std::vector<int> ready;
+    int result = this->Internals->WaitEpoll(timeout_msecs, ready);
+    if (result <= 0)
+    {
+      return result;
+    }
+    if (!do_processing)
+    {
+      return 1;
+    }
+
+    // Process all the sockets that are ready. Processing a socket may
+    // close or release the others, or consume their data, so each one is
+    // checked again before it is processed: ProcessRMIs() would block on a
+    // socket that is not ready anymore.
+    const double ready_time = vtkTimerLog::GetUniversalTime();
+    std::vector<vtkWeakPointer<vtkObject> > ready_objects;
+    for (int fd : ready)
+    {
+      auto iter = std::find(sockets_to_select.begin(), sockets_to_select.end(), fd);
+      if (iter != sockets_to_select.end())
+      {
+        ready_objects.push_back(controller_or_server_socket[iter - sockets_to_select.begin()]);
+      }
+    }
+    for (size_t cc = 0; cc < ready_objects.size(); ++cc)
+    {
+      vtkObject* object = ready_objects[cc].GetPointer();
+      if (!object || !this->Internals->IsWatched(object) ||
+        (cc > 0 && !vtkInternals::IsStillReady(object)))
+      {
+        continue;
+      }
+      if (this->ProcessReadySocket(object, can_quit_if_error, ready_time) == -1)
+      {
+        return -1;
+      }
+    }
+    return 1;
+  }
+#endif
+
   int selected_index = -1;
-  int result = vtkSocket::SelectSockets(sockets_to_select, size, timeout_msecs, &selected_index);
+  int result = vtkSocket::SelectSockets(sockets_to_select.data(),
+    static_cast<int>(sockets_to_select.size()), timeout_msecs, &selected_index);
   if (result <= 0)
   {
     return result;
@@ -270,10 +492,17 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     return 1;
   }
 
-  if (controller_or_server_socket[selected_index]->IsA("vtkServerSocket"))
+  return this->ProcessReadySocket(controller_or_server_socket[selected_index], can_quit_if_error,
+    vtkTimerLog::GetUniversalTime());
+}
+
+//----------------------------------------------------------------------------
+int vtkTCPNetworkAccessManager::ProcessReadySocket(
+  vtkObject* controller_or_server_socket, bool can_quit_if_error, double ready_time)
+{
+  if (controller_or_server_socket->IsA("vtkServerSocket"))
   {
-    vtkServerSocket* ss =
-      static_cast<vtkServerSocket*>(controller_or_server_socket[selected_index]);
+    vtkServerSocket* ss = static_cast<vtkServerSocket*>(controller_or_server_socket);
     int port = ss->GetServerPort();
     this->InvokeEvent(vtkCommand::ConnectionCreatedEvent, &port);
     return 1;
@@ -284,8 +513,22 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     // during the whole ProcessRMIs call. As that call can release
     // the controller while executing.
     vtkSmartPointer<vtkMultiProcessController> controller =
-      vtkMultiProcessController::SafeDownCast(controller_or_server_socket[selected_index]);
-    result = controller->ProcessRMIs(0, 1);
+      vtkMultiProcessController::SafeDownCast(controller_or_server_socket);
+    vtkSocketCommunicator* comm =
+      vtkSocketCommunicator::SafeDownCast(controller->GetCommunicator());
+    int result = controller->ProcessRMIs(0, 1);
+
+    // Time from the moment the socket was found ready until its messages were
+    // handled, i.e. including the time spent on the sockets handled before.
+    if (vtkInternals::Connection* connection = this->Internals->FindConnection(controller))
+    {
+      const double latency = vtkTimerLog::GetUniversalTime() - ready_time;
+      vtkInternals::ConnectionStatistics& stats = connection->Statistics;
+      stats.NumberOfEvents++;
+      stats.TotalLatency += latency;
+      stats.MaximumLatency = std::max(stats.MaximumLatency, latency);
+    }
+
     if (result == vtkMultiProcessController::RMI_NO_ERROR)
     {
       // all's well.
@@ -298,8 +541,6 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     }
 
     // Close cleanly the socket in error
-    vtkSocketCommunicator* comm =
-      vtkSocketCommunicator::SafeDownCast(controller->GetCommunicator());
     comm->CloseConnection();
 
     // Fire an event letting the world know that the connection was closed.
@@ -309,6 +550,62 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
   }
 }
 
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkTCPNetworkAccessManager::GetNumberOfProcessedEvents(
+  vtkMultiProcessController* controller)
+{
+  vtkInternals::Connection* connection = this->Internals->FindConnection(controller);
+  return connection ? connection->Statistics.NumberOfEvents : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkTCPNetworkAccessManager::GetAverageLatency(vtkMultiProcessController* controller)
+{
+  vtkInternals::Connection* connection = this->Internals->FindConnection(controller);
+  return connection && connection->Statistics.NumberOfEvents > 0
+    ? connection->Statistics.TotalLatency / connection->Statistics.NumberOfEvents
+    : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkTCPNetworkAccessManager::GetMaximumLatency(vtkMultiProcessController* controller)
+{
+  vtkInternals::Connection* connection = this->Internals->FindConnection(controller);
+  return connection ? connection->Statistics.MaximumLatency : 0.0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTCPNetworkAccessManager::GetNumberOfBytesTransferred(
+  vtkMultiProcessController* controller, vtkTypeUInt64& sent, vtkTypeUInt64& received)
+{
+  sent = received = 0;
+  vtkInternals::Connection* connection = this->Internals->FindConnection(controller);
+  if (!connection)
+  {
+    return false;
+  }
+#if USE_EPOLL
+  vtkSocketCommunicator* comm =
+    vtkSocketCommunicator::SafeDownCast(connection->Controller->GetCommunicator());
+  vtkSocket* socket = comm ? comm->GetSocket() : nullptr;
+  if (socket && socket->GetConnected())
+  {
+    // The kernel counts the bytes of the connection. Older kernels return a
+    // shorter structure without the counters.
+    struct tcp_info info = {};
+    socklen_t length = sizeof(info);
+    if (getsockopt(socket->GetSocketDescriptor(), IPPROTO_TCP, TCP_INFO, &info, &length) == 0 &&
+      length >= offsetof(struct tcp_info, tcpi_bytes_received) + sizeof(info.tcpi_bytes_received))
+    {
+      sent = info.tcpi_bytes_acked;
+      received = info.tcpi_bytes_received;
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
 //----------------------------------------------------------------------------
 void vtkTCPNetworkAccessManager::PrintHandshakeError(int errorcode, bool server_side)
 {
@@ -419,7 +716,9 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
     this->PrintHandshakeError(errorcode, false);
     return NULL;
   }
-  this->Internals->Controllers.push_back(controller);
+  vtkInternals::Connection connection;
+  connection.Controller = controller;
+  this->Internals->Controllers.push_back(connection);
   return controller;
 }
 
@@ -498,7 +797,9 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
 
   if (controller)
   {
-    this->Internals->Controllers.push_back(controller);
+    vtkInternals::Connection connection;
+    connection.Controller = controller;
+    this->Internals->Controllers.push_back(connection);
   }
 
   if (once)
@@ -609,4 +910,20 @@ int vtkTCPNetworkAccessManager::ParaViewHandshake(
 void vtkTCPNetworkAccessManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+#if USE_EPOLL
+  os << indent << "UseEpoll: " << (this->Internals->EpollDescriptor != -1) << endl;
+#endif
+  for (auto& connection : this->Internals->Controllers)
+  {
+    if (vtkSocketController* controller = connection.Controller.GetPointer())
+    {
+      vtkTypeUInt64 sent, received;
+      this->GetNumberOfBytesTransferred(controller, sent, received);
+      os << indent << "Connection " << controller << ": "
+         << connection.Statistics.NumberOfEvents << " events, average latency "
+         << this->GetAverageLatency(controller) << "s, maximum latency "
+         << connection.Statistics.MaximumLatency << "s, " << sent << " bytes sent, " << received
+         << " bytes received" << endl;
+    }
+  }
 }
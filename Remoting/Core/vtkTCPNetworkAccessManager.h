@@ -18,6 +18,11 @@
  * vtkTCPNetworkAccessManager is a concrete implementation of
  * vtkNetworkAccessManager that uses tcp/ip sockets for communication between
  * processes. It supports urls that use "tcp" as their protocol specifier.
+ *
+ * On Linux, ProcessEvents() waits for activity using epoll and handles all
+ * the sockets that are ready at once. Elsewhere, or when the
+ * PARAVIEW_TCP_USE_SELECT environment variable is set, it uses select() and
+ * handles one socket per call.
 */
 
 #ifndef vtkTCPNetworkAccessManager_h
@@ -106,6 +111,27 @@ public:
    */
   virtual bool GetWrongConnectID() override;
 
+  //@{
+  /**
+   * Counters for the connection of the given controller, updated by
+   * ProcessEvents(). The latency is the time, in seconds, from the moment
+   * activity is detected on the connection until its messages have been
+   * processed.
+   */
+  vtkTypeUInt64 GetNumberOfProcessedEvents(vtkMultiProcessController* controller);
+  double GetAverageLatency(vtkMultiProcessController* controller);
+  double GetMaximumLatency(vtkMultiProcessController* controller);
+  //@}
+
+  /**
+   * Number of bytes sent and received on the connection of the given
+   * controller, as counted by the operating system. Returns false if the
+   * counters are not available, which is the case on platforms other than
+   * Linux.
+   */
+  bool GetNumberOfBytesTransferred(
+    vtkMultiProcessController* controller, vtkTypeUInt64& sent, vtkTypeUInt64& received);
+
 protected:
   vtkTCPNetworkAccessManager();
   ~vtkTCPNetworkAccessManager() override;
@@ -113,6 +139,10 @@ protected:
   // used by GetPendingConnectionsPresent and ProcessEvents
   int ProcessEventsInternal(unsigned long timeout_msecs, bool do_processing);
 
+  // used by ProcessEventsInternal to handle a socket with activity.
+  int ProcessReadySocket(
+    vtkObject* controller_or_server_socket, bool can_quit_if_error, double ready_time);
+
   /**
    * Connects to remote processes.
    */
@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestExtractsDeliveryHelper.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the assignment of simulation processes to visualization processes
+// used to deliver Catalyst Live extracts, and the delivery itself: simulation
+// processes, run as threads, connect to the visualization process over their
+// own socket, send their id as vtkLiveInsituLink does and then their pieces,
+// which are merged in the order of the simulation process ids.
+
+#include "vtkCellArray.h"
+#include "vtkClientSocket.h"
+#include "vtkDummyController.h"
+#include "vtkExtractsDeliveryHelper.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkSocketController.h"
+#include "vtkTrivialProducer.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int NUMBER_OF_STEPS = 3;
+
+std::atomic<int> SimulationFailures(0);
+
+// piece of simulation process `simId`: simId + 1 points at x = simId, y = step.
+vtkSmartPointer<vtkPolyData> CreatePiece(int simId, int step)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(simId + 1);
+  for (int cc = 0; cc <= simId; ++cc)
+  {
+    verts->InsertCellPoint(points->InsertNextPoint(simId, step, cc));
+  }
+  auto piece = vtkSmartPointer<vtkPolyData>::New();
+  piece->SetPoints(points);
+  piece->SetVerts(verts);
+  return piece;
+}
+
+void RunSimulation(int simId, int numSim, int port, bool asynchronous)
+{
+  vtkNew<vtkSocketController> sim2vis;
+  if (!sim2vis->ConnectTo("localhost", port))
+  {
+    ++SimulationFailures;
+    return;
+  }
+  sim2vis->Send(&simId, 1, 1, 98212);
+
+  vtkNew<vtkDummyController> parallel;
+  vtkNew<vtkTrivialProducer> producer;
+  vtkNew<vtkExtractsDeliveryHelper> helper;
+  helper->SetProcessIsProducer(true);
+  helper->SetParallelController(parallel);
+  helper->SetNumberOfSimulationProcesses(numSim);
+  helper->SetNumberOfVisualizationProcesses(1);
+  helper->SetAsynchronousSend(asynchronous);
+  helper->SetSimulation2VisualizationController(sim2vis);
+  helper->AddExtractProducer("points", producer->GetOutputPort());
+  for (int step = 0; step < NUMBER_OF_STEPS; ++step)
+  {
+    producer->SetOutput(CreatePiece(simId, step));
+    helper->Update();
+  }
+}
+
+bool TestDelivery(int numSim, bool asynchronous)
+{
+  vtkNew<vtkServerSocket> socket;
+  if (socket->CreateServer(0) != 0)
+  {
+    cerr << "ERROR: failed to create the server socket." << endl;
+    return false;
+  }
+
+  // processes connect in reverse order, the visualization process sorts them.
+  std::vector<std::thread> simulations;
+  for (int cc = numSim - 1; cc >= 0; --cc)
+  {
+    simulations.emplace_back(RunSimulation, cc, numSim, socket->GetServerPort(), asynchronous);
+  }
+  std::map<int, vtkSmartPointer<vtkSocketController> > sim2visControllers;
+  for (int cc = 0; cc < numSim; ++cc)
+  {
+    vtkClientSocket* clientSocket = socket->WaitForConnection(10000);
+    if (!clientSocket)
+    {
+      cerr << "ERROR: simulation processes failed to connect." << endl;
+      for (auto& simulation : simulations)
+      {
+        simulation.detach();
+      }
+      return false;
+    }
+    vtkNew<vtkSocketController> sim2vis;
+    if (auto comm = vtkSocketCommunicator::SafeDownCast(sim2vis->GetCommunicator()))
+    {
+      comm->SetSocket(clientSocket);
+      comm->ServerSideHandshake();
+    }
+    clientSocket->Delete();
+    int simId = -1;
+    sim2vis->Receive(&simId, 1, 1, 98212);
+    sim2visControllers[simId] = sim2vis.GetPointer();
+  }
+
+  vtkNew<vtkDummyController> parallel;
+  vtkNew<vtkTrivialProducer> consumer;
+  vtkNew<vtkExtractsDeliveryHelper> helper;
+  helper->SetProcessIsProducer(false);
+  helper->SetParallelController(parallel);
+  helper->SetNumberOfSimulationProcesses(numSim);
+  helper->SetNumberOfVisualizationProcesses(1);
+  for (const auto& item : sim2visControllers)
+  {
+    helper->AddSimulation2VisualizationController(item.second);
+  }
+  helper->AddExtractConsumer("points", consumer);
+
+  bool success = true;
+  for (int step = 0; step < NUMBER_OF_STEPS; ++step)
+  {
+    if (!helper->Update())
+    {
+      cerr << "ERROR: extract not delivered at step " << step << endl;
+      success = false;
+      break;
+    }
+    vtkPolyData* output = vtkPolyData::SafeDownCast(consumer->GetOutputDataObject(0));
+    const vtkIdType expected = numSim * (numSim + 1) / 2;
+    if (!output || output->GetNumberOfPoints() != expected ||
+      output->GetNumberOfCells() != numSim)
+    {
+      cerr << "ERROR: unexpected extract at step " << step << " with " << numSim
+           << " simulation processes." << endl;
+      success = false;
+      break;
+    }
+    double previous = 0;
+    for (vtkIdType cc = 0; cc < expected; ++cc)
+    {
+      double pt[3];
+      output->GetPoint(cc, pt);
+      if (pt[0] < previous || pt[1] != step)
+      {
+        cerr << "ERROR: point " << cc << " of step " << step << " is (" << pt[0] << ", " << pt[1]
+             << "), pieces are not merged in order." << endl;
+        success = false;
+        break;
+      }
+      previous = pt[0];
+    }
+  }
+  for (auto& simulation : simulations)
+  {
+    simulation.join();
+  }
+  if (SimulationFailures != 0)
+  {
+    cerr << "ERROR: simulation processes failed." << endl;
+    success = false;
+  }
+  return success;
+}
+
+bool TestGroups(int numSim, int numVis)
+{
+  std::vector<int> groupSizes(numVis, 0);
+  int previous = 0;
+  for (int cc = 0; cc < numSim; ++cc)
+  {
+    const int visId = vtkExtractsDeliveryHelper::GetVisualizationProcess(cc, numSim, numVis);
+    if (visId < 0 || visId >= numVis || visId < previous)
+    {
+      cerr << "ERROR: simulation process " << cc << " of " << numSim
+           << " is assigned to visualization process " << visId << " of " << numVis << endl;
+      return false;
+    }
+    previous = visId;
+    ++groupSizes[visId];
+  }
+
+  // groups are balanced and only the first min(M, N) processes have one.
+  const int minSize = numSim / numVis;
+  for (int cc = 0; cc < numVis; ++cc)
+  {
+    const bool expected = numSim > numVis
+      ? (groupSizes[cc] == minSize || groupSizes[cc] == minSize + 1)
+      : groupSizes[cc] == (cc < numSim ? 1 : 0);
+    if (!expected)
+    {
+      cerr << "ERROR: visualization process " << cc << " receives from " << groupSizes[cc]
+           << " of " << numSim << " simulation processes" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestExtractsDeliveryHelper(int, char* [])
+{
+  const int sizes[][2] = { { 1, 1 }, { 4, 1 }, { 1, 4 }, { 7, 3 }, { 3, 7 }, { 2048, 16 },
+    { 1000, 24 } };
+  for (const auto& size : sizes)
+  {
+    if (!TestGroups(size[0], size[1]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!TestDelivery(1, true) || !TestDelivery(3, true) || !TestDelivery(3, false))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -23,13 +23,26 @@
 #include "vtkMultiProcessControllerHelper.h"
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVLogger.h"
 #include "vtkPointData.h"
 #include "vtkSocketController.h"
 #include "vtkStructuredGrid.h"
+#include "vtkTimerLog.h"
 #include "vtkTrivialProducer.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <memory>
+#include <thread>
+#include <utility>
+
+class vtkExtractsDeliveryHelper::vtkInternals
+{
+public:
+  // sends the extracts of the last time step when AsynchronousSend is on.
+  std::thread SendThread;
+};
 
 vtkStandardNewMacro(vtkExtractsDeliveryHelper);
 //----------------------------------------------------------------------------
@@ -37,23 +50,39 @@ vtkExtractsDeliveryHelper::vtkExtractsDeliveryHelper()
   : ProcessIsProducer(true)
   , NumberOfSimulationProcesses(0)
   , NumberOfVisualizationProcesses(0)
+  , AsynchronousSend(true)
+  , LastSendTime(0.0)
+  , Internals(new vtkExtractsDeliveryHelper::vtkInternals())
 {
+  std::fill_n(this->DeliveryTimesValues, NUMBER_OF_DELIVERY_TIMES, 0.0);
   this->SetParallelController(vtkMultiProcessController::GetGlobalController());
 }
 
 //----------------------------------------------------------------------------
 vtkExtractsDeliveryHelper::~vtkExtractsDeliveryHelper()
 {
+  this->WaitForSend();
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
 void vtkExtractsDeliveryHelper::SetSimulation2VisualizationController(vtkSocketController* cont)
 {
-  if (this->Simulation2VisualizationController != cont)
+  this->WaitForSend();
+  this->Simulation2VisualizationControllers.clear();
+  if (cont)
   {
-    this->Simulation2VisualizationController = cont;
-    this->Modified();
+    this->Simulation2VisualizationControllers.push_back(cont);
   }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkExtractsDeliveryHelper::AddSimulation2VisualizationController(vtkSocketController* cont)
+{
+  assert(cont != NULL);
+  this->Simulation2VisualizationControllers.push_back(cont);
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -101,52 +130,30 @@ void vtkExtractsDeliveryHelper::AddExtractProducer(
 }
 
 //----------------------------------------------------------------------------
-vtkDataObject* vtkExtractsDeliveryHelper::Collect(int node_count, vtkDataObject* dObj)
+int vtkExtractsDeliveryHelper::GetVisualizationProcess(
+  int simulationProcess, int numberOfSimulationProcesses, int numberOfVisualizationProcesses)
 {
-  int numProcs = this->ParallelController->GetNumberOfProcesses();
-  int myId = this->ParallelController->GetLocalProcessId();
-  if (myId >= node_count)
+  if (numberOfSimulationProcesses <= numberOfVisualizationProcesses)
   {
-    int destination = myId % node_count;
-    this->ParallelController->Send(dObj, destination, 13001);
-    return NULL;
+    return simulationProcess;
   }
-  else
-  {
-    std::vector<vtkDataObject*> pieces;
-    vtkDataObject* clone = dObj->NewInstance();
-    clone->ShallowCopy(dObj);
-    pieces.push_back(clone);
-
-    for (int cc = 1; myId + cc * node_count < numProcs; cc++)
-    {
-      vtkDataObject* piece =
-        this->ParallelController->ReceiveDataObject(vtkMultiProcessController::ANY_SOURCE, 13001);
-      if (piece)
-      {
-        pieces.push_back(piece);
-      }
-    }
-
-    vtkDataObject* result = NULL;
-    if (pieces.size() > 1)
-    {
-      result = vtkMultiProcessControllerHelper::MergePieces(
-        &pieces[0], static_cast<unsigned int>(pieces.size()));
-    }
-    else
-    {
-      result = dObj;
-      dObj->Register(this);
-    }
+  return static_cast<int>(static_cast<vtkTypeInt64>(simulationProcess) *
+    numberOfVisualizationProcesses / numberOfSimulationProcesses);
+}
 
-    for (size_t cc = 0; cc < pieces.size(); cc++)
-    {
-      pieces[cc]->Delete();
-      pieces[cc] = NULL;
-    }
+//----------------------------------------------------------------------------
+double vtkExtractsDeliveryHelper::GetDeliveryTime(int index)
+{
+  return (index >= 0 && index < NUMBER_OF_DELIVERY_TIMES) ? this->DeliveryTimesValues[index]
+                                                          : 0.0;
+}
 
-    return result;
+//----------------------------------------------------------------------------
+void vtkExtractsDeliveryHelper::WaitForSend()
+{
+  if (this->Internals->SendThread.joinable())
+  {
+    this->Internals->SendThread.join();
   }
 }
 
@@ -154,104 +161,160 @@ vtkDataObject* vtkExtractsDeliveryHelper::Collect(int node_count, vtkDataObject*
 bool vtkExtractsDeliveryHelper::Update()
 {
   bool retVal = true;
+  const int myId = this->ParallelController->GetLocalProcessId();
+  const int numProcs = this->ParallelController->GetNumberOfProcesses();
   if (this->ProcessIsProducer)
   {
-    //    cout << "Push extracts for: " << endl;
-    //    for (ExtractProducersType::iterator iter = this->ExtractProducers.begin();
-    //      iter != this->ExtractProducers.end(); ++iter)
-    //      {
-    //      cout << "  " << iter->first.c_str() << endl;
-    //      }
-
     // update all inputs. We shouldn't call Update() here since that messes up
     // the time/piece requests that'd be set by paraview. The co-processing code
     // should ensure all pipelines are updated.
-    // for (iter = this->ExtractProducers.begin();
-    //  iter != this->ExtractProducers.end(); ++iter)
-    //  {
-    //  iter->second->GetProducer()->Update();
-    //  }
-
-    // reduce to N procs where N is the number of Vis procs.
-    int M = this->NumberOfSimulationProcesses;
-    int N = this->NumberOfVisualizationProcesses;
-
-    std::map<std::string, vtkSmartPointer<vtkDataObject> > gathered_extracts;
-    if (M > N)
+
+    // the socket is busy until the extracts of the previous time step are sent.
+    double start = vtkTimerLog::GetUniversalTime();
+    this->WaitForSend();
+    double times[3] = { vtkTimerLog::GetUniversalTime() - start, 0.0, this->LastSendTime };
+
+    // when sending asynchronously, the extracts are deep copied since the
+    // pipelines, and the simulation arrays they may reference, change as soon
+    // as the simulation resumes.
+    start = vtkTimerLog::GetUniversalTime();
+    typedef std::vector<std::pair<std::string, vtkSmartPointer<vtkDataObject> > > ExtractsType;
+    auto extracts = std::make_shared<ExtractsType>();
+    for (ExtractProducersType::iterator iter = this->ExtractProducers.begin();
+         iter != this->ExtractProducers.end(); ++iter)
     {
-      // when simulation processes in greater than vis processes, the simulation
-      // processes will gather data on the first N processes and then ship that
-      // over.
-      for (ExtractProducersType::iterator iter = this->ExtractProducers.begin();
-           iter != this->ExtractProducers.end(); ++iter)
+      vtkDataObject* dObj =
+        iter->second->GetProducer()->GetOutputDataObject(iter->second->GetIndex());
+      vtkSmartPointer<vtkDataObject> extract = dObj;
+      if (this->AsynchronousSend)
       {
-        vtkDataObject* dObj = this->Collect(
-          N, iter->second->GetProducer()->GetOutputDataObject(iter->second->GetIndex()));
-        gathered_extracts[iter->first].TakeReference(dObj);
+        extract.TakeReference(dObj->NewInstance());
+        extract->DeepCopy(dObj);
       }
+      extracts->push_back(std::make_pair(iter->first, extract));
     }
+    times[1] = vtkTimerLog::GetUniversalTime() - start;
 
-    if (N >= M)
+    double maxTimes[3] = { times[0], times[1], times[2] };
+    if (numProcs > 1)
     {
-      // totally acceptable case, nothing special to do. Only the first M
-      // visualization processes have data. One can use D3 for load balancing.
+      this->ParallelController->Reduce(times, maxTimes, 3, vtkCommunicator::MAX_OP, 0);
     }
+    std::copy(maxTimes, maxTimes + 3, this->DeliveryTimesValues);
 
-    vtkSocketController* comm = this->Simulation2VisualizationController;
+    // each process sends its own pieces to the visualization process of its
+    // group. Merging them is left to the visualization processes.
+    vtkSocketController* comm = this->Simulation2VisualizationControllers.empty()
+      ? NULL
+      : this->Simulation2VisualizationControllers[0].GetPointer();
     if (comm)
     {
-      for (ExtractProducersType::iterator iter = this->ExtractProducers.begin();
-           iter != this->ExtractProducers.end(); ++iter)
-      {
+      const bool sendTimes = (myId == 0);
+      auto send = [this, comm, extracts, sendTimes, maxTimes]() {
+        const double sendStart = vtkTimerLog::GetUniversalTime();
+        for (const auto& extract : *extracts)
+        {
+          vtkMultiProcessStream stream;
+          stream << extract.first;
+          comm->Send(stream, 1, 12000);
+          comm->Send(extract.second.GetPointer(), 1, 12001);
+        }
+        // mark end. The root process also reports the simulation times.
         vtkMultiProcessStream stream;
-        stream << iter->first;
+        stream << std::string("null");
+        if (sendTimes)
+        {
+          stream << maxTimes[0] << maxTimes[1] << maxTimes[2];
+        }
         comm->Send(stream, 1, 12000);
-        vtkDataObject* dObj = (M > N)
-          ? gathered_extracts[iter->first].GetPointer()
-          : iter->second->GetProducer()->GetOutputDataObject(iter->second->GetIndex());
-        comm->Send(dObj, 1, 12001);
+        this->LastSendTime = vtkTimerLog::GetUniversalTime() - sendStart;
+      };
+      if (this->AsynchronousSend)
+      {
+        this->Internals->SendThread = std::thread(send);
+      }
+      else
+      {
+        send();
       }
-      // mark end.
-      vtkMultiProcessStream stream;
-      stream << std::string("null");
-      comm->Send(stream, 1, 12000);
     }
   }
   else
   {
-    vtkSocketController* comm = this->Simulation2VisualizationController;
-    if (comm)
+    // receive the pieces from the simulation processes of this group.
+    double start = vtkTimerLog::GetUniversalTime();
+    std::map<std::string, std::vector<vtkSmartPointer<vtkDataObject> > > pieces;
+    double simulationTimes[3] = { 0.0, 0.0, 0.0 };
+    for (const auto& comm : this->Simulation2VisualizationControllers)
     {
-      std::vector<vtkSmartPointer<vtkCompositeDataSet> > compositeDSToShare;
-      vtkMultiProcessStream data_types_stream;
       while (true)
       {
-        int needToShare = 0;
         std::string key;
         vtkMultiProcessStream stream;
         comm->Receive(stream, 1, 12000);
         stream >> key;
         if (key == "null")
         {
+          if (!stream.Empty())
+          {
+            stream >> simulationTimes[0] >> simulationTimes[1] >> simulationTimes[2];
+          }
           break;
         }
-        //        cout << "Received extract for: " << key.c_str() << endl;
-        vtkDataObject* extract = comm->ReceiveDataObject(1, 12001);
-        ExtractConsumersType::iterator iter;
-        iter = this->ExtractConsumers.find(key);
-        if (iter != this->ExtractConsumers.end())
+        vtkSmartPointer<vtkDataObject> piece;
+        piece.TakeReference(comm->ReceiveDataObject(1, 12001));
+        if (piece)
         {
-          iter->second.first->SetOutput(extract);
-          iter->second.second = true;
-        }
-        else
-        {
-          vtkWarningMacro("Received unidentified extract " << key.c_str() << ". Ignoring.");
+          pieces[key].push_back(piece);
         }
+      }
+    }
+    double times[2] = { vtkTimerLog::GetUniversalTime() - start, 0.0 };
+
+    start = vtkTimerLog::GetUniversalTime();
+    std::vector<vtkSmartPointer<vtkCompositeDataSet> > compositeDSToShare;
+    vtkMultiProcessStream data_types_stream;
+    for (auto& item : pieces)
+    {
+      const std::string& key = item.first;
+      std::vector<vtkDataObject*> keyPieces;
+      for (const auto& piece : item.second)
+      {
+        keyPieces.push_back(piece.GetPointer());
+      }
+      vtkSmartPointer<vtkDataObject> extract;
+      if (keyPieces.size() > 1)
+      {
+        extract.TakeReference(vtkMultiProcessControllerHelper::MergePieces(
+          &keyPieces[0], static_cast<unsigned int>(keyPieces.size())));
+      }
+      else
+      {
+        extract = keyPieces[0];
+      }
+      if (!extract)
+      {
+        vtkWarningMacro("Failed to merge extract " << key.c_str() << ". Ignoring.");
+        continue;
+      }
+
+      ExtractConsumersType::iterator iter = this->ExtractConsumers.find(key);
+      if (iter != this->ExtractConsumers.end())
+      {
+        iter->second.first->SetOutput(extract);
+        iter->second.second = true;
+      }
+      else
+      {
+        vtkWarningMacro("Received unidentified extract " << key.c_str() << ". Ignoring.");
+      }
 
+      if (myId == 0)
+      {
         // Composite dataset need to convey their data structure across
         // processes, let's create those empty data object with the proper
         // data structure to share ONLY if needed.
+        int needToShare = 0;
         if (extract->IsA("vtkCompositeDataSet"))
         {
           vtkCompositeDataSet* dsToShare = vtkCompositeDataSet::SafeDownCast(
@@ -262,34 +325,37 @@ bool vtkExtractsDeliveryHelper::Update()
           needToShare = 1;
         }
         data_types_stream << key.c_str() << extract->GetClassName() << needToShare;
-        extract->Delete();
-      }
-      data_types_stream << "null";
-      this->ParallelController->Broadcast(data_types_stream, 0);
-
-      // Send the empty data object that need to share its structure
-      std::vector<vtkSmartPointer<vtkCompositeDataSet> >::iterator dsIter;
-      for (dsIter = compositeDSToShare.begin(); dsIter != compositeDSToShare.end(); dsIter++)
-      {
-        this->ParallelController->Broadcast(dsIter->GetPointer(), 0);
       }
     }
-    else
+    data_types_stream << "null";
+    times[1] = vtkTimerLog::GetUniversalTime() - start;
+
+    if (numProcs > 1)
     {
-      vtkMultiProcessStream data_types_stream;
+      // processes that did not receive an extract, e.g. when there are more
+      // visualization processes than simulation processes, get an empty data
+      // object of the same type from the root.
       this->ParallelController->Broadcast(data_types_stream, 0);
-      std::string key;
-      int needToReceiveDataObject;
-      data_types_stream >> key;
-      while (key != "null")
+      if (myId == 0)
       {
-        std::string data_type;
-        data_types_stream >> data_type >> needToReceiveDataObject;
-
-        ExtractConsumersType::iterator iter = this->ExtractConsumers.find(key);
-        if (iter != this->ExtractConsumers.end())
+        // Send the empty data object that need to share its structure
+        for (const auto& ds : compositeDSToShare)
         {
-          vtkDataObject* dObj = vtkDataObjectTypes::NewDataObject(data_type.c_str());
+          this->ParallelController->Broadcast(ds.GetPointer(), 0);
+        }
+      }
+      else
+      {
+        std::string key;
+        int needToReceiveDataObject;
+        data_types_stream >> key;
+        while (key != "null")
+        {
+          std::string data_type;
+          data_types_stream >> data_type >> needToReceiveDataObject;
+
+          vtkSmartPointer<vtkDataObject> dObj;
+          dObj.TakeReference(vtkDataObjectTypes::NewDataObject(data_type.c_str()));
 
           // Fill with proper data structure if needed
           if (needToReceiveDataObject != 0)
@@ -297,19 +363,43 @@ bool vtkExtractsDeliveryHelper::Update()
             this->ParallelController->Broadcast(dObj, 0);
           }
 
-          iter->second.first->SetOutput(dObj);
-          iter->second.second = true;
-          dObj->FastDelete();
-        }
-        else
-        {
-          vtkWarningMacro("Received unidentified extract " << key.c_str() << ". Ignoring.");
-        }
+          ExtractConsumersType::iterator iter = this->ExtractConsumers.find(key);
+          if (pieces.find(key) != pieces.end())
+          {
+            // this process has its own pieces.
+          }
+          else if (iter != this->ExtractConsumers.end())
+          {
+            iter->second.first->SetOutput(dObj);
+            iter->second.second = true;
+          }
+          else
+          {
+            vtkWarningMacro("Received unidentified extract " << key.c_str() << ". Ignoring.");
+          }
 
-        // Move forward
-        data_types_stream >> key;
+          // Move forward
+          data_types_stream >> key;
+        }
       }
+
+      double maxTimes[2] = { times[0], times[1] };
+      this->ParallelController->Reduce(times, maxTimes, 2, vtkCommunicator::MAX_OP, 0);
+      std::copy(maxTimes, maxTimes + 2, times);
     }
+
+    std::copy(simulationTimes, simulationTimes + 3, this->DeliveryTimesValues);
+    this->DeliveryTimesValues[VISUALIZATION_RECEIVE_TIME] = times[0];
+    this->DeliveryTimesValues[VISUALIZATION_MERGE_TIME] = times[1];
+    if (myId == 0)
+    {
+      vtkVLogF(PARAVIEW_LOG_CATALYST_VERBOSITY(),
+        "extracts delivered: wait %gs, copy %gs, send %gs, receive %gs, merge %gs",
+        this->DeliveryTimesValues[SIMULATION_WAIT_TIME],
+        this->DeliveryTimesValues[SIMULATION_COPY_TIME],
+        this->DeliveryTimesValues[SIMULATION_SEND_TIME], times[0], times[1]);
+    }
+
     // figure out if we have all of the extracted data objects on the server
     for (ExtractConsumersType::iterator iter = this->ExtractConsumers.begin();
          iter != this->ExtractConsumers.end(); iter++)
@@ -324,4 +414,9 @@ bool vtkExtractsDeliveryHelper::Update()
 void vtkExtractsDeliveryHelper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ProcessIsProducer: " << this->ProcessIsProducer << endl;
+  os << indent << "NumberOfSimulationProcesses: " << this->NumberOfSimulationProcesses << endl;
+  os << indent << "NumberOfVisualizationProcesses: " << this->NumberOfVisualizationProcesses
+     << endl;
+  os << indent << "AsynchronousSend: " << this->AsynchronousSend << endl;
 }
@@ -15,7 +15,19 @@
 /**
  * @class   vtkExtractsDeliveryHelper
  *
+ * vtkExtractsDeliveryHelper ships the extracts from the simulation processes
+ * to the visualization processes for Catalyst Live. Simulation processes are
+ * split in contiguous groups, one per visualization process (see
+ * GetVisualizationProcess()), and each simulation process sends its pieces
+ * directly to the visualization process of its group over its own socket.
+ * The pieces are merged on the visualization processes.
  *
+ * When AsynchronousSend is on (default), the extracts are copied and sent from
+ * a separate thread so that the simulation can resume while the data is being
+ * transferred. The next Update() waits for that transfer to complete.
+ *
+ * The time spent in each stage of the delivery of the last time step is
+ * available on the root visualization process with GetDeliveryTime().
 */
 
 #ifndef vtkExtractsDeliveryHelper_h
@@ -33,6 +45,7 @@ class vtkTrivialProducer;
 
 #include <map>    // needed for typedef
 #include <string> // needed for typedef
+#include <vector> // needed for std::vector
 
 class VTKREMOTINGLIVE_EXPORT vtkExtractsDeliveryHelper : public vtkObject
 {
@@ -44,8 +57,11 @@ public:
   vtkSetMacro(ProcessIsProducer, bool);
   vtkGetMacro(ProcessIsProducer, bool);
 
-  // Controller to used to communicate between sim and viz.
+  // Controller to used to communicate between sim and viz. On the
+  // visualization processes, there is one controller for each simulation
+  // process of the group, added in the order of the simulation process ids.
   void SetSimulation2VisualizationController(vtkSocketController*);
+  void AddSimulation2VisualizationController(vtkSocketController*);
 
   // The MPI communicator to communicate between the process in the process
   // group. This is only used on the simulation processes.
@@ -71,15 +87,58 @@ public:
   vtkSetMacro(NumberOfSimulationProcesses, int);
   vtkGetMacro(NumberOfSimulationProcesses, int);
 
+  /**
+   * Returns the visualization process that receives the extracts of the given
+   * simulation process. With more simulation processes than visualization
+   * processes, each visualization process serves a contiguous range of
+   * simulation processes; otherwise simulation process `i` sends to
+   * visualization process `i`.
+   */
+  static int GetVisualizationProcess(
+    int simulationProcess, int numberOfSimulationProcesses, int numberOfVisualizationProcesses);
+
+  //@{
+  /**
+   * When on, extracts are sent from a separate thread on the simulation
+   * processes. Default is on.
+   */
+  vtkSetMacro(AsynchronousSend, bool);
+  vtkGetMacro(AsynchronousSend, bool);
+  vtkBooleanMacro(AsynchronousSend, bool);
+  //@}
+
+  enum DeliveryTimes
+  {
+    SIMULATION_WAIT_TIME = 0,
+    SIMULATION_COPY_TIME,
+    SIMULATION_SEND_TIME,
+    VISUALIZATION_RECEIVE_TIME,
+    VISUALIZATION_MERGE_TIME,
+    NUMBER_OF_DELIVERY_TIMES
+  };
+
+  /**
+   * Time, in seconds, spent in a stage of the delivery of the last time step,
+   * as the maximum over the processes. Simulation times are the time spent
+   * waiting for the previous transfer to complete, copying the extracts and
+   * sending them, the latter being measured for the previous time step.
+   * All times are only available on the root visualization process.
+   */
+  double GetDeliveryTime(int index);
+
 protected:
   vtkExtractsDeliveryHelper();
   ~vtkExtractsDeliveryHelper() override;
 
-  vtkDataObject* Collect(int nodes_to_collect_to, vtkDataObject*);
+  // Waits for the extracts of the previous time step to be sent.
+  void WaitForSend();
 
   bool ProcessIsProducer;
   int NumberOfSimulationProcesses;
   int NumberOfVisualizationProcesses;
+  bool AsynchronousSend;
+  double DeliveryTimesValues[NUMBER_OF_DELIVERY_TIMES];
+  double LastSendTime;
 
   // the bool is to keep track of whether the trivial producer has had
   // its output set yet. we don't want to update the pipeline until
@@ -91,12 +150,15 @@ protected:
   typedef std::map<std::string, vtkSmartPointer<vtkAlgorithmOutput> > ExtractProducersType;
   ExtractProducersType ExtractProducers;
 
-  vtkSmartPointer<vtkSocketController> Simulation2VisualizationController;
+  std::vector<vtkSmartPointer<vtkSocketController> > Simulation2VisualizationControllers;
   vtkSmartPointer<vtkMultiProcessController> ParallelController;
 
 private:
   vtkExtractsDeliveryHelper(const vtkExtractsDeliveryHelper&) = delete;
   void operator=(const vtkExtractsDeliveryHelper&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif
@@ -42,11 +42,13 @@
 #include "vtkSocketController.h"
 #include "vtkTrivialProducer.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <vtksys/SystemInformation.hxx>
 #include <vtksys/SystemTools.hxx>
 
@@ -214,7 +216,7 @@ void NotifyClientIdMapping(vtkWeakPointer<vtkPVSessionBase> liveSession, unsigne
 void NotifyClientDataInformationNextTimestep(vtkWeakPointer<vtkPVSessionBase> liveSession,
   unsigned int proxyId,
   const std::map<std::pair<vtkTypeUInt32, unsigned int>, std::string>& information,
-  vtkIdType timeStep)
+  const std::vector<double>& deliveryTimes, vtkIdType timeStep)
 {
   if (liveSession)
   {
@@ -227,6 +229,18 @@ void NotifyClientDataInformationNextTimestep(vtkWeakPointer<vtkPVSessionBase> li
     message.SetExtension(ProxyState::xml_group, "Catalyst_Communication");
     message.SetExtension(ProxyState::xml_name, "Catalyst_Communication");
 
+    // Add the time spent delivering the extracts. This comes before
+    // "LiveAction" so that it is known when the client handles the new time
+    // step.
+    ProxyState_UserData* timing = message.AddExtension(ProxyState::user_data);
+    timing->set_key("DeliveryTimes");
+    Variant* timingVariant = timing->add_variant();
+    timingVariant->set_type(Variant::FLOAT64);
+    for (double value : deliveryTimes)
+    {
+      timingVariant->add_float64(value);
+    }
+
     // Add custom user_data
     ProxyState_UserData* user_data = message.AddExtension(ProxyState::user_data);
     user_data->set_key("LiveAction");
@@ -627,65 +641,81 @@ void vtkLiveInsituLink::InsituConnect(vtkMultiProcessController* proc0NodesContr
       this->ExtractsDeliveryHelper->SetNumberOfVisualizationProcesses(num_procs_paraview);
       this->ExtractsDeliveryHelper->SetNumberOfSimulationProcesses(num_procs_catalyst);
       assert(num_procs_catalyst > 0 && num_procs_paraview > 0);
+      // each process below `num_groups` receives the extracts of a group of
+      // catalyst processes, each one on its own socket, so that extracts do not
+      // go through the root process (see
+      // vtkExtractsDeliveryHelper::GetVisualizationProcess).
+      const int num_groups = std::min(num_procs_paraview, num_procs_catalyst);
+      vtkNew<vtkServerSocket> socket;
+      vtkMultiProcessStream connectionMsg;
+      const auto hostname = std::string(vtksys::SystemInformation().GetHostname());
+      if (myId < num_groups)
+      {
+        socket->CreateServer(0);
+        vtkLogF(INFO, "Awaiting Catalyst connections on `%s:%d` for data x-fer", hostname.c_str(),
+          socket->GetServerPort());
+        connectionMsg << 98210 << hostname.c_str() << socket->GetServerPort();
+      }
+
+      // communicate into to 0 so it can communicate that to Catalyst processes.
+      std::vector<vtkMultiProcessStream> allConnectionMsgs;
+      if (numProcs > 1)
+      {
+        parallelController->Gather(connectionMsg, allConnectionMsgs, 0);
+      }
+      else
+      {
+        allConnectionMsgs.push_back(connectionMsg);
+      }
       if (myId == 0)
       {
-        // we'll piggy back on proc0NodesController to deliver extracts as well for this rank.
-        this->ExtractsDeliveryHelper->SetSimulation2VisualizationController(
-          vtkSocketController::SafeDownCast(proc0NodesController));
+        connectionMsg.Reset();
+        for (const auto& msg : allConnectionMsgs)
+        {
+          connectionMsg << msg;
+        }
+        proc0NodesController->Send(connectionMsg, 1, 98211);
+      }
 
-        // communicate between satellites to help them setup the catalyst-to-paraview socket
-        // connections.
-        if (std::min(num_procs_paraview, num_procs_catalyst) > 1)
+      if (myId < num_groups)
+      {
+        int group_size = 0;
+        for (int cc = 0; cc < num_procs_catalyst; ++cc)
         {
-          vtkMultiProcessStream connectionMsg;
-          std::vector<vtkMultiProcessStream> allConnectionMsgs;
-          parallelController->Gather(connectionMsg, allConnectionMsgs, 0);
-          connectionMsg.Reset();
-          for (const auto& msg : allConnectionMsgs)
+          if (vtkExtractsDeliveryHelper::GetVisualizationProcess(
+                cc, num_procs_catalyst, num_procs_paraview) == myId)
           {
-            connectionMsg << msg;
+            ++group_size;
           }
-          proc0NodesController->Send(connectionMsg, 1, 98211);
         }
-      }
-      else if (myId < std::min(num_procs_paraview, num_procs_catalyst))
-      {
-        assert(myId != 0);
 
-        // create a server-socket.
-        vtkNew<vtkServerSocket> socket;
-        socket->CreateServer(0);
-
-        const auto hostname = std::string(vtksys::SystemInformation().GetHostname());
-        vtkLogF(INFO, "Awaiting secondary Catalyst connection on `%s:%d` for data x-fer",
-          hostname.c_str(), socket->GetServerPort());
-
-        // communicate into to 0 so it can communicate that to Catalyst processes.
-        vtkMultiProcessStream connectionMsg;
-        connectionMsg << 98210 << hostname.c_str() << socket->GetServerPort();
-        std::vector<vtkMultiProcessStream> not_used;
-        parallelController->Gather(connectionMsg, not_used, 0);
-
-        auto clientSocket = socket->WaitForConnection();
-        if (!clientSocket)
+        // connections are accepted in any order, the catalyst process id is
+        // sent first.
+        std::map<int, vtkSmartPointer<vtkSocketController> > sim2visControllers;
+        for (int cc = 0; cc < group_size; ++cc)
         {
-          abort();
+          auto clientSocket = socket->WaitForConnection();
+          if (!clientSocket)
+          {
+            abort();
+          }
+          vtkNew<vtkSocketController> sim2vis;
+          if (auto comm = vtkSocketCommunicator::SafeDownCast(sim2vis->GetCommunicator()))
+          {
+            comm->SetSocket(clientSocket);
+            comm->ServerSideHandshake();
+          }
+          clientSocket->Delete();
+          int sim_id = -1;
+          sim2vis->Receive(&sim_id, 1, 1, 98212);
+          sim2visControllers[sim_id] = sim2vis.GetPointer();
         }
-        vtkNew<vtkSocketController> sim2vis;
-        if (auto comm = vtkSocketCommunicator::SafeDownCast(sim2vis->GetCommunicator()))
+        vtkLogF(INFO, "%d Catalyst process(es) connected on `%s:%d`", group_size, hostname.c_str(),
+          socket->GetServerPort());
+        for (const auto& item : sim2visControllers)
         {
-          comm->SetSocket(clientSocket);
-          comm->ServerSideHandshake();
+          this->ExtractsDeliveryHelper->AddSimulation2VisualizationController(item.second);
         }
-        vtkLogF(
-          INFO, "Catalyst process connected on `%s:%d`", hostname.c_str(), socket->GetServerPort());
-        clientSocket->Delete();
-        this->ExtractsDeliveryHelper->SetSimulation2VisualizationController(sim2vis);
-      }
-      else if (std::min(num_procs_paraview, num_procs_catalyst) > 1)
-      {
-        std::vector<vtkMultiProcessStream> tmp;
-        parallelController->Gather(vtkMultiProcessStream(), tmp, 0);
       }
 
       NotifyClientConnected(this->LiveSession, this->ProxyId, this->InsituXMLState);
@@ -733,44 +763,36 @@ void vtkLiveInsituLink::InsituConnect(vtkMultiProcessController* proc0NodesContr
       this->ExtractsDeliveryHelper->SetNumberOfSimulationProcesses(num_procs_catalyst);
       assert(num_procs_catalyst > 0 && num_procs_paraview > 0);
 
-      // connect to the sim-nodes for data x'fer.
+      // connect to the vis-node of this process group for data x'fer.
+      vtkMultiProcessStream connectionMsg;
       if (myId == 0)
       {
-        // we'll piggy back on proc0NodesController to deliver extracts.
-        this->ExtractsDeliveryHelper->SetSimulation2VisualizationController(
-          vtkSocketController::SafeDownCast(proc0NodesController));
-
-        // communicate between satellites.
-        if (std::min(num_procs_paraview, num_procs_catalyst) > 1)
-        {
-          vtkMultiProcessStream connectionMsg;
-          proc0NodesController->Receive(connectionMsg, 1, 98211);
-          parallelController->Broadcast(connectionMsg, 0);
-        }
+        proc0NodesController->Receive(connectionMsg, 1, 98211);
       }
-      else if (std::min(num_procs_catalyst, num_procs_paraview) > 1)
+      if (numProcs > 1)
       {
-        vtkMultiProcessStream connectionMsg;
         parallelController->Broadcast(connectionMsg, 0);
+      }
 
-        for (int cc = 0; cc < num_procs_paraview && cc < num_procs_catalyst; ++cc)
+      const int visId = vtkExtractsDeliveryHelper::GetVisualizationProcess(
+        myId, num_procs_catalyst, num_procs_paraview);
+      for (int cc = 0; cc <= visId; ++cc)
+      {
+        vtkMultiProcessStream msg;
+        connectionMsg >> msg;
+        if (cc == visId && !msg.Empty())
         {
-          vtkMultiProcessStream msg;
-          connectionMsg >> msg;
-          if (myId == cc && !msg.Empty())
+          std::string hostname;
+          int port, tag;
+          msg >> tag >> hostname >> port;
+          assert(tag == 98210);
+          vtkNew<vtkSocketController> sim2vis;
+          if (!sim2vis->ConnectTo(hostname.c_str(), port))
           {
-            std::string hostname;
-            int port, tag;
-            msg >> tag >> hostname >> port;
-            assert(tag == 98210);
-            vtkNew<vtkSocketController> sim2vis;
-            if (!sim2vis->ConnectTo(hostname.c_str(), port))
-            {
-              abort();
-            }
-            this->ExtractsDeliveryHelper->SetSimulation2VisualizationController(sim2vis);
-            break;
+            abort();
           }
+          sim2vis->Send(&myId, 1, 1, 98212);
+          this->ExtractsDeliveryHelper->SetSimulation2VisualizationController(sim2vis);
         }
       }
       parallelController->Barrier();
@@ -1173,8 +1195,13 @@ void vtkLiveInsituLink::OnInsituPostProcess(double time, vtkIdType timeStep)
   }
   if (myId == 0 && dataAvailable)
   {
+    std::vector<double> deliveryTimes;
+    for (int cc = 0; cc < vtkExtractsDeliveryHelper::NUMBER_OF_DELIVERY_TIMES; ++cc)
+    {
+      deliveryTimes.push_back(this->ExtractsDeliveryHelper->GetDeliveryTime(cc));
+    }
     NotifyClientDataInformationNextTimestep(
-      this->LiveSession, this->ProxyId, dataInformation, timeStep);
+      this->LiveSession, this->ProxyId, dataInformation, deliveryTimes, timeStep);
   }
 }
 
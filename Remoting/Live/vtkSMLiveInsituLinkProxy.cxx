@@ -32,6 +32,7 @@
 #include "vtkSMSourceProxy.h"
 #include "vtkSMStateLoader.h"
 #include <sstream>
+#include <vector>
 
 //#define vtkSMLiveInsituLinkProxyDebugMacro(x) cerr x << endl;
 #define vtkSMLiveInsituLinkProxyDebugMacro(x)
@@ -41,6 +42,7 @@ class vtkSMLiveInsituLinkProxy::vtkInternals
 public:
   typedef std::map<std::string, vtkSmartPointer<vtkSMProxy> > ExtractProxiesType;
   ExtractProxiesType ExtractProxies;
+  std::vector<double> DeliveryTimes;
 };
 
 vtkStandardNewMacro(vtkSMLiveInsituLinkProxy);
@@ -90,7 +92,12 @@ void vtkSMLiveInsituLinkProxy::LoadState(const vtkSMMessage* msg, vtkSMProxyLoca
       const ProxyState_UserData& user_data = msg->GetExtension(ProxyState::user_data, i);
 
       // Process User data
-      if (user_data.key() == "LiveAction")
+      if (user_data.key() == "DeliveryTimes")
+      {
+        const Variant& value = user_data.variant(0);
+        this->Internals->DeliveryTimes.assign(value.float64().begin(), value.float64().end());
+      }
+      else if (user_data.key() == "LiveAction")
       {
         const Variant& value = user_data.variant(0);
         switch (value.integer(0))
@@ -207,6 +214,13 @@ void vtkSMLiveInsituLinkProxy::InsituConnected(const char* state)
   }
 }
 
+//----------------------------------------------------------------------------
+double vtkSMLiveInsituLinkProxy::GetDeliveryTime(int index)
+{
+  const std::vector<double>& times = this->Internals->DeliveryTimes;
+  return (index >= 0 && index < static_cast<int>(times.size())) ? times[index] : 0.0;
+}
+
 //----------------------------------------------------------------------------
 void vtkSMLiveInsituLinkProxy::NextTimestepAvailable(vtkIdType timeStep)
 {
@@ -65,6 +65,13 @@ public:
   vtkIdType GetTimeStep() { return this->TimeStep; }
   //@}
 
+  /**
+   * Time, in seconds, spent in a stage of the delivery of the extracts for the
+   * last time step, as reported by the server. `index` is one of
+   * vtkExtractsDeliveryHelper::DeliveryTimes. Returns 0 when not available.
+   */
+  double GetDeliveryTime(int index);
+
   /**
    * Overridden to handle server-notification messages.
    */
@@ -13,6 +13,7 @@ PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
 #include "vtkInitializationHelper.h"
+#include "vtkNew.h"
 #include "vtkPVDataInformation.h"
 #include "vtkPVOptions.h"
 #include "vtkProcessModule.h"
@@ -21,6 +22,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSMSession.h"
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSMSourceProxy.h"
+#include "vtkSMStateLoader.h"
 
 #include "vtkPVXMLElement.h"
 
@@ -99,6 +101,30 @@ int TestXMLSaveLoadState(int argc, char* argv[])
     cout << endl << " ### FAILED: States are NOT equals ###" << endl;
     return_value = EXIT_FAILURE;
   }
+
+  cout << "==== Loading previous state with batched proxy updates ====" << endl;
+  pxm->UnRegisterProxies();
+  vtkNew<vtkSMStateLoader> loader;
+  loader->SetSessionProxyManager(pxm);
+  loader->BatchProxyUpdatesOn();
+  pxm->LoadXMLState(xmlRootNodeOrigin, loader);
+  shrink = vtkSMSourceProxy::SafeDownCast(pxm->GetProxy("filters", "shrink"));
+  if (!pxm->GetProxy("sources", "sphere") || !shrink ||
+    vtkSMPropertyHelper(shrink, "Input").GetAsProxy() != pxm->GetProxy("sources", "sphere"))
+  {
+    cout << " ### FAILED: batched state loading ###" << endl;
+    return_value = EXIT_FAILURE;
+  }
+  else if (loader->GetNumberOfCreatedProxies() < 2)
+  {
+    cout << " ### FAILED: " << loader->GetNumberOfCreatedProxies() << " proxies created ###"
+         << endl;
+    return_value = EXIT_FAILURE;
+  }
+  for (int cc = 0; cc < vtkSMStateLoader::NUMBER_OF_LOAD_TIMES; ++cc)
+  {
+    cout << " - load time " << cc << ": " << loader->GetLoadTime(cc) << "s" << endl;
+  }
   session->Delete();
 
   //---------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+"""
+    This test loads a state with vtkSMStateLoader::BatchProxyUpdates on a
+    remote server, where the proxy states are pushed to the server in a single
+    PUSH_BATCH message, and checks that the proxies are created, connected and
+    produce the same data as before the state was saved.
+"""
+
+from paraview import servermanager
+from paraview.simple import *
+
+# Make sure the test driver know that process has properly started
+print ("Process started")
+
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+
+options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+url = options.GetServerURL()
+Connect(getHost(url), getPort(url))
+assert servermanager.ActiveConnection.IsRemote()
+
+sphere = Sphere(PhiResolution=20, ThetaResolution=20)
+shrink = Shrink(Input=sphere, ShrinkFactor=0.25)
+shrink.UpdatePipeline()
+numberOfCells = shrink.GetDataInformation().GetNumberOfCells()
+bounds = shrink.GetDataInformation().GetBounds()
+
+pxm = servermanager.ProxyManager()
+state = pxm.SMProxyManager.SaveXMLState()
+
+Delete(shrink)
+Delete(sphere)
+del shrink, sphere
+assert FindSource("Sphere1") is None and FindSource("Shrink1") is None
+
+loader = servermanager.vtkSMStateLoader()
+loader.SetSessionProxyManager(pxm.SMProxyManager)
+loader.BatchProxyUpdatesOn()
+pxm.SMProxyManager.LoadXMLState(state, loader)
+assert loader.GetNumberOfCreatedProxies() >= 2
+
+sphere = FindSource("Sphere1")
+shrink = FindSource("Shrink1")
+assert sphere is not None and shrink is not None
+assert shrink.SMProxy.GetProperty("Input").GetProxy(0) == sphere.SMProxy
+assert sphere.PhiResolution == 20 and sphere.ThetaResolution == 20
+
+# the server-side objects received the batched state.
+shrink.UpdatePipeline()
+assert shrink.GetDataInformation().GetNumberOfCells() == numberOfCells
+assert shrink.GetDataInformation().GetBounds() == bounds
+
+Disconnect()
@@ -26,6 +26,7 @@
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVInformation.h"
+#include "vtkPVLogger.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
 #include "vtkPVSessionCoreInterpreterHelper.h"
@@ -37,11 +38,13 @@
 #include "vtkSmartPointer.h"
 
 #include "vtksys/FStream.hxx"
+#include "vtksys/SystemTools.hxx"
 
 #include <assert.h>
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define LOG(x)                                                                                     \
   if (this->LogStream)                                                                             \
@@ -616,7 +619,7 @@ void vtkPVSessionCore::ExecuteStreamSatelliteCallback()
   this->ParallelController->Broadcast(raw_data, byte_size[0], 0);
 
   vtkClientServerStream stream;
-  stream.SetData(raw_data, byte_size[0]);
+  stream.SetDataView(raw_data, byte_size[0]);
   this->ExecuteStreamInternal(stream, byte_size[1] != 0);
   delete[] raw_data;
 }
@@ -858,6 +861,22 @@ bool vtkPVSessionCore::GatherInformation(
   return this->CollectInformation(information);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::UseTreeReductionForInformation =
+  !vtksys::SystemTools::HasEnv("PARAVIEW_GATHER_INFORMATION_ON_ROOT");
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::SetUseTreeReductionForInformation(bool value)
+{
+  vtkPVSessionCore::UseTreeReductionForInformation = value;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::GetUseTreeReductionForInformation()
+{
+  return vtkPVSessionCore::UseTreeReductionForInformation;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionCore::GatherInformationStatelliteCallback()
 {
@@ -896,6 +915,77 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
   }
 
 bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
+{
+  if (this->ParallelController->GetNumberOfProcesses() == 1)
+  {
+    /* short-circuit */
+    return true;
+  }
+
+  const bool useTree = vtkPVSessionCore::UseTreeReductionForInformation;
+  vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "collect information %s (%s)",
+    info ? info->GetClassName() : "(none)", useTree ? "tree reduction" : "gather on root");
+  return useTree ? this->ReduceInformation(info) : this->GatherInformationOnRoot(info);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::ReduceInformation(vtkPVInformation* info)
+{
+  const int rank = this->ParallelController->GetLocalProcessId();
+  const int nranks = this->ParallelController->GetNumberOfProcesses();
+
+  // Binomial tree: at each level, ranks with the current bit set send what
+  // they have accumulated to the rank without that bit and are done, the
+  // others merge it. The root receives log(nranks) messages and information
+  // from lower ranks is always merged first, as with a gather.
+  std::vector<unsigned char> buffer;
+  for (int mask = 1; mask < nranks; mask <<= 1)
+  {
+    if ((rank & mask) != 0)
+    {
+      vtkClientServerStream stream;
+      if (info)
+      {
+        info->CopyToStream(&stream);
+      }
+      const unsigned char* data;
+      size_t length;
+      stream.GetData(&data, &length);
+      vtkIdType sendLength = info ? static_cast<vtkIdType>(length) : 0;
+      this->ParallelController->Send(&sendLength, 1, rank - mask, ROOT_SATELLITE_INFO_TAG);
+      if (sendLength > 0)
+      {
+        this->ParallelController->Send(data, sendLength, rank - mask, ROOT_SATELLITE_INFO_TAG);
+      }
+      break;
+    }
+
+    if (rank + mask < nranks)
+    {
+      vtkIdType recvLength = 0;
+      this->ParallelController->Receive(&recvLength, 1, rank + mask, ROOT_SATELLITE_INFO_TAG);
+      if (recvLength > 0)
+      {
+        buffer.resize(recvLength);
+        this->ParallelController->Receive(
+          buffer.data(), recvLength, rank + mask, ROOT_SATELLITE_INFO_TAG);
+        if (info)
+        {
+          vtkClientServerStream stream;
+          stream.SetData(buffer.data(), buffer.size());
+          vtkSmartPointer<vtkPVInformation> other;
+          other.TakeReference(info->NewInstance());
+          other->CopyFromStream(&stream);
+          info->AddInformation(other);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::GatherInformationOnRoot(vtkPVInformation* info)
 {
   // Sanity checks
   assert("pre: NULL PV information!" && (info != NULL));
@@ -904,12 +994,6 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
   int rank = this->ParallelController->GetLocalProcessId();
   int nranks = this->ParallelController->GetNumberOfProcesses();
 
-  if (nranks == 1)
-  {
-    /* short-circuit */
-    return true;
-  }
-
   vtkIdType* rcvcounts = NULL;     /* significant only at rank 0 */
   vtkIdType* offSet = NULL;        /* significant only at rank 0 */
   int rbufsize = 0;                /* significant only at rank 0 */
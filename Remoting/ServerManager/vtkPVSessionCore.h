@@ -175,6 +175,19 @@ public:
   void RegisterSIObjectSatelliteCallback();
   void UnRegisterSIObjectSatelliteCallback();
 
+  //@{
+  /**
+   * Choose how information is collected from MPI satellites. When true
+   * (default), information is merged pairwise along a binary tree so that
+   * the root only merges log(N) messages. When false, the root gathers the
+   * information of all ranks and merges them one by one. The default can be
+   * changed by setting the PARAVIEW_GATHER_INFORMATION_ON_ROOT environment
+   * variable. This must be the same on all ranks.
+   */
+  static void SetUseTreeReductionForInformation(bool);
+  static bool GetUseTreeReductionForInformation();
+  //@}
+
   /**
    * Allow the user to fill a vtkCollection with all RemoteObjects
    * This is useful when you want to hold a reference to them to
@@ -215,6 +228,17 @@ protected:
    */
   bool CollectInformation(vtkPVInformation*);
 
+  //@{
+  /**
+   * Implementations of CollectInformation(). ReduceInformation() merges
+   * information pairwise along a binary tree of ranks while
+   * GatherInformationOnRoot() gathers the information of all ranks on the
+   * root and merges them there.
+   */
+  bool ReduceInformation(vtkPVInformation*);
+  bool GatherInformationOnRoot(vtkPVInformation*);
+  //@}
+
   /**
    * Increment reference count of a local vtkSIObject.
    */
@@ -254,6 +278,8 @@ private:
   // Local counter for global Ids
   vtkTypeUInt32 LocalGlobalID;
 
+  static bool UseTreeReductionForInformation;
+
   ostream* LogStream;
 };
 
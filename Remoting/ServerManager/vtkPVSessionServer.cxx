@@ -534,25 +534,36 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   switch (type)
   {
     case vtkPVSessionServer::PUSH:
+    case vtkPVSessionServer::PUSH_BATCH:
     {
-      std::string string;
-      stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-
-      //      cout << "=================================" << endl;
-      //      msg.PrintDebugString();
-      //      cout << "=================================" << endl;
-
-      // Do we skip the processing ?
-      if (!this->Internal->StoreShareOnly(&msg))
+      // a PUSH_BATCH carries several messages, queued by the client while
+      // batching (see vtkSMSessionClient::BeginPushBatch).
+      int count = 1;
+      if (type == vtkPVSessionServer::PUSH_BATCH)
       {
-        this->PushState(&msg);
+        stream >> count;
+      }
+      for (int cc = 0; cc < count; ++cc)
+      {
+        std::string string;
+        stream >> string;
+        vtkSMMessage msg;
+        msg.ParseFromString(string);
+
+        //      cout << "=================================" << endl;
+        //      msg.PrintDebugString();
+        //      cout << "=================================" << endl;
+
+        // Do we skip the processing ?
+        if (!this->Internal->StoreShareOnly(&msg))
+        {
+          this->PushState(&msg);
+        }
+
+        // Notify when ProxyManager state has changed
+        // or any other state change
+        this->NotifyOtherClients(&msg);
       }
-
-      // Notify when ProxyManager state has changed
-      // or any other state change
-      this->NotifyOtherClients(&msg);
     }
     break;
 
@@ -602,7 +613,7 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       this->Internal->GetActiveController()->Receive(
         css_data, size, 1, vtkPVSessionServer::EXECUTE_STREAM_TAG);
       vtkClientServerStream cssStream;
-      cssStream.SetData(css_data, size);
+      cssStream.SetDataView(css_data, size);
       this->ExecuteStream(vtkPVSession::CLIENT_AND_SERVERS, cssStream, ignore_errors != 0);
       delete[] css_data;
     }
@@ -35,10 +35,13 @@
 #include "vtkTimerLog.h"
 
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <vtksys/RegularExpression.hxx>
@@ -49,6 +52,62 @@
 typedef vtkSmartPointer<vtkPVXMLElement> XMLElement;
 typedef std::map<std::string, XMLElement> StrToXmlMap;
 typedef std::map<std::string, StrToXmlMap> StrToStrToXmlMap;
+// offset and size of a definition in the binary definitions
+typedef std::map<std::string, std::pair<size_t, size_t> > StrToRangeMap;
+typedef std::map<std::string, StrToRangeMap> StrToStrToRangeMap;
+
+//----------------------------------------------------------------------------
+// Binary form of the core definitions. It starts with a header identifying
+// the format and the ParaView version, followed by an index of the
+// definitions and their binary form (see vtkPVXMLElement::WriteBinary).
+namespace
+{
+const char BinaryDefinitionsMagic[] = "PVSMDEFS";
+const vtkTypeUInt32 BinaryDefinitionsVersion = 1;
+
+template <typename T>
+void AppendBinaryValue(std::string& buffer, T value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendBinaryString(std::string& buffer, const std::string& str)
+{
+  AppendBinaryValue(buffer, static_cast<vtkTypeUInt32>(str.size()));
+  buffer += str;
+}
+
+struct vtkBinaryDefinitionsReader
+{
+  const char* Data;
+  size_t Size;
+  size_t Position;
+
+  template <typename T>
+  bool Read(T& value)
+  {
+    if (this->Size - this->Position < sizeof(value))
+    {
+      return false;
+    }
+    memcpy(&value, this->Data + this->Position, sizeof(value));
+    this->Position += sizeof(value);
+    return true;
+  }
+
+  bool Read(std::string& str)
+  {
+    vtkTypeUInt32 length;
+    if (!this->Read(length) || this->Size - this->Position < length)
+    {
+      return false;
+    }
+    str.assign(this->Data + this->Position, length);
+    this->Position += length;
+    return true;
+  }
+};
+}
 
 class vtkSIProxyDefinitionManager::vtkInternals
 {
@@ -59,9 +118,14 @@ public:
   StrToStrToXmlMap CoreDefinitions;
   // Keep track of custom definition
   StrToStrToXmlMap CustomsDefinitions;
+  // ServerManager definitions loaded in binary form that have not been
+  // requested yet. They are created from BinaryData on first use.
+  StrToStrToRangeMap PendingCoreDefinitions;
+  const char* BinaryData;
   //-------------------------------------------------------------------------
   vtkInternals()
     : EnableXMLProxyDefinitionUpdate(true)
+    , BinaryData(nullptr)
   {
   }
   //-------------------------------------------------------------------------
@@ -69,6 +133,67 @@ public:
   {
     this->CoreDefinitions.clear();
     this->CustomsDefinitions.clear();
+    this->PendingCoreDefinitions.clear();
+    this->BinaryData = nullptr;
+  }
+  //-------------------------------------------------------------------------
+  vtkPVXMLElement* NewPendingCoreDefinition(const std::string& groupName,
+    const std::string& proxyName, const std::pair<size_t, size_t>& range)
+  {
+    vtkPVXMLElement* element =
+      vtkPVXMLElement::NewFromBinary(this->BinaryData + range.first, range.second);
+    if (!element)
+    {
+      vtkGenericWarningMacro("Invalid binary definition for (" << groupName << ", " << proxyName
+                                                               << ").");
+    }
+    return element;
+  }
+  //-------------------------------------------------------------------------
+  void MaterializeCoreDefinition(const std::string& groupName, const std::string& proxyName,
+    const std::pair<size_t, size_t>& range)
+  {
+    vtkSmartPointer<vtkPVXMLElement> element;
+    element.TakeReference(this->NewPendingCoreDefinition(groupName, proxyName, range));
+    if (element)
+    {
+      this->CoreDefinitions[groupName][proxyName] = element;
+    }
+  }
+  //-------------------------------------------------------------------------
+  void MaterializeCoreDefinition(const char* groupName, const char* proxyName)
+  {
+    StrToStrToRangeMap::iterator it = this->PendingCoreDefinitions.find(groupName);
+    if (it != this->PendingCoreDefinitions.end())
+    {
+      StrToRangeMap::iterator it2 = it->second.find(proxyName);
+      if (it2 != it->second.end())
+      {
+        this->MaterializeCoreDefinition(it->first, it2->first, it2->second);
+        it->second.erase(it2);
+      }
+    }
+  }
+  //-------------------------------------------------------------------------
+  void MaterializeCoreGroup(const char* groupName)
+  {
+    StrToStrToRangeMap::iterator it = this->PendingCoreDefinitions.find(groupName);
+    if (it != this->PendingCoreDefinitions.end())
+    {
+      for (StrToRangeMap::iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      {
+        this->MaterializeCoreDefinition(it->first, it2->first, it2->second);
+      }
+      this->PendingCoreDefinitions.erase(it);
+    }
+  }
+  //-------------------------------------------------------------------------
+  void MaterializeCoreDefinitions()
+  {
+    while (!this->PendingCoreDefinitions.empty())
+    {
+      this->MaterializeCoreGroup(this->PendingCoreDefinitions.begin()->first.c_str());
+    }
   }
   //-------------------------------------------------------------------------
   bool HasCoreDefinition(const char* groupName, const char* proxyName)
@@ -87,6 +212,7 @@ public:
     if (groupName)
     {
       nbProxy += static_cast<unsigned int>(this->CoreDefinitions[groupName].size());
+      nbProxy += static_cast<unsigned int>(this->PendingCoreDefinitions[groupName].size());
       nbProxy += static_cast<unsigned int>(this->CustomsDefinitions[groupName].size());
     }
     return nbProxy;
@@ -116,6 +242,12 @@ public:
     // Test if parameters are valid
     if (firstStr && secondStr)
     {
+      // Create the definition if it is still in binary form
+      if (&map == &this->CoreDefinitions)
+      {
+        this->MaterializeCoreDefinition(firstStr, secondStr);
+      }
+
       // Find the value based on both keys
       StrToStrToXmlMap::const_iterator it = map.find(firstStr);
       if (it != map.end())
@@ -296,6 +428,15 @@ public:
     this->CustomDefinitionMap = map;
     this->InvalidCustomIterator = true;
   }
+  //-------------------------------------------------------------------------
+  // Core definitions still in binary form. A group is created with
+  // `materializeGroup` when the traversal reaches it.
+  void RegisterPendingCoreDefinitionMap(
+    StrToStrToRangeMap* map, std::function<void(const char*)> materializeGroup)
+  {
+    this->PendingCoreDefinitionMap = map;
+    this->MaterializeGroup = materializeGroup;
+  }
 
   //-------------------------------------------------------------------------
   void GoToNextGroup() override { this->NextGroup(); }
@@ -306,6 +447,7 @@ protected:
     this->Initialized = false;
     this->CoreDefinitionMap = NULL;
     this->CustomDefinitionMap = 0;
+    this->PendingCoreDefinitionMap = NULL;
     this->InvalidCoreIterator = true;
     this->InvalidCustomIterator = true;
   }
@@ -339,6 +481,13 @@ protected:
           it++;
         }
       }
+      if (this->PendingCoreDefinitionMap)
+      {
+        for (const auto& group : *this->PendingCoreDefinitionMap)
+        {
+          this->AddTraversalGroupName(group.first.c_str());
+        }
+      }
 
       if (this->GroupNames.size() == 0)
       {
@@ -381,6 +530,10 @@ protected:
   {
     this->CurrentGroupName = *GroupNameIterator;
     this->GroupNameIterator++;
+    if (this->PendingCoreDefinitionMap)
+    {
+      this->MaterializeGroup(this->CurrentGroupName.c_str());
+    }
     if (this->CoreDefinitionMap)
     {
       this->CoreProxyIterator = (*this->CoreDefinitionMap)[this->CurrentGroupName].begin();
@@ -408,6 +561,8 @@ private:
   StrToXmlMap::iterator CustomProxyIteratorEnd;
   StrToStrToXmlMap* CoreDefinitionMap;
   StrToStrToXmlMap* CustomDefinitionMap;
+  StrToStrToRangeMap* PendingCoreDefinitionMap;
+  std::function<void(const char*)> MaterializeGroup;
   std::set<std::string> GroupNames;
   std::set<std::string>::iterator GroupNameIterator;
   bool InvalidCoreIterator;
@@ -497,7 +652,12 @@ void vtkSIProxyDefinitionManager::AddElement(
   }
   else
   {
-    // Just referenced it
+    // Just referenced it, replacing any cached one
+    StrToStrToRangeMap::iterator pending = this->Internals->PendingCoreDefinitions.find(groupName);
+    if (pending != this->Internals->PendingCoreDefinitions.end())
+    {
+      pending->second.erase(proxyName);
+    }
     this->Internals->CoreDefinitions[groupName][proxyName] = element;
     updated = true;
   }
@@ -842,6 +1002,13 @@ vtkPVProxyDefinitionIterator* vtkSIProxyDefinitionManager::NewSingleGroupIterato
 vtkPVProxyDefinitionIterator* vtkSIProxyDefinitionManager::NewIterator(int scope)
 {
   vtkInternalDefinitionIterator* iterator = vtkInternalDefinitionIterator::New();
+  if (scope != vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS)
+  {
+    // only the traversed groups are created.
+    vtkInternals* internals = this->Internals;
+    iterator->RegisterPendingCoreDefinitionMap(&internals->PendingCoreDefinitions,
+      [internals](const char* groupName) { internals->MaterializeCoreGroup(groupName); });
+  }
   switch (scope)
   {
     case vtkSIProxyDefinitionManager::CORE_DEFINITIONS: // Core only
@@ -1078,21 +1245,42 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
   vtkPVProxyDefinitionIterator* iter;
 
   // Core Definition
-  iter = this->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
-  iter->GoToFirstItem();
-  while (!iter->IsDoneWithTraversal())
+  for (const auto& group : this->Internals->CoreDefinitions)
   {
-    std::ostringstream xmlContent;
-    iter->GetProxyDefinition()->PrintXML(xmlContent, vtkIndent());
+    for (const auto& proxy : group.second)
+    {
+      std::ostringstream xmlContent;
+      proxy.second->PrintXML(xmlContent, vtkIndent());
 
-    xmlDef = msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
-    xmlDef->set_group(iter->GetGroupName());
-    xmlDef->set_name(iter->GetProxyName());
-    xmlDef->set_xml(xmlContent.str());
+      xmlDef = msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
+      xmlDef->set_group(group.first);
+      xmlDef->set_name(proxy.first);
+      xmlDef->set_xml(xmlContent.str());
+    }
+  }
 
-    iter->GoToNextItem();
+  // Core definitions still in binary form are only created for the message
+  // and not kept, since they have not been requested on this process.
+  for (const auto& group : this->Internals->PendingCoreDefinitions)
+  {
+    for (const auto& proxy : group.second)
+    {
+      vtkSmartPointer<vtkPVXMLElement> element;
+      element.TakeReference(
+        this->Internals->NewPendingCoreDefinition(group.first, proxy.first, proxy.second));
+      if (!element)
+      {
+        continue;
+      }
+      std::ostringstream xmlContent;
+      element->PrintXML(xmlContent, vtkIndent());
+
+      xmlDef = msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
+      xmlDef->set_group(group.first);
+      xmlDef->set_name(proxy.first);
+      xmlDef->set_xml(xmlContent.str());
+    }
   }
-  iter->Delete();
 
   // Custom Definition
   iter = this->NewIterator(vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS);
@@ -1119,6 +1307,8 @@ void vtkSIProxyDefinitionManager::Push(vtkSMMessage* msg)
   // proxy definitions on the client side when a server's definitions are
   // loaded. Ideally, we save all proxies that are "client" only. We will do
   // that when we convert this class to use pugixml.
+  this->Internals->MaterializeCoreGroup("animation_writers");
+  this->Internals->MaterializeCoreGroup("screenshot_writers");
   const auto animationWriters = this->Internals->CoreDefinitions["animation_writers"];
   const auto screenshotWriters = this->Internals->CoreDefinitions["screenshot_writers"];
 
@@ -1185,18 +1375,29 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
     dynamic_cast<vtkPVServerManagerPluginInterface*>(plugin);
   if (smplugin)
   {
-    std::vector<std::string> xmls;
-    smplugin->GetXMLs(xmls);
-
     // Make sure only the SERVER is processing the XML proxy definition
     if (this->Internals->EnableXMLProxyDefinitionUpdate)
     {
-      for (size_t cc = 0; cc < xmls.size(); cc++)
+      // if GetPluginName() == vtkPVInitializerPlugin, it implies that it's
+      // the ParaView core and should not be treated as plugin.
+      const bool isInitializer = strcmp(plugin->GetPluginName(), "vtkPVInitializerPlugin") == 0;
+
+      // the core definitions embedded at build time, parsing the XMLs is
+      // only needed when they are missing or out of date.
+      const char* data = nullptr;
+      size_t size = 0;
+      if (isInitializer)
       {
-        this->LoadConfigurationXMLFromString(xmls[cc].c_str(),
-          // if GetPluginName() == vtkPVInitializerPlugin, it implies that it's
-          // the ParaView core and should not be treated as plugin.
-          strcmp(plugin->GetPluginName(), "vtkPVInitializerPlugin") != 0);
+        smplugin->GetBinaryDefinitions(data, size);
+      }
+      if (!data || !this->LoadBinaryDefinitions(data, size))
+      {
+        std::vector<std::string> xmls;
+        smplugin->GetXMLs(xmls);
+        for (size_t cc = 0; cc < xmls.size(); cc++)
+        {
+          this->LoadConfigurationXMLFromString(xmls[cc].c_str(), !isInitializer);
+        }
       }
 
       // Make sure we invalidate any cached flatten version of our proxy definition
@@ -1204,6 +1405,125 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
     }
   }
 }
+//---------------------------------------------------------------------------
+bool vtkSIProxyDefinitionManager::LoadBinaryDefinitions(const char* data, size_t size)
+{
+  vtkTimerLog::MarkStartEvent("vtkSIProxyDefinitionManager Load Binary Definitions");
+  vtkBinaryDefinitionsReader reader = { data, size, 0 };
+  std::string magic, version;
+  vtkTypeUInt32 formatVersion = 0, numberOfGroups = 0;
+  if (!reader.Read(magic) || magic != BinaryDefinitionsMagic || !reader.Read(formatVersion) ||
+    formatVersion != BinaryDefinitionsVersion || !reader.Read(version) ||
+    version != PARAVIEW_VERSION_FULL || !reader.Read(numberOfGroups))
+  {
+    vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Load Binary Definitions");
+    return false;
+  }
+
+  StrToStrToRangeMap pending;
+  bool valid = true;
+  for (vtkTypeUInt32 cc = 0; valid && cc < numberOfGroups; ++cc)
+  {
+    std::string groupName;
+    vtkTypeUInt32 numberOfProxies = 0;
+    valid = reader.Read(groupName) && reader.Read(numberOfProxies);
+    for (vtkTypeUInt32 kk = 0; valid && kk < numberOfProxies; ++kk)
+    {
+      std::string proxyName;
+      vtkTypeUInt64 offset = 0, length = 0;
+      valid = reader.Read(proxyName) && reader.Read(offset) && reader.Read(length) &&
+        offset <= size && length <= size - offset;
+      if (valid)
+      {
+        pending[groupName][proxyName] =
+          std::make_pair(static_cast<size_t>(offset), static_cast<size_t>(length));
+      }
+    }
+  }
+  if (!valid)
+  {
+    vtkWarningMacro("Ignoring invalid binary proxy definitions.");
+    vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Load Binary Definitions");
+    return false;
+  }
+
+  // all the definitions must come from the same data.
+  this->Internals->MaterializeCoreDefinitions();
+  this->Internals->BinaryData = data;
+  for (const auto& group : pending)
+  {
+    StrToXmlMap& definitions = this->Internals->CoreDefinitions[group.first];
+    for (const auto& proxy : group.second)
+    {
+      // replace any existing definition, as AddElement() does.
+      definitions.erase(proxy.first);
+      RegisteredDefinitionInformation info(group.first.c_str(), proxy.first.c_str(), false);
+      this->InvokeEvent(vtkCommand::RegisterEvent, &info);
+    }
+  }
+  this->Internals->PendingCoreDefinitions.swap(pending);
+  this->InvalidateCollapsedDefinition();
+  this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+  vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Load Binary Definitions");
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::SaveBinaryDefinitions(std::string& data)
+{
+  this->Internals->MaterializeCoreDefinitions();
+
+  // serialize the definitions, then lay out the index that locates them.
+  const StrToStrToXmlMap& definitions = this->Internals->CoreDefinitions;
+  std::string blob;
+  std::vector<std::pair<size_t, size_t> > ranges;
+  vtkTypeUInt32 numberOfGroups = 0;
+  size_t indexSize = 0;
+  for (const auto& group : definitions)
+  {
+    if (!group.second.empty())
+    {
+      ++numberOfGroups;
+      indexSize += 2 * sizeof(vtkTypeUInt32) + group.first.size();
+    }
+    for (const auto& proxy : group.second)
+    {
+      const size_t offset = blob.size();
+      proxy.second->WriteBinary(blob);
+      ranges.push_back(std::make_pair(offset, blob.size() - offset));
+      indexSize += sizeof(vtkTypeUInt32) + proxy.first.size() + 2 * sizeof(vtkTypeUInt64);
+    }
+  }
+
+  data.clear();
+  AppendBinaryString(data, BinaryDefinitionsMagic);
+  AppendBinaryValue(data, BinaryDefinitionsVersion);
+  AppendBinaryString(data, PARAVIEW_VERSION_FULL);
+  AppendBinaryValue(data, numberOfGroups);
+
+  const size_t blobStart = data.size() + indexSize;
+  data.reserve(blobStart + blob.size());
+  auto range = ranges.begin();
+  for (const auto& group : definitions)
+  {
+    if (group.second.empty())
+    {
+      continue;
+    }
+    AppendBinaryString(data, group.first);
+    AppendBinaryValue(data, static_cast<vtkTypeUInt32>(group.second.size()));
+    for (const auto& proxy : group.second)
+    {
+      AppendBinaryString(data, proxy.first);
+      AppendBinaryValue(data, static_cast<vtkTypeUInt64>(blobStart + range->first));
+      AppendBinaryValue(data, static_cast<vtkTypeUInt64>(range->second));
+      ++range;
+    }
+  }
+  assert(data.size() == blobStart);
+  data += blob;
+}
+
 //---------------------------------------------------------------------------
 bool vtkSIProxyDefinitionManager::HasDefinition(const char* groupName, const char* proxyName)
 {
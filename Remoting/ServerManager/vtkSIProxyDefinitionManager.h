@@ -37,6 +37,11 @@
  * \li \c vtkCommand::UnRegisterEvent - Fired when a proxy definition is
  * removed. Since this class only support removing custom proxies, this event is
  * fired only when a custom proxy is removed.
+ *
+ * The core definitions are embedded in binary form at build time (see
+ * SaveBinaryDefinitions). They are loaded without parsing the XMLs and each
+ * definition is only created when it is requested. The XMLs are parsed when
+ * the binary definitions are missing or do not match the ParaView version.
 */
 
 #ifndef vtkSIProxyDefinitionManager_h
@@ -45,6 +50,8 @@
 #include "vtkRemotingServerManagerModule.h" //needed for exports
 #include "vtkSIObject.h"
 
+#include <string> // for std::string
+
 class vtkPVPlugin;
 class vtkPVProxyDefinitionIterator;
 class vtkPVXMLElement;
@@ -157,6 +164,18 @@ public:
   bool LoadConfigurationXMLFromString(const char* xmlContent);
   //@}
 
+  //@{
+  /**
+   * Save the core definitions in binary form, or load them from it. Loaded
+   * definitions are only created when requested, so `data` must remain valid
+   * as long as this object uses it. LoadBinaryDefinitions returns false, and
+   * leaves the definitions unchanged, if `data` is invalid or comes from
+   * another version of ParaView.
+   */
+  void SaveBinaryDefinitions(std::string& data);
+  bool LoadBinaryDefinitions(const char* data, size_t size);
+  //@}
+
   enum Events
   {
     ProxyDefinitionsUpdated = 2000,
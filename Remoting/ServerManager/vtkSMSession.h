@@ -145,6 +145,20 @@ public:
    */
   void PushState(vtkSMMessage* msg) override;
 
+  //@{
+  /**
+   * Begin/end a batch of PushState() calls. Sessions communicating with
+   * remote servers may queue the messages pushed to the servers within a
+   * batch and send them together, saving one network message per push. Any
+   * other request to the servers sends the queued messages first, so that
+   * the order of operations is preserved. Batches can be nested; the
+   * messages are sent when the outermost batch ends.
+   * Default implementation does nothing.
+   */
+  virtual void BeginPushBatch() {}
+  virtual void EndPushBatch() {}
+  //@}
+
   /**
    * Sends the message to all clients.
    */
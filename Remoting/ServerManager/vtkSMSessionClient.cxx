@@ -92,6 +92,7 @@ vtkSMSessionClient::vtkSMSessionClient()
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->PushBatchDepth = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -447,6 +448,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushPushBatch();
   if (this->DataServerController)
   {
     this->DataServerController->TriggerRMIOnAllChildren(vtkPVSessionServer::CLOSE_SESSION);
@@ -510,18 +512,9 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   {
     controllers[num_controllers++] = this->RenderServerController;
   }
-  if (num_controllers > 0)
+  for (int cc = 0; cc < num_controllers; cc++)
   {
-    vtkMultiProcessStream stream;
-    stream << static_cast<int>(vtkPVSessionServer::PUSH);
-    stream << message->SerializeAsString();
-    std::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
-    for (int cc = 0; cc < num_controllers; cc++)
-    {
-      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
-        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
-    }
+    this->SendPushState(controllers[cc], *message);
   }
 
   if ((location & vtkPVSession::CLIENT) != 0)
@@ -551,14 +544,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         // Add extra-information
         msg.set_share_only(true);
         msg.set_client_id(this->ServerInformation->GetClientId());
-
-        vtkMultiProcessStream stream;
-        stream << static_cast<int>(vtkPVSessionServer::PUSH);
-        stream << msg.SerializeAsString();
-        std::vector<unsigned char> raw_message;
-        stream.GetRawData(raw_message);
-        this->DataServerController->TriggerRMIOnAllChildren(&raw_message[0],
-          static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendPushState(this->DataServerController, msg);
       }
       else if (!remoteObject)
       {
@@ -580,9 +566,80 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendPushState(
+  vtkMultiProcessController* controller, const vtkSMMessage& message)
+{
+  if (this->PushBatchDepth > 0)
+  {
+    auto& batch = controller == this->RenderServerController &&
+        controller != this->DataServerController
+      ? this->RenderServerPushBatch
+      : this->DataServerPushBatch;
+    batch.push_back(message.SerializeAsString());
+    return;
+  }
+
+  vtkMultiProcessStream stream;
+  stream << static_cast<int>(vtkPVSessionServer::PUSH);
+  stream << message.SerializeAsString();
+  std::vector<unsigned char> raw_message;
+  stream.GetRawData(raw_message);
+  controller->TriggerRMIOnAllChildren(&raw_message[0], static_cast<int>(raw_message.size()),
+    vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushPushBatch()
+{
+  std::vector<std::string>* batches[2] = { &this->DataServerPushBatch,
+    &this->RenderServerPushBatch };
+  vtkMultiProcessController* controllers[2] = { this->DataServerController,
+    this->RenderServerController };
+  for (int cc = 0; cc < 2; cc++)
+  {
+    std::vector<std::string>& batch = *batches[cc];
+    if (batch.empty())
+    {
+      continue;
+    }
+    if (controllers[cc])
+    {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH)
+             << static_cast<int>(batch.size());
+      for (const auto& message : batch)
+      {
+        stream << message;
+      }
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
+        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    }
+    batch.clear();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::BeginPushBatch()
+{
+  ++this->PushBatchDepth;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndPushBatch()
+{
+  if (this->PushBatchDepth > 0 && --this->PushBatchDepth == 0)
+  {
+    this->FlushPushBatch();
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -638,6 +695,7 @@ void vtkSMSessionClient::ExecuteStream(
   {
     return;
   }
+  this->FlushPushBatch();
 
   location = this->GetRealLocation(location);
 
@@ -682,6 +740,7 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   location = this->GetRealLocation(location);
 
@@ -730,6 +789,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   if (this->RenderServerController == NULL)
   {
@@ -828,6 +888,7 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
   {
     return;
   }
+  this->FlushPushBatch();
 
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -869,6 +930,7 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
   {
     return;
   }
+  this->FlushPushBatch();
 
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -26,6 +26,9 @@
 #include "vtkRemotingServerManagerModule.h" //needed for exports
 #include "vtkSMSession.h"
 
+#include <string> // for std::string
+#include <vector> // for std::vector
+
 class vtkMultiProcessController;
 class vtkPVServerInformation;
 class vtkSMCollaborationManager;
@@ -108,6 +111,17 @@ public:
   const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location) override;
   //@}
 
+  //@{
+  /**
+   * Overridden to queue the messages pushed to the data-server and the
+   * render-server while batching, and send them in a single message per
+   * server when the outermost batch ends or before any other request is sent
+   * to the servers.
+   */
+  void BeginPushBatch() override;
+  void EndPushBatch() override;
+  //@}
+
   //@{
   /**
    * When Connect() is waiting for a server to connect back to the client (in
@@ -239,6 +253,17 @@ protected:
    */
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  /**
+   * Sends a PUSH message to the server identified by the controller, or
+   * queues it while batching.
+   */
+  void SendPushState(vtkMultiProcessController* controller, const vtkSMMessage& message);
+
+  /**
+   * Sends the messages queued while batching, if any.
+   */
+  void FlushPushBatch();
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -278,6 +303,9 @@ private:
   void operator=(const vtkSMSessionClient&) = delete;
 
   int NotBusy;
+  int PushBatchDepth;
+  std::vector<std::string> DataServerPushBatch;
+  std::vector<std::string> RenderServerPushBatch;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
 };
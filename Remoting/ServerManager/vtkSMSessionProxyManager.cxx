@@ -21,6 +21,7 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h" // for PARAVIEW_VERSION_*
+#include "vtkPVLogger.h"
 #include "vtkPVProxyDefinitionIterator.h"
 #include "vtkPVXMLElement.h"
 #include "vtkPVXMLParser.h"
@@ -1215,7 +1216,11 @@ void vtkSMSessionProxyManager::LoadXMLState(
 {
   vtkPVXMLParser* parser = vtkPVXMLParser::New();
   parser->SetFileName(filename);
-  parser->Parse();
+  {
+    // the scope reports the parse time, the loader reports the other phases.
+    vtkVLogScopeF(PARAVIEW_LOG_APPLICATION_VERBOSITY(), "parse state file '%s'", filename);
+    parser->Parse();
+  }
 
   this->LoadXMLState(parser->GetRootElement(), loader);
   parser->Delete();
@@ -16,6 +16,7 @@
 
 #include "vtkClientServerStreamInstantiator.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVLogger.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSMProperty.h"
 #include "vtkSMPropertyLink.h"
@@ -29,7 +30,9 @@
 #include "vtkSMSourceProxy.h"
 #include "vtkSMStateVersionController.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <vector>
@@ -59,10 +62,19 @@ struct vtkSMStateLoaderInternals
   ProxyCreationOrderType ProxyCreationOrder;
   bool DeferProxyRegistration;
 
+  /// Source proxies whose pipeline information update is deferred, in
+  /// creation order.
+  std::vector<vtkWeakPointer<vtkSMSourceProxy> > DeferredPipelineInformation;
+
+  double LoadTimes[vtkSMStateLoader::NUMBER_OF_LOAD_TIMES];
+  int NumberOfCreatedProxies;
+
   vtkSMStateLoaderInternals()
     : KeepOriginalId(false)
     , DeferProxyRegistration(false)
+    , NumberOfCreatedProxies(0)
   {
+    std::fill_n(this->LoadTimes, vtkSMStateLoader::NUMBER_OF_LOAD_TIMES, 0.0);
   }
 };
 
@@ -72,6 +84,7 @@ vtkSMStateLoader::vtkSMStateLoader()
   this->Internal = new vtkSMStateLoaderInternals;
   this->ServerManagerStateElement = 0;
   this->KeepIdMapping = 0;
+  this->BatchProxyUpdates = false;
   this->ProxyLocator = vtkSMProxyLocator::New();
 }
 
@@ -221,10 +234,26 @@ void vtkSMStateLoader::CreatedNewProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
   }
 
   // Calling UpdateVTKObjects() will assign the proxy a GlobalId, if needed.
+  double* times = this->Internal->LoadTimes;
+  double start = vtkTimerLog::GetUniversalTime();
   proxy->UpdateVTKObjects();
-  if (proxy->IsA("vtkSMSourceProxy"))
+  times[PUSH_TIME] += vtkTimerLog::GetUniversalTime() - start;
+  this->Internal->NumberOfCreatedProxies++;
+
+  if (vtkSMSourceProxy* source = vtkSMSourceProxy::SafeDownCast(proxy))
   {
-    vtkSMSourceProxy::SafeDownCast(proxy)->UpdatePipelineInformation();
+    if (this->BatchProxyUpdates && this->Internal->DeferProxyRegistration)
+    {
+      // updating the pipeline information requires a round trip to the
+      // server, do it once all proxies have been created.
+      this->Internal->DeferredPipelineInformation.push_back(source);
+    }
+    else
+    {
+      start = vtkTimerLog::GetUniversalTime();
+      source->UpdatePipelineInformation();
+      times[UPDATE_TIME] += vtkTimerLog::GetUniversalTime() - start;
+    }
   }
   if (this->Internal->DeferProxyRegistration)
   {
@@ -237,6 +266,21 @@ void vtkSMStateLoader::CreatedNewProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkSMStateLoader::UpdateDeferredPipelineInformation()
+{
+  const double start = vtkTimerLog::GetUniversalTime();
+  for (const auto& source : this->Internal->DeferredPipelineInformation)
+  {
+    if (source)
+    {
+      source->UpdatePipelineInformation();
+    }
+  }
+  this->Internal->DeferredPipelineInformation.clear();
+  this->Internal->LoadTimes[UPDATE_TIME] += vtkTimerLog::GetUniversalTime() - start;
+}
+
 //---------------------------------------------------------------------------
 void vtkSMStateLoader::RegisterProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
 {
@@ -539,10 +583,19 @@ int vtkSMStateLoader::LoadState(vtkPVXMLElement* elem, bool keepOriginalId)
     return 0;
   }
 
+  std::fill_n(this->Internal->LoadTimes, NUMBER_OF_LOAD_TIMES, 0.0);
+  this->Internal->NumberOfCreatedProxies = 0;
+
   this->ProxyLocator->SetDeserializer(this);
   int ret = this->LoadStateInternal(elem);
   this->ProxyLocator->SetDeserializer(0);
 
+  const double* times = this->Internal->LoadTimes;
+  vtkVLogF(PARAVIEW_LOG_APPLICATION_VERBOSITY(),
+    "loaded state with %d new proxies: parse %gs, create %gs, push %gs, register %gs, update %gs",
+    this->Internal->NumberOfCreatedProxies, times[PARSE_TIME], times[CREATE_TIME],
+    times[PUSH_TIME], times[REGISTER_TIME], times[UPDATE_TIME]);
+
   // BUG #10650. When animation scene time ranges are read from the state, they
   // often override those that the timekeeper painstakingly computed. Here we
   // explicitly trigger the timekeeper so that the scene re-determines the
@@ -560,6 +613,8 @@ int vtkSMStateLoader::LoadState(vtkPVXMLElement* elem, bool keepOriginalId)
 //---------------------------------------------------------------------------
 int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
 {
+  double* times = this->Internal->LoadTimes;
+  double start = vtkTimerLog::GetUniversalTime();
   vtkPVXMLElement* rootElement = parent;
   if (rootElement->GetName() && strcmp(rootElement->GetName(), "ServerManagerState") != 0)
   {
@@ -619,6 +674,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
     }
   }
 
+  times[PARSE_TIME] += vtkTimerLog::GetUniversalTime() - start;
+
   // Iterate over all proxy collections to create all proxies. None are
   // registered at this point, just created. Since we don't register proxies
   // here, we have to take special care for loading state of proxies that are
@@ -628,7 +685,17 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
   // registered. That way, when properties on TimeKeeper or AnimationScene
   // start getting modified, the proxies they may refer to are already
   // present and registered.
+  // When batching, the state pushed by all the proxies created here is sent
+  // to the servers at once, when the batch ends.
   std::vector<vtkSmartPointer<vtkPVXMLElement> > deferredCollections;
+  vtkSMSession* session = this->GetSession();
+  const bool batch = this->BatchProxyUpdates && session;
+  if (batch)
+  {
+    session->BeginPushBatch();
+  }
+  start = vtkTimerLog::GetUniversalTime();
+  double pushAndUpdateTime = times[PUSH_TIME] + times[UPDATE_TIME];
   this->Internal->DeferProxyRegistration = true;
   for (i = 0; i < numElems; i++)
   {
@@ -643,13 +710,28 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
       }
       else if (!this->HandleProxyCollection(currentElement))
       {
+        if (batch)
+        {
+          session->EndPushBatch();
+        }
+        this->Internal->DeferredPipelineInformation.clear();
         return 0;
       }
     }
   }
+  times[CREATE_TIME] += vtkTimerLog::GetUniversalTime() - start -
+    (times[PUSH_TIME] + times[UPDATE_TIME] - pushAndUpdateTime);
+  if (batch)
+  {
+    start = vtkTimerLog::GetUniversalTime();
+    session->EndPushBatch();
+    times[PUSH_TIME] += vtkTimerLog::GetUniversalTime() - start;
+  }
+  this->UpdateDeferredPipelineInformation();
 
   // Register proxies in order they were created (as that's a good dependency
   // order).
+  start = vtkTimerLog::GetUniversalTime();
   for (vtkSMStateLoaderInternals::ProxyCreationOrderType::const_iterator iter =
          this->Internal->ProxyCreationOrder.begin();
        iter != this->Internal->ProxyCreationOrder.end(); ++iter)
@@ -657,9 +739,12 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
     this->RegisterProxy(iter->first, iter->second);
   }
   this->Internal->ProxyCreationOrder.clear();
+  times[REGISTER_TIME] += vtkTimerLog::GetUniversalTime() - start;
 
   // Now handle animation and timekeeper collections. This time, we let the
   // proxies be registered as needed.
+  start = vtkTimerLog::GetUniversalTime();
+  pushAndUpdateTime = times[PUSH_TIME] + times[UPDATE_TIME];
   this->Internal->DeferProxyRegistration = false;
   for (size_t cc = 0; cc < deferredCollections.size(); ++cc)
   {
@@ -668,6 +753,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
       return 0;
     }
   }
+  times[CREATE_TIME] += vtkTimerLog::GetUniversalTime() - start -
+    (times[PUSH_TIME] + times[UPDATE_TIME] - pushAndUpdateTime);
   assert(this->Internal->ProxyCreationOrder.size() == 0);
 
   // Process link elements.
@@ -731,10 +818,28 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
   return 1;
 }
 
+//---------------------------------------------------------------------------
+double vtkSMStateLoader::GetLoadTime(int time)
+{
+  if (time < 0 || time >= NUMBER_OF_LOAD_TIMES)
+  {
+    vtkErrorMacro("Invalid load time " << time);
+    return 0.0;
+  }
+  return this->Internal->LoadTimes[time];
+}
+
+//---------------------------------------------------------------------------
+int vtkSMStateLoader::GetNumberOfCreatedProxies()
+{
+  return this->Internal->NumberOfCreatedProxies;
+}
+
 //---------------------------------------------------------------------------
 void vtkSMStateLoader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "BatchProxyUpdates: " << this->BatchProxyUpdates << endl;
 }
 
 //---------------------------------------------------------------------------
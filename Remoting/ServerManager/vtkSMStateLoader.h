@@ -18,6 +18,16 @@
  *
  * vtkSMStateLoader can load server manager state from a given
  * vtkPVXMLElement. This element is usually populated by a vtkPVXMLParser.
+ *
+ * When BatchProxyUpdates is enabled, the state of all proxies created from
+ * the state is pushed to the servers in a single batch (see
+ * vtkSMSession::BeginPushBatch) and the pipeline information of source
+ * proxies is updated once all proxies have been created, rather than after
+ * each proxy. This avoids one round trip to the server per proxy in
+ * client-server mode.
+ *
+ * The time spent in each phase of the last LoadState() call is available
+ * through GetLoadTime() and is logged at the application verbosity.
  * @sa
  * vtkPVXMLParser vtkPVXMLElement
 */
@@ -76,11 +86,43 @@ public:
    * The array is kept internally using a std::vector
    */
   vtkTypeUInt32* GetMappingArray(int& size);
+  //@}
+
+  //@{
+  /**
+   * When enabled, batch the state pushed by the proxies to the servers and
+   * defer updating the pipeline information of source proxies until all
+   * proxies have been created. Default is false.
+   */
+  vtkSetMacro(BatchProxyUpdates, bool);
+  vtkGetMacro(BatchProxyUpdates, bool);
+  vtkBooleanMacro(BatchProxyUpdates, bool);
+  //@}
+
+  enum LoadTimes
+  {
+    PARSE_TIME,    // converting and scanning the state
+    CREATE_TIME,   // creating proxies and loading their properties
+    PUSH_TIME,     // pushing the proxies state to the servers
+    REGISTER_TIME, // registering the proxies with the proxy manager
+    UPDATE_TIME,   // updating the proxies pipeline information
+    NUMBER_OF_LOAD_TIMES
+  };
+
+  /**
+   * Returns the time, in seconds, spent in a phase of the last LoadState()
+   * call.
+   */
+  double GetLoadTime(int time);
+
+  /**
+   * Returns the number of proxies created by the last LoadState() call.
+   */
+  int GetNumberOfCreatedProxies();
 
 protected:
   vtkSMStateLoader();
   ~vtkSMStateLoader() override;
-  //@}
 
   /**
    * The rootElement must be the \c \<ServerManagerState/\> xml element.
@@ -162,9 +204,16 @@ protected:
    */
   vtkSMProxy* LocateExistingProxyUsingRegistrationName(vtkTypeUInt32 id);
 
+  /**
+   * Updates the pipeline information of the source proxies whose update was
+   * deferred when BatchProxyUpdates is enabled.
+   */
+  void UpdateDeferredPipelineInformation();
+
   vtkPVXMLElement* ServerManagerStateElement;
   vtkSMProxyLocator* ProxyLocator;
   int KeepIdMapping;
+  bool BatchProxyUpdates;
 
 private:
   vtkSMStateLoader(const vtkSMStateLoader&) = delete;
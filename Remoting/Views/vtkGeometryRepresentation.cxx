@@ -1228,6 +1228,32 @@ void vtkGeometryRepresentation::SetGenerateFeatureEdges(bool val)
   this->MarkModified();
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetExecuteBlocksInParallel(bool val)
+{
+  if (vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter))
+  {
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter)->SetExecuteBlocksInParallel(val);
+  }
+
+  // since geometry filter needs to execute, we need to mark the representation
+  // modified.
+  this->MarkModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetUseTopologyCache(bool val)
+{
+  if (vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter))
+  {
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter)->SetUseTopologyCache(val);
+  }
+
+  // since geometry filter needs to execute, we need to mark the representation
+  // modified.
+  this->MarkModified();
+}
+
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetBlockVisibility(unsigned int index, bool visible)
 {
@@ -176,6 +176,8 @@ public:
   void SetTriangulate(int);
   void SetNonlinearSubdivisionLevel(int);
   virtual void SetGenerateFeatureEdges(bool);
+  void SetExecuteBlocksInParallel(bool);
+  void SetUseTopologyCache(bool);
 
   //***************************************************************************
   // Forwarded to vtkProperty.
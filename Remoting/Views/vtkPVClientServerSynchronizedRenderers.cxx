@@ -21,6 +21,7 @@
 #include "vtkOpenGLRenderer.h"
 #include "vtkPVConfig.h"
 #include "vtkSquirtCompressor.h"
+#include "vtkTemporalImageCompressor.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZlibImageCompressor.h"
 #if VTK_MODULE_ENABLE_ParaView_nvpipe
@@ -47,6 +48,37 @@ vtkPVClientServerSynchronizedRenderers::~vtkPVClientServerSynchronizedRenderers(
   this->SetCompressor(NULL);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::MasterStartRender()
+{
+  this->Superclass::MasterStartRender();
+
+  vtkTemporalImageCompressor* temporal = vtkTemporalImageCompressor::SafeDownCast(this->Compressor);
+  if (temporal)
+  {
+    int needsKeyFrame = temporal->GetNeedsKeyFrame() ? 1 : 0;
+    this->ParallelController->Send(&needsKeyFrame, 1, 1, 0x023431);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SlaveStartRender()
+{
+  this->Superclass::SlaveStartRender();
+
+  vtkTemporalImageCompressor* temporal = vtkTemporalImageCompressor::SafeDownCast(this->Compressor);
+  if (temporal)
+  {
+    int needsKeyFrame = 0;
+    this->ParallelController->Receive(&needsKeyFrame, 1, 1, 0x023431);
+    if (needsKeyFrame)
+    {
+      // the client dropped a difference frame, start over with a key frame.
+      temporal->Reset();
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
 {
@@ -172,6 +204,10 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char* str
     {
       comp = vtkLZ4Compressor::New();
     }
+    else if (className == "vtkTemporalImageCompressor")
+    {
+      comp = vtkTemporalImageCompressor::New();
+    }
     else if (className == "vtkNvPipeCompressor" && this->NVPipeSupport)
     {
 #if VTK_MODULE_ENABLE_ParaView_nvpipe
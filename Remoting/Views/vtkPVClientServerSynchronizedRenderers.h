@@ -74,6 +74,15 @@ protected:
   vtkUnsignedCharArray* Compress(vtkUnsignedCharArray*);
   void Decompress(vtkUnsignedCharArray* input, vtkUnsignedCharArray* outputBuffer);
 
+  //@{
+  /**
+   * With vtkTemporalImageCompressor, the client tells the server when it
+   * needs a key frame to resynchronize.
+   */
+  void MasterStartRender() override;
+  void SlaveStartRender() override;
+  //@}
+
   void MasterEndRender() override;
   void SlaveEndRender() override;
 
@@ -16,6 +16,7 @@
 #define vtkPVDataDeliveryManagerInternals_h
 #ifndef __WRAP__
 
+#include "vtkBinaryDataObjectMarshaller.h"
 #include "vtkDataObject.h"
 #include "vtkInformation.h"
 #include "vtkNew.h"
@@ -89,11 +90,18 @@ public:
 
     vtkMTimeType TimeStamp{ 0 };
 
+    // Keeps track of the arrays transferred for this item so that consecutive
+    // deliveries (e.g. timesteps) only transfer the arrays that changed. This
+    // is not tied to the cache key nor reset by SetDataObject() on purpose.
+    vtkNew<vtkBinaryDataObjectMarshaller> Marshaller;
+
   public:
     vtkItem() {}
 
     void ClearCache() { this->Data.clear(); }
 
+    vtkBinaryDataObjectMarshaller* GetMarshaller() { return this->Marshaller.GetPointer(); }
+
     void SetDataObject(vtkDataObject* data, vtkInternals* helper, double cacheKey)
     {
       auto& store = this->Data[cacheKey];
@@ -29,7 +29,9 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOrderedCompositeDistributor.h"
+#include "vtkPVLogger.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVRenderViewSettings.h"
 #include "vtkPVStreamingMacros.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkWeakPointer.h"
@@ -564,6 +566,7 @@ void vtkPVRenderViewDataDeliveryManager::DeliverStreamedPieces(
 
     vtkNew<vtkMPIMoveData> dataMover;
     dataMover->InitializeForCommunicationForParaView();
+    vtkPVRenderViewDataDeliveryManager::ConfigureCompression(dataMover);
     dataMover->SetOutputDataType(data->GetDataObjectType());
     dataMover->SetMoveMode(this->GetViewDataDistributionMode(/*low_res=*/false));
     dataMover->SetInputData(piece);
@@ -633,6 +636,8 @@ void vtkPVRenderViewDataDeliveryManager::MoveData(
 
   vtkNew<vtkMPIMoveData> dataMover;
   dataMover->InitializeForCommunicationForParaView();
+  vtkPVRenderViewDataDeliveryManager::ConfigureCompression(dataMover);
+  dataMover->SetIncrementalMarshaller(item->GetMarshaller());
   dataMover->SetOutputDataType(dataObj->GetDataObjectType());
   dataMover->SetMoveMode(moveMode);
   if (info->Has(vtkPVRVDMKeys::DELIVER_TO_CLIENT_AND_RENDERING_PROCESSES()) &&
@@ -643,9 +648,28 @@ void vtkPVRenderViewDataDeliveryManager::MoveData(
   }
   dataMover->SetInputData(dataObj);
   dataMover->Update();
+  vtkVLogF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(),
+    "delivery timings: compress=%fs, transfer=%fs, decompress=%fs, bytes=%lld (%lld compressed, "
+    "%lld unchanged)",
+    dataMover->GetLastCompressTime(), dataMover->GetLastTransferTime(),
+    dataMover->GetLastDecompressTime(), static_cast<long long>(dataMover->GetLastUncompressedSize()),
+    static_cast<long long>(dataMover->GetLastCompressedSize()),
+    static_cast<long long>(dataMover->GetLastSkippedSize()));
   item->SetDeliveredDataObject(viewMode, cacheKey, dataMover->GetOutputDataObject(0));
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderViewDataDeliveryManager::ConfigureCompression(vtkMPIMoveData* dataMover)
+{
+  auto settings = vtkPVRenderViewSettings::GetInstance();
+  const int codec = settings->GetGeometryCompressionCodec();
+  if (codec != vtkMPIMoveData::COMPRESSION_NONE || !vtkMPIMoveData::GetUseZLibCompression())
+  {
+    dataMover->SetCompressionCodec(codec);
+  }
+  dataMover->SetCompressionLevel(settings->GetGeometryCompressionLevel());
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderViewDataDeliveryManager::PrintSelf(ostream& os, vtkIndent indent)
 {
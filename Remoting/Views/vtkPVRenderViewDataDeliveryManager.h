@@ -35,6 +35,7 @@ class vtkDataObject;
 class vtkExtentTranslator;
 class vtkInformation;
 class vtkMatrix4x4;
+class vtkMPIMoveData;
 class vtkPVDataRepresentation;
 class vtkPVView;
 
@@ -196,6 +197,13 @@ protected:
   int GetViewDataDistributionMode(bool low_res) const;
   int GetMoveMode(vtkInformation* info, int viewMode) const;
 
+  /**
+   * Setup geometry compression on the data mover using vtkPVRenderViewSettings.
+   * When the settings leave compression off, the codec set through
+   * vtkMPIMoveData::SetUseZLibCompression() is kept.
+   */
+  static void ConfigureCompression(vtkMPIMoveData* dataMover);
+
   std::vector<vtkBoundingBox> Cuts;
   std::vector<vtkBoundingBox> RawCuts;
   std::vector<int> RawCutsRankAssignments;
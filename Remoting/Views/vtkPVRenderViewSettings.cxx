@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPVRenderViewSettings.h"
 
+#include "vtkMPIMoveData.h"
 #include "vtkMapper.h"
 #include "vtkObjectFactory.h"
 
@@ -49,6 +50,8 @@ vtkPVRenderViewSettings::vtkPVRenderViewSettings()
   , PointPickingRadius(0)
   , DisableIceT(false)
   , EnableFastPreselection(false)
+  , GeometryCompressionCodec(vtkMPIMoveData::COMPRESSION_NONE)
+  , GeometryCompressionLevel(6)
 {
 }
 
@@ -112,6 +115,13 @@ void vtkPVRenderViewSettings::SetZShift(double val)
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderViewSettings::SetUseBinaryGeometryMarshalling(bool val)
+{
+  vtkMPIMoveData::SetUseBinaryMarshalling(val);
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderViewSettings::PrintSelf(ostream& os, vtkIndent indent)
 {
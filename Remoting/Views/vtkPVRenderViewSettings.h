@@ -113,6 +113,24 @@ public:
   vtkGetMacro(EnableFastPreselection, bool);
   //@}
 
+  //@{
+  /**
+   * Codec and level used to compress geometry delivered between processes by
+   * vtkMPIMoveData. The codec is one of vtkMPIMoveData::CompressionCodecs;
+   * the level is in the range [1, 9]. Defaults to no compression, level 6.
+   * No compression does not override vtkMPIMoveData::SetUseZLibCompression().
+   */
+  vtkSetClampMacro(GeometryCompressionCodec, int, 0, 2);
+  vtkGetMacro(GeometryCompressionCodec, int);
+  vtkSetClampMacro(GeometryCompressionLevel, int, 1, 9);
+  vtkGetMacro(GeometryCompressionLevel, int);
+  //@}
+
+  /**
+   * Forwarded to vtkMPIMoveData::SetUseBinaryMarshalling.
+   */
+  void SetUseBinaryGeometryMarshalling(bool);
+
 protected:
   vtkPVRenderViewSettings();
   ~vtkPVRenderViewSettings() override;
@@ -122,6 +140,8 @@ protected:
   int PointPickingRadius;
   bool DisableIceT;
   bool EnableFastPreselection;
+  int GeometryCompressionCodec;
+  int GeometryCompressionLevel;
 
 private:
   vtkPVRenderViewSettings(const vtkPVRenderViewSettings&) = delete;
@@ -16,7 +16,6 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkDoubleArray.h"
-#include "vtkIntArray.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVArrayInformation.h"
@@ -39,6 +38,7 @@
 #include "vtkStringList.h"
 #include "vtkTable.h"
 #include "vtkTuple.h"
+#include "vtkTypeInt64Array.h"
 #include "vtk_jsoncpp.h"
 
 #include "vtksys/FStream.hxx"
@@ -637,7 +637,8 @@ vtkTable* vtkSMTransferFunctionProxy::ComputeDataHistogramTable(int numberOfBins
     this->HistogramTableCache = nullptr;
     return this->HistogramTableCache;
   }
-  vtkIntArray* valueArray = vtkIntArray::SafeDownCast(this->HistogramTableCache->GetColumn(1));
+  vtkTypeInt64Array* valueArray =
+    vtkTypeInt64Array::SafeDownCast(this->HistogramTableCache->GetColumn(1));
   if (!valueArray)
   {
     vtkErrorMacro("Histogram is not producing integer data as expected");
@@ -645,10 +646,10 @@ vtkTable* vtkSMTransferFunctionProxy::ComputeDataHistogramTable(int numberOfBins
     return this->HistogramTableCache;
   }
 
-  // Copy histogram values, currently stored in an int array,
+  // Copy histogram values, currently stored in a 64-bit integer array,
   // into a double array in order to be able to use shift scale in the related plots
   vtkIdType nValue = valueArray->GetNumberOfTuples();
-  int* valuePointer = static_cast<int*>(valueArray->GetPointer(0));
+  vtkTypeInt64* valuePointer = valueArray->GetPointer(0);
   vtkNew<vtkDoubleArray> doubleValueArray;
   doubleValueArray->SetName(valueArray->GetName());
   doubleValueArray->SetNumberOfTuples(valueArray->GetNumberOfTuples());
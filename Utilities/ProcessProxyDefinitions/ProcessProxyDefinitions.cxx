@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    ProcessProxyDefinitions.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Parses server manager XML files and writes a header declaring their proxy
+// definitions in the binary form loaded by
+// vtkSIProxyDefinitionManager::LoadBinaryDefinitions().
+
+#include "vtkNew.h"
+#include "vtkSIProxyDefinitionManager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static bool read_option_file(std::vector<std::string>& strings, const char* fname)
+{
+  std::ifstream fp(fname);
+  if (!fp)
+  {
+    return false;
+  }
+  for (std::string line; std::getline(fp, line);)
+  {
+    strings.push_back(line);
+  }
+  return true;
+}
+
+static std::vector<std::string> parse_expand_args(int argc, char* argv[])
+{
+  std::vector<std::string> strings;
+  for (int cc = 0; cc < argc; ++cc)
+  {
+    if (cc > 0 && argv[cc][0] == '@')
+    {
+      if (!read_option_file(strings, &argv[cc][1]))
+      {
+        strings.push_back(argv[cc]);
+      }
+    }
+    else
+    {
+      strings.push_back(argv[cc]);
+    }
+  }
+
+  return strings;
+}
+
+int main(int argc, char* argv[])
+{
+  auto args = parse_expand_args(argc, argv);
+  if (args.size() < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <output-file> <variable> <xmls>..." << std::endl;
+    return 1;
+  }
+
+  vtkNew<vtkSIProxyDefinitionManager> manager;
+  for (size_t cc = 3; cc < args.size(); ++cc)
+  {
+    std::ifstream file(args[cc].c_str());
+    std::ostringstream content;
+    content << file.rdbuf();
+    if (!file || !manager->LoadConfigurationXMLFromString(content.str().c_str()))
+    {
+      std::cerr << "Problem parsing XML file: " << args[cc] << std::endl;
+      return 1;
+    }
+  }
+
+  std::string data;
+  manager->SaveBinaryDefinitions(data);
+
+  const std::string& variable = args[2];
+  std::ostringstream stream;
+  stream << "// Binary proxy definitions" << std::endl
+         << "//" << std::endl
+         << "// Generated by " << argv[0] << std::endl
+         << "//" << std::endl
+         << "#ifndef " << variable << "_h" << std::endl
+         << "#define " << variable << "_h" << std::endl
+         << std::endl
+         << "static const unsigned char " << variable << "[] = {";
+  char byte[8];
+  for (size_t cc = 0; cc < data.size(); ++cc)
+  {
+    snprintf(byte, sizeof(byte), "%u,", static_cast<unsigned char>(data[cc]));
+    stream << (cc % 24 == 0 ? "\n  " : "") << byte;
+  }
+  stream << std::endl << "};" << std::endl << std::endl << "#endif" << std::endl;
+
+  std::ofstream output(args[1].c_str());
+  output << stream.str();
+  if (!output)
+  {
+    std::cerr << "Cannot write output file: " << args[1] << std::endl;
+    return 1;
+  }
+  return 0;
+}
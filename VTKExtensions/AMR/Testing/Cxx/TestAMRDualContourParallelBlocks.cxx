@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAMRDualContourParallelBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkAMRDualContour, which contours blocks concurrently, produces
+// the same output whatever the number of threads, with and without merging
+// points, and reports the speedup for a range of thread counts. Pass
+// `--levels N` to change the number of levels of the fractal.
+
+#include "vtkAMRDualContour.h"
+#include "vtkCellArray.h"
+#include "vtkDataObject.h"
+#include "vtkHierarchicalFractal.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
+#include "vtkNonOverlappingAMR.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+vtkSmartPointer<vtkNonOverlappingAMR> CreateInput(int maximumLevel)
+{
+  vtkNew<vtkHierarchicalFractal> fractal;
+  fractal->SetDimensions(10);
+  fractal->SetMaximumLevel(maximumLevel);
+  fractal->SetGhostLevels(1);
+  fractal->SetTwoDimensional(0);
+  fractal->SetOverlap(0);
+  fractal->Update();
+
+  auto amr = vtkSmartPointer<vtkNonOverlappingAMR>::New();
+  amr->ShallowCopy(fractal->GetOutputDataObject(0));
+  return amr;
+}
+
+struct Output
+{
+  std::vector<double> Points;
+  std::vector<vtkIdType> Polys;
+
+  bool operator!=(const Output& other) const
+  {
+    return this->Points != other.Points || this->Polys != other.Polys;
+  }
+};
+
+double Execute(vtkNonOverlappingAMR* input, bool mergePoints, Output& output)
+{
+  vtkNew<vtkAMRDualContour> contour;
+  contour->SetIsoValue(0.5);
+  contour->SetEnableMergePoints(mergePoints);
+  contour->SetEnableMultiProcessCommunication(0);
+  contour->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "Fractal Volume Fraction");
+  contour->SetInputData(input);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  contour->Update();
+  timer->StopTimer();
+
+  output.Points.clear();
+  output.Polys.clear();
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(contour->GetOutputDataObject(0));
+  vtkMultiPieceDataSet* mp = mb ? vtkMultiPieceDataSet::SafeDownCast(mb->GetBlock(0)) : nullptr;
+  vtkPolyData* pd = mp ? vtkPolyData::SafeDownCast(mp->GetPiece(0)) : nullptr;
+  if (pd)
+  {
+    for (vtkIdType ptId = 0; ptId < pd->GetNumberOfPoints(); ++ptId)
+    {
+      double pt[3];
+      pd->GetPoint(ptId, pt);
+      output.Points.insert(output.Points.end(), pt, pt + 3);
+    }
+    vtkIdType npts;
+    const vtkIdType* pts;
+    vtkCellArray* polys = pd->GetPolys();
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+      output.Polys.push_back(npts);
+      output.Polys.insert(output.Polys.end(), pts, pts + npts);
+    }
+  }
+  return timer->GetElapsedTime();
+}
+}
+
+int TestAMRDualContourParallelBlocks(int argc, char* argv[])
+{
+  int maximumLevel = 5;
+  for (int cc = 1; cc + 1 < argc; ++cc)
+  {
+    if (strcmp(argv[cc], "--levels") == 0)
+    {
+      maximumLevel = atoi(argv[cc + 1]);
+    }
+  }
+
+  vtkSmartPointer<vtkNonOverlappingAMR> input = CreateInput(maximumLevel);
+  cout << "Blocks: " << input->GetTotalNumberOfBlocks() << endl;
+
+  const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int merge = 0; merge < 2; ++merge)
+  {
+    vtkSMPTools::Initialize(1);
+    Output reference;
+    const double referenceTime = Execute(input, merge == 1, reference);
+    cout << "MergePoints: " << merge << ", " << reference.Points.size() / 3 << " points" << endl;
+    cout << "Threads: 1 " << referenceTime << "s" << endl;
+    if (reference.Polys.empty())
+    {
+      cerr << "ERROR: empty contour." << endl;
+      return EXIT_FAILURE;
+    }
+
+    for (int numThreads = 2; numThreads <= maxThreads; numThreads *= 2)
+    {
+      vtkSMPTools::Initialize(numThreads);
+      Output output;
+      const double time = Execute(input, merge == 1, output);
+      cout << "Threads: " << numThreads << " " << time << "s, speedup "
+           << (time > 0 ? referenceTime / time : 0.0) << endl;
+      if (output != reference)
+      {
+        cerr << "ERROR: output with " << numThreads
+             << " threads differs from the output with 1 thread." << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -35,17 +35,26 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataSet.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
+// Threading
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include <algorithm>
 #include <ctime>
 #include <math.h>
+#include <memory>
+#include <unordered_map>
 
 vtkStandardNewMacro(vtkAMRDualContour);
 
@@ -56,6 +65,19 @@ static int vtkAMRDualIsoEdgeToPointsTable[12][2] = { { 0, 1 }, { 1, 3 }, { 2, 3
 static int vtkAMRDualIsoEdgeToVTKPointsTable[12][2] = { { 0, 1 }, { 1, 2 }, { 3, 2 }, { 0, 3 },
   { 4, 5 }, { 5, 6 }, { 7, 6 }, { 4, 7 }, { 0, 4 }, { 1, 5 }, { 3, 7 }, { 2, 6 } };
 
+// Blocks are contoured concurrently, so the ids of the points a block creates
+// are not known until its output is appended to the mesh. Until then they are
+// stored in the locators as -(localId + 2), which cannot be mixed up with -1
+// (no point yet) or with the ids of points appended earlier.
+static inline vtkIdType vtkAMRDualContourEncodeId(vtkIdType localId)
+{
+  return -localId - 2;
+}
+static inline vtkIdType vtkAMRDualContourResolveId(vtkIdType id, vtkIdType pointOffset)
+{
+  return id < -1 ? pointOffset - id - 2 : id;
+}
+
 // It is working but we have some missing features.
 // 1: Make a Clip Filter
 // 2: Merge points.
@@ -100,8 +122,11 @@ public:
   void SharePointIdsWithNeighbor(
     vtkAMRDualContourEdgeLocator* neighborLocator, int rx, int ry, int rz);
 
-  void ShareBlockLocatorWithNeighbor(
-    vtkAMRDualGridHelperBlock* block, vtkAMRDualGridHelperBlock* neighbor);
+  // Description:
+  // Point ids created by the block are resolved with pointOffset, the id of
+  // the first point of the block in the mesh.
+  void ShareBlockLocatorWithNeighbor(vtkAMRDualGridHelperBlock* block,
+    vtkAMRDualGridHelperBlock* neighbor, vtkIdType pointOffset);
 
 private:
   int DualCellDimensions[3];
@@ -459,8 +484,8 @@ vtkAMRDualContourEdgeLocator* vtkAMRDualContourGetBlockLocator(vtkAMRDualGridHel
 
 //----------------------------------------------------------------------------
 // This version works with higher level neighbor blocks.
-void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
-  vtkAMRDualGridHelperBlock* block, vtkAMRDualGridHelperBlock* neighbor)
+void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(vtkAMRDualGridHelperBlock* block,
+  vtkAMRDualGridHelperBlock* neighbor, vtkIdType pointOffset)
 {
   vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
   vtkAMRDualContourEdgeLocator* neighborLocator = vtkAMRDualContourGetBlockLocator(neighbor);
@@ -579,22 +604,22 @@ void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
         }
         outOffsetX = outOffsetY + xOut;
 
-        pointId = blockLocator->XEdges[inOffsetX];
+        pointId = vtkAMRDualContourResolveId(blockLocator->XEdges[inOffsetX], pointOffset);
         if (pointId >= 0)
         {
           neighborLocator->XEdges[outOffsetX] = pointId;
         }
-        pointId = blockLocator->YEdges[inOffsetX];
+        pointId = vtkAMRDualContourResolveId(blockLocator->YEdges[inOffsetX], pointOffset);
         if (pointId >= 0)
         {
           neighborLocator->YEdges[outOffsetX] = pointId;
         }
-        pointId = blockLocator->ZEdges[inOffsetX];
+        pointId = vtkAMRDualContourResolveId(blockLocator->ZEdges[inOffsetX], pointOffset);
         if (pointId >= 0)
         {
           neighborLocator->ZEdges[outOffsetX] = pointId;
         }
-        pointId = blockLocator->Corners[inOffsetX];
+        pointId = vtkAMRDualContourResolveId(blockLocator->Corners[inOffsetX], pointOffset);
         if (pointId >= 0)
         {
           neighborLocator->Corners[outOffsetX] = pointId;
@@ -608,6 +633,31 @@ void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
   }
 }
 
+//============================================================================
+// Points and polygons generated for one block. The point ids in the polygons
+// are local to the block, or ids of points of blocks appended to the mesh
+// before (see vtkAMRDualContourEncodeId).
+class vtkAMRDualContour::BlockOutput
+{
+public:
+  BlockOutput() { this->Mesh->SetPoints(this->Points); }
+
+  void InsertNextCell(vtkIdType npts, const vtkIdType* pts)
+  {
+    this->Connectivity.insert(this->Connectivity.end(), pts, pts + npts);
+    this->Offsets.push_back(static_cast<vtkIdType>(this->Connectivity.size()));
+  }
+
+  int BlockId = 0;
+  bool Contoured = false;
+  vtkAMRDualContourEdgeLocator* Locator = nullptr;
+  // Holds the points and their attributes.
+  vtkNew<vtkPolyData> Mesh;
+  vtkNew<vtkPoints> Points;
+  std::vector<vtkIdType> Offsets = std::vector<vtkIdType>(1, 0);
+  std::vector<vtkIdType> Connectivity;
+};
+
 //============================================================================
 //----------------------------------------------------------------------------
 // Description:
@@ -633,18 +683,11 @@ vtkAMRDualContour::vtkAMRDualContour()
   this->TemperatureArray = 0;
   this->BlockIdCellArray = 0;
   this->Helper = 0;
-
-  this->BlockLocator = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkAMRDualContour::~vtkAMRDualContour()
 {
-  if (this->BlockLocator)
-  {
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
-  }
   this->SetController(NULL);
 }
 
@@ -809,16 +852,141 @@ vtkMultiBlockDataSet* vtkAMRDualContour::DoRequestData(
   // Loop through blocks
   int numLevels = hbdsInput->GetNumberOfLevels();
 
-  // Add each block.
+  // Collect the local blocks, low levels first.
+  std::vector<vtkAMRDualGridHelperBlock*> blocks;
+  std::vector<int> blockIds;
   for (int level = 0; level < numLevels; ++level)
   {
     int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
     for (int blockId = 0; blockId < numBlocks; ++blockId)
     {
       vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      // Remote blocks are only to setup local block bit flags.
+      if (block->Image)
+      {
+        blocks.push_back(block);
+        blockIds.push_back(blockId);
+      }
+    }
+  }
+
+  // Blocks are contoured in waves. Blocks of the same wave are contoured
+  // concurrently, then their outputs are appended in block order. When points
+  // are merged, a block receives the point ids of the neighbors processed
+  // before it, so it has to be in a later wave than all of them.
+  std::vector<int> blockWaves(blocks.size(), 0);
+  int numWaves = blocks.empty() ? 0 : 1;
+  if (this->EnableMergePoints)
+  {
+    std::unordered_map<vtkAMRDualGridHelperBlock*, size_t> blockIndices;
+    for (size_t cc = 0; cc < blocks.size(); ++cc)
+    {
+      blockIndices[blocks[cc]] = cc;
+    }
+    std::vector<vtkAMRDualGridHelperBlock*> neighbors;
+    for (size_t cc = 0; cc < blocks.size(); ++cc)
+    {
+      this->GetBlockNeighbors(blocks[cc], neighbors);
+      for (vtkAMRDualGridHelperBlock* neighbor : neighbors)
+      {
+        auto iter = blockIndices.find(neighbor);
+        if (iter != blockIndices.end() && iter->second > cc)
+        {
+          blockWaves[iter->second] = std::max(blockWaves[iter->second], blockWaves[cc] + 1);
+        }
+      }
+      numWaves = std::max(numWaves, blockWaves[cc] + 1);
+    }
+  }
+  std::vector<std::vector<size_t> > waves(numWaves);
+  for (size_t cc = 0; cc < blocks.size(); ++cc)
+  {
+    waves[blockWaves[cc]].push_back(cc);
+  }
+
+  // Without merging, a locator is reinitialized for each block.
+  vtkSMPThreadLocal<std::shared_ptr<vtkAMRDualContourEdgeLocator> > threadLocators;
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> connectivity;
+  offsets->InsertNextValue(0);
+  vtkPointData* outPD = this->Mesh->GetPointData();
+
+  for (const std::vector<size_t>& wave : waves)
+  {
+    std::vector<BlockOutput> outputs(wave.size());
+    vtkSMPTools::For(0, static_cast<vtkIdType>(wave.size()), 1,
+      [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+          BlockOutput& output = outputs[cc];
+          output.BlockId = blockIds[wave[cc]];
+          if (!this->EnableMergePoints)
+          {
+            std::shared_ptr<vtkAMRDualContourEdgeLocator>& locator = threadLocators.Local();
+            if (!locator)
+            {
+              locator = std::make_shared<vtkAMRDualContourEdgeLocator>();
+            }
+            output.Locator = locator.get();
+          }
+          this->ProcessBlock(blocks[wave[cc]], arrayNameToProcess, output);
+        }
+      });
+
+    for (size_t cc = 0; cc < wave.size(); ++cc)
+    {
+      BlockOutput& output = outputs[cc];
+      if (!output.Contoured)
+      {
+        continue;
+      }
+      const vtkIdType pointOffset = this->Points->GetNumberOfPoints();
+      const vtkIdType numBlockPoints = output.Points->GetNumberOfPoints();
+      if (numBlockPoints > 0)
+      {
+        this->Points->InsertPoints(pointOffset, numBlockPoints, 0, output.Points);
+        vtkPointData* blockPD = output.Mesh->GetPointData();
+        for (int idx = 0; idx < outPD->GetNumberOfArrays(); ++idx)
+        {
+          vtkAbstractArray* outArray = outPD->GetAbstractArray(idx);
+          vtkAbstractArray* blockArray =
+            outArray->GetName() ? blockPD->GetAbstractArray(outArray->GetName()) : nullptr;
+          if (blockArray)
+          {
+            outArray->InsertTuples(pointOffset, numBlockPoints, 0, blockArray);
+          }
+        }
+      }
+      const vtkIdType connectivityOffset = connectivity->GetNumberOfValues();
+      for (size_t idx = 1; idx < output.Offsets.size(); ++idx)
+      {
+        offsets->InsertNextValue(connectivityOffset + output.Offsets[idx]);
+        this->BlockIdCellArray->InsertNextValue(output.BlockId);
+      }
+      for (vtkIdType ptId : output.Connectivity)
+      {
+        connectivity->InsertNextValue(vtkAMRDualContourResolveId(ptId, pointOffset));
+      }
+
+      if (this->EnableMergePoints)
+      {
+        vtkAMRDualGridHelperBlock* block = blocks[wave[cc]];
+        // Copy point ids into neighbor locators.
+        this->ShareBlockLocatorWithNeighbors(block, pointOffset);
+        // We are done.  We no longer need the locator for this block.
+        delete output.Locator;
+        block->UserData = 0;
+        // Lets use this unused flag (owner of center region/block) to indicate
+        // that the block is already processes.
+        // This will keep neighbors from recreating the locator.
+        // Another option would be to create the locator object for
+        // all blocks but do not allocate until needed.  Then the existence of the locator
+        // would tell whether the block was processed.
+        block->RegionBits[1][1][1] = 0;
+      }
     }
   }
+  this->Faces->SetData(offsets, connectivity);
 
   this->FinalizeCopyAttributes(this->Mesh);
   this->BlockIdCellArray->Delete();
@@ -837,8 +1005,10 @@ vtkMultiBlockDataSet* vtkAMRDualContour::DoRequestData(
 }
 
 //----------------------------------------------------------------------------
-void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(vtkAMRDualGridHelperBlock* block)
+void vtkAMRDualContour::GetBlockNeighbors(
+  vtkAMRDualGridHelperBlock* block, std::vector<vtkAMRDualGridHelperBlock*>& neighbors)
 {
+  neighbors.clear();
   vtkAMRDualGridHelperBlock* neighbor;
   // Blocks are processed low level to high so, we only need to share
   // the locator with blocks in the same level or higher.
@@ -870,11 +1040,9 @@ void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(vtkAMRDualGridHelperBlock
           if ((ix >> levelDiff) != xMid || (iy >> levelDiff) != yMid || (iz >> levelDiff) != zMid)
           {
             neighbor = this->Helper->GetBlock(level, ix, iy, iz);
-            // The unused center flag is used as a flag to indicate
-            if (neighbor && neighbor->Image && neighbor->RegionBits[1][1][1])
+            if (neighbor && neighbor->Image)
             {
-              vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
-              blockLocator->ShareBlockLocatorWithNeighbor(block, neighbor);
+              neighbors.push_back(neighbor);
             }
           }
         }
@@ -884,8 +1052,27 @@ void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(vtkAMRDualGridHelperBlock
 }
 
 //----------------------------------------------------------------------------
+void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
+  vtkAMRDualGridHelperBlock* block, vtkIdType pointOffset)
+{
+  std::vector<vtkAMRDualGridHelperBlock*> neighbors;
+  this->GetBlockNeighbors(block, neighbors);
+  for (vtkAMRDualGridHelperBlock* neighbor : neighbors)
+  {
+    // The unused center flag is used as a flag to indicate
+    // that the neighbor is already processed.
+    if (neighbor->RegionBits[1][1][1])
+    {
+      vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
+      blockLocator->ShareBlockLocatorWithNeighbor(block, neighbor, pointOffset);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// This is called concurrently for the blocks of a wave (see DoRequestData).
 void vtkAMRDualContour::ProcessBlock(
-  vtkAMRDualGridHelperBlock* block, int blockId, const char* arrayNameToProcess)
+  vtkAMRDualGridHelperBlock* block, const char* arrayNameToProcess, BlockOutput& output)
 {
   vtkImageData* image = block->Image;
   if (image == 0)
@@ -916,18 +1103,16 @@ void vtkAMRDualContour::ProcessBlock(
   // Input the dimensions of the dual cells with ghosts.
   if (this->EnableMergePoints)
   {
-    this->BlockLocator = vtkAMRDualContourGetBlockLocator(block);
+    output.Locator = vtkAMRDualContourGetBlockLocator(block);
   }
   else
-  { // Shared locator.
-    if (this->BlockLocator == 0)
-    {
-      this->BlockLocator = new vtkAMRDualContourEdgeLocator;
-    }
-    this->BlockLocator->Initialize(
+  { // Locator shared by the blocks processed by this thread.
+    output.Locator->Initialize(
       extent[1] - extent[0], extent[3] - extent[2], extent[5] - extent[4]);
-    this->BlockLocator->CopyRegionLevelDifferences(block);
+    output.Locator->CopyRegionLevelDifferences(block);
   }
+  output.Mesh->GetPointData()->CopyAllocate(image->GetCellData());
+  output.Contoured = true;
   image->GetOrigin(origin);
   spacing = image->GetSpacing();
   // Dual cells are shifted half a pixel.
@@ -1007,7 +1192,7 @@ void vtkAMRDualContour::ProcessBlock(
           cornerOffsets[5] = xOffset + 1 + zInc;
           cornerOffsets[6] = xOffset + 1 + yInc + zInc;
           cornerOffsets[7] = xOffset + yInc + zInc;
-          this->ProcessDualCell(block, blockId, x, y, z, cornerOffsets, volumeFractionArray);
+          this->ProcessDualCell(block, x, y, z, cornerOffsets, volumeFractionArray, output);
         }
         xOffset += 1; // xInc
       }
@@ -1015,23 +1200,8 @@ void vtkAMRDualContour::ProcessBlock(
     }
     zOffset += zInc;
   }
-
-  if (this->EnableMergePoints)
-  {
-    // Copy point ids into neighbor locators.
-    this->ShareBlockLocatorWithNeighbors(block);
-    // We are done.  We no longer need the locator for this block.
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
-    block->UserData = 0;
-    // Lets use this unused flag (owner of center region/block) to indicate
-    // that the block is already processes.
-    // This will keep neighbors from recreating the locator.
-    // Another option would be to create the locator object for
-    // all blocks but do not allocate until needed.  Then the existence of the locator
-    // would tell whether the block was processed.
-    block->RegionBits[1][1][1] = 0;
-  }
+  // When points are merged, the locator is shared with the neighbors once
+  // the output is appended to the mesh.
 }
 
 //----------------------------------------------------------------------------
@@ -1091,8 +1261,8 @@ static int vtkAMRDualLegacyIdToBitIdMap[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
 // Not implemented as optimally as we could.  It can be improved by making
 // a fast path for internal cells (with no degeneracies).
 // Corner offsets are absolute (relative to origin / 0).
-void vtkAMRDualContour::ProcessDualCell(vtkAMRDualGridHelperBlock* block, int blockId, int x, int y,
-  int z, vtkIdType cornerOffsets[8], vtkDataArray* volumeFractionArray)
+void vtkAMRDualContour::ProcessDualCell(vtkAMRDualGridHelperBlock* block, int x, int y, int z,
+  vtkIdType cornerOffsets[8], vtkDataArray* volumeFractionArray, BlockOutput& output)
 {
   // compute the case index
   vtkImageData* image = block->Image;
@@ -1329,7 +1499,7 @@ void vtkAMRDualContour::ProcessDualCell(vtkAMRDualGridHelperBlock* block, int bl
     // Only permanently keep locator for edges shared between two blocks.
     for (int ii = 0; ii < 3; ++ii, ++edge) // insert triangle
     {
-      vtkIdType* ptIdPtr = this->BlockLocator->GetEdgePointer(x, y, z, *edge);
+      vtkIdType* ptIdPtr = output.Locator->GetEdgePointer(x, y, z, *edge);
 
       if (*ptIdPtr == -1)
       {
@@ -1357,31 +1527,31 @@ void vtkAMRDualContour::ProcessDualCell(vtkAMRDualGridHelperBlock* block, int bl
           cornerPoints[pt1Idx | 1] + k * (cornerPoints[pt2Idx | 1] - cornerPoints[pt1Idx | 1]);
         pt[2] =
           cornerPoints[pt1Idx | 2] + k * (cornerPoints[pt2Idx | 2] - cornerPoints[pt1Idx | 2]);
-        *ptIdPtr = this->Points->InsertNextPoint(pt);
+        vtkIdType localId = output.Points->InsertNextPoint(pt);
+        *ptIdPtr = vtkAMRDualContourEncodeId(localId);
         // Interpolate attributes
         // Find the offsets of the two attributes to interpolate
         vtkIdType offset0 = cornerOffsets[vtkAMRDualIsoEdgeToVTKPointsTable[*edge][0]];
         vtkIdType offset1 = cornerOffsets[vtkAMRDualIsoEdgeToVTKPointsTable[*edge][1]];
-        this->InterpolateAttributes(block->Image, offset0, offset1, k, this->Mesh, *ptIdPtr);
+        this->InterpolateAttributes(block->Image, offset0, offset1, k, output.Mesh, localId);
       }
       edgePointIds[*edge] = pointIds[ii] = *ptIdPtr;
     }
     if (pointIds[0] != pointIds[1] && pointIds[0] != pointIds[2] && pointIds[1] != pointIds[2])
     {
-      this->Faces->InsertNextCell(3, pointIds);
-      this->BlockIdCellArray->InsertNextValue(blockId);
+      output.InsertNextCell(3, pointIds);
     }
   }
 
   if (this->EnableCapping)
   {
     this->CapCell(x, y, z, cubeBoundaryBits, cubeCase, edgePointIds, cornerPoints, cornerOffsets,
-      blockId, block->Image);
+      output, block->Image);
   }
 }
 
 //----------------------------------------------------------------------------
-void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int blockId)
+void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, BlockOutput& output)
 {
   if (this->TriangulateCap)
   {
@@ -1397,8 +1567,7 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
         tri[2] = pointIds[low];
         if (tri[0] != tri[1] && tri[0] != tri[2] && tri[1] != tri[2])
         {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          output.InsertNextCell(3, tri);
         }
       }
       else
@@ -1408,16 +1577,14 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
         tri[2] = pointIds[low];
         if (tri[0] != tri[1] && tri[0] != tri[2] && tri[1] != tri[2])
         {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          output.InsertNextCell(3, tri);
         }
         tri[0] = pointIds[high];
         tri[1] = pointIds[high + 1];
         tri[2] = pointIds[low];
         if (tri[0] != tri[1] && tri[0] != tri[2] && tri[1] != tri[2])
         {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          output.InsertNextCell(3, tri);
         }
       }
       ++low;
@@ -1427,8 +1594,7 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
   else
   {
     // Do not worry about degenerate polygons in this path.
-    this->Faces->InsertNextCell(ptCount, pointIds);
-    this->BlockIdCellArray->InsertNextValue(blockId);
+    output.InsertNextCell(ptCount, pointIds);
   }
 }
 
@@ -1450,8 +1616,8 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
   double cornerPoints[32],
   // The id order is VTK from marching cube cases.  Different than axis ordered "cornerPoints".
   vtkIdType cornerOffsets[8],
-  // For block id array (for debugging).  I should just make this an ivar.
-  int blockId,
+  // Locator, points and polygons of the block.
+  BlockOutput& output,
   // For passing attributes to output mesh
   vtkDataSet* inData)
 {
@@ -1472,12 +1638,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoNXCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1487,7 +1654,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
@@ -1508,12 +1675,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoPXCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1523,7 +1691,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
@@ -1545,12 +1713,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoNYCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1560,7 +1729,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
@@ -1582,12 +1751,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoPYCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1597,7 +1767,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
@@ -1618,12 +1788,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoNZCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1633,7 +1804,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
@@ -1655,12 +1826,13 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         if (*capPtr < 4)
         {
           cornerIdx = (vtkAMRDualIsoPZCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
+          ptIdPtr = output.Locator->GetCornerPointer(cellX, cellY, cellZ, cornerIdx);
           if (*ptIdPtr == -1)
           {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            vtkIdType localId = output.Points->InsertNextPoint(cornerPoints + (cornerIdx << 2));
+            *ptIdPtr = vtkAMRDualContourEncodeId(localId);
             this->CopyAttributes(
-              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], this->Mesh, *ptIdPtr);
+              inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]], output.Mesh, localId);
           }
           pointIds[ptCount++] = *ptIdPtr;
         }
@@ -1670,7 +1842,7 @@ void vtkAMRDualContour::CapCell(int cellX, int cellY, int cellZ, // cell index i
         }
         ++capPtr;
       }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(ptCount, pointIds, output);
       if (*capPtr == -1)
       {
         ++capPtr;
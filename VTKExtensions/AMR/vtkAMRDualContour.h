@@ -152,14 +152,25 @@ protected:
   int FillInputPortInformation(int port, vtkInformation* info) override;
   int FillOutputPortInformation(int port, vtkInformation* info) override;
 
-  void ShareBlockLocatorWithNeighbors(vtkAMRDualGridHelperBlock* block);
+  // Blocks are contoured concurrently, each into its own BlockOutput, and the
+  // outputs are appended to the mesh in block order (see DoRequestData).
+  class BlockOutput;
 
-  void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId, const char* arrayName);
+  /**
+   * Blocks of the same or higher levels, around the block, that the block
+   * shares its locator with when points are merged.
+   */
+  void GetBlockNeighbors(
+    vtkAMRDualGridHelperBlock* block, std::vector<vtkAMRDualGridHelperBlock*>& neighbors);
+
+  void ShareBlockLocatorWithNeighbors(vtkAMRDualGridHelperBlock* block, vtkIdType pointOffset);
 
-  void ProcessDualCell(vtkAMRDualGridHelperBlock* block, int blockId, int x, int y, int z,
-    vtkIdType cornerOffsets[8], vtkDataArray* volumeFractionArray);
+  void ProcessBlock(vtkAMRDualGridHelperBlock* block, const char* arrayName, BlockOutput& output);
 
-  void AddCapPolygon(int ptCount, vtkIdType* pointIds, int blockId);
+  void ProcessDualCell(vtkAMRDualGridHelperBlock* block, int x, int y, int z,
+    vtkIdType cornerOffsets[8], vtkDataArray* volumeFractionArray, BlockOutput& output);
+
+  void AddCapPolygon(int ptCount, vtkIdType* pointIds, BlockOutput& output);
 
   // This method is getting too many arguments!
   // Capping was an after thought...
@@ -174,8 +185,8 @@ protected:
     double cornerPoints[32],
     // The id order is VTK from marching cube cases.  Different than axis ordered "cornerPoints".
     vtkIdType cornerOffsets[8],
-    // For block id array (for debugging).  I should just make this an ivar.
-    int blockId,
+    // Locator, points and polygons of the block.
+    BlockOutput& output,
     // For passing attributes to output mesh
     vtkDataSet* inData);
 
@@ -196,8 +207,6 @@ protected:
   int* MessageBuffer;
   int* MessageBufferLength;
 
-  vtkAMRDualContourEdgeLocator* BlockLocator;
-
   // Stuff for passing cell attributes to point attributes.
   void InitializeCopyAttributes(vtkNonOverlappingAMR* hbdsInput, vtkDataSet* mesh);
   void InterpolateAttributes(vtkDataSet* uGrid, vtkIdType offset0, vtkIdType offset1, double k,
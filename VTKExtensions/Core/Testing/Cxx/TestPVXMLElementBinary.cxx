@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVXMLElementBinary.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkSmartPointer.h"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+const char* XML = "<ServerManagerConfiguration>\n"
+                  "  <ProxyGroup name=\"sources\">\n"
+                  "    <SourceProxy name=\"Sphere\" class=\"vtkSphereSource\" label=\"Sphere\">\n"
+                  "      <DoubleVectorProperty name=\"Center\" command=\"SetCenter\"\n"
+                  "        number_of_elements=\"3\" default_values=\"0 0 0\">\n"
+                  "        <DoubleRangeDomain name=\"range\" />\n"
+                  "        <Documentation>Center of the &quot;sphere&quot;.</Documentation>\n"
+                  "      </DoubleVectorProperty>\n"
+                  "      <Hints><ShowInMenu category=\"Alphabetical\" /></Hints>\n"
+                  "    </SourceProxy>\n"
+                  "  </ProxyGroup>\n"
+                  "</ServerManagerConfiguration>\n";
+
+std::string ToXML(vtkPVXMLElement* element)
+{
+  std::ostringstream stream;
+  element->PrintXML(stream, vtkIndent());
+  return stream.str();
+}
+}
+
+int TestPVXMLElementBinary(int, char* [])
+{
+  vtkNew<vtkPVXMLParser> parser;
+  if (!parser->Parse(XML))
+  {
+    cerr << "ERROR: failed to parse the XML." << endl;
+    return EXIT_FAILURE;
+  }
+  vtkPVXMLElement* root = parser->GetRootElement();
+  vtkPVXMLElement* proxy = root->GetNestedElement(0)->GetNestedElement(0);
+
+  // two elements in the same buffer, as vtkSIProxyDefinitionManager does.
+  std::string buffer;
+  root->WriteBinary(buffer);
+  const size_t rootSize = buffer.size();
+  proxy->WriteBinary(buffer);
+
+  vtkSmartPointer<vtkPVXMLElement> newRoot;
+  newRoot.TakeReference(vtkPVXMLElement::NewFromBinary(buffer.c_str(), rootSize));
+  vtkSmartPointer<vtkPVXMLElement> newProxy;
+  newProxy.TakeReference(
+    vtkPVXMLElement::NewFromBinary(buffer.c_str() + rootSize, buffer.size() - rootSize));
+  if (!newRoot || !newProxy)
+  {
+    cerr << "ERROR: failed to read the binary form." << endl;
+    return EXIT_FAILURE;
+  }
+  if (!newRoot->Equals(root) || ToXML(newRoot) != ToXML(root) || !newProxy->Equals(proxy) ||
+    ToXML(newProxy) != ToXML(proxy))
+  {
+    cerr << "ERROR: elements differ after the round trip." << endl
+         << ToXML(newRoot) << endl;
+    return EXIT_FAILURE;
+  }
+
+  // the nested elements are linked to their parent.
+  vtkPVXMLElement* property = newProxy->FindNestedElementByName("DoubleVectorProperty");
+  if (!property || property->GetParent() != newProxy.GetPointer() ||
+    property->GetAttribute("default_values") != std::string("0 0 0"))
+  {
+    cerr << "ERROR: invalid nested element." << endl;
+    return EXIT_FAILURE;
+  }
+  vtkPVXMLElement* documentation = property->FindNestedElementByName("Documentation");
+  if (!documentation ||
+    documentation->GetCharacterData() != std::string("Center of the \"sphere\"."))
+  {
+    cerr << "ERROR: invalid character data." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // truncated data is rejected.
+  for (size_t length = 0; length < rootSize; ++length)
+  {
+    vtkPVXMLElement* truncated = vtkPVXMLElement::NewFromBinary(buffer.c_str(), length);
+    if (truncated)
+    {
+      cerr << "ERROR: truncated data of " << length << " bytes accepted." << endl;
+      truncated->Delete();
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -15,12 +15,14 @@
 #include "vtkPVXMLElement.h"
 
 #include "vtkCollection.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
 
 vtkStandardNewMacro(vtkPVXMLElement);
 
 #include <ctype.h>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -749,6 +751,177 @@ void vtkPVXMLElement::CopyAttributesTo(vtkPVXMLElement* other)
     this->Internal->CharacterData.c_str(), static_cast<int>(this->Internal->CharacterData.size()));
 }
 
+//----------------------------------------------------------------------------
+// Binary form used by WriteBinary/NewFromBinary. Strings are stored as their
+// length followed by their characters, NULL strings have the length
+// NullStringLength. An element is stored as its name, id, attributes
+// (count, then names and values), character data and nested elements
+// (count, then the elements).
+namespace
+{
+const vtkTypeUInt32 NullStringLength = 0xffffffff;
+
+void WriteBinaryValue(std::string& buffer, vtkTypeUInt32 value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteBinaryString(std::string& buffer, const char* str, size_t length)
+{
+  if (!str)
+  {
+    WriteBinaryValue(buffer, NullStringLength);
+    return;
+  }
+  WriteBinaryValue(buffer, static_cast<vtkTypeUInt32>(length));
+  buffer.append(str, length);
+}
+
+void WriteBinaryString(std::string& buffer, const std::string& str)
+{
+  WriteBinaryString(buffer, str.c_str(), str.size());
+}
+
+struct vtkPVXMLBinaryReader
+{
+  const char* Position;
+  const char* End;
+
+  bool Read(vtkTypeUInt32& value)
+  {
+    if (static_cast<size_t>(this->End - this->Position) < sizeof(value))
+    {
+      return false;
+    }
+    memcpy(&value, this->Position, sizeof(value));
+    this->Position += sizeof(value);
+    return true;
+  }
+
+  // `isNull` is set for NULL strings.
+  bool Read(std::string& str, bool& isNull)
+  {
+    vtkTypeUInt32 length;
+    if (!this->Read(length))
+    {
+      return false;
+    }
+    isNull = (length == NullStringLength);
+    if (isNull)
+    {
+      str.clear();
+      return true;
+    }
+    if (static_cast<size_t>(this->End - this->Position) < length)
+    {
+      return false;
+    }
+    str.assign(this->Position, length);
+    this->Position += length;
+    return true;
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+void vtkPVXMLElement::WriteBinary(std::string& buffer)
+{
+  WriteBinaryString(buffer, this->Name, this->Name ? strlen(this->Name) : 0);
+  WriteBinaryString(buffer, this->Id, this->Id ? strlen(this->Id) : 0);
+
+  WriteBinaryValue(buffer, static_cast<vtkTypeUInt32>(this->Internal->AttributeNames.size()));
+  for (size_t cc = 0; cc < this->Internal->AttributeNames.size(); ++cc)
+  {
+    WriteBinaryString(buffer, this->Internal->AttributeNames[cc]);
+    WriteBinaryString(buffer, this->Internal->AttributeValues[cc]);
+  }
+  WriteBinaryString(buffer, this->Internal->CharacterData);
+
+  WriteBinaryValue(buffer, static_cast<vtkTypeUInt32>(this->Internal->NestedElements.size()));
+  for (auto& nested : this->Internal->NestedElements)
+  {
+    nested->WriteBinary(buffer);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVXMLElement::ReadBinary(const char*& position, const char* end)
+{
+  // smallest possible element: empty strings and no attributes or nested
+  // elements.
+  const size_t minimumElementSize = 5 * sizeof(vtkTypeUInt32);
+  const size_t minimumAttributeSize = 2 * sizeof(vtkTypeUInt32);
+
+  vtkPVXMLBinaryReader reader = { position, end };
+  std::string str;
+  bool isNull;
+  if (!reader.Read(str, isNull))
+  {
+    return false;
+  }
+  this->SetName(isNull ? nullptr : str.c_str());
+  if (!reader.Read(str, isNull))
+  {
+    return false;
+  }
+  this->SetId(isNull ? nullptr : str.c_str());
+
+  vtkTypeUInt32 count;
+  if (!reader.Read(count) ||
+    count > static_cast<size_t>(reader.End - reader.Position) / minimumAttributeSize)
+  {
+    return false;
+  }
+  this->Internal->AttributeNames.resize(count);
+  this->Internal->AttributeValues.resize(count);
+  for (vtkTypeUInt32 cc = 0; cc < count; ++cc)
+  {
+    if (!reader.Read(this->Internal->AttributeNames[cc], isNull) ||
+      !reader.Read(this->Internal->AttributeValues[cc], isNull))
+    {
+      return false;
+    }
+  }
+  if (!reader.Read(this->Internal->CharacterData, isNull))
+  {
+    return false;
+  }
+
+  if (!reader.Read(count) ||
+    count > static_cast<size_t>(reader.End - reader.Position) / minimumElementSize)
+  {
+    return false;
+  }
+  for (vtkTypeUInt32 cc = 0; cc < count; ++cc)
+  {
+    vtkNew<vtkPVXMLElement> nested;
+    if (!nested->ReadBinary(reader.Position, reader.End))
+    {
+      return false;
+    }
+    this->AddNestedElement(nested.GetPointer());
+  }
+  position = reader.Position;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkPVXMLElement* vtkPVXMLElement::NewFromBinary(const char* data, size_t length)
+{
+  if (!data)
+  {
+    return nullptr;
+  }
+  const char* position = data;
+  vtkPVXMLElement* element = vtkPVXMLElement::New();
+  if (!element->ReadBinary(position, data + length) || position != data + length)
+  {
+    element->Delete();
+    return nullptr;
+  }
+  return element;
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVXMLElement::Equals(vtkPVXMLElement* other)
 {
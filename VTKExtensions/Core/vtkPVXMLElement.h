@@ -263,6 +263,19 @@ public:
    */
   void CopyAttributesTo(vtkPVXMLElement* other);
 
+  //@{
+  /**
+   * Serialize the element and its nested elements in a compact binary form
+   * appended to `buffer`, and create an element from such data. This is much
+   * faster than printing and parsing XML, and is meant for caches of parsed
+   * XML. The binary form depends on the platform. NewFromBinary returns NULL
+   * if the data are invalid.
+   */
+  void WriteBinary(std::string& buffer);
+  VTK_NEWINSTANCE
+  static vtkPVXMLElement* NewFromBinary(const char* data, size_t length);
+  //@}
+
 protected:
   vtkPVXMLElement();
   ~vtkPVXMLElement() override;
@@ -280,6 +293,10 @@ protected:
   void ReadXMLAttributes(const char** atts);
   void AddCharacterData(const char* data, int length);
 
+  // Reads the binary form written by WriteBinary, starting at `position`,
+  // which is moved after the element.
+  bool ReadBinary(const char*& position, const char* end);
+
   // Internal utility methods.
   vtkPVXMLElement* LookupElementInScope(const char* id);
   vtkPVXMLElement* LookupElementUpScope(const char* id);
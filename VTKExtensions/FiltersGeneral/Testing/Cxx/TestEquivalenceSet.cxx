@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestEquivalenceSet.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkEquivalenceSet.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+
+#include <vector>
+
+#define vtk_assert(x)                                                                              \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << "On line " << __LINE__ << " ERROR: Condition FAILED!! : " << #x << endl;               \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// Members of a 1D grid are equivalent to their next neighbor, except across
+// multiples of `Period`, which are alone in their set.
+const vtkIdType NumberOfMembers = 1000000;
+const vtkIdType Period = 1000;
+
+bool Connected(vtkIdType id)
+{
+  return id % Period != 0 && (id + 1) % Period != 0;
+}
+
+// The expected set id of a member, sets being numbered by their smallest
+// member.
+vtkIdType ExpectedSetId(vtkIdType id)
+{
+  // each period holds two sets: {0} and {1, ..., Period - 1}.
+  return 2 * (id / Period) + (id % Period == 0 ? 0 : 1);
+}
+
+int CheckResolved(vtkEquivalenceSet* set)
+{
+  vtk_assert(set->ResolveEquivalences() == 2 * (NumberOfMembers / Period));
+  vtk_assert(set->GetNumberOfResolvedSets() == 2 * (NumberOfMembers / Period));
+  for (vtkIdType id = 0; id < NumberOfMembers; ++id)
+  {
+    vtk_assert(set->GetEquivalentSetId(id) == ExpectedSetId(id));
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestEquivalenceSet(int, char* [])
+{
+  // Serial unions, in decreasing order so that the roots are not the
+  // smallest members, and growing the set as needed.
+  vtkNew<vtkEquivalenceSet> serial;
+  for (vtkIdType id = NumberOfMembers - 2; id >= 0; --id)
+  {
+    serial->AddEquivalence(id, Connected(id) ? id + 1 : id);
+  }
+  serial->AddEquivalence(NumberOfMembers - 1, NumberOfMembers - 1);
+  vtk_assert(serial->GetNumberOfMembers() == NumberOfMembers);
+  vtk_assert(serial->GetEquivalentSetId(1) == serial->GetEquivalentSetId(Period - 2));
+  vtk_assert(serial->GetEquivalentSetId(1) != serial->GetEquivalentSetId(Period + 1));
+  vtkNew<vtkEquivalenceSet> copy;
+  copy->DeepCopy(serial);
+  if (CheckResolved(serial) != EXIT_SUCCESS || CheckResolved(copy) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Concurrent unions, from a vtkSMPTools loop.
+  vtkNew<vtkEquivalenceSet> concurrent;
+  concurrent->SetNumberOfMembers(NumberOfMembers);
+  vtkEquivalenceSet* set = concurrent;
+  vtkSMPTools::For(0, NumberOfMembers - 1, 1024, [set](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType id = end - 1; id >= begin; --id)
+    {
+      if (Connected(id))
+      {
+        set->AddEquivalenceConcurrent(id + 1, id);
+      }
+    }
+  });
+  if (CheckResolved(concurrent) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // No more equivalences once resolved.
+  concurrent->Squeeze();
+  vtk_assert(concurrent->Capacity() == NumberOfMembers);
+  vtk_assert(concurrent->GetEquivalentSetId(NumberOfMembers + 5) == NumberOfMembers + 5);
+  return EXIT_SUCCESS;
+}
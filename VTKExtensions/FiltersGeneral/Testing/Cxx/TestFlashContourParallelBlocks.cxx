@@ -0,0 +1,270 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFlashContourParallelBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkFlashContour, which contours the leaf blocks concurrently,
+// produces the same output whatever the number of threads. The input is a
+// synthetic FLASH block tree: 2x2x2 root blocks, each refined into 8 leaf
+// blocks, with the field data arrays the FLASH reader generates.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataObject.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFlashContour.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int CELLS_PER_BLOCK = 8;
+
+// Blocks of a level form a grid of `size`^3 blocks, indexed x first.
+int BlockIndex(int size, int x, int y, int z)
+{
+  if (x < 0 || y < 0 || z < 0 || x >= size || y >= size || z >= size)
+  {
+    return -1;
+  }
+  return x + size * (y + size * z);
+}
+
+vtkSmartPointer<vtkMultiBlockDataSet> CreateInput()
+{
+  // global ids: the 8 roots first, then the 8 children of each root.
+  const int numberOfRoots = 8;
+  const int numberOfBlocks = numberOfRoots * 9;
+
+  vtkNew<vtkIntArray> globalToLocalMap;
+  globalToLocalMap->SetName("GlobalToLocalMap");
+  globalToLocalMap->SetNumberOfTuples(numberOfBlocks);
+  vtkNew<vtkIntArray> children;
+  children->SetName("BlockChildren");
+  children->SetNumberOfComponents(8);
+  children->SetNumberOfTuples(numberOfBlocks);
+  children->Fill(-1);
+  vtkNew<vtkIntArray> neighbors;
+  neighbors->SetName("BlockNeighbors");
+  neighbors->SetNumberOfComponents(6);
+  neighbors->SetNumberOfTuples(numberOfBlocks);
+  vtkNew<vtkIntArray> levels;
+  levels->SetName("BlockLevel");
+  levels->SetNumberOfTuples(numberOfBlocks);
+
+  auto input = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  input->SetNumberOfBlocks(numberOfRoots * 8);
+
+  // global id of the block of the given level at the given grid position.
+  auto globalId = [](int level, int x, int y, int z) {
+    if (level == 1)
+    {
+      return BlockIndex(2, x, y, z);
+    }
+    const int root = BlockIndex(2, x >> 1, y >> 1, z >> 1);
+    if (root < 0)
+    {
+      return -1;
+    }
+    return numberOfRoots + 8 * root + ((x & 1) | ((y & 1) << 1) | ((z & 1) << 2));
+  };
+
+  for (int level = 1; level <= 2; ++level)
+  {
+    const int size = 2 * level;
+    const double blockSize = 1.0 / level;
+    for (int z = 0; z < size; ++z)
+    {
+      for (int y = 0; y < size; ++y)
+      {
+        for (int x = 0; x < size; ++x)
+        {
+          const int id = globalId(level, x, y, z);
+          levels->SetValue(id, level);
+          neighbors->SetTypedComponent(id, 0, globalId(level, x - 1, y, z));
+          neighbors->SetTypedComponent(id, 1, globalId(level, x + 1, y, z));
+          neighbors->SetTypedComponent(id, 2, globalId(level, x, y - 1, z));
+          neighbors->SetTypedComponent(id, 3, globalId(level, x, y + 1, z));
+          neighbors->SetTypedComponent(id, 4, globalId(level, x, y, z - 1));
+          neighbors->SetTypedComponent(id, 5, globalId(level, x, y, z + 1));
+          if (level == 1)
+          {
+            // not loaded, but its children are.
+            globalToLocalMap->SetValue(id, -1);
+            for (int child = 0; child < 8; ++child)
+            {
+              children->SetTypedComponent(id, child, numberOfRoots + 8 * id + child);
+            }
+            continue;
+          }
+
+          const int localId = id - numberOfRoots;
+          globalToLocalMap->SetValue(id, localId);
+          vtkNew<vtkImageData> image;
+          image->SetDimensions(CELLS_PER_BLOCK + 1, CELLS_PER_BLOCK + 1, CELLS_PER_BLOCK + 1);
+          const double spacing = blockSize / CELLS_PER_BLOCK;
+          image->SetSpacing(spacing, spacing, spacing);
+          image->SetOrigin(x * blockSize, y * blockSize, z * blockSize);
+          vtkNew<vtkDoubleArray> density;
+          density->SetName("density");
+          density->SetNumberOfTuples(image->GetNumberOfCells());
+          vtkNew<vtkDoubleArray> pressure;
+          pressure->SetName("pressure");
+          pressure->SetNumberOfTuples(image->GetNumberOfCells());
+          vtkIdType cellId = 0;
+          for (int k = 0; k < CELLS_PER_BLOCK; ++k)
+          {
+            for (int j = 0; j < CELLS_PER_BLOCK; ++j)
+            {
+              for (int i = 0; i < CELLS_PER_BLOCK; ++i, ++cellId)
+              {
+                const double center[3] = { x * blockSize + (i + 0.5) * spacing,
+                  y * blockSize + (j + 0.5) * spacing, z * blockSize + (k + 0.5) * spacing };
+                const double dx = center[0] - 1.0;
+                const double dy = center[1] - 1.0;
+                const double dz = center[2] - 1.0;
+                density->SetValue(cellId, std::sqrt(dx * dx + dy * dy + dz * dz));
+                pressure->SetValue(cellId, center[0]);
+              }
+            }
+          }
+          image->GetCellData()->AddArray(density);
+          image->GetCellData()->AddArray(pressure);
+          input->SetBlock(localId, image);
+        }
+      }
+    }
+  }
+
+  input->GetFieldData()->AddArray(globalToLocalMap);
+  input->GetFieldData()->AddArray(children);
+  input->GetFieldData()->AddArray(neighbors);
+  input->GetFieldData()->AddArray(levels);
+  return input;
+}
+
+struct Output
+{
+  std::vector<double> Points;
+  std::vector<vtkIdType> Polys;
+  std::vector<double> Pressure;
+  std::vector<int> BlockIds;
+
+  bool operator!=(const Output& other) const
+  {
+    return this->Points != other.Points || this->Polys != other.Polys ||
+      this->Pressure != other.Pressure || this->BlockIds != other.BlockIds;
+  }
+};
+
+bool Execute(vtkMultiBlockDataSet* input, Output& output)
+{
+  vtkNew<vtkFlashContour> contour;
+  contour->SetIsoValue(0.6);
+  contour->SetPassAttribute("pressure");
+  contour->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "density");
+  contour->SetInputData(input);
+  contour->Update();
+
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(contour->GetOutputDataObject(0));
+  vtkMultiPieceDataSet* mp = mb ? vtkMultiPieceDataSet::SafeDownCast(mb->GetBlock(0)) : nullptr;
+  vtkPolyData* pd = mp ? vtkPolyData::SafeDownCast(mp->GetPiece(0)) : nullptr;
+  vtkDataArray* pressure = pd ? pd->GetPointData()->GetArray("pressure") : nullptr;
+  vtkDataArray* blockIds = pd ? pd->GetCellData()->GetArray("GlobalBlockId") : nullptr;
+  if (!pressure || !blockIds)
+  {
+    cerr << "ERROR: missing output arrays." << endl;
+    return false;
+  }
+
+  for (vtkIdType ptId = 0; ptId < pd->GetNumberOfPoints(); ++ptId)
+  {
+    double pt[3];
+    pd->GetPoint(ptId, pt);
+    output.Points.insert(output.Points.end(), pt, pt + 3);
+    output.Pressure.push_back(pressure->GetTuple1(ptId));
+  }
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkCellArray* polys = pd->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    output.Polys.push_back(npts);
+    output.Polys.insert(output.Polys.end(), pts, pts + npts);
+  }
+  for (vtkIdType cellId = 0; cellId < blockIds->GetNumberOfTuples(); ++cellId)
+  {
+    output.BlockIds.push_back(static_cast<int>(blockIds->GetTuple1(cellId)));
+  }
+  return true;
+}
+}
+
+int TestFlashContourParallelBlocks(int, char* [])
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> input = CreateInput();
+
+  vtkSMPTools::Initialize(1);
+  Output reference;
+  if (!Execute(input, reference))
+  {
+    return EXIT_FAILURE;
+  }
+  cout << "Threads: 1, " << reference.Polys.size() / 4 << " triangles" << endl;
+  if (reference.Polys.empty())
+  {
+    cerr << "ERROR: empty contour." << endl;
+    return EXIT_FAILURE;
+  }
+  // the contour crosses at least the 8 leaf blocks around the center.
+  std::vector<int> blockIds = reference.BlockIds;
+  std::sort(blockIds.begin(), blockIds.end());
+  if (std::unique(blockIds.begin(), blockIds.end()) - blockIds.begin() < 8)
+  {
+    cerr << "ERROR: the contour does not cross the leaf blocks around the center." << endl;
+    return EXIT_FAILURE;
+  }
+
+  const int maxThreads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int numThreads = 2; numThreads <= maxThreads; numThreads *= 2)
+  {
+    vtkSMPTools::Initialize(numThreads);
+    Output output;
+    if (!Execute(input, output))
+    {
+      return EXIT_FAILURE;
+    }
+    cout << "Threads: " << numThreads << ", " << output.Polys.size() / 4 << " triangles" << endl;
+    if (output != reference)
+    {
+      cerr << "ERROR: output with " << numThreads
+           << " threads differs from the output with 1 thread." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
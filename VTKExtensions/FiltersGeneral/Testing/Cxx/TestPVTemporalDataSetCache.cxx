@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVTemporalDataSetCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkNew.h"
+#include "vtkPVTemporalDataSetCache.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <string>
+
+#define vtk_assert(x)                                                                              \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << "On line " << __LINE__ << " ERROR: Condition FAILED!! : " << #x << endl;               \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// An image of 32^3 points with a "time" point array holding `time`, like a
+// simulation allocating new buffers at each time step.
+vtkSmartPointer<vtkImageData> CreateStep(double time)
+{
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(32, 32, 32);
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("time");
+  array->SetNumberOfTuples(image->GetNumberOfPoints());
+  array->FillValue(time);
+  image->GetPointData()->AddArray(array);
+  image->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+  return image;
+}
+
+// Returns the value of the "time" array in the output, or -1.
+double GetOutputTime(vtkPVTemporalDataSetCache* cache)
+{
+  vtkImageData* output = vtkImageData::SafeDownCast(cache->GetOutputDataObject(0));
+  vtkDataArray* array = output ? output->GetPointData()->GetArray("time") : nullptr;
+  return array ? array->GetTuple1(0) : -1;
+}
+}
+
+int TestPVTemporalDataSetCache(int argc, char* argv[])
+{
+  const vtkTypeInt64 stepSize = CreateStep(0)->GetActualMemorySize() * 1024;
+
+  // shallow copies, at most 3 steps in memory.
+  vtkNew<vtkPVTemporalDataSetCache> cache;
+  cache->SetCacheSize(10);
+  cache->SetMemoryLimit(3 * stepSize + stepSize / 2);
+  cache->ShallowCopyInputOn();
+  vtkSmartPointer<vtkImageData> step;
+  for (int cc = 0; cc < 5; ++cc)
+  {
+    step = CreateStep(cc);
+    cache->SetInputDataObject(step);
+    cache->UpdateTimeStep(cc);
+    vtk_assert(GetOutputTime(cache) == cc);
+  }
+  vtk_assert(cache->GetNumberOfCachedTimeSteps() == 3);
+  vtk_assert(cache->GetNumberOfEvictions() == 2);
+  vtk_assert(cache->GetCachedMemorySize() <= cache->GetMemoryLimit());
+
+  // the cache references the input arrays.
+  vtkImageData* output = vtkImageData::SafeDownCast(cache->GetOutputDataObject(0));
+  vtk_assert(output->GetPointData()->GetArray("time") == step->GetPointData()->GetArray("time"));
+
+  cache->UpdateTimeStep(2);
+  vtk_assert(GetOutputTime(cache) == 2);
+  vtk_assert(cache->GetNumberOfHits() == 1);
+  cache->UpdateTimeStep(0);
+  vtk_assert(cache->GetNumberOfMisses() == 1);
+
+  // deep copies, spilled to disk.
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkPVTemporalDataSetCache> spilling;
+  spilling->SetCacheSize(2);
+  spilling->SetSpillDirectory(tempDir);
+  delete[] tempDir;
+  for (int cc = 0; cc < 4; ++cc)
+  {
+    step = CreateStep(cc);
+    spilling->SetInputDataObject(step);
+    spilling->UpdateTimeStep(cc);
+  }
+  output = vtkImageData::SafeDownCast(spilling->GetOutputDataObject(0));
+  vtk_assert(output->GetPointData()->GetArray("time") != step->GetPointData()->GetArray("time"));
+  vtk_assert(spilling->GetNumberOfCachedTimeSteps() == 2);
+  vtk_assert(spilling->GetNumberOfSpilledTimeSteps() == 2);
+  vtk_assert(spilling->GetNumberOfSpills() == 2);
+
+  spilling->UpdateTimeStep(0);
+  vtk_assert(GetOutputTime(spilling) == 0);
+  vtk_assert(spilling->GetNumberOfReloads() == 1);
+  vtk_assert(spilling->GetNumberOfSpilledTimeSteps() == 2);
+
+  spilling->ClearCache();
+  vtk_assert(spilling->GetNumberOfSpilledTimeSteps() == 0);
+  return EXIT_SUCCESS;
+}
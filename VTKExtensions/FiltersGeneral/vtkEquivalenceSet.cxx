@@ -13,8 +13,11 @@
 
 =========================================================================*/
 #include "vtkEquivalenceSet.h"
-#include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkEquivalenceSet);
 
@@ -22,25 +25,24 @@ vtkStandardNewMacro(vtkEquivalenceSet);
 // A class that implements an equivalent set.  It is used to combine fragments
 // from different processes.
 //
-// I believe that this class is a strictly ordered tree of equivalences.
-// Every member points to its own id or an id smaller than itself.
+// The members form a union-find forest. Serial unions link the root of the
+// smaller set under the root of the larger one, concurrent unions link the
+// root with the larger id under the other one with a compare and swap, so that
+// concurrent links cannot form a cycle. Finds halve the path they traverse.
 
 //----------------------------------------------------------------------------
 vtkEquivalenceSet::vtkEquivalenceSet()
 {
   this->Resolved = 0;
-  this->EquivalenceArray = vtkIntArray::New();
+  this->NumberOfResolvedSets = 0;
+  this->NumberOfMembers = 0;
+  this->MemberCapacity = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkEquivalenceSet::~vtkEquivalenceSet()
 {
   this->Resolved = 0;
-  if (this->EquivalenceArray)
-  {
-    this->EquivalenceArray->Delete();
-    this->EquivalenceArray = 0;
-  }
 }
 
 //----------------------------------------------------------------------------
@@ -48,14 +50,26 @@ void vtkEquivalenceSet::Initialize()
 {
   this->Resolved = 0;
   this->NumberOfResolvedSets = 0;
-  this->EquivalenceArray->Initialize();
+  this->NumberOfMembers = 0;
+  this->MemberCapacity = 0;
+  this->Parents.reset();
+  this->Sizes.reset();
 }
 
 //----------------------------------------------------------------------------
 void vtkEquivalenceSet::DeepCopy(vtkEquivalenceSet* in)
 {
+  this->Initialize();
+  this->Reserve(in->NumberOfMembers);
+  for (vtkIdType ii = 0; ii < in->NumberOfMembers; ++ii)
+  {
+    this->Parents[ii].store(in->Parents[ii].load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+    this->Sizes[ii] = in->Sizes[ii];
+  }
+  this->NumberOfMembers = in->NumberOfMembers;
+  this->NumberOfResolvedSets = in->NumberOfResolvedSets;
   this->Resolved = in->Resolved;
-  this->EquivalenceArray->DeepCopy(in->EquivalenceArray);
 }
 
 //----------------------------------------------------------------------------
@@ -73,37 +87,94 @@ void vtkEquivalenceSet::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //----------------------------------------------------------------------------
-// Return the id of the equivalent set.
-int vtkEquivalenceSet::GetEquivalentSetId(int memberId)
+void vtkEquivalenceSet::Reserve(vtkIdType capacity)
 {
-  int ref;
+  if (capacity <= this->MemberCapacity && this->Parents)
+  {
+    return;
+  }
+  std::unique_ptr<std::atomic<vtkIdType>[]> parents(new std::atomic<vtkIdType>[capacity]);
+  std::unique_ptr<vtkIdType[]> sizes(new vtkIdType[capacity]);
+  for (vtkIdType ii = 0; ii < this->NumberOfMembers; ++ii)
+  {
+    parents[ii].store(this->Parents[ii].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sizes[ii] = this->Sizes[ii];
+  }
+  this->Parents = std::move(parents);
+  this->Sizes = std::move(sizes);
+  this->MemberCapacity = capacity;
+}
 
-  ref = this->GetReference(memberId);
-  while (!this->Resolved && ref != memberId)
+//----------------------------------------------------------------------------
+void vtkEquivalenceSet::SetNumberOfMembers(vtkIdType numberOfMembers)
+{
+  if (numberOfMembers <= this->NumberOfMembers)
+  {
+    return;
+  }
+  if (numberOfMembers > this->MemberCapacity)
   {
-    memberId = ref;
-    ref = this->GetReference(memberId);
+    this->Reserve(std::max(numberOfMembers, 2 * this->MemberCapacity));
   }
+  // All values inserted are equivalent to only themselves.
+  for (vtkIdType ii = this->NumberOfMembers; ii < numberOfMembers; ++ii)
+  {
+    this->Parents[ii].store(ii, std::memory_order_relaxed);
+    this->Sizes[ii] = 1;
+  }
+  this->NumberOfMembers = numberOfMembers;
+}
 
-  return ref;
+//----------------------------------------------------------------------------
+// Return the id of the equivalent set.
+vtkIdType vtkEquivalenceSet::GetEquivalentSetId(vtkIdType memberId)
+{
+  if (this->Resolved)
+  {
+    return this->GetReference(memberId);
+  }
+  if (memberId >= this->NumberOfMembers)
+  { // We might consider this an error ...
+    return memberId;
+  }
+  return this->FindRoot(memberId);
 }
 
 //----------------------------------------------------------------------------
 // Return the id of the equivalent set.
-int vtkEquivalenceSet::GetReference(int memberId)
+vtkIdType vtkEquivalenceSet::GetReference(vtkIdType memberId)
 {
-  if (memberId >= this->EquivalenceArray->GetNumberOfTuples())
+  if (memberId >= this->NumberOfMembers)
   { // We might consider this an error ...
     return memberId;
   }
-  return this->EquivalenceArray->GetValue(memberId);
+  return this->Parents[memberId].load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkEquivalenceSet::FindRoot(vtkIdType memberId)
+{
+  vtkIdType parent = this->Parents[memberId].load(std::memory_order_relaxed);
+  while (parent != memberId)
+  {
+    const vtkIdType grandParent = this->Parents[parent].load(std::memory_order_relaxed);
+    if (grandParent != parent)
+    {
+      // Path halving. This may fail when another thread changed the parent,
+      // which is fine since parents only get closer to the root.
+      this->Parents[memberId].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+    }
+    memberId = grandParent;
+    parent = this->Parents[memberId].load(std::memory_order_relaxed);
+  }
+  return memberId;
 }
 
 //----------------------------------------------------------------------------
 // Makes two new or existing ids equivalent.
 // If the array is too small, the range of ids is increased until it contains
 // both the ids.  Negative ids are not allowed.
-void vtkEquivalenceSet::AddEquivalence(int id1, int id2)
+void vtkEquivalenceSet::AddEquivalence(vtkIdType id1, vtkIdType id2)
 {
   if (this->Resolved)
   {
@@ -111,123 +182,165 @@ void vtkEquivalenceSet::AddEquivalence(int id1, int id2)
     return;
   }
 
-  int num = this->EquivalenceArray->GetNumberOfTuples();
-
   // Expand the range to include both ids.
-  while (num <= id1 || num <= id2)
-  {
-    // All values inserted are equivalent to only themselves.
-    this->EquivalenceArray->InsertNextTuple1(num);
-    ++num;
-  }
-
-  // Our rule for references in the equivalent set is that
-  // all elements must point to a member equal to or smaller
-  // than itself.
-
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
+  this->SetNumberOfMembers(std::max(id1, id2) + 1);
 
-  // Replace the larger references.
-  if (id1 < id2)
+  vtkIdType root1 = this->FindRoot(id1);
+  vtkIdType root2 = this->FindRoot(id2);
+  if (root1 == root2)
   {
-    // We could follow the references to the smallest.  It might
-    // make this processing more efficient.  This is a compromise.
-    // The referenced id will always be smaller than the id so
-    // order does not change.
-    this->EquateInternal(this->GetReference(id1), id2);
+    return;
   }
-  else
+  // Union by size: the smaller set joins the larger one.
+  if (this->Sizes[root1] < this->Sizes[root2])
   {
-    this->EquateInternal(this->GetReference(id2), id1);
+    std::swap(root1, root2);
   }
+  this->Parents[root2].store(root1, std::memory_order_relaxed);
+  this->Sizes[root1] += this->Sizes[root2];
 }
 
 //----------------------------------------------------------------------------
-int vtkEquivalenceSet::GetNumberOfMembers()
-{
-  return this->EquivalenceArray->GetNumberOfTuples();
-}
-
-//----------------------------------------------------------------------------
-int* vtkEquivalenceSet::GetPointer()
+void vtkEquivalenceSet::AddEquivalenceConcurrent(vtkIdType id1, vtkIdType id2)
 {
-  return this->EquivalenceArray->GetPointer(0);
+  while (true)
+  {
+    vtkIdType root1 = this->FindRoot(id1);
+    vtkIdType root2 = this->FindRoot(id2);
+    if (root1 == root2)
+    {
+      return;
+    }
+    // Link the root with the larger id, if it still is a root.
+    if (root1 < root2)
+    {
+      std::swap(root1, root2);
+    }
+    vtkIdType expected = root1;
+    if (this->Parents[root1].compare_exchange_strong(expected, root2, std::memory_order_relaxed))
+    {
+      return;
+    }
+    id1 = root1;
+    id2 = root2;
+  }
 }
 
 //----------------------------------------------------------------------------
 void vtkEquivalenceSet::Squeeze()
 {
-  this->EquivalenceArray->Squeeze();
-}
-
-//----------------------------------------------------------------------------
-vtkIdType vtkEquivalenceSet::Capacity()
-{
-  return this->EquivalenceArray->Capacity();
+  if (this->MemberCapacity > this->NumberOfMembers)
+  {
+    const vtkIdType numberOfMembers = this->NumberOfMembers;
+    std::unique_ptr<std::atomic<vtkIdType>[]> parents = std::move(this->Parents);
+    std::unique_ptr<vtkIdType[]> sizes = std::move(this->Sizes);
+    this->MemberCapacity = 0;
+    this->NumberOfMembers = 0;
+    if (numberOfMembers > 0)
+    {
+      this->Parents.reset(new std::atomic<vtkIdType>[numberOfMembers]);
+      this->Sizes.reset(new vtkIdType[numberOfMembers]);
+      for (vtkIdType ii = 0; ii < numberOfMembers; ++ii)
+      {
+        this->Parents[ii].store(parents[ii].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+        this->Sizes[ii] = sizes[ii];
+      }
+    }
+    this->MemberCapacity = numberOfMembers;
+    this->NumberOfMembers = numberOfMembers;
+  }
 }
 
 //----------------------------------------------------------------------------
-// id1 must be less than or equal to id2.
-void vtkEquivalenceSet::EquateInternal(int id1, int id2)
+// Returns the number of merged sets.
+vtkIdType vtkEquivalenceSet::ResolveEquivalences()
 {
-  // This is the reference that might be orphaned in this process.
-  int oldRef = this->GetEquivalentSetId(id2);
-
-  // The two ids are already equal (not the only way they might be equal).
-  if (oldRef == id1)
+  if (this->Resolved)
   {
-    return;
+    return this->NumberOfResolvedSets;
   }
 
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
-  if (oldRef == id2)
-  {
-    this->EquivalenceArray->SetValue(id2, id1);
-  }
-  else if (oldRef > id1)
-  {
-    this->EquivalenceArray->SetValue(id2, id1);
-    this->EquateInternal(id1, oldRef);
-  }
-  else
-  { // oldRef < id1
-    this->EquateInternal(oldRef, id1);
-  }
-}
+  // Assign consecutive ids to the sets, in the order of their smallest
+  // member, as a strictly ordered tree of equivalences would.
+  const vtkIdType numIds = this->NumberOfMembers;
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstMembers(new std::atomic<vtkIdType>[numIds]);
+  std::atomic<vtkIdType>* parents = this->Parents.get();
+  std::atomic<vtkIdType>* first = firstMembers.get();
 
-//----------------------------------------------------------------------------
-// Returns the number of merged sets.
-int vtkEquivalenceSet::ResolveEquivalences()
-{
-  // Go through the equivalence array collapsing chains
-  // and assigning consecutive ids.
-  int count = 0;
-  int id;
-  int newId;
-
-  int numIds = this->EquivalenceArray->GetNumberOfTuples();
-  for (int ii = 0; ii < numIds; ++ii)
-  {
-    id = this->EquivalenceArray->GetValue(ii);
-    if (id == ii)
-    { // This is a new equivalence set.
-      this->EquivalenceArray->SetValue(ii, count);
-      ++count;
+  // Point every member to its root, and find the smallest member of each set.
+  vtkSMPTools::For(0, numIds, [first](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ii = begin; ii < end; ++ii)
+    {
+      first[ii].store(VTK_ID_MAX, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numIds, [this, parents](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ii = begin; ii < end; ++ii)
+    {
+      parents[ii].store(this->FindRoot(ii), std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numIds, [parents, first](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ii = begin; ii < end; ++ii)
+    {
+      std::atomic<vtkIdType>& firstMember = first[parents[ii].load(std::memory_order_relaxed)];
+      vtkIdType current = firstMember.load(std::memory_order_relaxed);
+      while (ii < current &&
+        !firstMember.compare_exchange_weak(current, ii, std::memory_order_relaxed))
+      {
+      }
     }
-    else
+  });
+
+  // The set id of a smallest member is the number of smallest members before
+  // it. Count them by chunks, then number them, keeping the set id of each root
+  // in Sizes, that is not needed anymore.
+  const vtkIdType chunkSize = 65536;
+  const vtkIdType numChunks = (numIds + chunkSize - 1) / chunkSize;
+  std::vector<vtkIdType> chunkOffsets(numChunks + 1, 0);
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
     {
-      // All earlier ids will be resolved already.
-      // This array only point to less than or equal ids. (id <= ii).
-      newId = this->EquivalenceArray->GetValue(id);
-      this->EquivalenceArray->SetValue(ii, newId);
+      vtkIdType count = 0;
+      const vtkIdType last = std::min(numIds, (chunk + 1) * chunkSize);
+      for (vtkIdType ii = chunk * chunkSize; ii < last; ++ii)
+      {
+        count += (first[parents[ii].load(std::memory_order_relaxed)].load(
+                    std::memory_order_relaxed) == ii);
+      }
+      chunkOffsets[chunk + 1] = count;
     }
+  });
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    chunkOffsets[chunk + 1] += chunkOffsets[chunk];
   }
-  this->Resolved = 1;
-  // cerr << "Final number of equivalent sets: " << count << endl;
-
-  this->NumberOfResolvedSets = count;
+  vtkIdType* setIds = this->Sizes.get();
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      vtkIdType setId = chunkOffsets[chunk];
+      const vtkIdType last = std::min(numIds, (chunk + 1) * chunkSize);
+      for (vtkIdType ii = chunk * chunkSize; ii < last; ++ii)
+      {
+        const vtkIdType root = parents[ii].load(std::memory_order_relaxed);
+        if (first[root].load(std::memory_order_relaxed) == ii)
+        { // This is a new equivalence set.
+          setIds[root] = setId++;
+        }
+      }
+    }
+  });
+  vtkSMPTools::For(0, numIds, [parents, setIds](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ii = begin; ii < end; ++ii)
+    {
+      parents[ii].store(setIds[parents[ii].load(std::memory_order_relaxed)],
+        std::memory_order_relaxed);
+    }
+  });
 
-  return count;
+  this->Resolved = 1;
+  this->NumberOfResolvedSets = chunkOffsets[numChunks];
+  return this->NumberOfResolvedSets;
 }
@@ -18,6 +18,13 @@
  *
  * Useful for connectivity on multiple processes.  Run connectivity
  * on each processes, then make touching fragments equivalent.
+ *
+ * The set is a union-find forest of 64-bit member ids. AddEquivalence()
+ * merges sets by size and halves the paths it traverses.
+ * AddEquivalenceConcurrent() can be called from several threads, e.g. in a
+ * vtkSMPTools loop, once the members have been allocated with
+ * SetNumberOfMembers(). ResolveEquivalences() runs in parallel and numbers
+ * the sets in the order of their smallest member.
 */
 
 #ifndef vtkEquivalenceSet_h
@@ -25,7 +32,9 @@
 
 #include "vtkObject.h"
 #include "vtkPVVTKExtensionsFiltersGeneralModule.h" //needed for exports
-class vtkIntArray;
+
+#include <atomic> // for std::atomic
+#include <memory> // for std::unique_ptr
 
 class VTKPVVTKEXTENSIONSFILTERSGENERAL_EXPORT vtkEquivalenceSet : public vtkObject
 {
@@ -35,53 +44,65 @@ public:
   static vtkEquivalenceSet* New();
 
   void Initialize();
-  void AddEquivalence(int id1, int id2);
+  void AddEquivalence(vtkIdType id1, vtkIdType id2);
+
+  // Thread safe version of AddEquivalence(). Both ids must be smaller than
+  // the number of members, see SetNumberOfMembers(). It cannot be called
+  // concurrently with the other methods.
+  void AddEquivalenceConcurrent(vtkIdType id1, vtkIdType id2);
 
   // The length of the equivalent array...
   // The Domain of the equivalance map is [0, numberOfMembers).
-  int GetNumberOfMembers();
+  vtkIdType GetNumberOfMembers() { return this->NumberOfMembers; }
+
+  // Adds members, each one equivalent to itself, until there are
+  // numberOfMembers of them. The number of members never decreases.
+  void SetNumberOfMembers(vtkIdType numberOfMembers);
 
   // Valid only after set is resolved.
   // The range of the map is [0 numberOfResolvedSets)
-  int GetNumberOfResolvedSets() { return this->NumberOfResolvedSets; }
+  vtkIdType GetNumberOfResolvedSets() { return this->NumberOfResolvedSets; }
 
   // Return the id of the equivalent set.
-  int GetEquivalentSetId(int memberId);
+  vtkIdType GetEquivalentSetId(vtkIdType memberId);
 
   // Equivalent set ids are reassinged to be sequential.
   // You cannot add anymore equivalences after this is called.
-  virtual int ResolveEquivalences();
+  virtual vtkIdType ResolveEquivalences();
 
   void DeepCopy(vtkEquivalenceSet* in);
 
-  // Needed for sending the set over MPI.
-  // Be very careful with the pointer.
-  // I guess this means do not write to the memory.
-  int* GetPointer();
-
   // Free unused memory
   void Squeeze();
 
   // Report used memory
-  vtkIdType Capacity();
+  vtkIdType Capacity() { return this->MemberCapacity; }
 
   // We should fix the pointer API and hide this ivar.
   int Resolved;
 
-  int GetReference(int memberId);
+  vtkIdType GetReference(vtkIdType memberId);
 
 protected:
   vtkEquivalenceSet();
   ~vtkEquivalenceSet() override;
 
-  int NumberOfResolvedSets;
+  vtkIdType NumberOfResolvedSets;
 
   // To merge connected framgments that have different ids because they were
   // traversed by different processes or passes.
-  vtkIntArray* EquivalenceArray;
-
-  // Return the id of the equivalent set.
-  void EquateInternal(int id1, int id2);
+  // Parent of each member in the forest, a member being the root of its set
+  // when it is its own parent. Once resolved, the set id of each member.
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+  // Number of members of the set of each root, for union by size.
+  std::unique_ptr<vtkIdType[]> Sizes;
+  vtkIdType NumberOfMembers;
+  vtkIdType MemberCapacity;
+
+  void Reserve(vtkIdType capacity);
+
+  // Returns the root of the set of a member, halving the path to it.
+  vtkIdType FindRoot(vtkIdType memberId);
 
 private:
   vtkEquivalenceSet(const vtkEquivalenceSet&) = delete;
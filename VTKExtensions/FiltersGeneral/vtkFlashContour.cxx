@@ -17,18 +17,25 @@
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMarchingCubesTriangleCases.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <cstring>
+
 vtkStandardNewMacro(vtkFlashContour);
 
 // How do we find edge/corner neighbors and neighbors in different levels.
@@ -45,6 +52,19 @@ static int vtkFlashIsoEdgeToPointsTable[12][2] = { { 0, 1 }, { 1, 3 }, { 2, 3 },
 static int vtkFlashIsoEdgeToVTKPointsTable[12][2] = { { 0, 1 }, { 1, 2 }, { 3, 2 }, { 0, 3 },
   { 4, 5 }, { 5, 6 }, { 7, 6 }, { 4, 7 }, { 0, 4 }, { 1, 5 }, { 3, 7 }, { 2, 6 } };
 
+//============================================================================
+// Triangles generated for one leaf block. Every triangle has its own three
+// points (there is no point locator), so the connectivity is implicit.
+class vtkFlashContour::LeafOutput
+{
+public:
+  int BlockId = 0;
+  unsigned char Level = 0;
+  unsigned char RemainingDepth = 0;
+  std::vector<double> Points;
+  std::vector<double> PassValues;
+};
+
 //============================================================================
 //----------------------------------------------------------------------------
 // Description:
@@ -364,7 +384,8 @@ int vtkFlashContour::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  // Find all roots and recurse on each.
+  // Find all roots and recurse on each to collect the leaves.
+  this->Leaves.clear();
   int* levelPtr = this->GlobalLevelArray;
   for (int i = 0; i < this->NumberOfGlobalBlocks; ++i)
   {
@@ -417,6 +438,78 @@ int vtkFlashContour::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  // Contour the leaves concurrently. The outputs are appended in the order of
+  // the leaves so that the mesh does not depend on the number of threads.
+  const vtkIdType numberOfLeaves = static_cast<vtkIdType>(this->Leaves.size());
+  std::vector<LeafOutput> outputs(this->Leaves.size());
+  vtkSMPTools::For(0, numberOfLeaves, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      this->ProcessLeaf(this->Leaves[cc], mbdsInput, outputs[cc]);
+    }
+  });
+
+  std::vector<vtkIdType> pointOffsets(this->Leaves.size() + 1, 0);
+  for (vtkIdType cc = 0; cc < numberOfLeaves; ++cc)
+  {
+    pointOffsets[cc + 1] =
+      pointOffsets[cc] + static_cast<vtkIdType>(outputs[cc].Points.size() / 3);
+  }
+  const vtkIdType numberOfPoints = pointOffsets.back();
+  const vtkIdType numberOfCells = numberOfPoints / 3;
+
+  this->Points->SetDataTypeToFloat();
+  this->Points->SetNumberOfPoints(numberOfPoints);
+  float* points = static_cast<float*>(this->Points->GetVoidPointer(0));
+  double* passValues = nullptr;
+  if (this->PassArray)
+  {
+    this->PassArray->SetNumberOfTuples(numberOfPoints);
+    passValues = this->PassArray->GetPointer(0);
+  }
+  this->BlockIdCellArray->SetNumberOfTuples(numberOfCells);
+  this->LevelCellArray->SetNumberOfTuples(numberOfCells);
+  this->RemainingDepthCellArray->SetNumberOfTuples(numberOfCells);
+  int* blockIds = this->BlockIdCellArray->GetPointer(0);
+  unsigned char* levels = this->LevelCellArray->GetPointer(0);
+  unsigned char* remainingDepths = this->RemainingDepthCellArray->GetPointer(0);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfTuples(numberOfCells + 1);
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfTuples(numberOfPoints);
+  vtkIdType* connectivityPtr = connectivity->GetPointer(0);
+  offsetsPtr[numberOfCells] = numberOfPoints;
+
+  vtkSMPTools::For(0, numberOfLeaves, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      const LeafOutput& output = outputs[cc];
+      const vtkIdType firstPoint = pointOffsets[cc];
+      const vtkIdType numberOfLeafPoints = pointOffsets[cc + 1] - firstPoint;
+      std::copy(output.Points.begin(), output.Points.end(), points + 3 * firstPoint);
+      if (passValues)
+      {
+        std::copy(output.PassValues.begin(), output.PassValues.end(), passValues + firstPoint);
+      }
+      for (vtkIdType ptId = firstPoint; ptId < firstPoint + numberOfLeafPoints; ++ptId)
+      {
+        connectivityPtr[ptId] = ptId;
+      }
+      const vtkIdType firstCell = firstPoint / 3;
+      const vtkIdType numberOfLeafCells = numberOfLeafPoints / 3;
+      for (vtkIdType cellId = firstCell; cellId < firstCell + numberOfLeafCells; ++cellId)
+      {
+        offsetsPtr[cellId] = 3 * cellId;
+      }
+      std::fill_n(blockIds + firstCell, numberOfLeafCells, output.BlockId);
+      std::fill_n(levels + firstCell, numberOfLeafCells, output.Level);
+      std::fill_n(remainingDepths + firstCell, numberOfLeafCells, output.RemainingDepth);
+    }
+  });
+  this->Faces->SetData(offsets, connectivity);
+  this->Leaves.clear();
+
   this->Mesh->Delete();
   this->Points->Delete();
   this->Points = 0;
@@ -640,30 +733,46 @@ void vtkFlashContour::RecurseTree(int neighborhood[3][3][3], vtkMultiBlockDataSe
   }
 
   // Center of neighborhood is a leaf.
-  // Contour the block and the shared regions it owns.
+  // Save it, it is contoured later by ProcessLeaf.
   int globalBlockId = neighborhood[1][1][1];
   vtkDataObject* block = input->GetBlock(this->GlobalToLocalMap[globalBlockId]);
-  vtkImageData* image = vtkImageData::SafeDownCast(block);
-  if (image)
+  if (vtkImageData::SafeDownCast(block))
+  {
+    Leaf leaf;
+    memcpy(leaf.Neighborhood, neighborhood, sizeof(leaf.Neighborhood));
+    this->Leaves.push_back(leaf);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Contour the block and the shared regions it owns.
+// This is called concurrently for different leaves.
+void vtkFlashContour::ProcessLeaf(
+  const Leaf& leaf, vtkMultiBlockDataSet* input, LeafOutput& output)
+{
+  int neighborhood[3][3][3];
+  memcpy(neighborhood, leaf.Neighborhood, sizeof(neighborhood));
+  int globalBlockId = neighborhood[1][1][1];
+  vtkImageData* image =
+    vtkImageData::SafeDownCast(input->GetBlock(this->GlobalToLocalMap[globalBlockId]));
+
+  output.Level = this->GlobalLevelArray[globalBlockId];
+  output.BlockId = globalBlockId;
+  // Recursively find the maximum depth of the children branches (not loaded).
+  output.RemainingDepth = this->ComputeBranchDepth(globalBlockId);
+
+  this->ProcessBlock(image, output);
+  // Now lets process the regions shared with neighbors.
+  int r[3];
+  for (r[2] = 0; r[2] < 3; ++r[2])
   {
-    this->CurrentLevel = this->GlobalLevelArray[globalBlockId];
-    this->CurrentBlockId = globalBlockId;
-    // Recursively find the maximum depth of the children branches (not loaded).
-    this->RemainingDepth = this->ComputeBranchDepth(globalBlockId);
-
-    this->ProcessBlock(image);
-    // Now lets process the regions shared with neighbors.
-    int r[3];
-    for (r[2] = 0; r[2] < 3; ++r[2])
+    for (r[1] = 0; r[1] < 3; ++r[1])
     {
-      for (r[1] = 0; r[1] < 3; ++r[1])
+      for (r[0] = 0; r[0] < 3; ++r[0])
       {
-        for (r[0] = 0; r[0] < 3; ++r[0])
+        if (r[0] != 1 || r[1] != 1 || r[2] != 1)
         {
-          if (r[0] != 1 || r[1] != 1 || r[2] != 1)
-          {
-            this->ProcessNeighborhoodSharedRegion(neighborhood, r, input);
-          }
+          this->ProcessNeighborhoodSharedRegion(neighborhood, r, input, output);
         }
       }
     }
@@ -671,7 +780,7 @@ void vtkFlashContour::RecurseTree(int neighborhood[3][3][3], vtkMultiBlockDataSe
 }
 
 //----------------------------------------------------------------------------
-void vtkFlashContour::ProcessBlock(vtkImageData* image)
+void vtkFlashContour::ProcessBlock(vtkImageData* image, LeafOutput& output)
 {
   const double* spacing = image->GetSpacing();
   double blockOrigin[3];
@@ -766,7 +875,7 @@ void vtkFlashContour::ProcessBlock(vtkImageData* image)
 
         // I adding interpolation of attributes after the fact.
         // I need ids of the corner cells (dual points).
-        this->ProcessCell(origin, spacing, cornerValues, passValues);
+        this->ProcessCell(origin, spacing, cornerValues, passValues, output);
         ++dPtr;
         if (pPtr)
         {
@@ -798,7 +907,7 @@ void vtkFlashContour::ProcessBlock(vtkImageData* image)
 //----------------------------------------------------------------------------
 // Assume the same level: easy.
 void vtkFlashContour::ProcessNeighborhoodSharedRegion(
-  int neighborhood[3][3][3], int r[3], vtkMultiBlockDataSet* input)
+  int neighborhood[3][3][3], int r[3], vtkMultiBlockDataSet* input, LeafOutput& output)
 {
   int regionDims[3];   // dual cell dimensions of region
   double* ptrs[8];     // Pointer to corner scalars
@@ -814,7 +923,10 @@ void vtkFlashContour::ProcessNeighborhoodSharedRegion(
   int level1 = this->GlobalLevelArray[block1GlobalId];
   vtkDataObject* block1 = input->GetBlock(this->GlobalToLocalMap[block1GlobalId]);
   vtkImageData* image1 = vtkImageData::SafeDownCast(block1);
-  const int* dims1 = image1->GetDimensions();
+  // GetDimensions() without argument updates the image, which is not safe
+  // with the neighbors being shared by concurrent leaves.
+  int dims1[3];
+  image1->GetDimensions(dims1);
   const double* spacing1 = image1->GetSpacing();
   const double* origin1 = image1->GetOrigin();
   // Compute increments for cell array (cell array is one less than point).
@@ -904,7 +1016,8 @@ void vtkFlashContour::ProcessNeighborhoodSharedRegion(
       return;
     }
     // Sanity check. All blocks must have the same dimensions.
-    int* dims2 = image2->GetDimensions();
+    int dims2[3];
+    image2->GetDimensions(dims2);
     if (dims1[0] != dims2[0] || dims1[1] != dims2[1] || dims1[2] != dims2[2])
     {
       vtkErrorMacro("Neighbor dimensions do not match.");
@@ -980,13 +1093,14 @@ void vtkFlashContour::ProcessNeighborhoodSharedRegion(
   }
   // Now that we have all of the information for the starting cell corners
   // Contour the region.
-  this->ProcessSharedRegion(regionDims, ptrs, incs, corners, spacings, levelDiff, aptrs);
+  this->ProcessSharedRegion(regionDims, ptrs, incs, corners, spacings, levelDiff, aptrs, output);
 }
 
 //----------------------------------------------------------------------------
 // cornerPtr and cornerPoints get modified.
 void vtkFlashContour::ProcessSharedRegion(int regionDims[3], double* cornerPtrs[8], int incs[3],
-  double cornerPoints[32], double cornerSpacings[32], int cornerLevelDiffs[8], double* passPtrs[8])
+  double cornerPoints[32], double cornerSpacings[32], int cornerLevelDiffs[8], double* passPtrs[8],
+  LeafOutput& output)
 {
   // Skip schedule for lower levels.
   // The 2's have not effect when levelDiff = 0.
@@ -1025,7 +1139,7 @@ void vtkFlashContour::ProcessSharedRegion(int regionDims[3], double* cornerPtrs[
       }
       for (int x = 0; x < regionDims[0]; ++x)
       {
-        this->ProcessDegenerateCell(cornerPointsX, cornerPtrsX, passPtrsX);
+        this->ProcessDegenerateCell(cornerPointsX, cornerPtrsX, passPtrsX, output);
         // Increment x corners
         for (int i = 0; i < 8; ++i)
         {
@@ -1081,7 +1195,7 @@ void vtkFlashContour::ProcessSharedRegion(int regionDims[3], double* cornerPtrs[
 
 //----------------------------------------------------------------------------
 void vtkFlashContour::ProcessDegenerateCell(
-  double cornerPoints[32], double* cornerPtrs[8], double* passPtrs[8])
+  double cornerPoints[32], double* cornerPtrs[8], double* passPtrs[8], LeafOutput& output)
 {
   int cubeCase = 0;
   double cornerValues[8];
@@ -1150,12 +1264,12 @@ void vtkFlashContour::ProcessDegenerateCell(
     passValues[7] = *passPtrs[6];
   }
 
-  this->ProcessCellFinal(cornerPoints, cornerValues, cubeCase, passValues);
+  this->ProcessCellFinal(cornerPoints, cornerValues, cubeCase, passValues, output);
 }
 
 //----------------------------------------------------------------------------
-void vtkFlashContour::ProcessCell(
-  const double* origin, const double* spacing, const double* cornerValues, const double* passValues)
+void vtkFlashContour::ProcessCell(const double* origin, const double* spacing,
+  const double* cornerValues, const double* passValues, LeafOutput& output)
 {
   int cubeCase = 0;
 
@@ -1215,16 +1329,15 @@ void vtkFlashContour::ProcessCell(
     cornerPoints[(c << 2) | 2] = origin[2] + spacing[2] * ((double)(pz));
   }
 
-  this->ProcessCellFinal(cornerPoints, cornerValues, cubeCase, passValues);
+  this->ProcessCellFinal(cornerPoints, cornerValues, cubeCase, passValues, output);
 }
 
 //----------------------------------------------------------------------------
 // It appears that cornerValues use VTK indexing scheme but
 // cornerPoints does not.
 void vtkFlashContour::ProcessCellFinal(const double cornerPoints[32], const double cornerValues[8],
-  int cubeCase, const double passValues[8])
+  int cubeCase, const double passValues[8], LeafOutput& output)
 {
-  vtkIdType pointIds[6];
   vtkMarchingCubesTriangleCases *triCase, *triCases;
   EDGE_LIST* edge;
   double k, v0, v1;
@@ -1237,52 +1350,36 @@ void vtkFlashContour::ProcessCellFinal(const double cornerPoints[32], const doub
   double pt[3];
 
   // loop over triangles
+  // There is no point locator: every triangle gets three new points, so
+  // RequestData generates the connectivity from the points.
   while (*edge > -1)
   {
-    // I want to avoid adding degenerate triangles.
-    // Maybe the best way to do this is to have a point locator
-    // merge points first.
-    // Create brute force locator for a block, and resuse it.
-    // Only permanently keep locator for edges shared between two blocks.
     for (int ii = 0; ii < 3; ++ii, ++edge) // insert triangle
     {
-      vtkIdType ptId = -1; // = this->BlockLocator->GetEdgePointer(x,y,z,*edge);
+      // Compute the interpolation factor.
+      v0 = cornerValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][0]];
+      v1 = cornerValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][1]];
+      k = (this->IsoValue - v0) / (v1 - v0);
+      // Add the point to the output.
+      int pt1Idx = (vtkFlashIsoEdgeToPointsTable[*edge][0] << 2);
+      int pt2Idx = (vtkFlashIsoEdgeToPointsTable[*edge][1] << 2);
+      // I wonder if this is any faster than incrementing a pointer.
+      pt[0] = cornerPoints[pt1Idx] + k * (cornerPoints[pt2Idx] - cornerPoints[pt1Idx]);
+      pt[1] =
+        cornerPoints[pt1Idx | 1] + k * (cornerPoints[pt2Idx | 1] - cornerPoints[pt1Idx | 1]);
+      pt[2] =
+        cornerPoints[pt1Idx | 2] + k * (cornerPoints[pt2Idx | 2] - cornerPoints[pt1Idx | 2]);
+      output.Points.insert(output.Points.end(), pt, pt + 3);
 
-      if (ptId == -1)
+      if (this->PassArray)
       {
-        // Compute the interpolation factor.
-        v0 = cornerValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][0]];
-        v1 = cornerValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][1]];
-        k = (this->IsoValue - v0) / (v1 - v0);
-        // Add the point to the output and get the index of the point.
-        int pt1Idx = (vtkFlashIsoEdgeToPointsTable[*edge][0] << 2);
-        int pt2Idx = (vtkFlashIsoEdgeToPointsTable[*edge][1] << 2);
-        // I wonder if this is any faster than incrementing a pointer.
-        pt[0] = cornerPoints[pt1Idx] + k * (cornerPoints[pt2Idx] - cornerPoints[pt1Idx]);
-        pt[1] =
-          cornerPoints[pt1Idx | 1] + k * (cornerPoints[pt2Idx | 1] - cornerPoints[pt1Idx | 1]);
-        pt[2] =
-          cornerPoints[pt1Idx | 2] + k * (cornerPoints[pt2Idx | 2] - cornerPoints[pt1Idx | 2]);
-        ptId = this->Points->InsertNextPoint(pt);
-
-        if (this->PassArray)
-        {
-          double p0;
-          double p1;
-          p0 = passValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][0]];
-          p1 = passValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][1]];
-          double value = p0 + k * (p1 - p0);
-          this->PassArray->InsertNextValue(value);
-        }
+        double p0;
+        double p1;
+        p0 = passValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][0]];
+        p1 = passValues[vtkFlashIsoEdgeToVTKPointsTable[*edge][1]];
+        double value = p0 + k * (p1 - p0);
+        output.PassValues.push_back(value);
       }
-      pointIds[ii] = ptId;
-    }
-    if (pointIds[0] != pointIds[1] && pointIds[0] != pointIds[2] && pointIds[1] != pointIds[2])
-    {
-      this->Faces->InsertNextCell(3, pointIds);
-      this->BlockIdCellArray->InsertNextValue(this->CurrentBlockId);
-      this->LevelCellArray->InsertNextValue(this->CurrentLevel);
-      this->RemainingDepthCellArray->InsertNextValue(this->RemainingDepth);
     }
   }
 }
@@ -26,6 +26,8 @@
 #include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkPVVTKExtensionsFiltersGeneralModule.h" //needed for exports
 
+#include <vector> // for std::vector
+
 class vtkImageData;
 class vtkPoints;
 class vtkCellArray;
@@ -57,14 +59,11 @@ protected:
 
   // Just for debugging.
   vtkIntArray* BlockIdCellArray;
-  int CurrentBlockId;
   // A couple cell arrays to help determine where I should refine.
   vtkUnsignedCharArray* LevelCellArray;
-  unsigned char CurrentLevel;
   // Instead of maximum depth, compute the different between the
   // maximum depth and the current depth.
   vtkUnsignedCharArray* RemainingDepthCellArray;
-  unsigned char RemainingDepth;
   unsigned char ComputeBranchDepth(int globalBlockId);
 
   vtkPoints* Points;
@@ -86,18 +85,30 @@ protected:
   int* GlobalNeighborArray;
   int* GlobalToLocalMap;
 
+  // RecurseTree collects the leaf blocks with their 26 neighbors. The leaves
+  // are then contoured concurrently, each into its own LeafOutput, and the
+  // outputs are appended to the mesh in the order of the leaves.
+  struct Leaf
+  {
+    int Neighborhood[3][3][3];
+  };
+  std::vector<Leaf> Leaves;
+  class LeafOutput;
+
   void RecurseTree(int neighborhood[3][3][3], vtkMultiBlockDataSet* input);
-  void ProcessBlock(vtkImageData* block);
+  void ProcessLeaf(const Leaf& leaf, vtkMultiBlockDataSet* input, LeafOutput& output);
+  void ProcessBlock(vtkImageData* block, LeafOutput& output);
   void ProcessCell(const double* origin, const double* spacing, const double* cornerValues,
-    const double* passValues);
+    const double* passValues, LeafOutput& output);
   void ProcessNeighborhoodSharedRegion(
-    int neighborhood[3][3][3], int r[3], vtkMultiBlockDataSet* input);
+    int neighborhood[3][3][3], int r[3], vtkMultiBlockDataSet* input, LeafOutput& output);
   void ProcessSharedRegion(int regionDims[3], double* cornerPtrs[8], int incs[3],
     double cornerPoints[32], double cornerSpacings[32], int cornerLevelDiffs[8],
-    double* passPtrs[8]);
-  void ProcessDegenerateCell(double cornerPoints[32], double* cornerPtrs[8], double* passPtrs[8]);
+    double* passPtrs[8], LeafOutput& output);
+  void ProcessDegenerateCell(double cornerPoints[32], double* cornerPtrs[8], double* passPtrs[8],
+    LeafOutput& output);
   void ProcessCellFinal(const double cornerPoints[32], const double cornerValues[8], int cubeCase,
-    const double passValues[8]);
+    const double passValues[8], LeafOutput& output);
 
 private:
   vtkFlashContour(const vtkFlashContour&) = delete;
@@ -13,10 +13,11 @@
 
 =========================================================================*/
 #include "vtkPEquivalenceSet.h"
-#include "vtkIntArray.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkPEquivalenceSet);
 
 vtkPEquivalenceSet::vtkPEquivalenceSet()
@@ -32,54 +33,70 @@ void vtkPEquivalenceSet::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 }
 
-int vtkPEquivalenceSet::ResolveEquivalences()
+vtkIdType vtkPEquivalenceSet::ResolveEquivalences()
 {
   vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
   int myProc = controller->GetLocalProcessId();
   int numProcs = controller->GetNumberOfProcesses();
 
-  vtkIntArray* workingSet = vtkIntArray::New();
-  workingSet->SetNumberOfComponents(1);
-
+  // Merge the forests of the processes pairwise, down to process 0.
+  std::vector<vtkIdType> workingSet;
   int tag = 475893745;
   int pivot = (numProcs + 1) / 2;
   while (pivot > 0 && myProc < (pivot * 2))
   {
-    int tuples;
+    vtkIdType tuples;
     if (myProc >= pivot)
     {
-      tuples = this->EquivalenceArray->GetNumberOfTuples();
+      tuples = this->NumberOfMembers;
+      workingSet.resize(static_cast<size_t>(tuples));
+      for (vtkIdType i = 0; i < tuples; i++)
+      {
+        workingSet[i] = this->Parents[i].load(std::memory_order_relaxed);
+      }
       controller->Send(&tuples, 1, myProc - pivot, tag + pivot + 0);
-      controller->Send(this->EquivalenceArray, myProc - pivot, tag + pivot + 1);
+      controller->Send(workingSet.data(), tuples, myProc - pivot, tag + pivot + 1);
     }
     else if ((myProc + pivot) < numProcs)
     {
       controller->Receive(&tuples, 1, myProc + pivot, tag + pivot + 0);
-      workingSet->SetNumberOfTuples(tuples);
-
-      controller->Receive(workingSet, myProc + pivot, tag + pivot + 1);
-      while (workingSet->GetNumberOfTuples() > this->EquivalenceArray->GetNumberOfTuples())
+      workingSet.resize(static_cast<size_t>(tuples));
+      controller->Receive(workingSet.data(), tuples, myProc + pivot, tag + pivot + 1);
+      this->SetNumberOfMembers(tuples);
+      for (vtkIdType i = 0; i < tuples; i++)
       {
-        this->EquivalenceArray->InsertNextTuple1(0);
-      }
-      for (int i = 0; i < workingSet->GetNumberOfTuples(); i++)
-      {
-        int workingVal = workingSet->GetValue(i);
+        // 0 is not a valid member id.
+        vtkIdType workingVal = workingSet[i];
         if (workingVal == 0)
         {
           continue;
         }
-        int existingVal = this->EquivalenceArray->GetValue(i);
-        this->EquivalenceArray->SetValue(i, workingVal);
-        if (existingVal != 0 && existingVal < workingVal)
-        {
-          this->EquateInternal(existingVal, workingVal);
-        }
+        this->AddEquivalence(i, workingVal);
       }
     }
     pivot /= 2;
   }
-  controller->Broadcast(this->EquivalenceArray, 0);
+
+  vtkIdType tuples = this->NumberOfMembers;
+  controller->Broadcast(&tuples, 1, 0);
+  workingSet.resize(static_cast<size_t>(tuples));
+  if (myProc == 0)
+  {
+    for (vtkIdType i = 0; i < tuples; i++)
+    {
+      workingSet[i] = this->FindRoot(i);
+    }
+  }
+  controller->Broadcast(workingSet.data(), tuples, 0);
+  if (myProc != 0)
+  {
+    this->Initialize();
+    this->SetNumberOfMembers(tuples);
+    for (vtkIdType i = 0; i < tuples; i++)
+    {
+      this->Parents[i].store(workingSet[i], std::memory_order_relaxed);
+    }
+  }
 
   this->Superclass::ResolveEquivalences();
   return 1;
@@ -34,7 +34,7 @@ public:
   static vtkPEquivalenceSet* New();
 
   // Globally equivalent set IDs are reassigned to be sequential.
-  int ResolveEquivalences() override;
+  vtkIdType ResolveEquivalences() override;
 
 protected:
   vtkPEquivalenceSet();
@@ -0,0 +1,479 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTemporalDataSetCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTemporalDataSetCache.h"
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataObjectTypes.h"
+#include "vtkFieldData.h"
+#include "vtkGenericDataObjectReader.h"
+#include "vtkGenericDataObjectWriter.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <vtksys/SystemInformation.hxx>
+#include <vtksys/SystemTools.hxx>
+
+class vtkPVTemporalDataSetCache::vtkInternals
+{
+public:
+  struct Item
+  {
+    // NULL when the time step is on disk, in FileName.
+    vtkSmartPointer<vtkDataObject> Data;
+    std::string FileName;
+    std::string ClassName;
+    // bytes in memory or on disk.
+    vtkTypeInt64 Size = 0;
+    // the input that was copied, to avoid copying it again.
+    vtkDataObject* Input = nullptr;
+    vtkMTimeType InputMTime = 0;
+    vtkIdType LastUsed = 0;
+  };
+  typedef std::map<double, Item> ItemsType;
+  ItemsType Items;
+  vtkIdType UseCounter = 0;
+  vtkIdType FileCounter = 0;
+  std::string FilePrefix;
+
+  //----------------------------------------------------------------------------
+  void Erase(ItemsType::iterator iter)
+  {
+    if (!iter->second.FileName.empty())
+    {
+      vtksys::SystemTools::RemoveFile(iter->second.FileName);
+    }
+    this->Items.erase(iter);
+  }
+
+  //----------------------------------------------------------------------------
+  void Clear()
+  {
+    while (!this->Items.empty())
+    {
+      this->Erase(this->Items.begin());
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Copies the input. Shallow copies of composite datasets also copy the
+  // leaves, so that changes to the input structure do not affect the copy.
+  static vtkSmartPointer<vtkDataObject> Copy(vtkDataObject* input, bool shallow)
+  {
+    vtkSmartPointer<vtkDataObject> copy;
+    copy.TakeReference(input->NewInstance());
+    vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
+    if (!shallow)
+    {
+      copy->DeepCopy(input);
+    }
+    else if (cdInput)
+    {
+      vtkCompositeDataSet* cdCopy = vtkCompositeDataSet::SafeDownCast(copy);
+      cdCopy->CopyStructure(cdInput);
+      cdCopy->GetFieldData()->ShallowCopy(cdInput->GetFieldData());
+      vtkSmartPointer<vtkCompositeDataIterator> iter;
+      iter.TakeReference(cdInput->NewIterator());
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+        vtkDataObject* leaf = iter->GetCurrentDataObject();
+        vtkSmartPointer<vtkDataObject> leafCopy;
+        leafCopy.TakeReference(leaf->NewInstance());
+        leafCopy->ShallowCopy(leaf);
+        cdCopy->SetDataSet(iter, leafCopy);
+      }
+    }
+    else
+    {
+      copy->ShallowCopy(input);
+    }
+    return copy;
+  }
+
+  //----------------------------------------------------------------------------
+  bool Spill(Item& item, const char* directory)
+  {
+    std::ostringstream fname;
+    fname << directory << "/" << this->FilePrefix << this->FileCounter++ << ".vtk";
+
+    vtkNew<vtkGenericDataObjectWriter> writer;
+    writer->SetFileName(fname.str().c_str());
+    writer->SetFileTypeToBinary();
+    writer->SetInputData(item.Data);
+    if (!writer->Write())
+    {
+      vtksys::SystemTools::RemoveFile(fname.str());
+      return false;
+    }
+    item.ClassName = item.Data->GetClassName();
+    item.Data = nullptr;
+    item.FileName = fname.str();
+    item.Size = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(item.FileName));
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  bool Reload(Item& item)
+  {
+    vtkNew<vtkGenericDataObjectReader> reader;
+    reader->SetFileName(item.FileName.c_str());
+    reader->ReadAllScalarsOn();
+    reader->ReadAllVectorsOn();
+    reader->ReadAllNormalsOn();
+    reader->ReadAllTensorsOn();
+    reader->ReadAllColorScalarsOn();
+    reader->ReadAllTCoordsOn();
+    reader->ReadAllFieldsOn();
+    reader->Update();
+    vtksys::SystemTools::RemoveFile(item.FileName);
+    item.FileName.clear();
+
+    vtkDataObject* data = reader->GetOutputDataObject(0);
+    if (!data || reader->GetErrorCode() != 0)
+    {
+      return false;
+    }
+    // the legacy format does not preserve all types, e.g. vtkImageData is read
+    // as vtkStructuredPoints.
+    item.Data.TakeReference(vtkDataObjectTypes::NewDataObject(item.ClassName.c_str()));
+    if (!item.Data)
+    {
+      item.Data = data;
+    }
+    else
+    {
+      item.Data->ShallowCopy(data);
+    }
+    item.Size = static_cast<vtkTypeInt64>(data->GetActualMemorySize()) * 1024;
+    item.Input = nullptr;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  void UpdateTimeSteps(vtkInformation* outInfo)
+  {
+    if (this->Items.empty())
+    {
+      outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+      return;
+    }
+    std::vector<double> times;
+    for (const auto& item : this->Items)
+    {
+      times.push_back(item.first);
+    }
+    double range[2] = { times.front(), times.back() };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times.data(),
+      static_cast<int>(times.size()));
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+  }
+};
+
+vtkStandardNewMacro(vtkPVTemporalDataSetCache);
+//----------------------------------------------------------------------------
+vtkPVTemporalDataSetCache::vtkPVTemporalDataSetCache()
+  : Internals(new vtkPVTemporalDataSetCache::vtkInternals())
+{
+  this->ShallowCopyInput = false;
+  this->MemoryLimit = 0;
+  this->SpillDirectory = nullptr;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->NumberOfSpills = 0;
+  this->NumberOfReloads = 0;
+
+  // ranks on the same node may share the spill directory.
+  vtksys::SystemInformation sysInfo;
+  std::ostringstream prefix;
+  prefix << "vtkPVTemporalDataSetCache_" << sysInfo.GetProcessId() << "_" << this << "_";
+  this->Internals->FilePrefix = prefix.str();
+}
+
+//----------------------------------------------------------------------------
+vtkPVTemporalDataSetCache::~vtkPVTemporalDataSetCache()
+{
+  this->Internals->Clear();
+  this->SetSpillDirectory(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTemporalDataSetCache::ClearCache()
+{
+  if (!this->Internals->Items.empty())
+  {
+    this->Internals->Clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTemporalDataSetCache::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->NumberOfSpills = 0;
+  this->NumberOfReloads = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTemporalDataSetCache::GetNumberOfCachedTimeSteps()
+{
+  int count = 0;
+  for (const auto& item : this->Internals->Items)
+  {
+    count += item.second.Data ? 1 : 0;
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkPVTemporalDataSetCache::GetCachedMemorySize()
+{
+  vtkTypeInt64 size = 0;
+  for (const auto& item : this->Internals->Items)
+  {
+    size += item.second.Data ? item.second.Size : 0;
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTemporalDataSetCache::GetNumberOfSpilledTimeSteps()
+{
+  return static_cast<int>(this->Internals->Items.size()) - this->GetNumberOfCachedTimeSteps();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkPVTemporalDataSetCache::GetSpilledSize()
+{
+  vtkTypeInt64 size = 0;
+  for (const auto& item : this->Internals->Items)
+  {
+    size += item.second.Data ? 0 : item.second.Size;
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTemporalDataSetCache::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  // time steps of the input are passed by the executive.
+  if (!inInfo || !inInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+  {
+    this->Internals->UpdateTimeSteps(outInfo);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTemporalDataSetCache::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  if (!inInfo || !outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()))
+  {
+    return 1;
+  }
+
+  // when the time step is cached, request the time the input already has so
+  // that it does not execute.
+  const double upTime = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+  vtkDataObject* input = vtkDataObject::GetData(inInfo);
+  if (input && input->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()) &&
+    this->Internals->Items.find(upTime) != this->Internals->Items.end())
+  {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+      input->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP()));
+  }
+  else
+  {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), upTime);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTemporalDataSetCache::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject* input = inInfo ? vtkDataObject::GetData(inInfo) : nullptr;
+  auto& items = this->Internals->Items;
+
+  const bool hasUpTime = outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) != 0;
+  double upTime =
+    hasUpTime ? outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) : 0.0;
+
+  // cache the input, unless it already is.
+  double inTime = upTime;
+  if (input)
+  {
+    if (input->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()))
+    {
+      inTime = input->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP());
+    }
+    upTime = hasUpTime ? upTime : inTime;
+
+    auto iter = items.find(inTime);
+    if (iter == items.end() || iter->second.Input != input ||
+      iter->second.InputMTime != input->GetMTime())
+    {
+      if (iter != items.end())
+      {
+        this->Internals->Erase(iter);
+      }
+      vtkInternals::Item& item = items[inTime];
+      item.Data = vtkInternals::Copy(input, this->ShallowCopyInput);
+      item.Size = static_cast<vtkTypeInt64>(item.Data->GetActualMemorySize()) * 1024;
+      item.Input = input;
+      item.InputMTime = input->GetMTime();
+      item.LastUsed = ++this->Internals->UseCounter;
+      if (!inInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+      {
+        this->Internals->UpdateTimeSteps(outInfo);
+      }
+    }
+  }
+
+  auto iter = items.find(upTime);
+  if (iter != items.end() && !iter->second.Data)
+  {
+    if (!this->Internals->Reload(iter->second))
+    {
+      vtkErrorMacro("Failed to read cached time step " << upTime << ".");
+      items.erase(iter);
+      iter = items.end();
+    }
+    else
+    {
+      ++this->NumberOfReloads;
+    }
+  }
+  if (input && upTime != inTime)
+  {
+    if (iter != items.end())
+    {
+      ++this->NumberOfHits;
+    }
+    else
+    {
+      ++this->NumberOfMisses;
+    }
+  }
+
+  vtkDataObject* source = input;
+  if (iter != items.end())
+  {
+    source = iter->second.Data;
+    iter->second.LastUsed = ++this->Internals->UseCounter;
+  }
+  else
+  {
+    upTime = inTime;
+  }
+  // `source` is referenced by the output or by the cache, which keeps the
+  // time step being served.
+  this->Evict(upTime);
+  if (!source)
+  {
+    return 1;
+  }
+
+  vtkDataObject* output = vtkDataObject::GetData(outInfo);
+  if (!output || strcmp(output->GetClassName(), source->GetClassName()) != 0)
+  {
+    output = source->NewInstance();
+    outInfo->Set(vtkDataObject::DATA_OBJECT(), output);
+    output->FastDelete();
+  }
+  output->ShallowCopy(source);
+  output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), upTime);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTemporalDataSetCache::Evict(double keep)
+{
+  auto& items = this->Internals->Items;
+  const bool spill = this->SpillDirectory && *this->SpillDirectory;
+  while (true)
+  {
+    int count = 0;
+    vtkTypeInt64 size = 0;
+    auto victim = items.end();
+    for (auto iter = items.begin(); iter != items.end(); ++iter)
+    {
+      if (iter->second.Data)
+      {
+        ++count;
+        size += iter->second.Size;
+        if (iter->first != keep &&
+          (victim == items.end() || iter->second.LastUsed < victim->second.LastUsed))
+        {
+          victim = iter;
+        }
+      }
+    }
+    if (victim == items.end() ||
+      (count <= this->GetCacheSize() && (this->MemoryLimit == 0 || size <= this->MemoryLimit)))
+    {
+      return;
+    }
+
+    ++this->NumberOfEvictions;
+    if (spill && this->Internals->Spill(victim->second, this->SpillDirectory))
+    {
+      ++this->NumberOfSpills;
+    }
+    else
+    {
+      this->Internals->Erase(victim);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTemporalDataSetCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ShallowCopyInput: " << this->ShallowCopyInput << endl;
+  os << indent << "MemoryLimit: " << this->MemoryLimit << endl;
+  os << indent << "SpillDirectory: " << (this->SpillDirectory ? this->SpillDirectory : "(none)")
+     << endl;
+  os << indent << "NumberOfHits: " << this->NumberOfHits << endl;
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
+  os << indent << "NumberOfSpills: " << this->NumberOfSpills << endl;
+  os << indent << "NumberOfReloads: " << this->NumberOfReloads << endl;
+}
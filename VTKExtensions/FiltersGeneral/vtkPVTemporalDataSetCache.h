@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTemporalDataSetCache.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVTemporalDataSetCache
+ * @brief   temporal cache with a memory budget, used by Catalyst.
+ *
+ * vtkPVTemporalDataSetCache is a vtkTemporalDataSetCache meant for in situ
+ * use, where the input is simulation data and each time step can be large.
+ *
+ * By default each time step is deep copied, as in vtkTemporalDataSetCache.
+ * When ShallowCopyInput is on, the cache keeps shallow copies of the input
+ * instead, i.e. references to the input arrays. This is only valid if the
+ * producer of the input never modifies these arrays once they are given to
+ * the cache, e.g. if the simulation allocates new buffers for each time step.
+ *
+ * The number of time steps kept in memory is limited by CacheSize and, if
+ * MemoryLimit is not 0, by the total memory used by the cached time steps.
+ * When a limit is exceeded, the least recently used time steps are evicted.
+ * If SpillDirectory is set, evicted time steps are written to files in that
+ * directory, typically on a node-local disk, and read back when requested.
+ * The files are removed when they are read back or when the cache is cleared.
+ *
+ * If the input does not provide time steps, the times of the cached time
+ * steps are reported as the time steps of the output.
+*/
+
+#ifndef vtkPVTemporalDataSetCache_h
+#define vtkPVTemporalDataSetCache_h
+
+#include "vtkPVVTKExtensionsFiltersGeneralModule.h" //needed for exports
+#include "vtkTemporalDataSetCache.h"
+
+#include <memory> // for std::unique_ptr
+
+class VTKPVVTKEXTENSIONSFILTERSGENERAL_EXPORT vtkPVTemporalDataSetCache
+  : public vtkTemporalDataSetCache
+{
+public:
+  static vtkPVTemporalDataSetCache* New();
+  vtkTypeMacro(vtkPVTemporalDataSetCache, vtkTemporalDataSetCache);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * When on, the cache keeps shallow copies of the input instead of deep
+   * copies. Only turn this on if the input arrays are not modified after they
+   * are cached. The value in effect when a time step is cached is used for
+   * that time step. Default is off.
+   */
+  vtkSetMacro(ShallowCopyInput, bool);
+  vtkGetMacro(ShallowCopyInput, bool);
+  vtkBooleanMacro(ShallowCopyInput, bool);
+  //@}
+
+  //@{
+  /**
+   * Maximum memory, in bytes, used by the time steps kept in memory. 0 means
+   * no limit other than CacheSize. The most recently used time step is always
+   * kept, even if it exceeds the limit. Default is 0.
+   */
+  vtkSetClampMacro(MemoryLimit, vtkTypeInt64, 0, VTK_TYPE_INT64_MAX);
+  vtkGetMacro(MemoryLimit, vtkTypeInt64);
+  //@}
+
+  //@{
+  /**
+   * Directory where evicted time steps are written. When not set (default),
+   * evicted time steps are discarded.
+   */
+  vtkSetStringMacro(SpillDirectory);
+  vtkGetStringMacro(SpillDirectory);
+  //@}
+
+  /**
+   * Remove all cached time steps, including the ones written to disk.
+   */
+  void ClearCache();
+
+  //@{
+  /**
+   * Statistics. A hit is a request for a time step, other than the one of the
+   * current input, that was served from the cache; a miss is one that was
+   * not. Evictions count the time steps removed from memory, including the
+   * ones written to disk, which are also counted as spills. Reloads count the
+   * time steps read back from disk.
+   */
+  vtkGetMacro(NumberOfHits, vtkIdType);
+  vtkGetMacro(NumberOfMisses, vtkIdType);
+  vtkGetMacro(NumberOfEvictions, vtkIdType);
+  vtkGetMacro(NumberOfSpills, vtkIdType);
+  vtkGetMacro(NumberOfReloads, vtkIdType);
+  void ResetStatistics();
+  //@}
+
+  //@{
+  /**
+   * Current state of the cache: number of time steps and bytes kept in memory
+   * and written to disk.
+   */
+  int GetNumberOfCachedTimeSteps();
+  vtkTypeInt64 GetCachedMemorySize();
+  int GetNumberOfSpilledTimeSteps();
+  vtkTypeInt64 GetSpilledSize();
+  //@}
+
+protected:
+  vtkPVTemporalDataSetCache();
+  ~vtkPVTemporalDataSetCache() override;
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  bool ShallowCopyInput;
+  vtkTypeInt64 MemoryLimit;
+  char* SpillDirectory;
+
+  vtkIdType NumberOfHits;
+  vtkIdType NumberOfMisses;
+  vtkIdType NumberOfEvictions;
+  vtkIdType NumberOfSpills;
+  vtkIdType NumberOfReloads;
+
+private:
+  vtkPVTemporalDataSetCache(const vtkPVTemporalDataSetCache&) = delete;
+  void operator=(const vtkPVTemporalDataSetCache&) = delete;
+
+  // Evicts time steps until the cache fits in the limits. The time step at
+  // `keep` is never evicted.
+  void Evict(double keep);
+
+  class vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+};
+
+#endif
@@ -2448,7 +2448,7 @@ void vtkRectilinearGridConnectivity::AddPolygonsToFaceHash(int blockIdx, vtkPoly
     }
 
     // update the smallest fragment Id used so far
-    minIndex = this->EquivalenceSet->GetEquivalentSetId(minIndex);
+    minIndex = static_cast<int>(this->EquivalenceSet->GetEquivalentSetId(minIndex));
 
     // Label the new faces of the volume with the final (smallest) fragment id.
     for (int k = 0; k < newIndex; k++)
@@ -2558,7 +2558,8 @@ void vtkRectilinearGridConnectivity::ResolveFaceFragmentIds()
 
   while ((thisFace = this->FaceHash->GetNextFace()))
   {
-    thisFace->FragmentId = this->EquivalenceSet->GetEquivalentSetId(thisFace->FragmentId);
+    thisFace->FragmentId =
+      static_cast<short>(this->EquivalenceSet->GetEquivalentSetId(thisFace->FragmentId));
   }
 
   thisFace = NULL;
@@ -3133,7 +3134,7 @@ void vtkRectilinearGridConnectivity::AddPolygonsToFaceHash(
       }
 
       // update the smallest fragment Id used so far
-      minIndex = this->EquivalenceSet->GetEquivalentSetId(minIndex);
+      minIndex = static_cast<int>(this->EquivalenceSet->GetEquivalentSetId(minIndex));
 
       // Label the new faces of the 'macro' volume with the final (smallest)
       // fragment id.
@@ -3806,7 +3807,7 @@ void vtkRectilinearGridConnectivity::AddInterProcessPolygonsToFaceHash(
       }
 
       // update the smallest fragment Id used so far
-      minIndex = this->EquivalenceSet->GetEquivalentSetId(minIndex);
+      minIndex = static_cast<int>(this->EquivalenceSet->GetEquivalentSetId(minIndex));
 
       // Label the new faces of the 'macro' volume with the final (smallest)
       // fragment id.
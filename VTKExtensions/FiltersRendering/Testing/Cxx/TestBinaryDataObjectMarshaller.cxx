@@ -0,0 +1,467 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestBinaryDataObjectMarshaller.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkBinaryDataObjectMarshaller.h"
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCommunicator.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+// One end of an in-process pair of communicators. Each end has a queue of the
+// messages sent to it; tags are ignored since each direction carries a single
+// stream.
+class vtkPairedCommunicator : public vtkCommunicator
+{
+public:
+  static vtkPairedCommunicator* New();
+  vtkTypeMacro(vtkPairedCommunicator, vtkCommunicator);
+
+  struct Channel
+  {
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    std::deque<std::vector<char> > Queues[2];
+  };
+
+  void Connect(std::shared_ptr<Channel> channel, int localId)
+  {
+    this->SharedChannel = channel;
+    this->LocalId = localId;
+  }
+
+  int SendVoidArray(const void* data, vtkIdType length, int type, int remoteHandle, int) override
+  {
+    const char* bytes = static_cast<const char*>(data);
+    const vtkIdType nbytes = length * vtkAbstractArray::GetDataTypeSize(type);
+    std::lock_guard<std::mutex> lock(this->SharedChannel->Mutex);
+    this->SharedChannel->Queues[remoteHandle].emplace_back(bytes, bytes + nbytes);
+    this->SharedChannel->Condition.notify_all();
+    return 1;
+  }
+
+  int ReceiveVoidArray(void* data, vtkIdType maxlength, int type, int, int) override
+  {
+    const vtkIdType typeSize = vtkAbstractArray::GetDataTypeSize(type);
+    std::unique_lock<std::mutex> lock(this->SharedChannel->Mutex);
+    auto& queue = this->SharedChannel->Queues[this->LocalId];
+    this->SharedChannel->Condition.wait(lock, [&queue]() { return !queue.empty(); });
+    const std::vector<char> message = std::move(queue.front());
+    queue.pop_front();
+    if (static_cast<vtkIdType>(message.size()) > maxlength * typeSize)
+    {
+      return 0;
+    }
+    if (!message.empty())
+    {
+      memcpy(data, message.data(), message.size());
+    }
+    this->Count = static_cast<vtkIdType>(message.size()) / typeSize;
+    return 1;
+  }
+
+protected:
+  vtkPairedCommunicator() = default;
+  ~vtkPairedCommunicator() override = default;
+
+private:
+  std::shared_ptr<Channel> SharedChannel;
+  int LocalId = 0;
+};
+vtkStandardNewMacro(vtkPairedCommunicator);
+
+vtkSmartPointer<vtkDataObject> RoundTrip(vtkDataObject* input)
+{
+  vtkNew<vtkBinaryDataObjectMarshaller> marshaller;
+  if (!marshaller->Marshal(input))
+  {
+    return nullptr;
+  }
+  std::vector<char> buffer(marshaller->GetPackedLength());
+  marshaller->Pack(buffer.data());
+  if (!vtkBinaryDataObjectMarshaller::IsMarshalledBuffer(
+        buffer.data(), static_cast<vtkIdType>(buffer.size())))
+  {
+    return nullptr;
+  }
+  vtkSmartPointer<vtkDataObject> result;
+  result.TakeReference(vtkBinaryDataObjectMarshaller::Unmarshal(
+    buffer.data(), static_cast<vtkIdType>(buffer.size())));
+  return result;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a == nullptr || b == nullptr || a->GetDataType() != b->GetDataType() ||
+    a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < a->GetNumberOfValues(); ++cc)
+  {
+    if (a->GetComponent(cc / a->GetNumberOfComponents(), cc % a->GetNumberOfComponents()) !=
+      b->GetComponent(cc / b->GetNumberOfComponents(), cc % b->GetNumberOfComponents()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestPolyData()
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToFloat();
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(1, 1, 0);
+  points->InsertNextPoint(0, 1, 0);
+
+  vtkNew<vtkCellArray> polys;
+  vtkIdType quad[4] = { 0, 1, 2, 3 };
+  vtkIdType tri[3] = { 0, 1, 2 };
+  polys->InsertNextCell(4, quad);
+  polys->InsertNextCell(3, tri);
+
+  vtkNew<vtkPolyData> pd;
+  pd->SetPoints(points);
+  pd->SetPolys(polys);
+
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  for (vtkIdType cc = 0; cc < 4; ++cc)
+  {
+    scalars->InsertNextValue(cc * 0.5);
+  }
+  pd->GetPointData()->SetScalars(scalars);
+
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("ids");
+  ids->InsertNextValue(10);
+  ids->InsertNextValue(20);
+  pd->GetCellData()->AddArray(ids);
+
+  vtkPolyData* result = vtkPolyData::SafeDownCast(RoundTrip(pd));
+  if (result == nullptr)
+  {
+    cerr << "Failed to round-trip vtkPolyData." << endl;
+    return false;
+  }
+  if (result->GetNumberOfPoints() != 4 || result->GetNumberOfPolys() != 2 ||
+    !SameArrays(result->GetPoints()->GetData(), points->GetData()) ||
+    !SameArrays(result->GetPointData()->GetScalars(), scalars) ||
+    !SameArrays(result->GetCellData()->GetArray("ids"), ids))
+  {
+    cerr << "vtkPolyData does not match after round-trip." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestImageData()
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(2, 5, 0, 3, 1, 1);
+  image->SetOrigin(1, 2, 3);
+  image->SetSpacing(0.5, 0.5, 1);
+
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType cc = 0; cc < vectors->GetNumberOfValues(); ++cc)
+  {
+    vectors->SetValue(cc, static_cast<float>(cc));
+  }
+  image->GetPointData()->SetVectors(vectors);
+
+  vtkImageData* result = vtkImageData::SafeDownCast(RoundTrip(image));
+  if (result == nullptr)
+  {
+    cerr << "Failed to round-trip vtkImageData." << endl;
+    return false;
+  }
+  int* extent = result->GetExtent();
+  double* origin = result->GetOrigin();
+  if (extent[0] != 2 || extent[1] != 5 || extent[3] != 3 || origin[2] != 3 ||
+    result->GetSpacing()[0] != 0.5 || !SameArrays(result->GetPointData()->GetVectors(), vectors))
+  {
+    cerr << "vtkImageData does not match after round-trip." << endl;
+    return false;
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> CreateUnstructuredGrid()
+{
+  vtkNew<vtkPoints> points;
+  for (int cc = 0; cc < 8; ++cc)
+  {
+    points->InsertNextPoint(cc & 1, (cc >> 1) & 1, (cc >> 2) & 1);
+  }
+  points->InsertNextPoint(0.5, 0.5, 2);
+
+  auto ug = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  ug->SetPoints(points);
+  vtkIdType hex[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+  vtkIdType pyramid[5] = { 4, 5, 7, 6, 8 };
+  vtkIdType tri[3] = { 0, 1, 8 };
+  ug->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+  ug->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+  ug->InsertNextCell(VTK_TRIANGLE, 3, tri);
+
+  vtkNew<vtkFloatArray> temperature;
+  temperature->SetName("temperature");
+  for (vtkIdType cc = 0; cc < ug->GetNumberOfPoints(); ++cc)
+  {
+    temperature->InsertNextValue(static_cast<float>(cc) * 1.5f);
+  }
+  ug->GetPointData()->SetScalars(temperature);
+
+  vtkNew<vtkIntArray> material;
+  material->SetName("material");
+  material->InsertNextValue(3);
+  material->InsertNextValue(7);
+  material->InsertNextValue(11);
+  ug->GetCellData()->AddArray(material);
+  return ug;
+}
+
+bool SameUnstructuredGrids(vtkUnstructuredGrid* result, vtkUnstructuredGrid* ug)
+{
+  if (result == nullptr || result->GetNumberOfPoints() != ug->GetNumberOfPoints() ||
+    result->GetNumberOfCells() != ug->GetNumberOfCells() ||
+    !SameArrays(result->GetPoints()->GetData(), ug->GetPoints()->GetData()) ||
+    !SameArrays(result->GetCellTypesArray(), ug->GetCellTypesArray()) ||
+    !SameArrays(result->GetCells()->GetOffsetsArray(), ug->GetCells()->GetOffsetsArray()) ||
+    !SameArrays(
+      result->GetCells()->GetConnectivityArray(), ug->GetCells()->GetConnectivityArray()) ||
+    !SameArrays(result->GetPointData()->GetScalars(), ug->GetPointData()->GetScalars()) ||
+    !SameArrays(
+      result->GetCellData()->GetArray("material"), ug->GetCellData()->GetArray("material")))
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < ug->GetNumberOfCells(); ++cc)
+  {
+    if (result->GetCellType(cc) != ug->GetCellType(cc) ||
+      result->GetCell(cc)->GetNumberOfPoints() != ug->GetCell(cc)->GetNumberOfPoints())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestUnstructuredGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> ug = CreateUnstructuredGrid();
+  if (!vtkBinaryDataObjectMarshaller::CanMarshal(ug))
+  {
+    cerr << "vtkUnstructuredGrid without polyhedra must be supported." << endl;
+    return false;
+  }
+  vtkSmartPointer<vtkDataObject> result = RoundTrip(ug);
+  if (!SameUnstructuredGrids(vtkUnstructuredGrid::SafeDownCast(result), ug))
+  {
+    cerr << "vtkUnstructuredGrid does not match after round-trip." << endl;
+    return false;
+  }
+  return true;
+}
+
+// A receiver that cannot decode a header must still consume the buffers that
+// follow it, so that the next transfer on the same communicator succeeds.
+bool TestUndecodableHeader()
+{
+  auto channel = std::make_shared<vtkPairedCommunicator::Channel>();
+  vtkNew<vtkPairedCommunicator> senderComm;
+  senderComm->Connect(channel, 0);
+  vtkNew<vtkPairedCommunicator> receiverComm;
+  receiverComm->Connect(channel, 1);
+
+  vtkSmartPointer<vtkUnstructuredGrid> ug = CreateUnstructuredGrid();
+  bool sent = false;
+  std::thread senderThread([&]() {
+    // a header from an incompatible format version, announcing two buffers.
+    const vtkTypeInt64 badHeader[4] = { 99, 0x01020304, sizeof(vtkIdType), VTK_POLY_DATA };
+    vtkIdType sizes[2] = { sizeof(badHeader), 2 };
+    vtkIdType lengths[2] = { 24, 16 };
+    std::vector<char> buffer(24, 0);
+    vtkNew<vtkBinaryDataObjectMarshaller> sender;
+    sent = senderComm->Send(sizes, 2, 1, 1000) &&
+      senderComm->Send(reinterpret_cast<const char*>(badHeader), sizes[0], 1, 1000) &&
+      senderComm->Send(lengths, 2, 1, 1000) &&
+      senderComm->Send(buffer.data(), lengths[0], 1, 1000) &&
+      senderComm->Send(buffer.data(), lengths[1], 1, 1000) && sender->Marshal(ug) &&
+      sender->Send(senderComm, 1, 1000);
+  });
+  vtkSmartPointer<vtkDataObject> rejected;
+  rejected.TakeReference(vtkBinaryDataObjectMarshaller::Receive(receiverComm, 0, 1000));
+  vtkSmartPointer<vtkDataObject> result;
+  result.TakeReference(vtkBinaryDataObjectMarshaller::Receive(receiverComm, 0, 1000));
+  senderThread.join();
+
+  if (!sent || rejected != nullptr)
+  {
+    cerr << "Undecodable header was not rejected." << endl;
+    return false;
+  }
+  if (!SameUnstructuredGrids(vtkUnstructuredGrid::SafeDownCast(result), ug))
+  {
+    cerr << "Transfer following an undecodable header failed." << endl;
+    return false;
+  }
+  return true;
+}
+
+// Sends `input` from `sender` to `receiver` with an incremental transfer.
+vtkSmartPointer<vtkPolyData> IncrementalTransfer(vtkPolyData* input,
+  vtkBinaryDataObjectMarshaller* sender, vtkBinaryDataObjectMarshaller* receiver,
+  vtkIdType& skippedLength)
+{
+  auto channel = std::make_shared<vtkPairedCommunicator::Channel>();
+  vtkNew<vtkPairedCommunicator> senderComm;
+  senderComm->Connect(channel, 0);
+  vtkNew<vtkPairedCommunicator> receiverComm;
+  receiverComm->Connect(channel, 1);
+
+  bool sent = false;
+  std::thread senderThread([&]() {
+    sent = sender->Marshal(input) && sender->SendIncremental(senderComm, 1, 1000);
+  });
+  vtkSmartPointer<vtkDataObject> result;
+  result.TakeReference(receiver->ReceiveIncremental(receiverComm, 0, 1000));
+  senderThread.join();
+
+  skippedLength = sender->GetLastSkippedLength();
+  if (!sent || receiver->GetLastSkippedLength() != skippedLength)
+  {
+    cerr << "Incremental transfer failed." << endl;
+    return nullptr;
+  }
+  return vtkPolyData::SafeDownCast(result);
+}
+
+bool TestIncremental()
+{
+  vtkNew<vtkPoints> points;
+  for (int cc = 0; cc < 100; ++cc)
+  {
+    points->InsertNextPoint(cc, cc % 10, 0);
+  }
+  vtkNew<vtkPolyData> pd;
+  pd->SetPoints(points);
+
+  vtkNew<vtkIntArray> fixed;
+  fixed->SetName("fixed");
+  vtkNew<vtkDoubleArray> varying;
+  varying->SetName("varying");
+  for (int cc = 0; cc < 100; ++cc)
+  {
+    fixed->InsertNextValue(cc);
+    varying->InsertNextValue(0);
+  }
+  pd->GetPointData()->AddArray(fixed);
+  pd->GetPointData()->AddArray(varying);
+
+  vtkNew<vtkBinaryDataObjectMarshaller> sender;
+  vtkNew<vtkBinaryDataObjectMarshaller> receiver;
+  vtkIdType skipped;
+
+  // the first transfer sends everything.
+  vtkSmartPointer<vtkPolyData> first = IncrementalTransfer(pd, sender, receiver, skipped);
+  if (!first || skipped != 0 || !SameArrays(first->GetPointData()->GetArray("fixed"), fixed) ||
+    !SameArrays(first->GetPointData()->GetArray("varying"), varying))
+  {
+    cerr << "First incremental transfer is incorrect." << endl;
+    return false;
+  }
+
+  // only the modified array is sent again, the others are reused.
+  for (int cc = 0; cc < 100; ++cc)
+  {
+    varying->SetValue(cc, cc * 0.5);
+  }
+  varying->Modified();
+  vtkSmartPointer<vtkPolyData> second = IncrementalTransfer(pd, sender, receiver, skipped);
+  const vtkIdType unchangedLength = points->GetData()->GetDataSize() * sizeof(float) +
+    fixed->GetDataSize() * static_cast<vtkIdType>(sizeof(int));
+  if (!second || skipped != unchangedLength ||
+    second->GetPointData()->GetArray("fixed") != first->GetPointData()->GetArray("fixed") ||
+    second->GetPoints()->GetData() != first->GetPoints()->GetData() ||
+    second->GetPointData()->GetArray("varying") == first->GetPointData()->GetArray("varying") ||
+    !SameArrays(second->GetPointData()->GetArray("varying"), varying) ||
+    !SameArrays(second->GetPointData()->GetArray("fixed"), fixed))
+  {
+    cerr << "Second incremental transfer did not reuse the unchanged arrays (skipped " << skipped
+         << " bytes instead of " << unchangedLength << ")." << endl;
+    return false;
+  }
+
+  // a transfer to another receiver leaves the first one with a stale history
+  // id, the next transfer to it must send everything.
+  vtkNew<vtkBinaryDataObjectMarshaller> otherReceiver;
+  vtkSmartPointer<vtkPolyData> other = IncrementalTransfer(pd, sender, otherReceiver, skipped);
+  if (!other || skipped != 0)
+  {
+    cerr << "Transfer to a new receiver skipped data." << endl;
+    return false;
+  }
+  vtkSmartPointer<vtkPolyData> third = IncrementalTransfer(pd, sender, receiver, skipped);
+  if (!third || skipped != 0 ||
+    third->GetPointData()->GetArray("fixed") == second->GetPointData()->GetArray("fixed") ||
+    !SameArrays(third->GetPointData()->GetArray("fixed"), fixed) ||
+    !SameArrays(third->GetPointData()->GetArray("varying"), varying))
+  {
+    cerr << "Transfer with a stale history id was not complete." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestBinaryDataObjectMarshaller(int, char* [])
+{
+  return (TestPolyData() && TestImageData() && TestUnstructuredGrid() && TestIncremental() &&
+           TestUndecodableHeader())
+    ? TEST_SUCCESS
+    : TEST_FAILED;
+}
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMPIMoveDataCompression.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that data marshalled by vtkMPIMoveData survives a compress /
+// decompress round trip with the zlib and LZ4 chunked codecs, for data that
+// fits in one chunk and for data split in many chunks, with both the legacy
+// writer and the binary marshaller.
+
+#include "vtkCellArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMPIMoveData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+#include <cmath>
+#include <cstring>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+// Exposes the marshalling and compression steps of vtkMPIMoveData, which are
+// otherwise only reached through inter-process transfers.
+class vtkTestMPIMoveData : public vtkMPIMoveData
+{
+public:
+  static vtkTestMPIMoveData* New();
+  vtkTypeMacro(vtkTestMPIMoveData, vtkMPIMoveData);
+
+  // Marshals and compresses `input`, then decompresses and unmarshals the
+  // buffer into `output`. Returns the number of compressed chunks, 0 if the
+  // buffer was not compressed.
+  vtkTypeInt64 RoundTrip(vtkDataObject* input, vtkDataObject* output)
+  {
+    this->ClearBuffer();
+    this->ResetTimings();
+    this->MarshalDataToBuffer(input);
+    vtkTypeInt64 numberOfChunks = 0;
+    if (this->NumberOfBuffers == 1 && this->BufferTotalLength > 32 &&
+      memcmp(this->Buffers, "pvcz", 4) == 0)
+    {
+      memcpy(&numberOfChunks, this->Buffers + 24, sizeof(numberOfChunks));
+    }
+    this->ReconstructDataFromBuffer(output);
+    this->ClearBuffer();
+    return numberOfChunks;
+  }
+
+protected:
+  vtkTestMPIMoveData() = default;
+  ~vtkTestMPIMoveData() override = default;
+};
+vtkStandardNewMacro(vtkTestMPIMoveData);
+
+vtkSmartPointer<vtkPolyData> CreatePolyData(vtkIdType numberOfPoints)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numberOfPoints);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(numberOfPoints);
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(static_cast<int>(numberOfPoints));
+  for (vtkIdType cc = 0; cc < numberOfPoints; ++cc)
+  {
+    points->SetPoint(cc, cc % 100, (cc / 100) % 100, cc / 10000);
+    scalars->SetValue(cc, static_cast<float>(std::sin(cc * 0.01)));
+    verts->InsertCellPoint(cc);
+  }
+  auto pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->SetVerts(verts);
+  pd->GetPointData()->SetScalars(scalars);
+  return pd;
+}
+
+bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells() || !b->GetPointData()->GetScalars())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < a->GetNumberOfPoints(); ++cc)
+  {
+    double pa[3], pb[3];
+    a->GetPoint(cc, pa);
+    b->GetPoint(cc, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2] ||
+      a->GetPointData()->GetScalars()->GetTuple1(cc) !=
+        b->GetPointData()->GetScalars()->GetTuple1(cc))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestRoundTrip(int codec, vtkIdType numberOfPoints, bool binary)
+{
+  const char* codecName = codec == vtkMPIMoveData::COMPRESSION_ZLIB ? "zlib" : "LZ4";
+  vtkMPIMoveData::SetUseBinaryMarshalling(binary);
+  vtkNew<vtkTestMPIMoveData> mover;
+  mover->SetCompressionCodec(codec);
+  mover->SetCompressionChunkSize(65536);
+
+  vtkSmartPointer<vtkPolyData> input = CreatePolyData(numberOfPoints);
+  vtkNew<vtkPolyData> output;
+  const vtkTypeInt64 numberOfChunks = mover->RoundTrip(input, output);
+  vtkMPIMoveData::SetUseBinaryMarshalling(false);
+
+  // the raw data is at least 16 bytes per point.
+  const vtkTypeInt64 minChunks = (numberOfPoints * 16 + 65535) / 65536;
+  if (numberOfChunks < minChunks || (numberOfPoints <= 100 && numberOfChunks != 1))
+  {
+    cerr << codecName << ", " << numberOfPoints << " points: " << numberOfChunks
+         << " chunks, expected " << (numberOfPoints <= 100 ? "1" : "more") << endl;
+    return false;
+  }
+  if (numberOfChunks > 1 && mover->GetLastCompressedSize() >= mover->GetLastUncompressedSize())
+  {
+    cerr << codecName << ", " << numberOfPoints << " points: compressed size "
+         << mover->GetLastCompressedSize() << " is not less than "
+         << mover->GetLastUncompressedSize() << endl;
+    return false;
+  }
+  if (!SamePolyData(input, output))
+  {
+    cerr << codecName << ", " << numberOfPoints << " points"
+         << (binary ? ", binary marshalling" : "") << ": data differs after round trip." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestMPIMoveDataCompression(int, char* [])
+{
+  const int codecs[] = { vtkMPIMoveData::COMPRESSION_ZLIB, vtkMPIMoveData::COMPRESSION_LZ4 };
+  const vtkIdType sizes[] = { 100, 200000 };
+  for (int codec : codecs)
+  {
+    for (vtkIdType numberOfPoints : sizes)
+    {
+      if (!TestRoundTrip(codec, numberOfPoints, false) ||
+        !TestRoundTrip(codec, numberOfPoints, true))
+      {
+        return TEST_FAILED;
+      }
+    }
+  }
+
+  // SetUseZLibCompression() sets the default codec of new instances.
+  vtkMPIMoveData::SetUseZLibCompression(true);
+  vtkNew<vtkMPIMoveData> zlibMover;
+  vtkMPIMoveData::SetUseZLibCompression(false);
+  if (zlibMover->GetCompressionCodec() != vtkMPIMoveData::COMPRESSION_ZLIB)
+  {
+    cerr << "SetUseZLibCompression(true) does not select zlib." << endl;
+    return TEST_FAILED;
+  }
+  return TEST_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterParallelBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPVGeometryFilter::ExecuteBlocksInParallel produces the same
+// output as the serial path and reports the speedup for a range of thread
+// counts. Pass `--blocks N` to change the number of leaves.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+vtkSmartPointer<vtkMultiBlockDataSet> CreateInput(unsigned int numBlocks)
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(0, 15, 0, 15, 0, 15);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(source->GetOutputPort());
+  tetrahedralize->Update();
+
+  auto mb = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  mb->SetNumberOfBlocks(numBlocks);
+  for (unsigned int cc = 0; cc < numBlocks; ++cc)
+  {
+    // deep copy so that blocks do not share any state.
+    vtkNew<vtkUnstructuredGrid> block;
+    block->DeepCopy(tetrahedralize->GetOutput());
+    mb->SetBlock(cc, block);
+  }
+  return mb;
+}
+
+double Execute(vtkMultiBlockDataSet* input, bool parallel, std::vector<vtkIdType>& counts)
+{
+  vtkNew<vtkPVGeometryFilter> filter;
+  filter->SetUseOutline(0);
+  filter->SetExecuteBlocksInParallel(parallel);
+  filter->SetInputData(input);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  filter->Update();
+  timer->StopTimer();
+
+  counts.clear();
+  vtkCompositeDataSet* output = vtkCompositeDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(output->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+    counts.push_back(iter->GetCurrentFlatIndex());
+    counts.push_back(pd ? pd->GetNumberOfPoints() : -1);
+    counts.push_back(pd ? pd->GetNumberOfCells() : -1);
+  }
+  return timer->GetElapsedTime();
+}
+}
+
+int TestPVGeometryFilterParallelBlocks(int argc, char* argv[])
+{
+  unsigned int numBlocks = 64;
+  for (int cc = 1; cc + 1 < argc; ++cc)
+  {
+    if (strcmp(argv[cc], "--blocks") == 0)
+    {
+      numBlocks = static_cast<unsigned int>(atoi(argv[cc + 1]));
+    }
+  }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> input = CreateInput(numBlocks);
+
+  std::vector<vtkIdType> serialCounts;
+  const double serialTime = Execute(input, false, serialCounts);
+  cout << "Blocks: " << numBlocks << endl;
+  cout << "Serial: " << serialTime << "s" << endl;
+
+  const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+  {
+    vtkSMPTools::Initialize(numThreads);
+    std::vector<vtkIdType> parallelCounts;
+    const double parallelTime = Execute(input, true, parallelCounts);
+    cout << "Threads: " << numThreads << " " << parallelTime << "s, speedup "
+         << (parallelTime > 0 ? serialTime / parallelTime : 0.0) << endl;
+    if (parallelCounts != serialCounts)
+    {
+      cerr << "ERROR: parallel output differs from serial output with " << numThreads
+           << " threads." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
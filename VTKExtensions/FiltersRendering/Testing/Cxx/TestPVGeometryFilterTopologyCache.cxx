@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterTopologyCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+// Returns a grid of n^3 hexahedra, with point coordinates and scalars scaled
+// by `scale`.
+vtkSmartPointer<vtkUnstructuredGrid> CreateGrid(int n, double scale)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  for (int k = 0; k <= n; ++k)
+  {
+    for (int j = 0; j <= n; ++j)
+    {
+      for (int i = 0; i <= n; ++i)
+      {
+        points->InsertNextPoint(i * scale, j * scale, k * scale);
+        scalars->InsertNextValue((i + j + k) * scale);
+      }
+    }
+  }
+
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->Allocate(n * n * n);
+  auto id = [n](int i, int j, int k) {
+    return static_cast<vtkIdType>((k * (n + 1) + j) * (n + 1) + i);
+  };
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        vtkIdType hex[8] = { id(i, j, k), id(i + 1, j, k), id(i + 1, j + 1, k), id(i, j + 1, k),
+          id(i, j, k + 1), id(i + 1, j, k + 1), id(i + 1, j + 1, k + 1), id(i, j + 1, k + 1) };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+  return grid;
+}
+
+bool SameSurface(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells() ||
+    a->GetPointData()->GetNumberOfArrays() != b->GetPointData()->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < a->GetNumberOfPoints(); ++cc)
+  {
+    double pa[3], pb[3];
+    a->GetPoint(cc, pa);
+    b->GetPoint(cc, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2] ||
+      a->GetPointData()->GetScalars()->GetTuple1(cc) !=
+        b->GetPointData()->GetScalars()->GetTuple1(cc))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkPVGeometryFilter* cached, vtkUnstructuredGrid* input)
+{
+  vtkNew<vtkPVGeometryFilter> reference;
+  reference->SetUseOutline(0);
+  reference->SetTriangulate(cached->GetTriangulate());
+  reference->SetInputData(input);
+  reference->Update();
+
+  cached->SetInputData(input);
+  cached->Update();
+  return SameSurface(vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0)),
+    vtkPolyData::SafeDownCast(reference->GetOutputDataObject(0)));
+}
+}
+
+int TestPVGeometryFilterTopologyCache(int, char* [])
+{
+  vtkNew<vtkPVGeometryFilter> filter;
+  filter->SetUseOutline(0);
+  filter->SetUseTopologyCache(true);
+
+  if (!Compare(filter, CreateGrid(4, 1.0)))
+  {
+    cerr << "Surface differs on first execution." << endl;
+    return TEST_FAILED;
+  }
+  vtkSmartPointer<vtkCellArray> polys =
+    vtkPolyData::SafeDownCast(filter->GetOutputDataObject(0))->GetPolys();
+
+  // same topology in different arrays, new coordinates and scalars.
+  if (!Compare(filter, CreateGrid(4, 2.0)))
+  {
+    cerr << "Surface differs when reusing the cached topology." << endl;
+    return TEST_FAILED;
+  }
+  if (vtkPolyData::SafeDownCast(filter->GetOutputDataObject(0))->GetPolys() != polys)
+  {
+    cerr << "Cached topology was not used." << endl;
+    return TEST_FAILED;
+  }
+
+  // different topology.
+  if (!Compare(filter, CreateGrid(3, 2.0)))
+  {
+    cerr << "Surface differs after a topology change." << endl;
+    return TEST_FAILED;
+  }
+
+  // the cache does not apply to triangulated surfaces.
+  filter->SetTriangulate(1);
+  if (!Compare(filter, CreateGrid(4, 1.0)))
+  {
+    cerr << "Triangulated surface differs on first execution." << endl;
+    return TEST_FAILED;
+  }
+  polys = vtkPolyData::SafeDownCast(filter->GetOutputDataObject(0))->GetPolys();
+  if (!Compare(filter, CreateGrid(4, 2.0)))
+  {
+    cerr << "Triangulated surface differs on second execution." << endl;
+    return TEST_FAILED;
+  }
+  if (vtkPolyData::SafeDownCast(filter->GetOutputDataObject(0))->GetPolys() == polys)
+  {
+    cerr << "Cached topology was used for a triangulated surface." << endl;
+    return TEST_FAILED;
+  }
+  return TEST_SUCCESS;
+}
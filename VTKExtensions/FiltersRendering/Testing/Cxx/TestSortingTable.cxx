@@ -17,6 +17,7 @@
 
 #include "vtkDoubleArray.h"
 #include "vtkDummyController.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMultiProcessController.h"
 #include "vtkSmartPointer.h"
 #include "vtkSortedTableStreamer.h"
@@ -24,7 +25,10 @@
 #include "vtkTestUtilities.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
 #include <float.h>
+#include <functional>
+#include <vector>
 // ----------------------------------------------------------------------------
 void fillArray(vtkDoubleArray* array, double* dataPointer, int dataSize, const char* name)
 {
@@ -164,6 +168,138 @@ int sortMagnitudeOnUnsignedCharVector()
   return EXIT_SUCCESS;
 }
 
+// ----------------------------------------------------------------------------
+// Request several blocks of a table large enough to use the sorted index.
+int sortPagesOfLargeTable(bool invertOrder, bool debug)
+{
+  const int size = 100000;
+  std::vector<double> values(size);
+  for (int i = 0; i < size; i++)
+  {
+    // many duplicated values
+    values[i] = (i * 7919) % 1000;
+  }
+
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(dataToSort.GetPointer(), values.data(), size, "data");
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter =
+    vtkSmartPointer<vtkSortedTableStreamer>::New();
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetColumnNameToSort("data");
+  sortingfilter->SetInvertOrder(invertOrder ? 1 : 0);
+  sortingfilter->SetBlockSize(1000);
+
+  if (invertOrder)
+  {
+    std::sort(values.begin(), values.end(), std::greater<double>());
+  }
+  else
+  {
+    std::sort(values.begin(), values.end());
+  }
+
+  const vtkIdType blocks[] = { 0, 1, 37, 99 };
+  for (vtkIdType block : blocks)
+  {
+    sortingfilter->SetBlock(block);
+    sortingfilter->Update();
+    if (!compareArray(
+          sortingfilter->GetOutput(), "data", values.data() + block * 1000, 1000, debug))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Page through a table with only a few distinct values and check that every
+// row is served exactly once, with equal values ordered by row id in the sort
+// direction.
+int pageThroughDuplicatedValues(bool invertOrder)
+{
+  const vtkIdType size = 50000;
+  const vtkIdType blockSize = 1000;
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  dataToSort->SetName("data");
+  dataToSort->SetNumberOfTuples(size);
+  vtkSmartPointer<vtkIdTypeArray> rowIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  rowIds->SetName("rowIds");
+  rowIds->SetNumberOfTuples(size);
+  for (vtkIdType i = 0; i < size; i++)
+  {
+    dataToSort->SetValue(i, static_cast<double>((i * 31) % 7));
+    rowIds->SetValue(i, i);
+  }
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+  input->AddColumn(rowIds);
+
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter =
+    vtkSmartPointer<vtkSortedTableStreamer>::New();
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetColumnNameToSort("data");
+  sortingfilter->SetInvertOrder(invertOrder ? 1 : 0);
+  sortingfilter->SetBlockSize(blockSize);
+
+  std::vector<int> seen(size, 0);
+  bool first = true;
+  double previousValue = 0;
+  vtkIdType previousId = 0;
+  for (vtkIdType block = 0; block < size / blockSize; block++)
+  {
+    sortingfilter->SetBlock(block);
+    sortingfilter->Update();
+    vtkTable* output = sortingfilter->GetOutput();
+    vtkDoubleArray* values = vtkDoubleArray::SafeDownCast(output->GetColumnByName("data"));
+    vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(output->GetColumnByName("rowIds"));
+    if (!values || !ids || ids->GetNumberOfTuples() != blockSize)
+    {
+      cout << "Block " << block << " is incomplete." << endl;
+      return EXIT_FAILURE;
+    }
+    for (vtkIdType i = 0; i < blockSize; i++)
+    {
+      const double value = values->GetValue(i);
+      const vtkIdType id = ids->GetValue(i);
+      if (id < 0 || id >= size || ++seen[id] != 1)
+      {
+        cout << "Row " << id << " served more than once (block " << block << ")." << endl;
+        return EXIT_FAILURE;
+      }
+      if (!first)
+      {
+        const bool ordered = invertOrder
+          ? (value < previousValue || (value == previousValue && id < previousId))
+          : (value > previousValue || (value == previousValue && id > previousId));
+        if (!ordered)
+        {
+          cout << "Row " << id << " (" << value << ") is out of order after row " << previousId
+               << " (" << previousValue << ")." << endl;
+          return EXIT_FAILURE;
+        }
+      }
+      first = false;
+      previousValue = value;
+      previousId = id;
+    }
+  }
+  if (std::count(seen.begin(), seen.end(), 1) != size)
+  {
+    cout << "Some rows were never served." << endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 int TestSortingTable(int vtkNotUsed(argc), char** vtkNotUsed(argv))
 {
@@ -183,6 +319,17 @@ int TestSortingTable(int vtkNotUsed(argc), char** vtkNotUsed(argv))
   cout << "Testing sorting with magnitude on unsigned char: "
        << ((result += sortMagnitudeOnUnsignedCharVector()) ? "FAILED" : "SUCCESS") << endl;
   // --------------------------------------------------------------------------
+  cout << "Testing sorting pages of a large table: "
+       << ((result += sortPagesOfLargeTable(false, debug)) ? "FAILED" : "SUCCESS") << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing sorting pages of a large table in reverse order: "
+       << ((result += sortPagesOfLargeTable(true, debug)) ? "FAILED" : "SUCCESS") << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing paging through duplicated values: "
+       << ((result += pageThroughDuplicatedValues(false)) ? "FAILED" : "SUCCESS") << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing paging through duplicated values in reverse order: "
+       << ((result += pageThroughDuplicatedValues(true)) ? "FAILED" : "SUCCESS") << endl;
   // --------------------------------------------------------------------------
 
   // Delete Fake MPI controller
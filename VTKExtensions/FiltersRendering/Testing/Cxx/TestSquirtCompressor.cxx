@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSquirtCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compresses images large enough to be encoded in strips and checks that the
+// stream matches a straightforward serial run-length encoding and that
+// lossless mode reconstructs the image exactly.
+
+#include "vtkNew.h"
+#include "vtkSquirtCompressor.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstring>
+#include <vector>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+const int Width = 1920;
+const int Height = 1080;
+
+void CreateImage(vtkUnsignedCharArray* image, int numComps)
+{
+  image->SetNumberOfComponents(numComps);
+  image->SetNumberOfTuples(Width * Height);
+  unsigned char* pixels = image->GetPointer(0);
+  for (int y = 0; y < Height; ++y)
+  {
+    for (int x = 0; x < Width; ++x)
+    {
+      unsigned char* pixel = pixels + numComps * (y * Width + x);
+      // runs of various lengths, including some longer than 256 pixels.
+      const bool background = (x / 40 + y / 40) % 3 == 0 || y > Height / 2;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        pixel[comp] =
+          background ? 0x40 : static_cast<unsigned char>((x / (1 + y % 7)) * (comp + 1));
+      }
+    }
+  }
+}
+
+// Reference implementation of the SQUIRT encoding.
+std::vector<unsigned char> Encode(vtkUnsignedCharArray* image, const unsigned char mask[4])
+{
+  const int numComps = image->GetNumberOfComponents();
+  const int maxCount = numComps == 4 ? 0x0F : 0xFF;
+  const unsigned char* pixels = image->GetPointer(0);
+  const vtkIdType numPixels = image->GetNumberOfTuples();
+  auto same = [&](vtkIdType a, vtkIdType b) {
+    for (int comp = 0; comp < numComps; ++comp)
+    {
+      if ((pixels[numComps * a + comp] & mask[comp]) != (pixels[numComps * b + comp] & mask[comp]))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::vector<unsigned char> stream;
+  for (vtkIdType index = 0; index < numPixels;)
+  {
+    int count = 0;
+    while (index + count + 1 < numPixels && count < maxCount && same(index, index + count + 1))
+    {
+      ++count;
+    }
+    stream.insert(stream.end(), pixels + numComps * index, pixels + numComps * index + 3);
+    stream.push_back(static_cast<unsigned char>(
+      numComps == 4 ? (count | (pixels[numComps * index + 3] & 0xF0)) : count));
+    index += count + 1;
+  }
+  return stream;
+}
+
+bool DoTest(int numComps, int level)
+{
+  const unsigned char masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
+    { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
+    { 0xE0, 0xF0, 0xE0, 0xE0 } };
+
+  vtkNew<vtkUnsignedCharArray> image;
+  CreateImage(image, numComps);
+
+  vtkNew<vtkSquirtCompressor> squirt;
+  squirt->SetSquirtLevel(level);
+  squirt->SetLossLessMode(level == 0 ? 1 : 0);
+
+  vtkNew<vtkUnsignedCharArray> compressed;
+  squirt->SetInput(image);
+  squirt->SetOutput(compressed);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  if (squirt->Compress() != VTK_OK)
+  {
+    cerr << "Failed to compress." << endl;
+    return false;
+  }
+  timer->StopTimer();
+  const double compressTime = timer->GetElapsedTime();
+
+  const std::vector<unsigned char> expected = Encode(image, masks[level]);
+  if (static_cast<size_t>(compressed->GetNumberOfTuples()) != expected.size() ||
+    memcmp(compressed->GetPointer(0), expected.data(), expected.size()) != 0)
+  {
+    cerr << "Compressed stream differs from the reference encoding (" << numComps
+         << " components, level " << level << ")." << endl;
+    return false;
+  }
+
+  vtkNew<vtkUnsignedCharArray> decompressed;
+  decompressed->SetNumberOfComponents(numComps);
+  decompressed->SetNumberOfTuples(image->GetNumberOfTuples());
+  squirt->SetInput(compressed);
+  squirt->SetOutput(decompressed);
+  timer->StartTimer();
+  if (squirt->Decompress() != VTK_OK)
+  {
+    cerr << "Failed to decompress." << endl;
+    return false;
+  }
+  timer->StopTimer();
+
+  if (level == 0 &&
+    memcmp(decompressed->GetPointer(0), image->GetPointer(0),
+      image->GetNumberOfTuples() * numComps) != 0)
+  {
+    cerr << "Lossless round trip differs from the input (" << numComps << " components)."
+         << endl;
+    return false;
+  }
+
+  cout << numComps << " components, level " << level << ": " << compressed->GetNumberOfTuples()
+       << " bytes, compress " << compressTime << "s, decompress " << timer->GetElapsedTime()
+       << "s" << endl;
+  return true;
+}
+}
+
+int TestSquirtCompressor(int, char* [])
+{
+  for (int numComps = 3; numComps <= 4; ++numComps)
+  {
+    for (int level = 0; level <= 5; level += 5)
+    {
+      if (!DoTest(numComps, level))
+      {
+        return TEST_FAILED;
+      }
+    }
+  }
+  return TEST_SUCCESS;
+}
@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTemporalImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compresses a sequence of frames with a moving square and checks that they
+// are reconstructed exactly and that difference frames are smaller than key
+// frames.
+
+#include "vtkNew.h"
+#include "vtkTemporalImageCompressor.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstring>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+const int Width = 320;
+const int Height = 240;
+
+void RenderFrame(vtkUnsignedCharArray* image, int frame)
+{
+  image->SetNumberOfComponents(4);
+  image->SetNumberOfTuples(Width * Height);
+  unsigned char* pixels = image->GetPointer(0);
+  for (int y = 0; y < Height; ++y)
+  {
+    for (int x = 0; x < Width; ++x)
+    {
+      unsigned char* pixel = pixels + 4 * (y * Width + x);
+      const bool inSquare = x >= 10 + 3 * frame && x < 60 + 3 * frame && y >= 20 && y < 70;
+      pixel[0] = inSquare ? 255 : static_cast<unsigned char>(x);
+      pixel[1] = inSquare ? 32 : static_cast<unsigned char>(y);
+      pixel[2] = static_cast<unsigned char>(x ^ y);
+      pixel[3] = 255;
+    }
+  }
+}
+}
+
+int TestTemporalImageCompressor(int, char* [])
+{
+  vtkNew<vtkTemporalImageCompressor> encoder;
+  vtkNew<vtkTemporalImageCompressor> decoder;
+  encoder->SetLossLessMode(1);
+  encoder->SetKeyFrameInterval(5);
+  decoder->RestoreConfiguration(encoder->SaveConfiguration());
+
+  vtkNew<vtkUnsignedCharArray> frame;
+  vtkNew<vtkUnsignedCharArray> decompressed;
+  vtkIdType keyFrameSize = 0;
+  vtkIdType deltaFrameSize = 0;
+  for (int cc = 0; cc < 12; ++cc)
+  {
+    RenderFrame(frame, cc);
+    encoder->SetImageResolution(Width, Height);
+    encoder->SetInput(frame);
+    if (encoder->Compress() != VTK_OK)
+    {
+      cerr << "Failed to compress frame " << cc << endl;
+      return TEST_FAILED;
+    }
+    const bool keyFrame = encoder->GetLastFrameWasKeyFrame();
+    if (keyFrame != (cc % 5 == 0))
+    {
+      cerr << "Unexpected frame type for frame " << cc << endl;
+      return TEST_FAILED;
+    }
+    if (keyFrame)
+    {
+      keyFrameSize = encoder->GetOutput()->GetNumberOfTuples();
+    }
+    else
+    {
+      deltaFrameSize = encoder->GetOutput()->GetNumberOfTuples();
+    }
+
+    decoder->SetImageResolution(Width, Height);
+    decoder->SetInput(encoder->GetOutput());
+    decoder->SetOutput(decompressed);
+    if (decoder->Decompress() != VTK_OK)
+    {
+      cerr << "Failed to decompress frame " << cc << endl;
+      return TEST_FAILED;
+    }
+    if (decompressed->GetNumberOfValues() != frame->GetNumberOfValues() ||
+      memcmp(decompressed->GetPointer(0), frame->GetPointer(0), frame->GetNumberOfValues()) != 0)
+    {
+      cerr << "Frame " << cc << " differs after decompression." << endl;
+      return TEST_FAILED;
+    }
+  }
+
+  cout << "Key frame: " << keyFrameSize << " bytes, difference frame: " << deltaFrameSize
+       << " bytes (uncompressed: " << frame->GetNumberOfValues() << " bytes)" << endl;
+  if (deltaFrameSize >= keyFrameSize)
+  {
+    cerr << "Difference frames are not smaller than key frames." << endl;
+    return TEST_FAILED;
+  }
+
+  // a difference frame must be rejected by a decoder that missed the
+  // previous frame.
+  RenderFrame(frame, 12);
+  encoder->SetInput(frame);
+  encoder->Compress();
+  vtkNew<vtkTemporalImageCompressor> lateDecoder;
+  lateDecoder->SetInput(encoder->GetOutput());
+  lateDecoder->SetOutput(decompressed);
+  lateDecoder->GlobalWarningDisplayOff();
+  if (lateDecoder->Decompress() != VTK_ERROR)
+  {
+    cerr << "Difference frame without reference was not rejected." << endl;
+    return TEST_FAILED;
+  }
+  if (!lateDecoder->GetNeedsKeyFrame())
+  {
+    cerr << "Decoder does not ask for a key frame after a rejected frame." << endl;
+    return TEST_FAILED;
+  }
+
+  // the encoder resynchronizes right away when asked.
+  encoder->Reset();
+  RenderFrame(frame, 13);
+  encoder->SetInput(frame);
+  if (encoder->Compress() != VTK_OK || !encoder->GetLastFrameWasKeyFrame())
+  {
+    cerr << "No key frame sent after Reset()." << endl;
+    return TEST_FAILED;
+  }
+  if (lateDecoder->Decompress() != VTK_OK || lateDecoder->GetNeedsKeyFrame() ||
+    memcmp(decompressed->GetPointer(0), frame->GetPointer(0), frame->GetNumberOfValues()) != 0)
+  {
+    cerr << "Decoder did not resynchronize on the key frame." << endl;
+    return TEST_FAILED;
+  }
+  return TEST_SUCCESS;
+}
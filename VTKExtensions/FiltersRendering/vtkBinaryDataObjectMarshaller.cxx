@@ -0,0 +1,1036 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkBinaryDataObjectMarshaller.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBinaryDataObjectMarshaller.h"
+
+#include "vtkBufferHashPrivate.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCommunicator.h"
+#include "vtkDataArray.h"
+#include "vtkFieldData.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Packed buffers start with this 8-byte tag, followed by the header length.
+const char MARSHALLED_BUFFER_TAG[8] = { 'v', 't', 'k', 'b', 'i', 'n', '0', '1' };
+const vtkTypeInt64 FORMAT_VERSION = 1;
+const vtkTypeInt64 BYTE_ORDER_MARK = 0x01020304;
+
+inline vtkIdType vtkPad8(vtkIdType length)
+{
+  return (length + 7) & ~static_cast<vtkIdType>(7);
+}
+
+inline vtkIdType vtkGetArrayByteLength(vtkDataArray* array)
+{
+  return array->GetNumberOfTuples() * array->GetNumberOfComponents() *
+    array->GetDataTypeSize();
+}
+
+//----------------------------------------------------------------------------
+class vtkHeaderWriter
+{
+public:
+  std::vector<char>& Data;
+  vtkHeaderWriter(std::vector<char>& data)
+    : Data(data)
+  {
+  }
+
+  void Write(vtkTypeInt64 value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    this->Data.insert(this->Data.end(), bytes, bytes + sizeof(value));
+  }
+
+  void Write(double value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    this->Data.insert(this->Data.end(), bytes, bytes + sizeof(value));
+  }
+
+  void Write(const char* value)
+  {
+    if (value == nullptr)
+    {
+      this->Write(static_cast<vtkTypeInt64>(-1));
+      return;
+    }
+    const vtkTypeInt64 length = static_cast<vtkTypeInt64>(strlen(value));
+    this->Write(length);
+    this->Data.insert(this->Data.end(), value, value + length);
+  }
+};
+
+//----------------------------------------------------------------------------
+class vtkHeaderReader
+{
+public:
+  const char* Data;
+  vtkIdType Length;
+  vtkIdType Position;
+
+  vtkHeaderReader(const char* data, vtkIdType length)
+    : Data(data)
+    , Length(length)
+    , Position(0)
+  {
+  }
+
+  template <typename T>
+  bool Read(T& value)
+  {
+    if (this->Position + static_cast<vtkIdType>(sizeof(T)) > this->Length)
+    {
+      return false;
+    }
+    memcpy(&value, this->Data + this->Position, sizeof(T));
+    this->Position += static_cast<vtkIdType>(sizeof(T));
+    return true;
+  }
+
+  bool Read(std::string& value, bool& isNull)
+  {
+    vtkTypeInt64 length;
+    if (!this->Read(length))
+    {
+      return false;
+    }
+    isNull = (length < 0);
+    if (isNull)
+    {
+      value.clear();
+      return true;
+    }
+    if (this->Position + length > this->Length)
+    {
+      return false;
+    }
+    value.assign(this->Data + this->Position, static_cast<size_t>(length));
+    this->Position += length;
+    return true;
+  }
+};
+
+
+//----------------------------------------------------------------------------
+// Structure decoded from a header. Arrays are created while decoding but their
+// memory is only allocated by Allocate(), so that arrays kept from a previous
+// transfer can be substituted before that.
+struct vtkDecodedLayout
+{
+  struct ArrayInfo
+  {
+    vtkSmartPointer<vtkDataArray> Array;
+    vtkIdType NumberOfTuples;
+  };
+
+  struct AttributeArray
+  {
+    int Index;
+    int AttributeType;
+  };
+
+  int DataObjectType = -1;
+  vtkTypeInt64 Extent[6] = { 0, -1, 0, -1, 0, -1 };
+  double Origin[3] = { 0, 0, 0 };
+  double Spacing[3] = { 1, 1, 1 };
+  int Points = -1;
+  int CellTypes = -1;
+  bool HasCells[4] = { false, false, false, false };
+  int Offsets[4] = { -1, -1, -1, -1 };
+  int Connectivity[4] = { -1, -1, -1, -1 };
+  std::vector<AttributeArray> Attributes[3];
+
+  // All arrays, in the order their buffers appear in the stream.
+  std::vector<ArrayInfo> Arrays;
+
+  vtkDataArray* Get(int index) const
+  {
+    return index >= 0 ? this->Arrays[index].Array.GetPointer() : nullptr;
+  }
+
+  vtkIdType GetByteLength(size_t index) const
+  {
+    const auto& info = this->Arrays[index];
+    return info.NumberOfTuples * info.Array->GetNumberOfComponents() *
+      info.Array->GetDataTypeSize();
+  }
+
+  // Returns true if the buffer lengths announced by the sender are the ones
+  // of the arrays described by the header.
+  bool MatchesLengths(const std::vector<vtkIdType>& lengths) const
+  {
+    if (lengths.size() != this->Arrays.size())
+    {
+      return false;
+    }
+    for (size_t cc = 0; cc < lengths.size(); ++cc)
+    {
+      if (lengths[cc] != this->GetByteLength(cc))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Allocate(size_t index)
+  {
+    auto& info = this->Arrays[index];
+    info.Array->SetNumberOfTuples(info.NumberOfTuples);
+  }
+
+  // Use `other` in place of the array at `index`, if it matches the array
+  // described by the header.
+  bool Substitute(size_t index, vtkDataArray* other)
+  {
+    auto& info = this->Arrays[index];
+    const char* name = info.Array->GetName();
+    const char* otherName = other ? other->GetName() : nullptr;
+    if (other == nullptr || other->GetDataType() != info.Array->GetDataType() ||
+      other->GetNumberOfComponents() != info.Array->GetNumberOfComponents() ||
+      other->GetNumberOfTuples() != info.NumberOfTuples ||
+      (name == nullptr) != (otherName == nullptr) ||
+      (name != nullptr && strcmp(name, otherName) != 0))
+    {
+      return false;
+    }
+    info.Array = other;
+    return true;
+  }
+
+  bool ReadArray(vtkHeaderReader& reader, int& index)
+  {
+    index = -1;
+    vtkTypeInt64 present;
+    if (!reader.Read(present))
+    {
+      return false;
+    }
+    if (present == 0)
+    {
+      return true;
+    }
+
+    std::string name;
+    bool nameIsNull;
+    vtkTypeInt64 dataType, numComps, numTuples;
+    if (!reader.Read(name, nameIsNull) || !reader.Read(dataType) || !reader.Read(numComps) ||
+      !reader.Read(numTuples) || numComps <= 0 || numTuples < 0 || dataType == VTK_BIT)
+    {
+      return false;
+    }
+
+    ArrayInfo info;
+    info.Array.TakeReference(vtkDataArray::CreateDataArray(static_cast<int>(dataType)));
+    if (!info.Array)
+    {
+      return false;
+    }
+    if (!nameIsNull)
+    {
+      info.Array->SetName(name.c_str());
+    }
+    info.Array->SetNumberOfComponents(static_cast<int>(numComps));
+    info.NumberOfTuples = static_cast<vtkIdType>(numTuples);
+    index = static_cast<int>(this->Arrays.size());
+    this->Arrays.push_back(info);
+    return true;
+  }
+
+  bool ReadCells(vtkHeaderReader& reader, int index)
+  {
+    vtkTypeInt64 present;
+    if (!reader.Read(present))
+    {
+      return false;
+    }
+    this->HasCells[index] = (present != 0);
+    if (!this->HasCells[index])
+    {
+      return true;
+    }
+    return this->ReadArray(reader, this->Offsets[index]) &&
+      this->ReadArray(reader, this->Connectivity[index]) && this->Offsets[index] >= 0 &&
+      this->Connectivity[index] >= 0;
+  }
+
+  bool Read(const char* header, vtkIdType headerLength)
+  {
+    vtkHeaderReader reader(header, headerLength);
+    vtkTypeInt64 version, bom, idTypeSize, dataObjectType;
+    if (!reader.Read(version) || !reader.Read(bom) || !reader.Read(idTypeSize) ||
+      !reader.Read(dataObjectType))
+    {
+      vtkGenericWarningMacro("Truncated marshalled data header.");
+      return false;
+    }
+    if (version != FORMAT_VERSION || bom != BYTE_ORDER_MARK ||
+      idTypeSize != static_cast<vtkTypeInt64>(sizeof(vtkIdType)))
+    {
+      vtkGenericWarningMacro("Marshalled data was generated by an incompatible process "
+                             "(version, byte order or vtkIdType size mismatch).");
+      return false;
+    }
+    this->DataObjectType = static_cast<int>(dataObjectType);
+
+    bool status = true;
+    switch (this->DataObjectType)
+    {
+      case VTK_IMAGE_DATA:
+        for (int cc = 0; cc < 6; ++cc)
+        {
+          status = status && reader.Read(this->Extent[cc]);
+        }
+        for (int cc = 0; cc < 3; ++cc)
+        {
+          status = status && reader.Read(this->Origin[cc]);
+        }
+        for (int cc = 0; cc < 3; ++cc)
+        {
+          status = status && reader.Read(this->Spacing[cc]);
+        }
+        break;
+
+      case VTK_POLY_DATA:
+        status = this->ReadArray(reader, this->Points);
+        for (int cc = 0; cc < 4; ++cc)
+        {
+          status = status && this->ReadCells(reader, cc);
+        }
+        break;
+
+      case VTK_UNSTRUCTURED_GRID:
+        status = this->ReadArray(reader, this->Points) &&
+          this->ReadArray(reader, this->CellTypes) && this->ReadCells(reader, 0);
+        if (status && this->CellTypes >= 0 &&
+          this->Get(this->CellTypes)->GetDataType() != VTK_UNSIGNED_CHAR)
+        {
+          status = false;
+        }
+        break;
+
+      default:
+        vtkGenericWarningMacro("Unsupported data type in marshalled data: " << dataObjectType);
+        return false;
+    }
+
+    for (int attr = 0; status && attr < 3; ++attr)
+    {
+      vtkTypeInt64 count;
+      status = reader.Read(count) && count >= 0;
+      for (vtkTypeInt64 cc = 0; status && cc < count; ++cc)
+      {
+        AttributeArray item;
+        vtkTypeInt64 attributeType = -1;
+        status =
+          this->ReadArray(reader, item.Index) && item.Index >= 0 && reader.Read(attributeType);
+        item.AttributeType = static_cast<int>(attributeType);
+        this->Attributes[attr].push_back(item);
+      }
+    }
+
+    if (!status)
+    {
+      vtkGenericWarningMacro("Corrupt marshalled data header.");
+    }
+    return status;
+  }
+
+  vtkSmartPointer<vtkCellArray> NewCells(int index) const
+  {
+    if (!this->HasCells[index])
+    {
+      return nullptr;
+    }
+    auto cells = vtkSmartPointer<vtkCellArray>::New();
+    if (!cells->SetData(this->Get(this->Offsets[index]), this->Get(this->Connectivity[index])))
+    {
+      vtkGenericWarningMacro("Failed to reconstruct cell array from marshalled data.");
+    }
+    return cells;
+  }
+
+  vtkDataObject* Assemble() const
+  {
+    vtkSmartPointer<vtkDataSet> dataset;
+    if (this->DataObjectType == VTK_IMAGE_DATA)
+    {
+      auto image = vtkSmartPointer<vtkImageData>::New();
+      int extent[6];
+      std::copy(this->Extent, this->Extent + 6, extent);
+      image->SetExtent(extent);
+      image->SetOrigin(this->Origin[0], this->Origin[1], this->Origin[2]);
+      image->SetSpacing(this->Spacing[0], this->Spacing[1], this->Spacing[2]);
+      dataset = image;
+    }
+    else if (this->DataObjectType == VTK_POLY_DATA)
+    {
+      auto pd = vtkSmartPointer<vtkPolyData>::New();
+      if (this->Points >= 0)
+      {
+        vtkNew<vtkPoints> points;
+        points->SetData(this->Get(this->Points));
+        pd->SetPoints(points);
+      }
+      pd->SetVerts(this->NewCells(0));
+      pd->SetLines(this->NewCells(1));
+      pd->SetPolys(this->NewCells(2));
+      pd->SetStrips(this->NewCells(3));
+      dataset = pd;
+    }
+    else
+    {
+      auto ug = vtkSmartPointer<vtkUnstructuredGrid>::New();
+      if (this->Points >= 0)
+      {
+        vtkNew<vtkPoints> points;
+        points->SetData(this->Get(this->Points));
+        ug->SetPoints(points);
+      }
+      auto cells = this->NewCells(0);
+      if (cells && this->CellTypes >= 0)
+      {
+        ug->SetCells(vtkUnsignedCharArray::SafeDownCast(this->Get(this->CellTypes)), cells);
+      }
+      dataset = ug;
+    }
+
+    vtkFieldData* fields[3] = { dataset->GetFieldData(), dataset->GetPointData(),
+      dataset->GetCellData() };
+    for (int attr = 0; attr < 3; ++attr)
+    {
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fields[attr]);
+      for (const auto& item : this->Attributes[attr])
+      {
+        int idx = fields[attr]->AddArray(this->Get(item.Index));
+        if (dsa && item.AttributeType >= 0 &&
+          item.AttributeType < vtkDataSetAttributes::NUM_ATTRIBUTES)
+        {
+          dsa->SetActiveAttribute(idx, item.AttributeType);
+        }
+      }
+    }
+
+    dataset->Register(nullptr);
+    return dataset;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Receives the header and the buffer lengths sent by vtkInternals::SendHeader().
+bool vtkReceiveHeader(vtkCommunicator* comm, int remoteId, int tag, std::vector<char>& header,
+  std::vector<vtkIdType>& lengths)
+{
+  vtkIdType sizes[2] = { 0, 0 };
+  if (!comm->Receive(sizes, 2, remoteId, tag) || sizes[0] <= 0 || sizes[1] < 0)
+  {
+    return false;
+  }
+  header.resize(sizes[0]);
+  lengths.resize(sizes[1]);
+  return comm->Receive(header.data(), sizes[0], remoteId, tag) &&
+    (sizes[1] == 0 || comm->Receive(lengths.data(), sizes[1], remoteId, tag));
+}
+
+//----------------------------------------------------------------------------
+// Receives and discards the buffers the sender pushes after a header that
+// could not be decoded, so that the next messages from it are not mistaken
+// for them. `flags`, if not null, tells which buffers were actually sent.
+void vtkDrainBuffers(vtkCommunicator* comm, int remoteId, int tag,
+  const std::vector<vtkIdType>& lengths, const char* flags)
+{
+  std::vector<char> scratch;
+  for (size_t cc = 0; cc < lengths.size(); ++cc)
+  {
+    if (lengths[cc] <= 0 || (flags != nullptr && flags[cc] == 0))
+    {
+      continue;
+    }
+    scratch.resize(lengths[cc]);
+    if (!comm->Receive(scratch.data(), lengths[cc], remoteId, tag))
+    {
+      return;
+    }
+  }
+}
+
+vtkTypeInt64 vtkNewHistoryId()
+{
+  std::random_device rd;
+  vtkTypeInt64 value = 0;
+  while (value == 0)
+  {
+    value = (static_cast<vtkTypeInt64>(rd()) << 32) ^ static_cast<vtkTypeInt64>(rd());
+  }
+  return value;
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkBinaryDataObjectMarshaller::vtkInternals
+{
+public:
+  struct Segment
+  {
+    const void* Pointer;
+    vtkIdType Length;
+    // The array the segment was generated from, and its MTime.
+    vtkDataArray* Source;
+    vtkMTimeType SourceMTime;
+    // The part of the header describing this array.
+    std::string Descriptor;
+  };
+
+  struct Fingerprint
+  {
+    vtkDataArray* Source = nullptr; // never dereferenced.
+    vtkMTimeType SourceMTime = 0;
+    std::string Descriptor;
+    vtkTypeUInt64 Hash = 0;
+  };
+
+  std::vector<char> Header;
+  std::vector<Segment> Segments;
+  // Keeps the marshalled arrays (or their AOS copies) alive until Reset().
+  std::vector<vtkSmartPointer<vtkDataArray> > Arrays;
+
+  // State for incremental transfers, on the sending side.
+  std::vector<Fingerprint> SentFingerprints;
+  vtkTypeInt64 SentHistoryId = 0;
+
+  // State for incremental transfers, on the receiving side.
+  std::vector<vtkSmartPointer<vtkDataArray> > ReceivedArrays;
+  vtkTypeInt64 ReceivedHistoryId = 0;
+
+  vtkIdType LastSkippedLength = 0;
+
+  // Sends the header followed by the length of every buffer, so that the
+  // receiver knows what to expect even if it cannot decode the header.
+  bool SendHeader(vtkCommunicator* comm, int remoteId, int tag) const
+  {
+    std::vector<vtkIdType> lengths;
+    lengths.reserve(this->Segments.size());
+    for (const auto& segment : this->Segments)
+    {
+      lengths.push_back(segment.Length);
+    }
+    vtkIdType sizes[2] = { static_cast<vtkIdType>(this->Header.size()),
+      static_cast<vtkIdType>(lengths.size()) };
+    return comm->Send(sizes, 2, remoteId, tag) &&
+      comm->Send(this->Header.data(), sizes[0], remoteId, tag) &&
+      (sizes[1] == 0 || comm->Send(lengths.data(), sizes[1], remoteId, tag));
+  }
+
+  void AddArray(vtkHeaderWriter& writer, vtkDataArray* array)
+  {
+    writer.Write(static_cast<vtkTypeInt64>(array != nullptr ? 1 : 0));
+    if (array == nullptr)
+    {
+      return;
+    }
+
+    vtkSmartPointer<vtkDataArray> aos = array;
+    if (!array->HasStandardMemoryLayout())
+    {
+      aos.TakeReference(vtkDataArray::CreateDataArray(array->GetDataType()));
+      aos->DeepCopy(array);
+    }
+    const size_t descriptorStart = this->Header.size();
+    writer.Write(array->GetName());
+    writer.Write(static_cast<vtkTypeInt64>(aos->GetDataType()));
+    writer.Write(static_cast<vtkTypeInt64>(aos->GetNumberOfComponents()));
+    writer.Write(static_cast<vtkTypeInt64>(aos->GetNumberOfTuples()));
+
+    Segment segment;
+    segment.Length = vtkGetArrayByteLength(aos);
+    segment.Pointer = segment.Length > 0 ? aos->GetVoidPointer(0) : nullptr;
+    segment.Source = array;
+    segment.SourceMTime = array->GetMTime();
+    segment.Descriptor.assign(this->Header.begin() + descriptorStart, this->Header.end());
+    this->Segments.push_back(segment);
+    this->Arrays.push_back(aos);
+  }
+
+  void AddCells(vtkHeaderWriter& writer, vtkCellArray* cells)
+  {
+    writer.Write(static_cast<vtkTypeInt64>(cells != nullptr ? 1 : 0));
+    if (cells != nullptr)
+    {
+      this->AddArray(writer, cells->GetOffsetsArray());
+      this->AddArray(writer, cells->GetConnectivityArray());
+    }
+  }
+
+  void AddFields(vtkHeaderWriter& writer, vtkFieldData* fd)
+  {
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    const int numArrays = fd ? fd->GetNumberOfArrays() : 0;
+    writer.Write(static_cast<vtkTypeInt64>(numArrays));
+    for (int cc = 0; cc < numArrays; ++cc)
+    {
+      this->AddArray(writer, fd->GetArray(cc));
+      writer.Write(static_cast<vtkTypeInt64>(dsa ? dsa->IsArrayAnAttribute(cc) : -1));
+    }
+  }
+};
+
+vtkStandardNewMacro(vtkBinaryDataObjectMarshaller);
+//----------------------------------------------------------------------------
+vtkBinaryDataObjectMarshaller::vtkBinaryDataObjectMarshaller()
+  : Internals(new vtkBinaryDataObjectMarshaller::vtkInternals())
+{
+}
+
+//----------------------------------------------------------------------------
+vtkBinaryDataObjectMarshaller::~vtkBinaryDataObjectMarshaller()
+{
+  delete this->Internals;
+  this->Internals = nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryDataObjectMarshaller::CanMarshal(vtkDataObject* data)
+{
+  if (data == nullptr)
+  {
+    return false;
+  }
+
+  const int type = data->GetDataObjectType();
+  if (type != VTK_POLY_DATA && type != VTK_UNSTRUCTURED_GRID && type != VTK_IMAGE_DATA)
+  {
+    return false;
+  }
+
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+  if (ug && ug->GetFaces() != nullptr)
+  {
+    // polyhedral cells are not supported.
+    return false;
+  }
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+  vtkFieldData* fields[3] = { ds->GetFieldData(), ds->GetPointData(), ds->GetCellData() };
+  for (vtkFieldData* fd : fields)
+  {
+    const int numArrays = fd ? fd->GetNumberOfArrays() : 0;
+    for (int cc = 0; cc < numArrays; ++cc)
+    {
+      vtkDataArray* array = fd->GetArray(cc);
+      if (array == nullptr || array->GetDataType() == VTK_BIT)
+      {
+        // string, variant and bit arrays are not supported.
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryDataObjectMarshaller::IsMarshalledBuffer(const char* buffer, vtkIdType length)
+{
+  return buffer != nullptr && length >= 16 &&
+    memcmp(buffer, MARSHALLED_BUFFER_TAG, sizeof(MARSHALLED_BUFFER_TAG)) == 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryDataObjectMarshaller::Reset()
+{
+  // note: this does not clear the state used by incremental transfers.
+  auto& internals = (*this->Internals);
+  internals.Header.clear();
+  internals.Segments.clear();
+  internals.Arrays.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryDataObjectMarshaller::Marshal(vtkDataObject* data)
+{
+  this->Reset();
+  if (!vtkBinaryDataObjectMarshaller::CanMarshal(data))
+  {
+    return false;
+  }
+
+  auto& internals = (*this->Internals);
+  vtkHeaderWriter writer(internals.Header);
+  writer.Write(FORMAT_VERSION);
+  writer.Write(BYTE_ORDER_MARK);
+  writer.Write(static_cast<vtkTypeInt64>(sizeof(vtkIdType)));
+  writer.Write(static_cast<vtkTypeInt64>(data->GetDataObjectType()));
+
+  if (vtkImageData* image = vtkImageData::SafeDownCast(data))
+  {
+    const int* extent = image->GetExtent();
+    const double* origin = image->GetOrigin();
+    const double* spacing = image->GetSpacing();
+    for (int cc = 0; cc < 6; ++cc)
+    {
+      writer.Write(static_cast<vtkTypeInt64>(extent[cc]));
+    }
+    for (int cc = 0; cc < 3; ++cc)
+    {
+      writer.Write(origin[cc]);
+    }
+    for (int cc = 0; cc < 3; ++cc)
+    {
+      writer.Write(spacing[cc]);
+    }
+  }
+  else if (vtkPolyData* pd = vtkPolyData::SafeDownCast(data))
+  {
+    internals.AddArray(writer, pd->GetPoints() ? pd->GetPoints()->GetData() : nullptr);
+    internals.AddCells(writer, pd->GetVerts());
+    internals.AddCells(writer, pd->GetLines());
+    internals.AddCells(writer, pd->GetPolys());
+    internals.AddCells(writer, pd->GetStrips());
+  }
+  else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data))
+  {
+    internals.AddArray(writer, ug->GetPoints() ? ug->GetPoints()->GetData() : nullptr);
+    internals.AddArray(writer, ug->GetCellTypesArray());
+    internals.AddCells(writer, ug->GetCells());
+  }
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+  internals.AddFields(writer, ds->GetFieldData());
+  internals.AddFields(writer, ds->GetPointData());
+  internals.AddFields(writer, ds->GetCellData());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBinaryDataObjectMarshaller::GetPackedLength() const
+{
+  const auto& internals = (*this->Internals);
+  vtkIdType length = sizeof(MARSHALLED_BUFFER_TAG) + sizeof(vtkTypeInt64) +
+    vtkPad8(static_cast<vtkIdType>(internals.Header.size()));
+  for (const auto& segment : internals.Segments)
+  {
+    length += vtkPad8(segment.Length);
+  }
+  return length;
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryDataObjectMarshaller::Pack(char* buffer) const
+{
+  const auto& internals = (*this->Internals);
+  memcpy(buffer, MARSHALLED_BUFFER_TAG, sizeof(MARSHALLED_BUFFER_TAG));
+  vtkIdType offset = sizeof(MARSHALLED_BUFFER_TAG);
+
+  const vtkTypeInt64 headerLength = static_cast<vtkTypeInt64>(internals.Header.size());
+  memcpy(buffer + offset, &headerLength, sizeof(headerLength));
+  offset += sizeof(headerLength);
+
+  memcpy(buffer + offset, internals.Header.data(), internals.Header.size());
+  memset(buffer + offset + headerLength, 0, vtkPad8(headerLength) - headerLength);
+  offset += vtkPad8(headerLength);
+
+  for (const auto& segment : internals.Segments)
+  {
+    if (segment.Length > 0)
+    {
+      memcpy(buffer + offset, segment.Pointer, segment.Length);
+    }
+    memset(buffer + offset + segment.Length, 0, vtkPad8(segment.Length) - segment.Length);
+    offset += vtkPad8(segment.Length);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryDataObjectMarshaller::Send(vtkCommunicator* comm, int remoteId, int tag) const
+{
+  const auto& internals = (*this->Internals);
+  if (!internals.SendHeader(comm, remoteId, tag))
+  {
+    return false;
+  }
+  for (const auto& segment : internals.Segments)
+  {
+    if (segment.Length > 0 &&
+      !comm->Send(static_cast<const char*>(segment.Pointer), segment.Length, remoteId, tag))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryDataObjectMarshaller::Unmarshal(const char* buffer, vtkIdType length)
+{
+  if (!vtkBinaryDataObjectMarshaller::IsMarshalledBuffer(buffer, length))
+  {
+    return nullptr;
+  }
+
+  vtkTypeInt64 headerLength;
+  vtkIdType offset = sizeof(MARSHALLED_BUFFER_TAG);
+  memcpy(&headerLength, buffer + offset, sizeof(headerLength));
+  offset += sizeof(headerLength);
+  if (headerLength < 0 || offset + headerLength > length)
+  {
+    vtkGenericWarningMacro("Truncated marshalled data buffer.");
+    return nullptr;
+  }
+
+  vtkDecodedLayout layout;
+  if (!layout.Read(buffer + offset, headerLength))
+  {
+    return nullptr;
+  }
+  offset += vtkPad8(headerLength);
+
+  for (size_t cc = 0; cc < layout.Arrays.size(); ++cc)
+  {
+    const vtkIdType nbytes = layout.GetByteLength(cc);
+    if (offset + nbytes > length)
+    {
+      vtkGenericWarningMacro("Truncated marshalled data buffer.");
+      return nullptr;
+    }
+    layout.Allocate(cc);
+    if (nbytes > 0)
+    {
+      memcpy(layout.Get(static_cast<int>(cc))->GetVoidPointer(0), buffer + offset, nbytes);
+    }
+    offset += vtkPad8(nbytes);
+  }
+  return layout.Assemble();
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryDataObjectMarshaller::Receive(
+  vtkCommunicator* comm, int remoteId, int tag)
+{
+  std::vector<char> header;
+  std::vector<vtkIdType> lengths;
+  if (!vtkReceiveHeader(comm, remoteId, tag, header, lengths))
+  {
+    return nullptr;
+  }
+
+  vtkDecodedLayout layout;
+  if (!layout.Read(header.data(), static_cast<vtkIdType>(header.size())) ||
+    !layout.MatchesLengths(lengths))
+  {
+    // the sender still pushes the array buffers; this can only happen when the
+    // two processes are built differently.
+    vtkDrainBuffers(comm, remoteId, tag, lengths, nullptr);
+    return nullptr;
+  }
+
+  for (size_t cc = 0; cc < layout.Arrays.size(); ++cc)
+  {
+    const vtkIdType nbytes = layout.GetByteLength(cc);
+    layout.Allocate(cc);
+    if (nbytes > 0 &&
+      !comm->Receive(static_cast<char*>(layout.Get(static_cast<int>(cc))->GetVoidPointer(0)),
+        nbytes, remoteId, tag))
+    {
+      return nullptr;
+    }
+  }
+  return layout.Assemble();
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryDataObjectMarshaller::ResetHistory()
+{
+  auto& internals = (*this->Internals);
+  internals.SentFingerprints.clear();
+  internals.SentHistoryId = 0;
+  internals.ReceivedArrays.clear();
+  internals.ReceivedHistoryId = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBinaryDataObjectMarshaller::GetLastSkippedLength() const
+{
+  return this->Internals->LastSkippedLength;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryDataObjectMarshaller::SendIncremental(vtkCommunicator* comm, int remoteId, int tag)
+{
+  auto& internals = (*this->Internals);
+  internals.LastSkippedLength = 0;
+
+  // Find out what the receiver has from us.
+  vtkTypeInt64 remoteHistoryId = 0;
+  if (!comm->Receive(&remoteHistoryId, 1, remoteId, tag))
+  {
+    return false;
+  }
+  const bool canSkip = internals.SentHistoryId != 0 && remoteHistoryId == internals.SentHistoryId;
+
+  const size_t numSegments = internals.Segments.size();
+  std::vector<vtkInternals::Fingerprint> fingerprints(numSegments);
+  std::vector<char> flags(sizeof(vtkTypeInt64) + numSegments, 1);
+  for (size_t cc = 0; cc < numSegments; ++cc)
+  {
+    const auto& segment = internals.Segments[cc];
+    auto& fingerprint = fingerprints[cc];
+    fingerprint.Source = segment.Source;
+    fingerprint.SourceMTime = segment.SourceMTime;
+    fingerprint.Descriptor = segment.Descriptor;
+
+    const vtkInternals::Fingerprint* previous =
+      cc < internals.SentFingerprints.size() ? &internals.SentFingerprints[cc] : nullptr;
+    if (previous && previous->Source == segment.Source &&
+      previous->SourceMTime == segment.SourceMTime)
+    {
+      // same array, unmodified since the last transfer; no need to hash it.
+      fingerprint.Hash = previous->Hash;
+    }
+    else
+    {
+      fingerprint.Hash = vtkBufferHashPrivate::Hash(segment.Pointer, segment.Length);
+    }
+
+    if (canSkip && previous && previous->Descriptor == fingerprint.Descriptor &&
+      previous->Hash == fingerprint.Hash)
+    {
+      flags[sizeof(vtkTypeInt64) + cc] = 0;
+      internals.LastSkippedLength += segment.Length;
+    }
+  }
+
+  const vtkTypeInt64 historyId = vtkNewHistoryId();
+  memcpy(flags.data(), &historyId, sizeof(historyId));
+
+  if (!internals.SendHeader(comm, remoteId, tag) ||
+    !comm->Send(flags.data(), static_cast<vtkIdType>(flags.size()), remoteId, tag))
+  {
+    return false;
+  }
+  for (size_t cc = 0; cc < numSegments; ++cc)
+  {
+    const auto& segment = internals.Segments[cc];
+    if (flags[sizeof(vtkTypeInt64) + cc] != 0 && segment.Length > 0 &&
+      !comm->Send(static_cast<const char*>(segment.Pointer), segment.Length, remoteId, tag))
+    {
+      return false;
+    }
+  }
+
+  internals.SentFingerprints.swap(fingerprints);
+  internals.SentHistoryId = historyId;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryDataObjectMarshaller::ReceiveIncremental(
+  vtkCommunicator* comm, int remoteId, int tag)
+{
+  auto& internals = (*this->Internals);
+  internals.LastSkippedLength = 0;
+
+  if (!comm->Send(&internals.ReceivedHistoryId, 1, remoteId, tag))
+  {
+    return nullptr;
+  }
+
+  std::vector<char> header;
+  std::vector<vtkIdType> lengths;
+  if (!vtkReceiveHeader(comm, remoteId, tag, header, lengths))
+  {
+    return nullptr;
+  }
+
+  const size_t numArrays = lengths.size();
+  std::vector<char> flags(sizeof(vtkTypeInt64) + numArrays);
+  if (!comm->Receive(flags.data(), static_cast<vtkIdType>(flags.size()), remoteId, tag))
+  {
+    return nullptr;
+  }
+
+  vtkDecodedLayout layout;
+  if (!layout.Read(header.data(), static_cast<vtkIdType>(header.size())) ||
+    !layout.MatchesLengths(lengths))
+  {
+    vtkDrainBuffers(comm, remoteId, tag, lengths, flags.data() + sizeof(vtkTypeInt64));
+    this->ResetHistory();
+    return nullptr;
+  }
+
+  bool status = true;
+  for (size_t cc = 0; cc < numArrays; ++cc)
+  {
+    const vtkIdType nbytes = layout.GetByteLength(cc);
+    if (flags[sizeof(vtkTypeInt64) + cc] == 0)
+    {
+      // the sender determined we already have this array.
+      vtkDataArray* previous =
+        cc < internals.ReceivedArrays.size() ? internals.ReceivedArrays[cc].GetPointer() : nullptr;
+      if (!layout.Substitute(cc, previous))
+      {
+        vtkGenericWarningMacro("Incremental transfer does not match previously received data.");
+        status = false;
+      }
+      internals.LastSkippedLength += nbytes;
+      continue;
+    }
+
+    layout.Allocate(cc);
+    if (nbytes > 0 &&
+      !comm->Receive(static_cast<char*>(layout.Get(static_cast<int>(cc))->GetVoidPointer(0)),
+        nbytes, remoteId, tag))
+    {
+      this->ResetHistory();
+      return nullptr;
+    }
+  }
+
+  if (!status)
+  {
+    this->ResetHistory();
+    return nullptr;
+  }
+
+  internals.ReceivedArrays.resize(numArrays);
+  for (size_t cc = 0; cc < numArrays; ++cc)
+  {
+    internals.ReceivedArrays[cc] = layout.Arrays[cc].Array;
+  }
+  memcpy(&internals.ReceivedHistoryId, flags.data(), sizeof(vtkTypeInt64));
+  return layout.Assemble();
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryDataObjectMarshaller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfSegments: " << this->Internals->Segments.size() << endl;
+}
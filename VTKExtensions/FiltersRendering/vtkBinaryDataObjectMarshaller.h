@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkBinaryDataObjectMarshaller.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBinaryDataObjectMarshaller
+ * @brief   marshals datasets as raw array buffers.
+ *
+ * vtkBinaryDataObjectMarshaller is an alternative to serializing datasets
+ * using vtkGenericDataObjectWriter / vtkGenericDataObjectReader when
+ * delivering data between processes. Instead of formatting the dataset in the
+ * legacy VTK file format, it generates a small header describing the dataset
+ * structure and the arrays it is built from, followed by the raw memory of each
+ * of those arrays.
+ *
+ * The marshalled form can be consumed in two ways:
+ * \li Pack() copies the header and all array buffers into a single contiguous
+ *     buffer. This is needed for collective operations such as
+ *     vtkCommunicator::GatherV(). Unmarshal() reconstructs the dataset from
+ *     such a buffer.
+ * \li Send() sends the header and the buffer lengths followed by each array
+ *     buffer directly from the dataset's memory without any intermediate copy.
+ *     Receive() allocates the arrays described by the header and receives
+ *     each buffer directly into the array memory.
+ * \li SendIncremental() / ReceiveIncremental() are similar to Send() /
+ *     Receive() but skip array buffers that are unchanged since the previous
+ *     incremental transfer between the same pair of instances. This is
+ *     intended for time-varying data where only some arrays change from one
+ *     timestep to the next.
+ *
+ * Only vtkPolyData, vtkUnstructuredGrid (without polyhedral cells) and
+ * vtkImageData with numeric attribute arrays are supported. Use CanMarshal()
+ * to check if a data object is supported; callers are expected to fall back to
+ * the legacy writer otherwise. Array information keys and component names are
+ * not preserved. Both ends must share byte order and `sizeof(vtkIdType)`.
+ */
+
+#ifndef vtkBinaryDataObjectMarshaller_h
+#define vtkBinaryDataObjectMarshaller_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsFiltersRenderingModule.h" //needed for exports
+
+class vtkCommunicator;
+class vtkDataObject;
+
+class VTKPVVTKEXTENSIONSFILTERSRENDERING_EXPORT vtkBinaryDataObjectMarshaller : public vtkObject
+{
+public:
+  static vtkBinaryDataObjectMarshaller* New();
+  vtkTypeMacro(vtkBinaryDataObjectMarshaller, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Returns true if the data object can be marshalled using this class.
+   */
+  static bool CanMarshal(vtkDataObject* data);
+
+  /**
+   * Returns true if the buffer was generated by Pack().
+   */
+  static bool IsMarshalledBuffer(const char* buffer, vtkIdType length);
+
+  /**
+   * Prepares the header and the list of array buffers for the data object.
+   * This does not copy any array memory unless the array does not use the
+   * standard (array-of-structures) memory layout. Returns false if the data
+   * object is not supported.
+   */
+  bool Marshal(vtkDataObject* data);
+
+  /**
+   * Release the references held on the last marshalled data object.
+   */
+  void Reset();
+
+  /**
+   * Returns the number of bytes needed by Pack().
+   */
+  vtkIdType GetPackedLength() const;
+
+  /**
+   * Copies the marshalled data into `buffer` which must be at least
+   * GetPackedLength() bytes long.
+   */
+  void Pack(char* buffer) const;
+
+  /**
+   * Sends the marshalled data to `remoteId` one buffer at a time. The
+   * receiver must call Receive() with the same tag.
+   */
+  bool Send(vtkCommunicator* comm, int remoteId, int tag) const;
+
+  /**
+   * Reconstructs a data object from a buffer generated by Pack(). Returns a
+   * new instance or nullptr on error. The caller must release the returned
+   * object.
+   */
+  static vtkDataObject* Unmarshal(const char* buffer, vtkIdType length);
+
+  /**
+   * Reconstructs a data object sent with Send(). Array buffers are received
+   * directly into the memory of the arrays of the returned data object.
+   * Returns a new instance or nullptr on error. The caller must release the
+   * returned object. If the header cannot be decoded, the buffers that follow
+   * it are received and discarded so that the communicator can still be used.
+   */
+  static vtkDataObject* Receive(vtkCommunicator* comm, int remoteId, int tag);
+
+  //@{
+  /**
+   * Incremental transfers. SendIncremental() sends the marshalled data like
+   * Send() but skips the array buffers that are identical to the ones sent by
+   * the previous SendIncremental() call on this instance. ReceiveIncremental()
+   * reuses the arrays it received in the previous call in place of the skipped
+   * buffers, hence the same sender and receiver instances must be used for
+   * consecutive transfers.
+   *
+   * Buffers are compared using their description (name, type, size) and a
+   * 64-bit hash of their contents; hashing is skipped for arrays that are
+   * the same instance with the same MTime as in the previous transfer. The
+   * receiver starts by sending the id of the last transfer it received, so a
+   * complete transfer is done whenever the two sides are not in sync.
+   *
+   * Reused arrays are shared between the successive data objects returned by
+   * ReceiveIncremental(); they must be treated as read-only.
+   */
+  bool SendIncremental(vtkCommunicator* comm, int remoteId, int tag);
+  vtkDataObject* ReceiveIncremental(vtkCommunicator* comm, int remoteId, int tag);
+  //@}
+
+  /**
+   * Forget about previous incremental transfers. The next incremental
+   * transfer will send all buffers.
+   */
+  void ResetHistory();
+
+  /**
+   * Returns the number of bytes that were not transferred during the last
+   * SendIncremental() or ReceiveIncremental() call.
+   */
+  vtkIdType GetLastSkippedLength() const;
+
+protected:
+  vtkBinaryDataObjectMarshaller();
+  ~vtkBinaryDataObjectMarshaller() override;
+
+private:
+  vtkBinaryDataObjectMarshaller(const vtkBinaryDataObjectMarshaller&) = delete;
+  void operator=(const vtkBinaryDataObjectMarshaller&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkBufferHashPrivate.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBufferHashPrivate
+ * @brief   64-bit fingerprint of a memory buffer.
+ *
+ * The buffer is split into 1 MiB chunks that are hashed concurrently using
+ * vtkSMPTools, then the chunk hashes are combined. The result only depends on
+ * the contents of the buffer, not on the number of threads. It is used to
+ * detect arrays that did not change between two executions.
+ *
+ * \internal
+ */
+
+#ifndef vtkBufferHashPrivate_h
+#define vtkBufferHashPrivate_h
+
+#include "vtkSMPTools.h"
+#include "vtkType.h"
+
+#include <algorithm> // for std::min
+#include <cstring>   // for memcpy
+#include <vector>    // for std::vector
+
+namespace vtkBufferHashPrivate
+{
+inline vtkTypeUInt64 Mix(vtkTypeUInt64 hash, vtkTypeUInt64 value)
+{
+  hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+  return hash ^ (hash >> 29);
+}
+
+// Hashes chunks of a buffer concurrently; see Hash().
+class ChunksWorker
+{
+public:
+  const unsigned char* Data;
+  vtkIdType Length;
+  vtkIdType ChunkSize;
+  std::vector<vtkTypeUInt64> Hashes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      const vtkIdType first = chunk * this->ChunkSize;
+      const vtkIdType last = std::min(first + this->ChunkSize, this->Length);
+      vtkTypeUInt64 hash = 0xcbf29ce484222325ULL;
+      vtkIdType cc = first;
+      for (; cc + 8 <= last; cc += 8)
+      {
+        vtkTypeUInt64 word;
+        memcpy(&word, this->Data + cc, sizeof(word));
+        hash = Mix(hash, word);
+      }
+      for (; cc < last; ++cc)
+      {
+        hash = Mix(hash, this->Data[cc]);
+      }
+      this->Hashes[chunk] = hash;
+    }
+  }
+};
+
+// Combines the length and the contents of the buffer into `hash`.
+inline vtkTypeUInt64 Hash(const void* data, vtkIdType length, vtkTypeUInt64 hash = 0)
+{
+  ChunksWorker worker;
+  worker.Data = static_cast<const unsigned char*>(data);
+  worker.Length = length;
+  worker.ChunkSize = 1024 * 1024;
+  const vtkIdType numChunks = (length + worker.ChunkSize - 1) / worker.ChunkSize;
+  worker.Hashes.resize(numChunks);
+  vtkSMPTools::For(0, numChunks, 1, worker);
+
+  hash = Mix(hash, static_cast<vtkTypeUInt64>(length));
+  for (const auto& chunkHash : worker.Hashes)
+  {
+    hash = Mix(hash, chunkHash);
+  }
+  return hash;
+}
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkBufferHashPrivate.h
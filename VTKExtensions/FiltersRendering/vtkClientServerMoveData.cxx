@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkClientServerMoveData.h"
 
+#include "vtkBinaryDataObjectMarshaller.h"
 #include "vtkCharArray.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTypes.h"
@@ -21,8 +22,10 @@
 #include "vtkGenericDataObjectWriter.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMPIMoveData.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVSession.h"
 #include "vtkPolyData.h"
@@ -211,6 +214,17 @@ int vtkClientServerMoveData::SendData(vtkDataObject* input, vtkMultiProcessContr
     }
   }
 
+  // Let the receiver know which marshalling is used for the data object.
+  vtkNew<vtkBinaryDataObjectMarshaller> marshaller;
+  int binary = (vtkMPIMoveData::GetUseBinaryMarshalling() && marshaller->Marshal(input)) ? 1 : 0;
+  controller->Send(&binary, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  if (binary)
+  {
+    return marshaller->Send(
+             controller->GetCommunicator(), 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT)
+      ? 1
+      : 0;
+  }
   return controller->Send(input, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
 }
 
@@ -240,7 +254,17 @@ vtkDataObject* vtkClientServerMoveData::ReceiveData(vtkMultiProcessController* c
   }
   else
   {
-    data = controller->ReceiveDataObject(1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    int binary = 0;
+    controller->Receive(&binary, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    if (binary)
+    {
+      data = vtkBinaryDataObjectMarshaller::Receive(
+        controller->GetCommunicator(), 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
+    else
+    {
+      data = controller->ReceiveDataObject(1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
   }
   return data;
 }
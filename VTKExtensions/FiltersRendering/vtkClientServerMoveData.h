@@ -22,6 +22,8 @@
  * this filter behaves as a simple pass-through filter.
  * This can work with any data type, the application does not need to set
  * the output type before hand.
+ * When vtkMPIMoveData::GetUseBinaryMarshalling() is true, datasets supported
+ * by vtkBinaryDataObjectMarshaller are sent as raw array buffers.
  * @warning
  * This filter may change the output in RequestData().
 */
@@ -15,6 +15,7 @@
 #include "vtkMPIMoveData.h"
 
 #include "vtkAllToNRedistributeCompositePolyData.h"
+#include "vtkBinaryDataObjectMarshaller.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataIterator.h"
@@ -28,6 +29,7 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
 #include "vtkPVConfig.h"
@@ -35,6 +37,7 @@
 #include "vtkPVSession.h"
 #include "vtkPointData.h"
 #include "vtkProcessModule.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
@@ -42,16 +45,188 @@
 #include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 
+#include "vtk_lz4.h"
 #include "vtk_zlib.h"
-#include <sstream>
-#include <vector>
 
+#include <algorithm>
+#include <sstream>
 #include <vector>
 
 bool vtkMPIMoveData::UseZLibCompression = false;
+bool vtkMPIMoveData::UseBinaryMarshalling = false;
 
 namespace
 {
+// Sent in place of the number of buffers when the data follows as a
+// vtkBinaryDataObjectMarshaller stream.
+const int DIRECT_BINARY_STREAM = -1;
+// Same as DIRECT_BINARY_STREAM for incremental transfers.
+const int DIRECT_INCREMENTAL_STREAM = -2;
+
+// Buffers compressed using CompressionCodec start with this tag, followed by
+// the codec (int32), the uncompressed length, the chunk size, the number of
+// chunks and the compressed length of each chunk (all int64). The compressed
+// chunks follow.
+const char CHUNKED_COMPRESSION_TAG[4] = { 'p', 'v', 'c', 'z' };
+
+// Compresses fixed-size chunks of a buffer independently so that they can be
+// processed concurrently.
+class vtkCompressChunksWorker
+{
+public:
+  const char* Input;
+  vtkIdType InputLength;
+  vtkIdType ChunkSize;
+  int Codec;
+  int Level;
+  std::vector<std::vector<char> > Chunks;
+  std::vector<unsigned char> Failed;
+
+  vtkCompressChunksWorker(
+    const char* input, vtkIdType length, vtkIdType chunkSize, int codec, int level)
+    : Input(input)
+    , InputLength(length)
+    , ChunkSize(chunkSize)
+    , Codec(codec)
+    , Level(level)
+  {
+    const vtkIdType numChunks = (length + chunkSize - 1) / chunkSize;
+    this->Chunks.resize(numChunks);
+    this->Failed.resize(numChunks, 0);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      const char* src = this->Input + idx * this->ChunkSize;
+      const vtkIdType srcLength = std::min(this->ChunkSize, this->InputLength - idx * this->ChunkSize);
+      std::vector<char>& out = this->Chunks[idx];
+      if (this->Codec == vtkMPIMoveData::COMPRESSION_ZLIB)
+      {
+        uLongf outSize = compressBound(static_cast<uLong>(srcLength));
+        out.resize(outSize);
+        this->Failed[idx] = compress2(reinterpret_cast<Bytef*>(out.data()), &outSize,
+                              reinterpret_cast<const Bytef*>(src), static_cast<uLong>(srcLength),
+                              this->Level) != Z_OK;
+        out.resize(outSize);
+      }
+      else
+      {
+        // LZ4 trades ratio for speed using an "acceleration" factor. Map the
+        // compression level such that higher levels compress better.
+        const int acceleration = std::max(1, 10 - this->Level);
+        const int bound = LZ4_compressBound(static_cast<int>(srcLength));
+        out.resize(bound);
+        const int outSize = LZ4_compress_fast(
+          src, out.data(), static_cast<int>(srcLength), bound, acceleration);
+        this->Failed[idx] = outSize <= 0;
+        out.resize(std::max(outSize, 0));
+      }
+    }
+  }
+};
+
+// Decompresses chunks generated by vtkCompressChunksWorker concurrently.
+class vtkDecompressChunksWorker
+{
+public:
+  const char* Input;
+  std::vector<vtkIdType> CompressedLengths;
+  std::vector<vtkIdType> CompressedOffsets;
+  char* Output;
+  vtkIdType OutputLength;
+  vtkIdType ChunkSize;
+  int Codec;
+  std::vector<unsigned char> Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      const char* src = this->Input + this->CompressedOffsets[idx];
+      const vtkIdType srcLength = this->CompressedLengths[idx];
+      char* dest = this->Output + idx * this->ChunkSize;
+      const vtkIdType destLength =
+        std::min(this->ChunkSize, this->OutputLength - idx * this->ChunkSize);
+      if (this->Codec == vtkMPIMoveData::COMPRESSION_ZLIB)
+      {
+        uLongf outSize = static_cast<uLongf>(destLength);
+        this->Failed[idx] = uncompress(reinterpret_cast<Bytef*>(dest), &outSize,
+                              reinterpret_cast<const Bytef*>(src), static_cast<uLong>(srcLength)) !=
+            Z_OK ||
+          static_cast<vtkIdType>(outSize) != destLength;
+      }
+      else
+      {
+        const int outSize = LZ4_decompress_safe(
+          src, dest, static_cast<int>(srcLength), static_cast<int>(destLength));
+        this->Failed[idx] = outSize != destLength;
+      }
+    }
+  }
+};
+
+// Decompresses a buffer starting with CHUNKED_COMPRESSION_TAG. Returns a new
+// buffer or nullptr on failure.
+char* vtkDecompressChunks(const char* buffer, vtkIdType length, vtkIdType& outLength)
+{
+  const vtkIdType headerLength = 4 + 4 + 3 * sizeof(vtkTypeInt64);
+  if (length < headerLength)
+  {
+    return nullptr;
+  }
+
+  vtkTypeInt32 codec;
+  vtkTypeInt64 rawLength, chunkSize, numChunks;
+  memcpy(&codec, buffer + 4, sizeof(codec));
+  memcpy(&rawLength, buffer + 8, sizeof(rawLength));
+  memcpy(&chunkSize, buffer + 16, sizeof(chunkSize));
+  memcpy(&numChunks, buffer + 24, sizeof(numChunks));
+  if (rawLength < 0 || chunkSize <= 0 || numChunks < 0 ||
+    numChunks != (rawLength + chunkSize - 1) / chunkSize ||
+    headerLength + numChunks * static_cast<vtkIdType>(sizeof(vtkTypeInt64)) > length)
+  {
+    return nullptr;
+  }
+
+  vtkDecompressChunksWorker worker;
+  worker.Input = buffer + headerLength + numChunks * sizeof(vtkTypeInt64);
+  worker.CompressedLengths.resize(numChunks);
+  worker.CompressedOffsets.resize(numChunks);
+  vtkIdType offset = 0;
+  for (vtkIdType idx = 0; idx < numChunks; ++idx)
+  {
+    vtkTypeInt64 chunkLength;
+    memcpy(&chunkLength, buffer + headerLength + idx * sizeof(vtkTypeInt64), sizeof(chunkLength));
+    if (chunkLength < 0)
+    {
+      return nullptr;
+    }
+    worker.CompressedLengths[idx] = chunkLength;
+    worker.CompressedOffsets[idx] = offset;
+    offset += chunkLength;
+  }
+  if (worker.Input + offset > buffer + length)
+  {
+    return nullptr;
+  }
+
+  worker.Output = new char[rawLength];
+  worker.OutputLength = rawLength;
+  worker.ChunkSize = chunkSize;
+  worker.Codec = codec;
+  worker.Failed.resize(numChunks, 0);
+  vtkSMPTools::For(0, numChunks, 1, worker);
+  if (std::find(worker.Failed.begin(), worker.Failed.end(), 1) != worker.Failed.end())
+  {
+    delete[] worker.Output;
+    return nullptr;
+  }
+  outLength = rawLength;
+  return worker.Output;
+}
+
 bool vtkMPIMoveDataMerge(
   std::vector<vtkSmartPointer<vtkDataObject> >& pieces, vtkDataObject* result)
 {
@@ -89,6 +264,7 @@ vtkStandardNewMacro(vtkMPIMoveData);
 vtkCxxSetObjectMacro(vtkMPIMoveData, Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData, ClientDataServerSocketController, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData, MPIMToNSocketConnection, vtkMPIMToNSocketConnection);
+vtkCxxSetObjectMacro(vtkMPIMoveData, IncrementalMarshaller, vtkBinaryDataObjectMarshaller);
 //-----------------------------------------------------------------------------
 vtkMPIMoveData::vtkMPIMoveData()
 {
@@ -118,6 +294,13 @@ vtkMPIMoveData::vtkMPIMoveData()
   this->UpdatePiece = 0;
 
   this->SkipDataServerGatherToZero = false;
+
+  this->CompressionCodec = vtkMPIMoveData::UseZLibCompression ? vtkMPIMoveData::COMPRESSION_ZLIB
+                                                              : vtkMPIMoveData::COMPRESSION_NONE;
+  this->CompressionLevel = 6;
+  this->CompressionChunkSize = 4 * 1024 * 1024;
+  this->IncrementalMarshaller = nullptr;
+  this->ResetTimings();
 }
 
 //-----------------------------------------------------------------------------
@@ -126,6 +309,7 @@ vtkMPIMoveData::~vtkMPIMoveData()
   this->SetController(0);
   this->SetClientDataServerSocketController(0);
   this->SetMPIMToNSocketConnection(0);
+  this->SetIncrementalMarshaller(nullptr);
   this->ClearBuffer();
 }
 
@@ -180,6 +364,29 @@ bool vtkMPIMoveData::GetUseZLibCompression()
   return vtkMPIMoveData::UseZLibCompression;
 }
 
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::ResetTimings()
+{
+  this->LastCompressTime = 0.0;
+  this->LastDecompressTime = 0.0;
+  this->LastTransferTime = 0.0;
+  this->LastSkippedSize = 0;
+  this->LastUncompressedSize = 0;
+  this->LastCompressedSize = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetUseBinaryMarshalling(bool b)
+{
+  vtkMPIMoveData::UseBinaryMarshalling = b;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMPIMoveData::GetUseBinaryMarshalling()
+{
+  return vtkMPIMoveData::UseBinaryMarshalling;
+}
+
 //----------------------------------------------------------------------------
 int vtkMPIMoveData::FillInputPortInformation(int, vtkInformation* info)
 {
@@ -297,6 +504,8 @@ int vtkMPIMoveData::RequestData(
     }
   }
 
+  this->ResetTimings();
+
   this->UpdatePiece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
   this->UpdateNumberOfPieces =
     outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
@@ -582,6 +791,7 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input, vtkDataObject* ou
 
   // Compute the degenerate input offsets and lengths.
   // Broadcast our size to all other processes.
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->AllGather(&inBufferLength, this->BufferLengths, 1);
 
   // Compute the displacements.
@@ -596,6 +806,7 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input, vtkDataObject* ou
   this->Buffers = new char[this->BufferTotalLength];
   com->AllGatherV(
     inBuffer, this->Buffers, inBufferLength, this->BufferLengths, this->BufferOffsets);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
 
   this->ReconstructDataFromBuffer(output);
 
@@ -658,6 +869,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input, vtkDataObject*
 
   // Compute the degenerate input offsets and lengths.
   // Broadcast our size to process 0.
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->Gather(&inBufferLength, this->BufferLengths, 1, 0);
 
   // Compute the displacements.
@@ -674,6 +886,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input, vtkDataObject*
   }
   com->GatherV(
     inBuffer, this->Buffers, inBufferLength, this->BufferLengths, this->BufferOffsets, 0);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
   this->NumberOfBuffers = numProcs;
 
   if (myId == 0)
@@ -709,9 +922,11 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
   this->ClearBuffer();
   this->MarshalDataToBuffer(output);
 
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
   com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
   com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
 }
 
 //-----------------------------------------------------------------------------
@@ -728,6 +943,7 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataObject* output)
   vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "receive-from-dataserver");
 
   this->ClearBuffer();
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
   com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
@@ -741,6 +957,7 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataObject* output)
   }
   this->Buffers = new char[this->BufferTotalLength];
   com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
 
   // int fixme;  // Can we avoid this?
   this->ReconstructDataFromBuffer(output);
@@ -769,9 +986,11 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
     // We might be able to eliminate this marshal.
     this->ClearBuffer();
     this->MarshalDataToBuffer(data);
+    const double transferStart = vtkTimerLog::GetUniversalTime();
     com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
     com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
     com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+    this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
     this->ClearBuffer();
   }
 }
@@ -794,6 +1013,7 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataObject* da
     vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "receive-from-dataserver-root");
 
     this->ClearBuffer();
+    const double transferStart = vtkTimerLog::GetUniversalTime();
     com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
     this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
     com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
@@ -807,6 +1027,7 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataObject* da
     }
     this->Buffers = new char[this->BufferTotalLength];
     com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
+    this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
 
     // int fixme;  // Can we avoid this?
     this->ReconstructDataFromBuffer(data);
@@ -828,13 +1049,49 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   {
     vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "send-to-client");
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
-    this->ClientDataServerSocketController->Send(&(this->NumberOfBuffers), 1, 1, 23490);
-    this->ClientDataServerSocketController->Send(
-      this->BufferLengths, this->NumberOfBuffers, 1, 23491);
-    this->ClientDataServerSocketController->Send(this->Buffers, this->BufferTotalLength, 1, 23492);
-    this->ClearBuffer();
+    vtkSmartPointer<vtkBinaryDataObjectMarshaller> marshaller = this->IncrementalMarshaller;
+    if (marshaller == nullptr)
+    {
+      marshaller = vtkSmartPointer<vtkBinaryDataObjectMarshaller>::New();
+    }
+    if (vtkMPIMoveData::UseBinaryMarshalling &&
+      this->CompressionCodec == vtkMPIMoveData::COMPRESSION_NONE && marshaller->Marshal(output))
+    {
+      // Send the arrays straight from the dataset's memory.
+      vtkCommunicator* com = this->ClientDataServerSocketController->GetCommunicator();
+      const double transferStart = vtkTimerLog::GetUniversalTime();
+      if (this->IncrementalMarshaller)
+      {
+        int direct = DIRECT_INCREMENTAL_STREAM;
+        this->ClientDataServerSocketController->Send(&direct, 1, 1, 23490);
+        marshaller->SendIncremental(com, 1, 23492);
+        this->LastSkippedSize = marshaller->GetLastSkippedLength();
+        vtkVLogF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "skipped %lld unchanged bytes",
+          static_cast<long long>(this->LastSkippedSize));
+      }
+      else
+      {
+        int direct = DIRECT_BINARY_STREAM;
+        this->ClientDataServerSocketController->Send(&direct, 1, 1, 23490);
+        marshaller->Send(com, 1, 23492);
+      }
+      this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
+      // don't hold on to the data between transfers.
+      marshaller->Reset();
+    }
+    else
+    {
+      this->ClearBuffer();
+      this->MarshalDataToBuffer(output);
+      const double transferStart = vtkTimerLog::GetUniversalTime();
+      this->ClientDataServerSocketController->Send(&(this->NumberOfBuffers), 1, 1, 23490);
+      this->ClientDataServerSocketController->Send(
+        this->BufferLengths, this->NumberOfBuffers, 1, 23491);
+      this->ClientDataServerSocketController->Send(
+        this->Buffers, this->BufferTotalLength, 1, 23492);
+      this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
+      this->ClearBuffer();
+    }
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
   }
 }
@@ -853,7 +1110,45 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
   vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "receive-from-dataserver");
 
   this->ClearBuffer();
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
+  if (this->NumberOfBuffers == DIRECT_BINARY_STREAM ||
+    this->NumberOfBuffers == DIRECT_INCREMENTAL_STREAM)
+  {
+    vtkSmartPointer<vtkDataObject> data;
+    if (this->NumberOfBuffers == DIRECT_BINARY_STREAM)
+    {
+      data.TakeReference(vtkBinaryDataObjectMarshaller::Receive(com, 1, 23492));
+    }
+    else
+    {
+      if (this->IncrementalMarshaller == nullptr)
+      {
+        // the server expects us to keep track of previous transfers; a
+        // temporary marshaller simply has no history.
+        vtkWarningMacro("Incremental transfer received without an IncrementalMarshaller.");
+        vtkNew<vtkBinaryDataObjectMarshaller> marshaller;
+        data.TakeReference(marshaller->ReceiveIncremental(com, 1, 23492));
+      }
+      else
+      {
+        data.TakeReference(this->IncrementalMarshaller->ReceiveIncremental(com, 1, 23492));
+        this->LastSkippedSize = this->IncrementalMarshaller->GetLastSkippedLength();
+      }
+    }
+    this->NumberOfBuffers = 0;
+    this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
+    if (data == nullptr)
+    {
+      vtkErrorMacro("Failed to receive data from the data server.");
+      output->Initialize();
+      return;
+    }
+    unsetGlobalIdsAttribute(data);
+    std::vector<vtkSmartPointer<vtkDataObject> > pieces(1, data);
+    vtkMPIMoveDataMerge(pieces, output);
+    return;
+  }
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
   com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23491);
   // Compute additional buffer information.
@@ -866,6 +1161,7 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
   }
   this->Buffers = new char[this->BufferTotalLength];
   com->Receive(this->Buffers, this->BufferTotalLength, 1, 23492);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
   this->ReconstructDataFromBuffer(output);
   this->ClearBuffer();
 }
@@ -899,6 +1195,7 @@ void vtkMPIMoveData::RenderServerZeroBroadcast(vtkDataObject* data)
   }
 
   // Broadcast the size of the buffer.
+  const double transferStart = vtkTimerLog::GetUniversalTime();
   com->Broadcast(&bufferLength, 1, 0);
 
   // Allocate buffers for all receiving nodes.
@@ -915,6 +1212,7 @@ void vtkMPIMoveData::RenderServerZeroBroadcast(vtkDataObject* data)
 
   // Broadcast the buffer.
   com->Broadcast(this->Buffers, bufferLength, 0);
+  this->LastTransferTime += vtkTimerLog::GetUniversalTime() - transferStart;
 
   // Reconstruct the output on nodes other than 0.
   if (myId != 0)
@@ -959,58 +1257,101 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
     this->NumberOfBuffers = 0;
   }
 
-  // Copy input to isolate reader from the pipeline.
-  vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
-  writer->SetInputData(data);
-  if (imageData)
+  char* raw_buffer = NULL;
+  vtkIdType raw_length = 0;
+
+  vtkNew<vtkBinaryDataObjectMarshaller> marshaller;
+  if (vtkMPIMoveData::UseBinaryMarshalling && marshaller->Marshal(data))
   {
-    // We add the image extents to the header, since the writer doesn't preserve
-    // the extents.
-    int* extent = imageData->GetExtent();
-    double* origin = imageData->GetOrigin();
-    std::ostringstream stream;
-    stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
-           << " " << extent[4] << " " << extent[5];
-    stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
-    writer->SetHeader(stream.str().c_str());
+    vtkTimerLog::MarkStartEvent("Binary marshal");
+    raw_length = marshaller->GetPackedLength();
+    raw_buffer = new char[raw_length];
+    marshaller->Pack(raw_buffer);
+    marshaller->Reset();
+    vtkTimerLog::MarkEndEvent("Binary marshal");
   }
+  else
+  {
+    // Copy input to isolate reader from the pipeline.
+    vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
+    writer->SetInputData(data);
+    if (imageData)
+    {
+      // We add the image extents to the header, since the writer doesn't preserve
+      // the extents.
+      int* extent = imageData->GetExtent();
+      double* origin = imageData->GetOrigin();
+      std::ostringstream stream;
+      stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
+             << " " << extent[4] << " " << extent[5];
+      stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
+      writer->SetHeader(stream.str().c_str());
+    }
+
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
 
-  writer->SetFileTypeToBinary();
-  writer->WriteToOutputStringOn();
-  writer->Write();
+    raw_length = writer->GetOutputStringLength();
+    raw_buffer = writer->RegisterAndGetOutputString();
+
+    writer->Delete();
+    writer = 0;
+  }
 
   char* buffer = NULL;
   vtkIdType buffer_length = 0;
 
-  if (vtkMPIMoveData::UseZLibCompression)
+  this->LastUncompressedSize += raw_length;
+  if (this->CompressionCodec != vtkMPIMoveData::COMPRESSION_NONE && raw_length > 0)
   {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
-    // Use z-lib compression.
-    uLongf out_size = compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8];
-    memcpy(buffer, "zlib0000", 8);
-
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()), writer->GetOutputStringLength(),
-      /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
-    for (int cc = 0; cc < 4; cc++)
+    vtkTimerLog::MarkStartEvent("Compress");
+    const double start = vtkTimerLog::GetUniversalTime();
+    vtkCompressChunksWorker worker(raw_buffer, raw_length, this->CompressionChunkSize,
+      this->CompressionCodec, this->CompressionLevel);
+    const vtkIdType numChunks = static_cast<vtkIdType>(worker.Chunks.size());
+    vtkSMPTools::For(0, numChunks, 1, worker);
+    if (std::find(worker.Failed.begin(), worker.Failed.end(), 1) == worker.Failed.end())
     {
-      // the first 4 bytes in the header are "zlib" which helps the receiver
-      // identify that zlib compression has been used.
-      // the next 4 bytes are the original length since zlib doesn't provide
-      // that to the receiver.
-      buffer[4 + cc] = (in_size & 0x0ff);
-      in_size = in_size >> 8;
+      const vtkIdType headerLength =
+        4 + 4 + 3 * sizeof(vtkTypeInt64) + numChunks * sizeof(vtkTypeInt64);
+      buffer_length = headerLength;
+      for (const auto& chunk : worker.Chunks)
+      {
+        buffer_length += static_cast<vtkIdType>(chunk.size());
+      }
+      buffer = new char[buffer_length];
+      memcpy(buffer, CHUNKED_COMPRESSION_TAG, 4);
+      const vtkTypeInt32 codec = this->CompressionCodec;
+      const vtkTypeInt64 header[3] = { raw_length, this->CompressionChunkSize, numChunks };
+      memcpy(buffer + 4, &codec, sizeof(codec));
+      memcpy(buffer + 8, header, sizeof(header));
+      vtkIdType offset = headerLength;
+      for (vtkIdType idx = 0; idx < numChunks; ++idx)
+      {
+        const vtkTypeInt64 chunkLength = static_cast<vtkTypeInt64>(worker.Chunks[idx].size());
+        memcpy(buffer + 8 + sizeof(header) + idx * sizeof(vtkTypeInt64), &chunkLength,
+          sizeof(chunkLength));
+        memcpy(buffer + offset, worker.Chunks[idx].data(), chunkLength);
+        offset += chunkLength;
+      }
+      delete[] raw_buffer;
     }
-    buffer_length = out_size + 8;
+    else
+    {
+      vtkWarningMacro("Compression failed; sending data uncompressed.");
+      buffer_length = raw_length;
+      buffer = raw_buffer;
+    }
+    this->LastCompressTime += vtkTimerLog::GetUniversalTime() - start;
+    vtkTimerLog::MarkEndEvent("Compress");
   }
   else
   {
-    buffer_length = writer->GetOutputStringLength();
-    buffer = writer->RegisterAndGetOutputString();
+    buffer_length = raw_length;
+    buffer = raw_buffer;
   }
+  this->LastCompressedSize += buffer_length;
 
   // Get string.
   this->NumberOfBuffers = 1;
@@ -1020,9 +1361,6 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   this->BufferOffsets[0] = 0;
   this->Buffers = buffer;
   this->BufferTotalLength = this->BufferLengths[0];
-
-  writer->Delete();
-  writer = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1064,6 +1402,39 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       bufferArray = realBuffer;
       bufferLength = uncompressed_length;
     }
+    else if (bufferLength > 4 && memcmp(bufferArray, CHUNKED_COMPRESSION_TAG, 4) == 0)
+    {
+      vtkTimerLog::MarkStartEvent("Decompress");
+      const double start = vtkTimerLog::GetUniversalTime();
+      vtkIdType uncompressed_length = 0;
+      realBuffer = vtkDecompressChunks(bufferArray, bufferLength, uncompressed_length);
+      this->LastDecompressTime += vtkTimerLog::GetUniversalTime() - start;
+      vtkTimerLog::MarkEndEvent("Decompress");
+      if (realBuffer == nullptr)
+      {
+        vtkErrorMacro("Failed to decompress received data.");
+        continue;
+      }
+      bufferArray = realBuffer;
+      bufferLength = uncompressed_length;
+    }
+
+    if (vtkBinaryDataObjectMarshaller::IsMarshalledBuffer(bufferArray, bufferLength))
+    {
+      vtkTimerLog::MarkStartEvent("Binary unmarshal");
+      vtkSmartPointer<vtkDataObject> piece;
+      piece.TakeReference(vtkBinaryDataObjectMarshaller::Unmarshal(bufferArray, bufferLength));
+      vtkTimerLog::MarkEndEvent("Binary unmarshal");
+      if (piece)
+      {
+        // reconstructing data distributted on MPI node, so global ids are valid
+        unsetGlobalIdsAttribute(piece);
+        pieces.push_back(piece);
+      }
+      delete[] realBuffer;
+      realBuffer = 0;
+      continue;
+    }
 
     // Setup a reader.
     vtkDataReader* reader = vtkGenericDataObjectReader::New();
@@ -1127,6 +1498,10 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Server: " << this->Server << endl;
   os << indent << "MoveMode: " << this->MoveMode << endl;
   os << indent << "SkipDataServerGatherToZero: " << this->SkipDataServerGatherToZero << endl;
+  os << indent << "CompressionCodec: " << this->CompressionCodec << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+  os << indent << "CompressionChunkSize: " << this->CompressionChunkSize << endl;
+  os << indent << "IncrementalMarshaller: " << this->IncrementalMarshaller << endl;
   os << indent << "OutputDataType: ";
   if (this->OutputDataType == VTK_POLY_DATA)
   {
@@ -29,6 +29,7 @@
 #include "vtkPVVTKExtensionsFiltersRenderingModule.h" //needed for exports
 #include "vtkPassInputTypeAlgorithm.h"
 
+class vtkBinaryDataObjectMarshaller;
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
@@ -108,11 +109,94 @@ public:
    * When set to true, zlib compression is used. False by default.
    * This value has any effect only on the data-sender processes. The receiver
    * always checks the received data to see if zlib decompression is required.
+   * This only sets the default for CompressionCodec for instances created
+   * afterwards.
    */
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
   //@}
 
+  enum CompressionCodecs
+  {
+    COMPRESSION_NONE = 0,
+    COMPRESSION_ZLIB = 1,
+    COMPRESSION_LZ4 = 2
+  };
+
+  //@{
+  /**
+   * Select the codec used to compress the marshalled data. The data is split
+   * in chunks of CompressionChunkSize bytes which are compressed and
+   * decompressed concurrently using vtkSMPTools. As with
+   * SetUseZLibCompression(), this only affects the sender; receivers detect
+   * the codec used. Defaults to COMPRESSION_ZLIB if GetUseZLibCompression()
+   * is true, else COMPRESSION_NONE.
+   */
+  vtkSetClampMacro(CompressionCodec, int, COMPRESSION_NONE, COMPRESSION_LZ4);
+  vtkGetMacro(CompressionCodec, int);
+  //@}
+
+  //@{
+  /**
+   * Compression level in the range [1, 9]; higher values favor ratio over
+   * speed. For LZ4, this controls the acceleration factor. Default is 6.
+   */
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+  //@}
+
+  //@{
+  /**
+   * Size, in bytes, of the chunks compressed independently. Default is 4 MiB.
+   */
+  vtkSetClampMacro(CompressionChunkSize, vtkIdType, 65536, VTK_INT_MAX / 2);
+  vtkGetMacro(CompressionChunkSize, vtkIdType);
+  //@}
+
+  //@{
+  /**
+   * Timings (in seconds) and sizes (in bytes) for the last RequestData() on
+   * this process. The compress time and sizes are only updated on processes
+   * sending data, the decompress time on processes receiving data. The
+   * transfer time includes the time spent waiting for the other processes.
+   */
+  vtkGetMacro(LastCompressTime, double);
+  vtkGetMacro(LastDecompressTime, double);
+  vtkGetMacro(LastTransferTime, double);
+  vtkGetMacro(LastUncompressedSize, vtkIdType);
+  vtkGetMacro(LastCompressedSize, vtkIdType);
+  vtkGetMacro(LastSkippedSize, vtkIdType);
+  //@}
+
+  //@{
+  /**
+   * When set to true, datasets supported by vtkBinaryDataObjectMarshaller are
+   * marshalled as raw array buffers rather than through
+   * vtkGenericDataObjectWriter. Data sent from the data server to the client
+   * is then sent array by array, without an intermediate buffer, unless
+   * compression is enabled, whatever the codec. False by default. As with
+   * SetUseZLibCompression(), this only affects the sender; receivers detect
+   * the format used. vtkClientServerMoveData honors this setting too.
+   */
+  static void SetUseBinaryMarshalling(bool b);
+  static bool GetUseBinaryMarshalling();
+  //@}
+
+  //@{
+  /**
+   * When set, data sent from the data server to the client using binary
+   * marshalling without compression goes through this marshaller's
+   * incremental transfer: array buffers identical to the ones sent in the
+   * previous transfer are not sent again (see
+   * vtkBinaryDataObjectMarshaller::SendIncremental()). The same marshaller
+   * instance must be set on the data server and the client for consecutive
+   * transfers of the same data, e.g. successive timesteps of a
+   * representation. LastSkippedSize reports the bytes saved.
+   */
+  void SetIncrementalMarshaller(vtkBinaryDataObjectMarshaller*);
+  vtkGetObjectMacro(IncrementalMarshaller, vtkBinaryDataObjectMarshaller);
+  //@}
+
   /**
    * vtkMPIMoveData doesn't necessarily generate a valid output data on all the
    * involved processes (depending on the MoveMode and Server ivars). This
@@ -174,12 +258,26 @@ protected:
   void ClearBuffer();
   void MarshalDataToBuffer(vtkDataObject* data);
   void ReconstructDataFromBuffer(vtkDataObject* data);
+  void ResetTimings();
 
   int MoveMode;
   int Server;
 
   bool SkipDataServerGatherToZero;
 
+  int CompressionCodec;
+  int CompressionLevel;
+  vtkIdType CompressionChunkSize;
+
+  double LastCompressTime;
+  double LastDecompressTime;
+  double LastTransferTime;
+  vtkIdType LastUncompressedSize;
+  vtkIdType LastCompressedSize;
+  vtkIdType LastSkippedSize;
+
+  vtkBinaryDataObjectMarshaller* IncrementalMarshaller;
+
   enum Servers
   {
     CLIENT = 0,
@@ -197,6 +295,7 @@ private:
   void operator=(const vtkMPIMoveData&) = delete;
 
   static bool UseZLibCompression;
+  static bool UseBinaryMarshalling;
 };
 
 #endif
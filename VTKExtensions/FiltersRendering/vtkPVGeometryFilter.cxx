@@ -17,6 +17,7 @@
 #include "vtkAMRInformation.h"
 #include "vtkAlgorithmOutput.h"
 #include "vtkAppendPolyData.h"
+#include "vtkBufferHashPrivate.h"
 #include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
 #include "vtkCellArrayIterator.h"
@@ -40,6 +41,8 @@
 #include "vtkHierarchicalBoxDataSet.h"
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerVectorKey.h"
@@ -58,6 +61,8 @@
 #include "vtkPolygon.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridOutlineFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -74,8 +79,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <map>
 #include <math.h>
+#include <numeric>
 #include <set>
 #include <string>
 #include <vector>
@@ -150,6 +157,97 @@ public:
   int Commutative() override { return 1; }
 };
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Combines the hash of the array's values into `hash`. Returns false if the
+// array does not use the standard memory layout.
+bool vtkHashArray(vtkDataArray* array, vtkTypeUInt64& hash)
+{
+  if (array == nullptr)
+  {
+    hash = vtkBufferHashPrivate::Mix(hash, 0);
+    return true;
+  }
+  if (!array->HasStandardMemoryLayout())
+  {
+    return false;
+  }
+
+  hash = vtkBufferHashPrivate::Mix(hash, static_cast<vtkTypeUInt64>(array->GetDataType()));
+  hash = vtkBufferHashPrivate::Hash(
+    array->GetVoidPointer(0), array->GetNumberOfValues() * array->GetDataTypeSize(), hash);
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+// Surface extracted for a vtkUnstructuredGrid and what identifies the
+// topology it was extracted from. See UseTopologyCache.
+class vtkPVGeometryFilter::vtkTopologyCache
+{
+public:
+  // The arrays defining the input topology and their MTime. Used to avoid
+  // hashing the arrays again when they did not change.
+  std::vector<std::pair<vtkDataArray*, vtkMTimeType> > Stamps;
+  vtkTypeUInt64 Hash = 0;
+  vtkIdType NumberOfInputPoints = 0;
+  vtkIdType NumberOfInputCells = 0;
+  int NonlinearSubdivisionLevel = 0;
+  bool Valid = false;
+
+  // The surface, without points nor attributes.
+  vtkNew<vtkPolyData> Surface;
+  // Surface point/cell id -> input point/cell id.
+  vtkNew<vtkIdList> InputPointIds;
+  vtkNew<vtkIdList> InputCellIds;
+  // 0..n-1 for the surface points and cells.
+  vtkNew<vtkIdList> SurfacePointIds;
+  vtkNew<vtkIdList> SurfaceCellIds;
+
+  void Clear()
+  {
+    this->Valid = false;
+    this->Stamps.clear();
+    this->Surface->Initialize();
+    this->InputPointIds->Initialize();
+    this->InputCellIds->Initialize();
+    this->SurfacePointIds->Initialize();
+    this->SurfaceCellIds->Initialize();
+  }
+
+  static std::vector<std::pair<vtkDataArray*, vtkMTimeType> > GetStamps(vtkUnstructuredGrid* input)
+  {
+    vtkCellArray* cells = input->GetCells();
+    vtkDataArray* arrays[] = { cells ? cells->GetOffsetsArray() : nullptr,
+      cells ? cells->GetConnectivityArray() : nullptr, input->GetCellTypesArray(),
+      input->GetFaces(), input->GetFaceLocations(),
+      input->GetCellData()->GetArray(vtkDataSetAttributes::GhostArrayName()),
+      input->GetPointData()->GetArray(vtkDataSetAttributes::GhostArrayName()) };
+    std::vector<std::pair<vtkDataArray*, vtkMTimeType> > stamps;
+    for (vtkDataArray* array : arrays)
+    {
+      stamps.push_back(std::make_pair(array, array ? array->GetMTime() : 0));
+    }
+    return stamps;
+  }
+
+  // Returns false if the topology cannot be hashed.
+  static bool ComputeHash(
+    const std::vector<std::pair<vtkDataArray*, vtkMTimeType> >& stamps, vtkTypeUInt64& hash)
+  {
+    hash = 0;
+    for (const auto& stamp : stamps)
+    {
+      if (!vtkHashArray(stamp.first, hash))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter()
 {
@@ -195,6 +293,9 @@ vtkPVGeometryFilter::vtkPVGeometryFilter()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->ExecuteBlocksInParallel = false;
+  this->UseTopologyCache = false;
+  this->TopologyCache = new vtkPVGeometryFilter::vtkTopologyCache();
 }
 
 //----------------------------------------------------------------------------
@@ -232,6 +333,8 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter()
   }
   this->OutlineSource->Delete();
   this->SetController(0);
+  delete this->TopologyCache;
+  this->TopologyCache = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -924,6 +1027,57 @@ int vtkPVGeometryFilter::RequestAMRData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Extracts the surface of a range of blocks using a vtkPVGeometryFilter per
+// thread.
+class vtkPVGeometryFilter::BlockExecutionWorker
+{
+public:
+  vtkPVGeometryFilter* Self;
+  const int* WholeExtent;
+  std::vector<vtkDataObject*> Blocks;
+  std::vector<vtkSmartPointer<vtkPolyData> > Outputs;
+  std::vector<int> OutlineFlags;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkPVGeometryFilter> > Filters;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkSmartPointer<vtkPVGeometryFilter>& filter = this->Filters.Local();
+    if (filter == nullptr)
+    {
+      filter.TakeReference(this->Self->NewInstance());
+      filter->CopyExecuteBlockSettings(this->Self);
+    }
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      vtkSmartPointer<vtkPolyData> tmpOut = vtkSmartPointer<vtkPolyData>::New();
+      filter->ExecuteBlock(this->Blocks[cc], tmpOut, 0, 0, 1, 0, this->WholeExtent);
+      filter->CleanupOutputData(tmpOut, 0);
+      this->Outputs[cc] = tmpOut;
+      this->OutlineFlags[cc] = filter->OutlineFlag;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::CopyExecuteBlockSettings(vtkPVGeometryFilter* other)
+{
+  this->SetUseOutline(other->UseOutline);
+  this->SetGenerateFeatureEdges(other->GenerateFeatureEdges);
+  this->SetBlockColorsDistinctValues(other->BlockColorsDistinctValues);
+  this->SetUseStrips(other->UseStrips);
+  this->SetForceUseStrips(other->ForceUseStrips);
+  this->SetGenerateCellNormals(other->GenerateCellNormals);
+  this->SetTriangulate(other->Triangulate);
+  this->SetNonlinearSubdivisionLevel(other->NonlinearSubdivisionLevel);
+  this->SetController(other->Controller);
+  this->SetPassThroughCellIds(other->PassThroughCellIds);
+  this->SetPassThroughPointIds(other->PassThroughPointIds);
+  this->SetGenerateProcessIds(other->GenerateProcessIds);
+  this->SetHideInternalAMRFaces(other->HideInternalAMRFaces);
+  this->SetUseNonOverlappingAMRMetaDataForOutlines(other->UseNonOverlappingAMRMetaDataForOutlines);
+}
+
 //----------------------------------------------------------------------------
 int vtkPVGeometryFilter::RequestDataObjectTree(
   vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -965,6 +1119,31 @@ int vtkPVGeometryFilter::RequestDataObjectTree(
 
   int* wholeExtent =
     vtkStreamingDemandDrivenPipeline::GetWholeExtent(inputVector[0]->GetInformationObject(0));
+
+  // When executing in parallel, extract all surfaces first. The outputs are
+  // then added to the tree in the same traversal order as the serial path so
+  // that the composite indices are the same.
+  BlockExecutionWorker worker;
+  if (this->ExecuteBlocksInParallel && totNumBlocks > 1)
+  {
+    worker.Self = this;
+    worker.WholeExtent = wholeExtent;
+    for (inIter->InitTraversal(); !inIter->IsDoneWithTraversal(); inIter->GoToNextItem())
+    {
+      if (vtkDataObject* block = inIter->GetCurrentDataObject())
+      {
+        worker.Blocks.push_back(block);
+      }
+    }
+    worker.Outputs.resize(worker.Blocks.size());
+    worker.OutlineFlags.resize(worker.Blocks.size(), 0);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(worker.Blocks.size()), 1, worker);
+    if (!worker.OutlineFlags.empty())
+    {
+      this->OutlineFlag = worker.OutlineFlags.back();
+    }
+  }
+
   int numInputs = 0;
   for (inIter->InitTraversal(); !inIter->IsDoneWithTraversal(); inIter->GoToNextItem())
   {
@@ -974,23 +1153,26 @@ int vtkPVGeometryFilter::RequestDataObjectTree(
       continue;
     }
 
-    vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
-    this->CleanupOutputData(tmpOut, 0);
+    vtkSmartPointer<vtkPolyData> tmpOut;
+    if (!worker.Outputs.empty())
+    {
+      tmpOut = worker.Outputs[numInputs];
+      worker.Outputs[numInputs] = nullptr;
+    }
+    else
+    {
+      tmpOut = vtkSmartPointer<vtkPolyData>::New();
+      this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
+      this->CleanupOutputData(tmpOut, 0);
+    }
     // skip empty nodes.
     if (tmpOut->GetNumberOfPoints() > 0)
     {
       output->SetDataSet(inIter, tmpOut);
-      tmpOut->FastDelete();
 
       const unsigned int current_flat_index = inIter->GetCurrentFlatIndex();
       this->AddCompositeIndex(tmpOut, current_flat_index);
     }
-    else
-    {
-      tmpOut->Delete();
-      tmpOut = NULL;
-    }
 
     numInputs++;
     this->UpdateProgress(static_cast<float>(numInputs) / totNumBlocks);
@@ -1498,9 +1680,38 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
       }
     }
 
-    if (input->GetNumberOfCells() > 0)
+    // The topology cache holds a single surface hence it is only used for
+    // non-composite inputs, i.e. when doCommunicate is true.
+    vtkUnstructuredGrid* cacheableInput = nullptr;
+    if (this->UseTopologyCache && doCommunicate && !handleSubdivision && !this->Triangulate &&
+      !this->UseStrips)
+    {
+      cacheableInput = vtkUnstructuredGrid::SafeDownCast(input);
+    }
+    if (!cacheableInput)
     {
+      this->TopologyCache->Clear();
+    }
+
+    if (cacheableInput && this->ExecuteCachedSurface(cacheableInput, output))
+    {
+      vtkDebugMacro("Reused cached surface.");
+    }
+    else if (input->GetNumberOfCells() > 0)
+    {
+      if (cacheableInput)
+      {
+        // the original ids are needed to fill the cache.
+        this->DataSetSurfaceFilter->PassThroughCellIdsOn();
+        this->DataSetSurfaceFilter->PassThroughPointIdsOn();
+      }
       this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      if (cacheableInput)
+      {
+        this->DataSetSurfaceFilter->SetPassThroughCellIds(this->PassThroughCellIds);
+        this->DataSetSurfaceFilter->SetPassThroughPointIds(this->PassThroughPointIds);
+        this->UpdateTopologyCache(cacheableInput, output);
+      }
     }
 
     if (this->Triangulate && (output->GetNumberOfPolys() > 0))
@@ -1573,6 +1784,145 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
   this->DataSetExecute(input, output, doCommunicate);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVGeometryFilter::ExecuteCachedSurface(vtkUnstructuredGrid* input, vtkPolyData* output)
+{
+  vtkTopologyCache& cache = *this->TopologyCache;
+  if (!cache.Valid || input->GetPoints() == nullptr ||
+    cache.NumberOfInputPoints != input->GetNumberOfPoints() ||
+    cache.NumberOfInputCells != input->GetNumberOfCells() ||
+    cache.NonlinearSubdivisionLevel != this->NonlinearSubdivisionLevel)
+  {
+    return false;
+  }
+
+  auto stamps = vtkTopologyCache::GetStamps(input);
+  if (stamps != cache.Stamps)
+  {
+    // different arrays, or modified ones: compare the contents.
+    vtkTypeUInt64 hash;
+    if (!vtkTopologyCache::ComputeHash(stamps, hash) || hash != cache.Hash)
+    {
+      return false;
+    }
+    cache.Stamps = stamps;
+  }
+
+  const vtkIdType numPts = cache.InputPointIds->GetNumberOfIds();
+  const vtkIdType numCells = cache.InputCellIds->GetNumberOfIds();
+  output->CopyStructure(cache.Surface);
+
+  vtkNew<vtkPoints> points;
+  points->SetDataType(input->GetPoints()->GetDataType());
+  points->GetData()->InsertTuples(
+    cache.SurfacePointIds, cache.InputPointIds, input->GetPoints()->GetData());
+  output->SetPoints(points);
+
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(input->GetPointData(), numPts);
+  outPD->CopyData(input->GetPointData(), cache.InputPointIds, cache.SurfacePointIds);
+
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(input->GetCellData(), numCells);
+  outCD->CopyData(input->GetCellData(), cache.InputCellIds, cache.SurfaceCellIds);
+
+  if (this->PassThroughPointIds)
+  {
+    vtkNew<vtkIdTypeArray> originalPointIds;
+    originalPointIds->SetName(this->DataSetSurfaceFilter->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfTuples(numPts);
+    std::copy(cache.InputPointIds->GetPointer(0), cache.InputPointIds->GetPointer(0) + numPts,
+      originalPointIds->GetPointer(0));
+    outPD->AddArray(originalPointIds);
+  }
+  if (this->PassThroughCellIds)
+  {
+    vtkNew<vtkIdTypeArray> originalCellIds;
+    originalCellIds->SetName(this->DataSetSurfaceFilter->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfTuples(numCells);
+    std::copy(cache.InputCellIds->GetPointer(0), cache.InputCellIds->GetPointer(0) + numCells,
+      originalCellIds->GetPointer(0));
+    outCD->AddArray(originalCellIds);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::UpdateTopologyCache(vtkUnstructuredGrid* input, vtkPolyData* output)
+{
+  vtkTopologyCache& cache = *this->TopologyCache;
+  cache.Clear();
+
+  const char* pointIdsName = this->DataSetSurfaceFilter->GetOriginalPointIdsName();
+  const char* cellIdsName = this->DataSetSurfaceFilter->GetOriginalCellIdsName();
+  vtkIdTypeArray* pointIds =
+    vtkIdTypeArray::SafeDownCast(output->GetPointData()->GetArray(pointIdsName));
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray(cellIdsName));
+
+  cache.Stamps = vtkTopologyCache::GetStamps(input);
+  bool valid = pointIds && cellIds && input->GetPoints() &&
+    pointIds->GetNumberOfTuples() == output->GetNumberOfPoints() &&
+    cellIds->GetNumberOfTuples() == output->GetNumberOfCells() &&
+    vtkTopologyCache::ComputeHash(cache.Stamps, cache.Hash);
+
+  // The cached surface can only be used if all its points and cells are
+  // copied from the input (e.g. no points were generated by subdividing
+  // nonlinear cells).
+  const vtkIdType numInputPts = input->GetNumberOfPoints();
+  const vtkIdType numInputCells = input->GetNumberOfCells();
+  for (vtkIdType cc = 0; valid && cc < output->GetNumberOfPoints(); ++cc)
+  {
+    const vtkIdType id = pointIds->GetValue(cc);
+    valid = id >= 0 && id < numInputPts;
+  }
+  for (vtkIdType cc = 0; valid && cc < output->GetNumberOfCells(); ++cc)
+  {
+    const vtkIdType id = cellIds->GetValue(cc);
+    valid = id >= 0 && id < numInputCells;
+  }
+
+  if (valid)
+  {
+    const vtkIdType numPts = pointIds->GetNumberOfTuples();
+    const vtkIdType numCells = cellIds->GetNumberOfTuples();
+    cache.Surface->CopyStructure(output);
+    cache.Surface->SetPoints(nullptr);
+    cache.InputPointIds->SetNumberOfIds(numPts);
+    std::copy(pointIds->GetPointer(0), pointIds->GetPointer(0) + numPts,
+      cache.InputPointIds->GetPointer(0));
+    cache.InputCellIds->SetNumberOfIds(numCells);
+    std::copy(cellIds->GetPointer(0), cellIds->GetPointer(0) + numCells,
+      cache.InputCellIds->GetPointer(0));
+    cache.SurfacePointIds->SetNumberOfIds(numPts);
+    std::iota(cache.SurfacePointIds->GetPointer(0), cache.SurfacePointIds->GetPointer(0) + numPts,
+      vtkIdType(0));
+    cache.SurfaceCellIds->SetNumberOfIds(numCells);
+    std::iota(cache.SurfaceCellIds->GetPointer(0), cache.SurfaceCellIds->GetPointer(0) + numCells,
+      vtkIdType(0));
+    cache.NumberOfInputPoints = numInputPts;
+    cache.NumberOfInputCells = numInputCells;
+    cache.NonlinearSubdivisionLevel = this->NonlinearSubdivisionLevel;
+    cache.Valid = true;
+  }
+  else
+  {
+    cache.Clear();
+  }
+
+  // Remove the original ids added only for the cache.
+  if (!this->PassThroughPointIds)
+  {
+    output->GetPointData()->RemoveArray(pointIdsName);
+  }
+  if (!this->PassThroughCellIds)
+  {
+    output->GetCellData()->RemoveArray(cellIdsName);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::PolyDataExecute(
   vtkPolyData* input, vtkPolyData* output, int doCommunicate)
@@ -1807,6 +2157,8 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "PassThroughCellIds: " << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: " << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "ExecuteBlocksInParallel: " << this->ExecuteBlocksInParallel << endl;
+  os << indent << "UseTopologyCache: " << this->UseTopologyCache << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -43,6 +43,7 @@ class vtkPolyData;
 class vtkPVRecoverGeometryWireframe;
 class vtkRectilinearGrid;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 class vtkUnstructuredGridBase;
 class vtkUnstructuredGridGeometryFilter;
 class vtkAMRBox;
@@ -207,6 +208,40 @@ public:
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   //@}
 
+  //@{
+  /**
+   * When set, the leaves of composite datasets (other than AMR) are processed
+   * concurrently using vtkSMPTools. Each thread uses its own copy of the
+   * internal filters, configured like this one; the composite structure and
+   * the composite / hierarchical indices added to the output are the same as
+   * in serial mode. Progress is only reported once all leaves are done.
+   * Default is false.
+   */
+  vtkSetMacro(ExecuteBlocksInParallel, bool);
+  vtkGetMacro(ExecuteBlocksInParallel, bool);
+  vtkBooleanMacro(ExecuteBlocksInParallel, bool);
+  //@}
+
+  //@{
+  /**
+   * When set, the surface extracted from a (non-composite) vtkUnstructuredGrid
+   * input is cached along with the ids of the input points and cells it was
+   * built from. If the next input has the same connectivity, cell types and
+   * ghost arrays (compared using their MTime or, when they are different
+   * arrays, a hash of their contents) and the same number of points, the
+   * cached surface is reused and only the point coordinates and the
+   * point/cell attributes are gathered from the new input. This is typically
+   * the case when stepping through time on a static mesh.
+   *
+   * The cache is only used for linear cells when triangulation and strips are
+   * off. It holds the surface connectivity and the id maps in memory.
+   * Default is false.
+   */
+  vtkSetMacro(UseTopologyCache, bool);
+  vtkGetMacro(UseTopologyCache, bool);
+  vtkBooleanMacro(UseTopologyCache, bool);
+  //@}
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -331,6 +366,8 @@ protected:
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
   bool GenerateFeatureEdges;
+  bool ExecuteBlocksInParallel;
+  bool UseTopologyCache;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&) = delete;
@@ -348,6 +385,26 @@ private:
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
   //@}
+
+  /**
+   * Copies the ivars affecting ExecuteBlock() from `other`. Used to set up the
+   * per-thread filters when ExecuteBlocksInParallel is true.
+   */
+  void CopyExecuteBlockSettings(vtkPVGeometryFilter* other);
+  class BlockExecutionWorker;
+
+  //@{
+  /**
+   * Used by UnstructuredGridExecute() when UseTopologyCache is true.
+   * ExecuteCachedSurface() returns false if the cached surface cannot be used
+   * for the input; the surface must then be extracted and passed to
+   * UpdateTopologyCache().
+   */
+  bool ExecuteCachedSurface(vtkUnstructuredGrid* input, vtkPolyData* output);
+  void UpdateTopologyCache(vtkUnstructuredGrid* input, vtkPolyData* output);
+  class vtkTopologyCache;
+  vtkTopologyCache* TopologyCache;
+  //@}
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include "vtkPartitionedDataSetCollection.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
 #include "vtkSignedCharArray.h"
@@ -146,218 +147,6 @@ template <class T>
 class vtkSortedTableStreamer::Internals : public vtkSortedTableStreamer::InternalsBase
 {
 public:
-  class Histogram
-  {
-  public:
-    vtkIdType* Values;
-    double Delta;
-    double Min;
-    int Size;
-    vtkIdType TotalValues;
-    bool Inverted;
-
-    Histogram()
-    {
-      this->Inverted = false;
-      this->TotalValues = 0;
-      this->Size = 0;
-      this->Min = 0;
-      this->Delta = 1;
-      this->Values = 0;
-    }
-
-    Histogram(int size)
-      : Size(size)
-      , TotalValues(0)
-    {
-      this->Min = 0;
-      this->Delta = 0;
-      this->Inverted = false;
-      this->Values = new vtkIdType[size];
-      for (int i = 0; i < this->Size; ++i)
-      {
-        this->Values[i] = 0;
-      }
-    }
-
-    virtual ~Histogram()
-    {
-      if (this->Values)
-      {
-        delete[] this->Values;
-        this->Values = 0;
-      }
-    }
-
-    bool CanBeReduced() { return this->TotalValues != this->Values[0] && (this->Delta > 10E-5); }
-
-    bool SetScalarRange(double* scalarRange)
-    {
-      this->Min = scalarRange[0];
-      this->Delta = (scalarRange[1] - scalarRange[0]) / (double)this->Size;
-      return (scalarRange[1] > scalarRange[0]);
-    }
-
-    void CopyRangeTo(Histogram& other)
-    {
-      other.Min = this->Min;
-      other.Delta = this->Delta;
-    }
-
-    void AddValue(double value)
-    {
-      int idx = vtkMath::Floor((value - this->Min) / this->Delta);
-      if (idx == this->Size)
-      {
-        --idx;
-      }
-      if (this->Inverted)
-      {
-        idx = this->Size - idx - 1;
-      }
-      if (idx >= 0 && idx < this->Size)
-      {
-        this->TotalValues++;
-        this->Values[idx]++;
-      }
-      else if (value == static_cast<T>(this->Min))
-      {
-        // Manage type troncature
-        this->TotalValues++;
-        this->Values[0]++;
-      }
-      else
-      {
-        cout << "Try to add value out of the histogran range: " << value << " Range: [" << this->Min
-             << ", " << (this->Min + this->Delta * this->Size) << "]" << endl;
-      }
-    }
-
-    // Description:
-    // Find the selected bar corresponding to the nth element in the histogram.
-    // As result, we return the number of elements found before the selected bar
-    // as well as providing the scalar range and the index of that bar.
-    vtkIdType GetNewRange(vtkIdType nthElement, vtkIdType& selectedBarIdx, double* scalarRange)
-    {
-      if (nthElement >= this->TotalValues)
-      {
-        scalarRange[0] = this->Min;
-        scalarRange[1] = this->Min + this->Delta * this->Size;
-        selectedBarIdx = this->Size - 1;
-        return this->TotalValues;
-      }
-      vtkIdType nbElementsFounds = 0;
-      selectedBarIdx = 0;
-      while (nbElementsFounds + this->Values[selectedBarIdx] < nthElement)
-      {
-        nbElementsFounds += this->Values[selectedBarIdx++];
-      }
-      if (this->Inverted)
-      {
-        scalarRange[1] = this->Min + this->Delta * (this->Size - selectedBarIdx);
-        scalarRange[0] = scalarRange[1] - this->Delta;
-      }
-      else
-      {
-        scalarRange[0] = this->Min + this->Delta * selectedBarIdx;
-        scalarRange[1] = scalarRange[0] + this->Delta;
-      }
-      return nbElementsFounds;
-    }
-
-    void Merge(const Histogram& other)
-    {
-      if (this->Min != other.Min || this->Delta != other.Delta || Size != other.Size)
-      {
-        // Throw exception because not compatible histogram
-        cout << "ERROR: Histogram::Merge not compatible histogram !" << endl;
-      }
-      for (int i = 0; i < this->Size; i++)
-      {
-        this->TotalValues += other.Values[i];
-        this->Values[i] += other.Values[i];
-      }
-    }
-
-    void UpdateTotalValues()
-    {
-      this->TotalValues = 0;
-      for (int i = 0; i < this->Size; i++)
-      {
-        this->TotalValues += Values[i];
-      }
-    }
-
-    vtkIdType GetNumberOfElements(int lowerIndex, int upperIndex)
-    {
-      vtkIdType nbElements = 0;
-      if (lowerIndex == -1 || upperIndex == -1 || lowerIndex >= this->Size)
-      {
-        return 0;
-      }
-      upperIndex = (upperIndex > this->Size) ? this->Size : upperIndex;
-      for (int i = lowerIndex; i < upperIndex; ++i)
-      {
-        nbElements += this->Values[i];
-      }
-      return nbElements;
-    }
-
-    void Print()
-    {
-      cout << "Histo: " << endl
-           << " - NbElements: " << this->TotalValues << endl
-           << " - Min: " << this->Min << endl
-           << " - Delta: " << this->Delta << endl
-           << " - Size: " << this->Size << endl;
-      double min = this->Min;
-      for (int i = 0; i < this->Size; i++)
-      {
-        if (this->Values[i] > 0)
-        {
-          cout << " - [" << min << ", ";
-          min += this->Delta;
-          cout << min << "]: " << this->Values[i] << endl;
-        }
-        else
-        {
-          min += this->Delta;
-        }
-      }
-    }
-
-    void CopyTo(Histogram& other)
-    {
-      other.Inverted = this->Inverted;
-      other.Delta = this->Delta;
-      other.Min = this->Min;
-      other.Size = this->Size;
-      other.TotalValues = this->TotalValues;
-      if (other.Values)
-      {
-        delete[] other.Values;
-        other.Values = 0;
-      }
-      other.Values = new vtkIdType[this->Size];
-      for (int i = 0; i < this->Size; i++)
-      {
-        other.Values[i] = this->Values[i];
-      }
-    }
-
-    void ClearHistogramValues()
-    {
-      this->TotalValues = 0;
-      if (!this->Values)
-      {
-        this->Values = new vtkIdType[this->Size];
-      }
-      for (int i = 0; i < this->Size; i++)
-      {
-        this->Values[i] = 0;
-      }
-    }
-  };
   class SortableArrayItem
   {
   public:
@@ -421,14 +210,13 @@ public:
   class ArraySorter
   {
   public:
-    Histogram* Histo;
     SortableArrayItem* Array;
     vtkIdType ArraySize;
 
     ArraySorter()
     {
       this->Array = 0;
-      this->Histo = 0;
+      this->ArraySize = 0;
     }
 
     ~ArraySorter() { this->Clear(); }
@@ -440,11 +228,7 @@ public:
         delete[] this->Array;
         this->Array = 0;
       }
-      if (this->Histo)
-      {
-        delete this->Histo;
-        this->Histo = 0;
-      }
+      this->ArraySize = 0;
     }
     void FillArray(vtkIdType numTuples)
     {
@@ -456,15 +240,24 @@ public:
       this->Array = new SortableArrayItem[this->ArraySize];
 
       // Fill the sortable array
-      for (vtkIdType i = 0; i < this->ArraySize; ++i)
-      {
-        this->Array[i].OriginalIndex = i;
-        this->Array[i].Value = 0;
-      }
+      SortableArrayItem* array = this->Array;
+      vtkSMPTools::For(0, this->ArraySize, [array](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          array[i].OriginalIndex = i;
+          array[i].Value = 0;
+        }
+      });
     }
 
     void Update(T* dataPtr, vtkIdType numTuples, int numComponents, int selectedComponent,
-      vtkIdType histogramSize, double* scalarRange, bool reverseOrder)
+      bool reverseOrder)
+    {
+      this->Fill(dataPtr, numTuples, numComponents, selectedComponent);
+      this->Sort(reverseOrder);
+    }
+
+    void Fill(T* dataPtr, vtkIdType numTuples, int numComponents, int selectedComponent)
     {
       // Clear memory if needed
       this->Clear();
@@ -475,58 +268,41 @@ public:
       }
 
       // Allocate memory and fill the structure
-      this->Histo = new Histogram(histogramSize);
-      this->Histo->Inverted = reverseOrder;
-      this->Histo->SetScalarRange(scalarRange);
       this->ArraySize = numTuples;
       this->Array = new SortableArrayItem[this->ArraySize];
 
       // Fill the sortable array
-      for (vtkIdType i = 0; i < this->ArraySize; ++i)
-      {
-        this->Array[i].OriginalIndex = i;
-        double value = 0;
-        double tmp;
-        if (selectedComponent < 0)
+      SortableArrayItem* array = this->Array;
+      vtkSMPTools::For(0, this->ArraySize, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
         {
-          // Compute magnitude
-          for (int k = 0; k < numComponents; k++)
+          array[i].OriginalIndex = i;
+          if (selectedComponent < 0)
           {
-            tmp = static_cast<double>(dataPtr[k + i * numComponents]);
-            value += tmp * tmp;
+            // Compute magnitude
+            double value = 0;
+            for (int k = 0; k < numComponents; k++)
+            {
+              const double tmp = static_cast<double>(dataPtr[k + i * numComponents]);
+              value += tmp * tmp;
+            }
+            value = sqrt(value) / sqrt(static_cast<double>(numComponents));
+            array[i].Value = static_cast<T>(value);
+          }
+          else
+          {
+            array[i].Value = dataPtr[selectedComponent + i * numComponents];
           }
-          value = sqrt(value) / sqrt(static_cast<double>(numComponents));
-          this->Array[i].Value = static_cast<T>(value);
-        }
-        else
-        {
-          this->Array[i].Value = dataPtr[selectedComponent + i * numComponents];
-          value = static_cast<double>(this->Array[i].Value);
         }
-        this->Histo->AddValue(value);
-      }
-
-      // Sort it
-      if (reverseOrder)
-      {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
-      }
-      else
-      {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
-      }
+      });
     }
 
-    void SortProcessId(vtkIdType* dataPtr, vtkIdType numTuples, vtkIdType histogramSize,
-      double* scalarRange, bool reverseOrder)
+    void SortProcessId(vtkIdType* dataPtr, vtkIdType numTuples, bool reverseOrder)
     {
       // Clear memory if needed
       this->Clear();
 
       // Allocate memory and fill the structure
-      this->Histo = new Histogram(histogramSize);
-      this->Histo->Inverted = reverseOrder;
-      this->Histo->SetScalarRange(scalarRange);
       this->ArraySize = numTuples;
       this->Array = new SortableArrayItem[this->ArraySize];
 
@@ -535,19 +311,67 @@ public:
       {
         this->Array[i].OriginalIndex = i;
         this->Array[i].Value = static_cast<T>(dataPtr[i]);
-        double value = static_cast<double>(this->Array[i].Value);
-        this->Histo->AddValue(value);
       }
 
-      // Sort it
+      this->Sort(reverseOrder);
+    }
+
+    void Sort(bool reverseOrder)
+    {
+      vtkSMPTools::Sort(this->Array, this->Array + this->ArraySize,
+        reverseOrder ? SortableArrayItem::Ascendent : SortableArrayItem::Descendent);
+    }
+
+    // Sorts the rows of a table made of the local subsets of all processes,
+    // each one in the order of its local sorted array, appended in process
+    // order. Ties are broken by process id and then by original index in the
+    // sort direction, like SplitterKey. Within a process, the position in
+    // the merged table already follows the original index in the sort
+    // direction, so it is used in place of the original index.
+    void SortMerged(const vtkIdType* processIds, bool reverseOrder)
+    {
+      vtkSMPTools::Sort(this->Array, this->Array + this->ArraySize,
+        [processIds, reverseOrder](const SortableArrayItem& a, const SortableArrayItem& b) {
+          if (a.Value != b.Value)
+          {
+            return reverseOrder ? b.Value < a.Value : a.Value < b.Value;
+          }
+          const vtkIdType pidA = processIds ? processIds[a.OriginalIndex] : 0;
+          const vtkIdType pidB = processIds ? processIds[b.OriginalIndex] : 0;
+          if (pidA != pidB)
+          {
+            return reverseOrder ? pidB < pidA : pidA < pidB;
+          }
+          return a.OriginalIndex < b.OriginalIndex;
+        });
+    }
+  };
+
+  // Key of a row in the distributed sort. Rows are ordered by value, then by
+  // process id and then by index in the local table, which matches the order
+  // of the local ArraySorter on each process.
+  class SplitterKey
+  {
+  public:
+    T Value;
+    vtkIdType OriginalIndex;
+    int ProcessId;
+
+    static bool Less(const SplitterKey& a, const SplitterKey& b, bool reverseOrder)
+    {
       if (reverseOrder)
       {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+        return Less(b, a, false);
       }
-      else
+      if (a.Value != b.Value)
       {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+        return a.Value < b.Value;
       }
+      if (a.ProcessId != b.ProcessId)
+      {
+        return a.ProcessId < b.ProcessId;
+      }
+      return a.OriginalIndex < b.OriginalIndex;
     }
   };
 
@@ -556,7 +380,7 @@ public:
   {
     // Only used for testing
     this->LocalSorter = 0;
-    this->GlobalHistogram = 0;
+    this->GlobalNumberOfRows = 0;
     this->Debug = false;
   }
 
@@ -581,15 +405,13 @@ public:
 
     // Create internal objects
     this->LocalSorter = new ArraySorter();
-    this->GlobalHistogram = new Histogram(HISTOGRAM_SIZE);
+    this->GlobalNumberOfRows = 0;
   }
 
   ~Internals() override
   {
     if (this->LocalSorter)
       delete this->LocalSorter;
-    if (this->GlobalHistogram)
-      delete this->GlobalHistogram;
   }
 
   // --------------------------------------------------------------------------
@@ -614,7 +436,7 @@ public:
       this->DataToSort->GetRange(localRange, this->SelectedComponent);
     }
 
-    // Gather the array range to build a common scale histogram
+    // Gather the array range to see if there is anything to sort
     this->MPI->AllReduce(&localRange[0], &this->CommonRange[0], 1, vtkCommunicator::MIN_OP);
     this->MPI->AllReduce(&localRange[1], &this->CommonRange[1], 1, vtkCommunicator::MAX_OP);
 
@@ -646,13 +468,7 @@ public:
 
     double delta = (this->CommonRange[1] - this->CommonRange[0]);
     delta *= delta;
-    bool sortable = delta > FLT_EPSILON;
-
-    // Extend range with epsilon to make sure that a computed magnitude will fit in
-    this->CommonRange[0] -= FLT_EPSILON;
-    this->CommonRange[1] += FLT_EPSILON;
-
-    return sortable;
+    return delta > FLT_EPSILON;
   }
 
   // --------------------------------------------------------------------------
@@ -661,9 +477,6 @@ public:
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
 
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs * HISTOGRAM_SIZE];
-
     // Is there something to sort ???
     if (!sortableArray)
     {
@@ -677,42 +490,101 @@ public:
     {
       if (this->DataToSort)
       {
-        // Sort and build local histogram
+        // Sort the local array
         this->LocalSorter->Update(static_cast<T*>(this->DataToSort->GetVoidPointer(0)),
           this->DataToSort->GetNumberOfTuples(), this->DataToSort->GetNumberOfComponents(),
-          this->SelectedComponent, HISTOGRAM_SIZE, this->CommonRange, invertOrder);
+          this->SelectedComponent, invertOrder);
       }
       else
       {
-        // Build empty local histogram
         this->LocalSorter->Clear();
-        this->LocalSorter->Histo = new Histogram(HISTOGRAM_SIZE);
-        this->LocalSorter->Histo->SetScalarRange(this->CommonRange);
-        this->LocalSorter->Histo->Inverted = invertOrder;
       }
 
-      // Initialize the global histogram with same range
-      this->LocalSorter->Histo->CopyRangeTo(*this->GlobalHistogram);
-
-      // Make sure that the global histogram is properly initialized
-      this->GlobalHistogram->ClearHistogramValues();
-      this->GlobalHistogram->Inverted = invertOrder;
-
-      // Send local histogram and receive every histogram from everybody
-      this->MPI->AllGather(this->LocalSorter->Histo->Values, bufferHistogramValues, HISTOGRAM_SIZE);
-
-      // Merge all histogram into the GlobalHistogram
-      for (int idx = 0, nb = this->NumProcs * HISTOGRAM_SIZE; idx < nb; ++idx)
-      {
-        this->GlobalHistogram->TotalValues += bufferHistogramValues[idx];
-        this->GlobalHistogram->Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
-      }
+      this->BuildIndex(invertOrder);
     }
-
-    delete[] bufferHistogramValues;
     return 1;
   }
 
+  // --------------------------------------------------------------------------
+  // Build the distributed sorted index from the locally sorted arrays.
+  // Every process contributes regularly spaced samples of its sorted array,
+  // the samples are shared with everybody and sorted to become the splitters.
+  // For each splitter we keep the number of local rows and the number of rows
+  // over all processes that come before it. A block request can then be
+  // answered by looking at the rows between the two splitters surrounding
+  // the block.
+  void BuildIndex(bool invertOrder)
+  {
+    const vtkIdType localSize = this->LocalSorter->ArraySize;
+    this->MPI->AllReduce(&localSize, &this->GlobalNumberOfRows, 1, vtkCommunicator::SUM_OP);
+
+    // Pick local samples
+    vtkIdType numberOfSplitters = this->GlobalNumberOfRows / SPLITTER_SPACING;
+    if (numberOfSplitters > MAX_NUMBER_OF_SPLITTERS)
+    {
+      numberOfSplitters = MAX_NUMBER_OF_SPLITTERS;
+    }
+    const vtkIdType numberOfSamples = this->GlobalNumberOfRows > 0
+      ? localSize * numberOfSplitters / this->GlobalNumberOfRows
+      : 0;
+    std::vector<SplitterKey> samples(numberOfSamples);
+    for (vtkIdType cc = 0; cc < numberOfSamples; ++cc)
+    {
+      const SortableArrayItem& item = this->LocalSorter->Array[cc * localSize / numberOfSamples];
+      samples[cc].Value = item.Value;
+      samples[cc].OriginalIndex = item.OriginalIndex;
+      samples[cc].ProcessId = this->Me;
+    }
+
+    // Share them with everybody
+    const vtkIdType sendLength = numberOfSamples * static_cast<vtkIdType>(sizeof(SplitterKey));
+    std::vector<vtkIdType> recvLengths(this->NumProcs);
+    std::vector<vtkIdType> offsets(this->NumProcs + 1, 0);
+    this->MPI->AllGather(&sendLength, recvLengths.data(), 1);
+    for (int pid = 0; pid < this->NumProcs; ++pid)
+    {
+      offsets[pid + 1] = offsets[pid] + recvLengths[pid];
+    }
+    std::vector<SplitterKey> splitters(offsets[this->NumProcs] / sizeof(SplitterKey));
+    this->MPI->AllGatherV(reinterpret_cast<const char*>(samples.data()),
+      reinterpret_cast<char*>(splitters.data()), sendLength, recvLengths.data(), offsets.data());
+    std::sort(splitters.begin(), splitters.end(),
+      [invertOrder](const SplitterKey& a, const SplitterKey& b) {
+        return SplitterKey::Less(a, b, invertOrder);
+      });
+
+    // Locate the splitters in the local sorted array. The first and the last
+    // entries stand for the beginning and the end of the sorted table.
+    const vtkIdType numberOfEntries = static_cast<vtkIdType>(splitters.size()) + 2;
+    this->SplitterLocalOffsets.assign(numberOfEntries, 0);
+    this->SplitterGlobalOffsets.assign(numberOfEntries, 0);
+    vtkIdType* localOffsets = this->SplitterLocalOffsets.data();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(splitters.size()),
+      [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+          localOffsets[cc + 1] = this->GetNumberOfLocalRowsBefore(splitters[cc], invertOrder);
+        }
+      });
+    localOffsets[numberOfEntries - 1] = localSize;
+    this->MPI->AllReduce(this->SplitterLocalOffsets.data(), this->SplitterGlobalOffsets.data(),
+      numberOfEntries, vtkCommunicator::SUM_OP);
+  }
+
+  // --------------------------------------------------------------------------
+  vtkIdType GetNumberOfLocalRowsBefore(const SplitterKey& key, bool invertOrder) const
+  {
+    const SortableArrayItem* array = this->LocalSorter->Array;
+    const SortableArrayItem* end = array + this->LocalSorter->ArraySize;
+    const int me = this->Me;
+    return std::lower_bound(array, end, key,
+             [me, invertOrder](const SortableArrayItem& item, const SplitterKey& other) {
+               const SplitterKey itemKey = { item.Value, item.OriginalIndex, me };
+               return SplitterKey::Less(itemKey, other, invertOrder);
+             }) -
+      array;
+  }
+
   // --------------------------------------------------------------------------
   // The sorting is based on processId and the current order
   int Extract(vtkTable* input, vtkTable* output, vtkIdType block, vtkIdType blockSize,
@@ -784,10 +656,6 @@ public:
     // ------------------------------------------------------------------------
     if (this->Me == mergePid)
     {
-      // Reset to correct range
-      this->CommonRange[0] = 0;
-      this->CommonRange[1] = this->NumProcs;
-
       // Add local vtkOriginalProcessIds array
       if (this->NumProcs > 1)
       {
@@ -821,11 +689,9 @@ public:
       if (subsetArray)
       {
         ArraySorter sorter;
-        this->CommonRange[0] = 0;
-        this->CommonRange[1] = this->NumProcs;
         // ProcessId array is not the same type of T
         sorter.SortProcessId(static_cast<vtkIdType*>(subsetArray->GetVoidPointer(0)),
-          subsetArray->GetNumberOfTuples(), HISTOGRAM_SIZE, this->CommonRange, revertOrder);
+          subsetArray->GetNumberOfTuples(), revertOrder);
 
         localResult.TakeReference(this->NewSubsetTable(
           localResult.GetPointer(), &sorter, 0, localResult->GetNumberOfRows()));
@@ -853,8 +719,9 @@ public:
   {
     // ------------------------------------------------------------------------
     // Make sure that the Cache is built
-    //    This will sort the local array, that's why we don't want to do it
-    //    at each execution. Specially when we only change the requested block.
+    //    This will sort the local array and build the distributed index,
+    //    that's why we don't want to do it at each execution. Specially when
+    //    we only change the requested block.
     // ------------------------------------------------------------------------
     if (this->NeedToBuildCache)
     {
@@ -862,29 +729,24 @@ public:
     }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
-    // ------------------------------------------------------------------------
-    vtkIdType nbElementsToRemoveFromHead = 0;
-    vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation((block * blockSize), this->LocalSorter->Histo,
-      this->GlobalHistogram, nbElementsToRemoveFromHead, localOffset, nbElementsInBar);
-
+    // Find the splitters surrounding the requested block. Rows before the
+    // first splitter can be skipped on every process, and no process has
+    // more than (nbElementsToRemoveFromHead + blockSize) rows to provide.
     // ------------------------------------------------------------------------
-    // Search for upper bound
-    // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx = (this->GlobalHistogram->TotalValues < (block + 1) * blockSize)
-      ? this->GlobalHistogram->TotalValues
-      : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation(searchIdx, this->LocalSorter->Histo, this->GlobalHistogram,
-      globalUpperOffset, upperOffset, nbElementsInBar);
-
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+    const std::vector<vtkIdType>& globalOffsets = this->SplitterGlobalOffsets;
+    const vtkIdType first = std::min(block * blockSize, this->GlobalNumberOfRows);
+    const vtkIdType last = std::min(first + blockSize, this->GlobalNumberOfRows);
+    const size_t lower =
+      std::upper_bound(globalOffsets.begin(), globalOffsets.end(), first) - globalOffsets.begin() -
+      1;
+    const size_t upper =
+      std::lower_bound(globalOffsets.begin() + lower, globalOffsets.end(), last) -
+      globalOffsets.begin();
+    const vtkIdType nbElementsToRemoveFromHead = first - globalOffsets[lower];
+    const vtkIdType localOffset = this->SplitterLocalOffsets[lower];
+    const vtkIdType localSize = std::min(this->SplitterLocalOffsets[upper],
+                                  localOffset + nbElementsToRemoveFromHead + (last - first)) -
+      localOffset;
 
     // ------------------------------------------------------------------------
     // Build local subset table
@@ -898,22 +760,6 @@ public:
     // ------------------------------------------------------------------------
     int mergePid = GetMergingProcessId(localSubset.GetPointer());
 
-    // ------------------------------------------------------------------------
-    // Add local meta-data in case of merge process
-    // ------------------------------------------------------------------------
-    if (this->NumProcs > 1 && this->Me == mergePid)
-    {
-      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      processIdArray->SetName("vtkOriginalProcessIds");
-      processIdArray->SetNumberOfComponents(1);
-      processIdArray->Allocate((blockSize < localSize) ? localSize : blockSize);
-      for (vtkIdType idx = 0; idx < localSubset->GetNumberOfRows(); idx++)
-      {
-        processIdArray->InsertNextTuple1(mergePid);
-      }
-      localSubset->GetRowData()->AddArray(processIdArray);
-    }
-
     // ------------------------------------------------------------------------
     // Send local subset array to process mergePid
     // ------------------------------------------------------------------------
@@ -927,14 +773,29 @@ public:
     // ------------------------------------------------------------------------
     if (this->Me == mergePid)
     {
+      // Merge the subsets in process order, see ArraySorter::SortMerged().
+      vtkSmartPointer<vtkTable> mergedSubset;
+      mergedSubset.TakeReference(this->NewSubsetTable(localSubset.GetPointer(), NULL, 0, 0));
+      if (this->NumProcs > 1)
+      {
+        vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+        processIdArray->SetName("vtkOriginalProcessIds");
+        processIdArray->SetNumberOfComponents(1);
+        processIdArray->Allocate(blockSize);
+        mergedSubset->GetRowData()->AddArray(processIdArray);
+      }
+
       vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
       for (int i = 0; i < this->NumProcs; i++)
       {
         if (i == mergePid)
+        {
+          this->MergeTable(i, localSubset.GetPointer(), mergedSubset.GetPointer(), blockSize);
           continue;
+        }
 
         this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
-        this->MergeTable(i, tmp.GetPointer(), localSubset.GetPointer(), blockSize);
+        this->MergeTable(i, tmp.GetPointer(), mergedSubset.GetPointer(), blockSize);
       }
 
       // Sort new table/array
@@ -945,27 +806,30 @@ public:
         return 1;
       }
       vtkDataArray* subsetArray =
-        vtkDataArray::SafeDownCast(localSubset->GetColumnByName(this->DataToSort->GetName()));
+        vtkDataArray::SafeDownCast(mergedSubset->GetColumnByName(this->DataToSort->GetName()));
 
       if (!subsetArray)
       {
-        vtkSortedTableStreamer::PrintInfo(localSubset.GetPointer());
+        vtkSortedTableStreamer::PrintInfo(mergedSubset.GetPointer());
       }
 
+      vtkIdTypeArray* processIds =
+        vtkIdTypeArray::SafeDownCast(mergedSubset->GetColumnByName("vtkOriginalProcessIds"));
       ArraySorter sorter;
-      sorter.Update(static_cast<T*>(subsetArray->GetVoidPointer(0)),
+      sorter.Fill(static_cast<T*>(subsetArray->GetVoidPointer(0)),
         subsetArray->GetNumberOfTuples(), subsetArray->GetNumberOfComponents(),
-        this->SelectedComponent, HISTOGRAM_SIZE, this->CommonRange, revertOrder);
+        this->SelectedComponent);
+      sorter.SortMerged(processIds ? processIds->GetPointer(0) : nullptr, revertOrder);
 
       // trim it (remove head and tail that don't belong to the result)
-      localSubset.TakeReference(this->NewSubsetTable(
-        localSubset.GetPointer(), &sorter, nbElementsToRemoveFromHead, blockSize));
+      mergedSubset.TakeReference(this->NewSubsetTable(
+        mergedSubset.GetPointer(), &sorter, nbElementsToRemoveFromHead, blockSize));
 
       // Add extra information such as structured indices, block number...
-      this->DecorateTable(input, localSubset.GetPointer(), mergePid);
+      this->DecorateTable(input, mergedSubset.GetPointer(), mergePid);
 
       // ShallowCopy it to the output
-      output->ShallowCopy(localSubset.GetPointer());
+      output->ShallowCopy(mergedSubset.GetPointer());
     }
     else
     {
@@ -976,73 +840,6 @@ public:
     return 1;
   }
 
-  // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skipped at the end
-  // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
-  // in the histogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
-  // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex, Histogram* localHistogram,
-    Histogram* globalHistogram, vtkIdType& nbGlobalToSkip, vtkIdType& localOffset,
-    vtkIdType& nbInLocalBar)
-  {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs * HISTOGRAM_SIZE];
-
-    // Local internal working var
-    vtkIdType histogramBarIdx = -1;
-    double currentRange[2];
-    vtkIdType idx, idxEnd;
-
-    // Setup initial histogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
-    {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip, histogramBarIdx, currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx, histogramBarIdx + 1);
-
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
-
-      idxEnd = localOffset + nbInLocalBar;
-      for (idx = localOffset; idx < idxEnd; ++idx)
-      {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
-      }
-
-      // Exchange local histo with everyone
-      this->MPI->AllGather(_localHistogram.Values, bufferHistogramValues, HISTOGRAM_SIZE);
-
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
-
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for (idx = 0; idx < idxEnd; ++idx)
-      {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
-      }
-    } while (nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
-
-    delete[] bufferHistogramValues;
-  }
-
   // --------------------------------------------------------------------------
   static vtkTable* NewSubsetTable(
     vtkTable* srcTable, ArraySorter* sorter, vtkIdType offset, vtkIdType size)
@@ -1176,7 +973,7 @@ public:
     dataB->SetNumberOfComponents(3);
 
     // Fill data with values
-    for (int i = 0; i < 2048; i++) // 2048 is bigger than histogram
+    for (int i = 0; i < 2048; i++)
     {
       dataA->InsertNextTuple1(vtkMath::Random());
       dataB->InsertNextTuple3(vtkMath::Random(), vtkMath::Random(), vtkMath::Random());
@@ -1185,48 +982,10 @@ public:
     input->GetRowData()->AddArray(dataA.GetPointer());
     input->GetRowData()->AddArray(dataB.GetPointer());
 
-    Histogram histPart1(100);
-    Histogram histPart2(100);
-    Histogram histMerge(100);
-    histPart1.SetScalarRange(dataA->GetRange());
-    histPart2.SetScalarRange(dataA->GetRange());
-    histMerge.SetScalarRange(dataA->GetRange());
-    for (vtkIdType i = 0; i < dataA->GetNumberOfTuples(); i++)
-    {
-      if (i < 1024)
-      {
-        histPart1.AddValue(dataA->GetValue(i));
-      }
-      else
-      {
-        histPart2.AddValue(dataA->GetValue(i));
-      }
-    }
-
-    // Make sure that no values have been skipped while adding them
-    if (histPart1.TotalValues + histPart2.TotalValues != dataA->GetNumberOfTuples())
-    {
-      cout << "Invalid number of elements in the histogram. Expected " << dataA->GetNumberOfTuples()
-           << " and got " << (histPart1.TotalValues + histPart2.TotalValues) << endl;
-      return false;
-    }
-
-    // Make sure that no values have been skipped while merging histo
-    histMerge.Merge(histPart1);
-    histMerge.Merge(histPart2);
-    if (histMerge.TotalValues != dataA->GetNumberOfTuples())
-    {
-      cout << "Invalid number of elements in the histogram. Expected " << dataA->GetNumberOfTuples()
-           << " and got " << (histMerge.TotalValues) << endl;
-      return false;
-    }
-
-    cout << "Histogram ok" << endl;
-
     // Try to sort array
     ArraySorter sortedArray;
     sortedArray.Update(static_cast<T*>(dataA->GetVoidPointer(0)), dataA->GetNumberOfTuples(),
-      dataA->GetNumberOfComponents(), 0, 100, dataA->GetRange(), false);
+      dataA->GetNumberOfComponents(), 0, false);
 
     double min = dataA->GetRange()[0];
     double max = dataA->GetRange()[1];
@@ -1254,7 +1013,7 @@ public:
 
     // Reserse order
     sortedArray.Update(static_cast<T*>(dataA->GetVoidPointer(0)), dataA->GetNumberOfTuples(),
-      dataA->GetNumberOfComponents(), 0, 100, dataA->GetRange(), true);
+      dataA->GetNumberOfComponents(), 0, true);
 
     if (sortedArray.ArraySize != dataA->GetNumberOfTuples())
     {
@@ -1305,28 +1064,48 @@ public:
   }
   // --------------------------------------------------------------------------
 private:
-  vtkMTimeType InputMTime;    // Keep the original input MTime
-  vtkMTimeType DataMTime;     // Keep the original data MTime
-  vtkDataArray* DataToSort;   // DataArray to sort
-  ArraySorter* LocalSorter;   // Local ArraySorter based on global range
-  Histogram* GlobalHistogram; // Globaly merged Histogram based on global range
-  double CommonRange[2];      // Scalar range used across processes
-  int Me;                     // Current process ID
-  int NumProcs;               // Number of processes involved
-  vtkCommunicator* MPI;       // MPI communicator to send/receive/gather
-  int SelectedComponent;      // Component used to sort array
+  vtkMTimeType InputMTime;  // Keep the original input MTime
+  vtkMTimeType DataMTime;   // Keep the original data MTime
+  vtkDataArray* DataToSort; // DataArray to sort
+  ArraySorter* LocalSorter; // Local sorted permutation of DataToSort
+  // Distributed sorted index: number of rows across processes and number of
+  // rows before each splitter, locally and across processes
+  vtkIdType GlobalNumberOfRows;
+  std::vector<vtkIdType> SplitterLocalOffsets;
+  std::vector<vtkIdType> SplitterGlobalOffsets;
+  double CommonRange[2]; // Scalar range used across processes
+  int Me;                // Current process ID
+  int NumProcs;          // Number of processes involved
+  vtkCommunicator* MPI;  // MPI communicator to send/receive/gather
+  int SelectedComponent; // Component used to sort array
   bool NeedToBuildCache;
   bool Debug;
 
   const static int VTK_TABLE_EXCHANGE_TAG = 50;
-  // HISTOGRAM_SIZE could be computed dynamically based on the type of the
-  // array to sort but to make sure that unsigned char won't be distributed
-  // correctly we set the histogram size to be their max number of element
-  // type.
-  // Maybe make some test on huge cluster to see which histogram size is
-  // the best.
-  const static int HISTOGRAM_SIZE = 256;
+  // Splitters are sampled so that about SPLITTER_SPACING rows lie between
+  // two consecutive ones, which bounds the number of rows exchanged for a
+  // block request. MAX_NUMBER_OF_SPLITTERS bounds the index memory.
+  const static int SPLITTER_SPACING = 1024;
+  const static int MAX_NUMBER_OF_SPLITTERS = 1 << 18;
 };
+//****************************************************************************
+namespace
+{
+// Returns the most recent modification time of a composite dataset and its
+// leaves.
+vtkMTimeType vtkGetCompositeMTime(vtkCompositeDataSet* cd)
+{
+  vtkMTimeType mtime = cd->GetMTime();
+  vtkCompositeDataIterator* iter = cd->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    mtime = std::max(mtime, iter->GetCurrentDataObject()->GetMTime());
+  }
+  iter->Delete();
+  return mtime;
+}
+}
+
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
 vtkCxxSetObjectMacro(vtkSortedTableStreamer, Controller, vtkMultiProcessController);
@@ -1342,6 +1121,7 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->BlockSize = 1024;
   this->Internal = 0;
   this->SelectedComponent = 0;
+  this->MergedInputMTime = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -1548,22 +1328,35 @@ int vtkSortedTableStreamer::RequestData(vtkInformation* vtkNotUsed(request),
   // Convert a composite dataset into a vtkTable input.
   if (auto inputCD = vtkCompositeDataSet::SafeDownCast(inputDO))
   {
-    input = this->MergeBlocks(inputCD);
-    if (input->GetColumnByName("vtkCompositeIndexArray") == nullptr)
-    {
-      auto array = this->GenerateCompositeIndexArray(inputCD, input->GetNumberOfRows());
-      input->GetRowData()->AddArray(array);
-    }
-    if (input->GetColumnByName("vtkBlockNameIndices") == nullptr)
+    // The merged table is kept as long as the input does not change, otherwise
+    // the sorted index would be rebuilt for every block request.
+    const vtkMTimeType mtime = vtkGetCompositeMTime(inputCD);
+    if (!this->MergedInput || this->MergedInputMTime != mtime)
     {
-      // add name array.
-      auto array_pair = this->GenerateBlockNameArray(inputCD, input->GetNumberOfRows());
-      if (array_pair.first && array_pair.second)
+      this->MergedInput = this->MergeBlocks(inputCD);
+      this->MergedInputMTime = mtime;
+      input = this->MergedInput;
+      if (input->GetColumnByName("vtkCompositeIndexArray") == nullptr)
       {
-        input->GetRowData()->AddArray(array_pair.second);
-        input->GetFieldData()->AddArray(array_pair.first);
+        auto array = this->GenerateCompositeIndexArray(inputCD, input->GetNumberOfRows());
+        input->GetRowData()->AddArray(array);
+      }
+      if (input->GetColumnByName("vtkBlockNameIndices") == nullptr)
+      {
+        // add name array.
+        auto array_pair = this->GenerateBlockNameArray(inputCD, input->GetNumberOfRows());
+        if (array_pair.first && array_pair.second)
+        {
+          input->GetRowData()->AddArray(array_pair.second);
+          input->GetFieldData()->AddArray(array_pair.first);
+        }
       }
     }
+    input = this->MergedInput;
+  }
+  else
+  {
+    this->MergedInput = nullptr;
   }
 
   // Get input data
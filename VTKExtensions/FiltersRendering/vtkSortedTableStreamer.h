@@ -20,6 +20,11 @@
  * This filter is used quickly get a sorted subset of a given vtkTable.
  * By sorted we mean a subset build from a global sort even if some optimisation
  * allow us to skip a global table sorting.
+ *
+ * The first request after the input, the column or the order changes sorts
+ * the table on each process and builds a distributed index of splitter keys.
+ * Subsequent block requests only exchange the rows surrounding the requested
+ * block.
 */
 
 #ifndef vtkSortedTableStreamer_h
@@ -137,6 +142,10 @@ private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&) = delete;
   void operator=(const vtkSortedTableStreamer&) = delete;
 
+  // Table built from a composite input, kept until the input is modified.
+  vtkSmartPointer<vtkTable> MergedInput;
+  vtkMTimeType MergedInputMTime;
+
   vtkSmartPointer<vtkTable> MergeBlocks(vtkCompositeDataSet* cd);
   vtkSmartPointer<vtkUnsignedIntArray> GenerateCompositeIndexArray(
     vtkCompositeDataSet* cd, vtkIdType maxSize);
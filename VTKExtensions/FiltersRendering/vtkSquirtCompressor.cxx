@@ -19,12 +19,324 @@
 #include "vtkSquirtCompressor.h"
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 #include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTK_SQUIRT_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(VTK_SQUIRT_USE_SSE2) && (defined(__GNUC__) || defined(__clang__)) &&                  \
+  (defined(__x86_64__) || defined(__i386__))
+#define VTK_SQUIRT_USE_AVX2 1
+#include <immintrin.h>
+#endif
 
 vtkStandardNewMacro(vtkSquirtCompressor);
 
+namespace
+{
+// Images smaller than this are not split into strips.
+const vtkIdType vtkSquirtMinimumStripSize = 65536;
+
+// Returns the number of pixels, at most `count`, at the beginning of `pixels`
+// whose masked color is `color`.
+typedef int (*vtkSquirtScanFunction)(
+  const vtkTypeUInt32* pixels, int count, vtkTypeUInt32 color, vtkTypeUInt32 mask);
+
+int vtkSquirtScanScalar(
+  const vtkTypeUInt32* pixels, int count, vtkTypeUInt32 color, vtkTypeUInt32 mask)
+{
+  int cc = 0;
+  while (cc < count && (pixels[cc] & mask) == color)
+  {
+    ++cc;
+  }
+  return cc;
+}
+
+#if defined(VTK_SQUIRT_USE_SSE2)
+inline int vtkFirstZeroBit(int bits)
+{
+  int cc = 0;
+  while (bits & (1 << cc))
+  {
+    ++cc;
+  }
+  return cc;
+}
+
+int vtkSquirtScanSSE2(
+  const vtkTypeUInt32* pixels, int count, vtkTypeUInt32 color, vtkTypeUInt32 mask)
+{
+  const __m128i vmask = _mm_set1_epi32(static_cast<int>(mask));
+  const __m128i vcolor = _mm_set1_epi32(static_cast<int>(color));
+  int cc = 0;
+  for (; cc + 4 <= count; cc += 4)
+  {
+    const __m128i values =
+      _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + cc)), vmask);
+    const int bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(values, vcolor)));
+    if (bits != 0xF)
+    {
+      return cc + vtkFirstZeroBit(bits);
+    }
+  }
+  return cc + vtkSquirtScanScalar(pixels + cc, count - cc, color, mask);
+}
+#endif
+
+#if defined(VTK_SQUIRT_USE_AVX2)
+__attribute__((target("avx2"))) int vtkSquirtScanAVX2(
+  const vtkTypeUInt32* pixels, int count, vtkTypeUInt32 color, vtkTypeUInt32 mask)
+{
+  const __m256i vmask = _mm256_set1_epi32(static_cast<int>(mask));
+  const __m256i vcolor = _mm256_set1_epi32(static_cast<int>(color));
+  int cc = 0;
+  for (; cc + 8 <= count; cc += 8)
+  {
+    const __m256i values =
+      _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + cc)), vmask);
+    const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(values, vcolor)));
+    if (bits != 0xFF)
+    {
+      return cc + vtkFirstZeroBit(bits);
+    }
+  }
+  return cc + vtkSquirtScanSSE2(pixels + cc, count - cc, color, mask);
+}
+#endif
+
+// Picks the fastest run scanner supported by the CPU.
+vtkSquirtScanFunction vtkGetSquirtScanFunction()
+{
+#if defined(VTK_SQUIRT_USE_AVX2)
+  static const vtkSquirtScanFunction scan =
+    __builtin_cpu_supports("avx2") ? vtkSquirtScanAVX2 : vtkSquirtScanSSE2;
+  return scan;
+#elif defined(VTK_SQUIRT_USE_SSE2)
+  return vtkSquirtScanSSE2;
+#else
+  return vtkSquirtScanScalar;
+#endif
+}
+
+// The run length is stored in the last byte of each compressed word. For RGBA
+// images the upper 4 bits of that byte hold the opacity of the run.
+inline unsigned char& vtkRunByte(vtkTypeUInt32& word)
+{
+  return reinterpret_cast<unsigned char*>(&word)[3];
+}
+
+inline unsigned char vtkRunByte(const vtkTypeUInt32& word)
+{
+  return reinterpret_cast<const unsigned char*>(&word)[3];
+}
+
+// Encodes a single run starting at pixel `index` of an RGBA image into `word`.
+// The run does not extend past `end`. Returns the first pixel after the run.
+class vtkSquirtRGBAEncoder
+{
+public:
+  vtkSquirtRGBAEncoder(const unsigned char* pixels, vtkTypeUInt32 mask)
+    : Pixels(reinterpret_cast<const vtkTypeUInt32*>(pixels))
+    , Mask(mask)
+    , Scan(vtkGetSquirtScanFunction())
+  {
+  }
+
+  vtkIdType operator()(vtkIdType index, vtkIdType end, vtkTypeUInt32& word) const
+  {
+    word = this->Pixels[index];
+    const unsigned char opacity = vtkRunByte(word);
+    const int count = this->Scan(this->Pixels + index + 1,
+      static_cast<int>(std::min<vtkIdType>(0x0F, end - index - 1)), word & this->Mask, this->Mask);
+    // encode 8-bit opacity into the upper 4 bits.
+    vtkRunByte(word) = static_cast<unsigned char>(count | (opacity & 0xF0));
+    return index + 1 + count;
+  }
+
+  static vtkIdType GetRunLength(vtkTypeUInt32 word) { return (vtkRunByte(word) & 0x0F) + 1; }
+
+private:
+  const vtkTypeUInt32* Pixels;
+  vtkTypeUInt32 Mask;
+  vtkSquirtScanFunction Scan;
+};
+
+// Same as vtkSquirtRGBAEncoder for RGB images, where runs can be up to 256
+// pixels long.
+class vtkSquirtRGBEncoder
+{
+public:
+  vtkSquirtRGBEncoder(const unsigned char* pixels, vtkTypeUInt32 mask)
+    : Pixels(pixels)
+    , Mask(mask)
+  {
+  }
+
+  vtkIdType operator()(vtkIdType index, vtkIdType end, vtkTypeUInt32& word) const
+  {
+    word = this->GetColor(index);
+    const vtkTypeUInt32 color = word & this->Mask;
+    vtkIdType next = index + 1;
+    int count = 0;
+    while (next < end && count < 255 && (this->GetColor(next) & this->Mask) == color)
+    {
+      ++next;
+      ++count;
+    }
+    vtkRunByte(word) = static_cast<unsigned char>(count);
+    return next;
+  }
+
+  static vtkIdType GetRunLength(vtkTypeUInt32 word) { return vtkRunByte(word) + 1; }
+
+private:
+  vtkTypeUInt32 GetColor(vtkIdType index) const
+  {
+    vtkTypeUInt32 color = 0;
+    memcpy(&color, this->Pixels + 3 * index, 3);
+    return color;
+  }
+
+  const unsigned char* Pixels;
+  vtkTypeUInt32 Mask;
+};
+
+// Run-length encodes `numPixels` pixels into `out` and returns the number of
+// words written.
+//
+// Large images are split into horizontal strips encoded concurrently, each
+// with runs starting at the beginning of the strip. The strips are then
+// stitched together: wherever the runs of the serial encoding and of a strip
+// start on the same pixel, the remaining runs of the strip are identical and
+// are copied as is; elsewhere (at strip boundaries, until both encodings
+// start a run on the same pixel) runs are encoded again serially. The result
+// is identical to encoding the whole image serially.
+template <typename Encoder>
+vtkIdType vtkSquirtEncode(const Encoder& encoder, vtkIdType numPixels, vtkTypeUInt32* out,
+  std::vector<vtkTypeUInt32>& scratch)
+{
+  const vtkIdType numStrips = std::min<vtkIdType>(
+    2 * vtkSMPTools::GetEstimatedNumberOfThreads(), numPixels / vtkSquirtMinimumStripSize);
+  if (numStrips <= 1)
+  {
+    vtkIdType numWords = 0;
+    for (vtkIdType index = 0; index < numPixels;)
+    {
+      index = encoder(index, numPixels, out[numWords++]);
+    }
+    return numWords;
+  }
+
+  auto stripBegin = [numPixels, numStrips](vtkIdType strip) {
+    return numPixels * strip / numStrips;
+  };
+  scratch.resize(numPixels);
+  std::vector<vtkIdType> stripWords(numStrips);
+  std::vector<vtkIdType> lastRunBegin(numStrips);
+  vtkSMPTools::For(0, numStrips, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType strip = begin; strip < end; ++strip)
+    {
+      const vtkIdType stripEnd = stripBegin(strip + 1);
+      vtkTypeUInt32* words = scratch.data() + stripBegin(strip);
+      vtkIdType numWords = 0;
+      for (vtkIdType index = stripBegin(strip); index < stripEnd;)
+      {
+        lastRunBegin[strip] = index;
+        index = encoder(index, stripEnd, words[numWords++]);
+      }
+      stripWords[strip] = numWords;
+    }
+  });
+
+  vtkIdType numWords = 0;
+  vtkIdType index = 0;
+  for (vtkIdType strip = 0; strip < numStrips; ++strip)
+  {
+    const vtkIdType stripEnd = stripBegin(strip + 1);
+    const vtkTypeUInt32* words = scratch.data() + stripBegin(strip);
+    vtkIdType word = 0;
+    vtkIdType runBegin = stripBegin(strip);
+    while (index < stripEnd)
+    {
+      while (word < stripWords[strip] && runBegin < index)
+      {
+        runBegin += Encoder::GetRunLength(words[word++]);
+      }
+      if (runBegin == index && word + 1 < stripWords[strip])
+      {
+        // in sync with the strip. Its last run is encoded again since it may
+        // continue in the next strip.
+        const vtkIdType count = stripWords[strip] - 1 - word;
+        std::copy(words + word, words + word + count, out + numWords);
+        numWords += count;
+        word += count;
+        index = runBegin = lastRunBegin[strip];
+      }
+      else
+      {
+        index = encoder(index, numPixels, out[numWords++]);
+      }
+    }
+  }
+  return numWords;
+}
+
+// Decodes `numWords` words into an image of `numPixels` pixels. Chunks of
+// words are decoded concurrently, the first pixel of each chunk is found by
+// summing the run lengths. Returns false if the runs do not fit in the image.
+template <typename RunLength, typename DecodeRun>
+bool vtkSquirtDecode(const vtkTypeUInt32* words, vtkIdType numWords, vtkIdType numPixels,
+  RunLength runLength, DecodeRun decodeRun)
+{
+  const vtkIdType numChunks = std::max<vtkIdType>(1,
+    std::min<vtkIdType>(4 * vtkSMPTools::GetEstimatedNumberOfThreads(),
+      numWords / (vtkSquirtMinimumStripSize / 4)));
+  auto chunkBegin = [numWords, numChunks](vtkIdType chunk) {
+    return numWords * chunk / numChunks;
+  };
+
+  std::vector<vtkIdType> offsets(numChunks + 1, 0);
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      vtkIdType length = 0;
+      for (vtkIdType cc = chunkBegin(chunk), max = chunkBegin(chunk + 1); cc < max; ++cc)
+      {
+        length += runLength(words[cc]);
+      }
+      offsets[chunk + 1] = length;
+    }
+  });
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    offsets[chunk + 1] += offsets[chunk];
+  }
+  if (offsets[numChunks] > numPixels)
+  {
+    return false;
+  }
+
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      vtkIdType index = offsets[chunk];
+      for (vtkIdType cc = chunkBegin(chunk), max = chunkBegin(chunk + 1); cc < max; ++cc)
+      {
+        index = decodeRun(words[cc], index);
+      }
+    }
+  });
+  return true;
+}
+}
+
 //-----------------------------------------------------------------------------
 vtkSquirtCompressor::vtkSquirtCompressor()
   : SquirtLevel(3)
@@ -53,12 +365,7 @@ int vtkSquirtCompressor::Compress()
     return VTK_ERROR;
   }
 
-  int count = 0;
-  int index = 0;
-  int comp_index = 0;
-  int end_index;
   int compress_level = this->LossLessMode ? 0 : this->SquirtLevel;
-  unsigned int current_color;
   unsigned char compress_masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
     { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
     { 0xE0, 0xF0, 0xE0, 0xE0 } };
@@ -70,103 +377,30 @@ int vtkSquirtCompressor::Compress()
   }
 
   // Set bitmask based on compress_level
-  unsigned int compress_mask;
+  vtkTypeUInt32 compress_mask;
   // I shifted the level by one so that 0 means no compression.
   memcpy(&compress_mask, &compress_masks[compress_level], 4);
 
   // Access raw arrays directly
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  const unsigned char* _rawColorBuffer = input->GetPointer(0);
+  vtkTypeUInt32* _rawCompressedBuffer =
+    reinterpret_cast<vtkTypeUInt32*>(this->Output->WritePointer(0, numPixels * 4));
+
+  // Go through color buffer and put RLE format into compressed buffer
+  std::vector<vtkTypeUInt32> scratch;
+  vtkIdType comp_index;
   if (input->GetNumberOfComponents() == 4)
   {
-    unsigned int* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned int*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0, numPixels * 4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while ((index < end_index) && (comp_index < end_index))
-    {
-
-      // Record color
-      current_color = _rawCompressedBuffer[comp_index] = _rawColorBuffer[index];
-      unsigned char opacity = *(((unsigned char*)&current_color) + 3);
-      index++;
-
-      // Compute Run
-      while ((index < end_index) && (count < 0x0F) &&
-        ((current_color & compress_mask) == (_rawColorBuffer[index] & compress_mask)))
-      {
-        index++;
-        count++;
-      }
-      if (opacity > 0)
-      {
-        opacity /= 16; // since we want to encode 8-bit opacity into 4 bits.
-        opacity = opacity << 4;
-        count |= opacity;
-      }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer + comp_index * 4 + 3) = (unsigned char)count;
-      comp_index++;
-
-      count = 0;
-    }
+    comp_index = vtkSquirtEncode(vtkSquirtRGBAEncoder(_rawColorBuffer, compress_mask), numPixels,
+      _rawCompressedBuffer, scratch);
   }
-  else if (input->GetNumberOfComponents() == 3)
+  else
   {
-    unsigned char* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned char*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0, numPixels * 4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while ((index < 3 * numPixels) && (comp_index < end_index))
-    {
-
-      int next_color = 0;
-      // Record color
-      unsigned char* p = (unsigned char*)&current_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index + 1];
-      *p++ = _rawColorBuffer[index + 2];
-      *p = 0x0;
-
-      _rawCompressedBuffer[comp_index] = current_color;
-      index += 3;
-
-      p = (unsigned char*)&next_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index + 1];
-      *p++ = _rawColorBuffer[index + 2];
-      *p = 0x0;
-
-      // Compute Run
-      while (((current_color & compress_mask) == (next_color & compress_mask)) &&
-        (index < 3 * numPixels) && (count < 255))
-      {
-        index += 3;
-        count++;
-        if (index < 3 * numPixels)
-        {
-          p = (unsigned char*)&next_color;
-          *p++ = _rawColorBuffer[index];
-          *p++ = _rawColorBuffer[index + 1];
-          *p++ = _rawColorBuffer[index + 2];
-          *p = 0x0;
-        }
-      }
-
-      // Record Run length
-      reinterpret_cast<unsigned char*>(_rawCompressedBuffer)[comp_index * 4 + 3] =
-        static_cast<unsigned char>(count);
-      comp_index++;
-
-      count = 0;
-    }
+    // the 4th byte is not part of RGB colors.
+    reinterpret_cast<unsigned char*>(&compress_mask)[3] = 0;
+    comp_index = vtkSquirtEncode(vtkSquirtRGBEncoder(_rawColorBuffer, compress_mask), numPixels,
+      _rawCompressedBuffer, scratch);
   }
 
   // Back to vtk arrays :)
@@ -209,50 +443,26 @@ int vtkSquirtCompressor::DecompressRGBA()
   vtkUnsignedCharArray* out = this->GetOutput();
   assert(out->GetNumberOfComponents() == 4);
 
-  int count = 0;
-  int index = 0;
-  unsigned int current_color;
-  unsigned int* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
-
   // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
+  const vtkIdType CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
 
   // Access raw arrays directly
-  _rawColorBuffer = (unsigned int*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
+  vtkTypeUInt32* _rawColorBuffer = reinterpret_cast<vtkTypeUInt32*>(out->GetPointer(0));
+  const vtkTypeUInt32* _rawCompressedBuffer =
+    reinterpret_cast<const vtkTypeUInt32*>(in->GetPointer(0));
 
   // Go through compress buffer and extract RLE format into color buffer
-  for (int i = 0; i < CompSize; i++)
+  if (!vtkSquirtDecode(_rawCompressedBuffer, CompSize, out->GetNumberOfTuples(),
+        vtkSquirtRGBAEncoder::GetRunLength, [_rawColorBuffer](vtkTypeUInt32 word, vtkIdType index) {
+          const vtkIdType count = vtkSquirtRGBAEncoder::GetRunLength(word);
+          // opacity is stored in the upper 4 bits.
+          vtkRunByte(word) &= 0xF0;
+          std::fill_n(_rawColorBuffer + index, count, word);
+          return index + count;
+        }))
   {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
-
-    // Get run length count;
-    count = *((unsigned char*)&current_color + 3);
-
-    if (count > 0x0f)
-    {
-      // we have some opacity.
-      unsigned char opacity = (count & 0xF0);
-      opacity = opacity >> 4;
-      opacity *= 16;
-      *((unsigned char*)&current_color + 3) = opacity;
-    }
-    else
-    {
-      *((unsigned char*)&current_color + 3) = 0;
-    }
-    count &= 0x0F;
-
-    // Set color
-    _rawColorBuffer[index++] = current_color;
-
-    // Blast color into color buffer
-    for (int j = 0; j < count; j++)
-    {
-      _rawColorBuffer[index++] = current_color;
-    }
+    vtkErrorMacro("Compressed data does not match the output size.");
+    return VTK_ERROR;
   }
   return VTK_OK;
 }
@@ -264,39 +474,29 @@ int vtkSquirtCompressor::DecompressRGB()
   vtkUnsignedCharArray* out = this->GetOutput();
   assert(out->GetNumberOfComponents() == 3);
 
-  int count = 0;
-  unsigned int current_color;
-  unsigned char* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
-
   // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
+  const vtkIdType CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
 
   // Access raw arrays directly
-  _rawColorBuffer = (unsigned char*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
+  unsigned char* _rawColorBuffer = out->GetPointer(0);
+  const vtkTypeUInt32* _rawCompressedBuffer =
+    reinterpret_cast<const vtkTypeUInt32*>(in->GetPointer(0));
 
   // Go through compress buffer and extract RLE format into color buffer
-  for (int i = 0; i < CompSize; i++)
+  if (!vtkSquirtDecode(_rawCompressedBuffer, CompSize, out->GetNumberOfTuples(),
+        vtkSquirtRGBEncoder::GetRunLength, [_rawColorBuffer](vtkTypeUInt32 word, vtkIdType index) {
+          const vtkIdType count = vtkSquirtRGBEncoder::GetRunLength(word);
+          const unsigned char* color = reinterpret_cast<const unsigned char*>(&word);
+          unsigned char* pixel = _rawColorBuffer + 3 * index;
+          for (vtkIdType cc = 0; cc < count; ++cc, pixel += 3)
+          {
+            std::copy(color, color + 3, pixel);
+          }
+          return index + count;
+        }))
   {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
-
-    // Get run length count;
-    count = *((unsigned char*)&current_color + 3);
-
-    *((unsigned char*)&current_color + 3) = 0xff;
-
-    unsigned char current_color_rgb[3];
-    std::copy(reinterpret_cast<const unsigned char*>(&current_color),
-      reinterpret_cast<const unsigned char*>(&current_color) + 3, current_color_rgb);
-    std::copy(current_color_rgb, current_color_rgb + 3, _rawColorBuffer);
-    _rawColorBuffer += 3;
-    for (int j = 0; j < count; j++)
-    {
-      std::copy(current_color_rgb, current_color_rgb + 3, _rawColorBuffer);
-      _rawColorBuffer += 3;
-    }
+    vtkErrorMacro("Compressed data does not match the output size.");
+    return VTK_ERROR;
   }
   return VTK_OK;
 }
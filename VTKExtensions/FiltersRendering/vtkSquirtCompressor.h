@@ -44,6 +44,10 @@
  * The compressor uses a modified SQUIRT implementation where encode 4-bit
  * opacity information as well. This is needed to improve background color
  * blending for translucent renderings in ParaView.
+ *
+ * Large images are encoded and decoded concurrently using vtkSMPTools, and
+ * the run scan uses SSE2/AVX2 when available. The compressed stream is
+ * identical to the one produced by a serial encoder.
  * @par Thanks:
  * Thanks to Sandia National Laboratories for this compression technique
 */
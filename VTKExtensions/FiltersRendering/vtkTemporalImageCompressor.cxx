@@ -0,0 +1,526 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTemporalImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTemporalImageCompressor.h"
+
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include "vtk_lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+const vtkTypeUInt32 vtkTemporalImageMagic = 0x43545650; // "PVTC"
+
+struct vtkFrameHeader
+{
+  vtkTypeUInt32 Magic;
+  vtkTypeUInt32 FrameId;
+  vtkTypeUInt32 Width;
+  vtkTypeUInt32 Height;
+  vtkTypeUInt32 TileSize;
+  vtkTypeUInt32 ResidualSize;
+  vtkTypeUInt8 KeyFrame;
+  vtkTypeUInt8 NumberOfComponents;
+  vtkTypeUInt8 Padding[2];
+};
+
+// Describes how an image is split into tiles. For images without a known
+// 2D layout (height of 1) tiles are TileSize^2 pixels long strips.
+class vtkTileLayout
+{
+public:
+  vtkTileLayout(int width, int height, int tileSize, int numComps)
+    : Width(width)
+    , NumberOfComponents(numComps)
+  {
+    this->TileWidth = height == 1 ? tileSize * tileSize : tileSize;
+    this->TileHeight = tileSize;
+    this->TilesX = (width + this->TileWidth - 1) / this->TileWidth;
+    this->TilesY = (height + this->TileHeight - 1) / this->TileHeight;
+    this->Height = height;
+  }
+
+  vtkIdType GetNumberOfTiles() const { return static_cast<vtkIdType>(this->TilesX) * this->TilesY; }
+
+  // Returns the first pixel, the number of columns and the number of rows of
+  // the tile.
+  void GetTile(vtkIdType tile, vtkIdType& first, int& columns, int& rows) const
+  {
+    const int x0 = static_cast<int>(tile % this->TilesX) * this->TileWidth;
+    const int y0 = static_cast<int>(tile / this->TilesX) * this->TileHeight;
+    columns = std::min(this->TileWidth, this->Width - x0);
+    rows = std::min(this->TileHeight, this->Height - y0);
+    first = static_cast<vtkIdType>(y0) * this->Width + x0;
+  }
+
+  vtkIdType GetTileSize(vtkIdType tile) const
+  {
+    vtkIdType first;
+    int columns, rows;
+    this->GetTile(tile, first, columns, rows);
+    return static_cast<vtkIdType>(columns) * rows * this->NumberOfComponents;
+  }
+
+  // Calls `op(dst, src, rowBytes)` for each row of the tile, `src` pointing
+  // into `image` and `dst` into the packed tile at `packed` (if not null).
+  template <typename Op>
+  void ForEachRow(vtkIdType tile, unsigned char* image, char* packed, Op&& op) const
+  {
+    vtkIdType first;
+    int columns, rows;
+    this->GetTile(tile, first, columns, rows);
+    const vtkIdType rowBytes = static_cast<vtkIdType>(columns) * this->NumberOfComponents;
+    const vtkIdType stride = static_cast<vtkIdType>(this->Width) * this->NumberOfComponents;
+    unsigned char* src = image + first * this->NumberOfComponents;
+    for (int row = 0; row < rows; ++row, src += stride)
+    {
+      op(packed, src, rowBytes);
+      if (packed)
+      {
+        packed += rowBytes;
+      }
+    }
+  }
+
+private:
+  int Width;
+  int Height;
+  int NumberOfComponents;
+  int TileWidth;
+  int TileHeight;
+  int TilesX;
+  int TilesY;
+};
+
+// Computes the offset of each dirty tile in the packed residual and returns
+// the total size.
+vtkIdType vtkComputeTileOffsets(const vtkTileLayout& layout,
+  const std::vector<unsigned char>& dirty, std::vector<vtkIdType>& offsets)
+{
+  const vtkIdType numTiles = layout.GetNumberOfTiles();
+  offsets.resize(numTiles);
+  vtkIdType total = 0;
+  for (vtkIdType tile = 0; tile < numTiles; ++tile)
+  {
+    offsets[tile] = total;
+    total += dirty[tile] ? layout.GetTileSize(tile) : 0;
+  }
+  return total;
+}
+}
+
+vtkStandardNewMacro(vtkTemporalImageCompressor);
+//----------------------------------------------------------------------------
+vtkTemporalImageCompressor::vtkTemporalImageCompressor()
+  : Quality(3)
+  , KeyFrameInterval(100)
+  , TileSize(32)
+  , ImageWidth(0)
+  , ImageHeight(0)
+  , ReferenceWidth(0)
+  , ReferenceHeight(0)
+  , FrameId(0)
+  , FramesSinceKeyFrame(0)
+  , LastFrameWasKeyFrame(false)
+  , NeedsKeyFrame(false)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkTemporalImageCompressor::~vtkTemporalImageCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalImageCompressor::Reset()
+{
+  this->Reference->Initialize();
+  this->ReferenceWidth = 0;
+  this->ReferenceHeight = 0;
+  this->FramesSinceKeyFrame = 0;
+  this->Residual.clear();
+  this->Residual.shrink_to_fit();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalImageCompressor::SetImageResolution(int width, int height)
+{
+  this->ImageWidth = width;
+  this->ImageHeight = height;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalImageCompressor::ComputeLayout(
+  vtkIdType numberOfPixels, int& width, int& height) const
+{
+  if (this->ImageWidth > 0 && this->ImageHeight > 0 &&
+    static_cast<vtkIdType>(this->ImageWidth) * this->ImageHeight == numberOfPixels)
+  {
+    width = this->ImageWidth;
+    height = this->ImageHeight;
+  }
+  else
+  {
+    width = static_cast<int>(numberOfPixels);
+    height = 1;
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot compress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  const int numComps = this->Input->GetNumberOfComponents();
+  const vtkIdType numPixels = this->Input->GetNumberOfTuples();
+  if (numComps <= 0 || numComps > 255 || numPixels <= 0 || numPixels > VTK_INT_MAX)
+  {
+    vtkWarningMacro("Cannot compress, unsupported input.");
+    return VTK_ERROR;
+  }
+
+  int width, height;
+  this->ComputeLayout(numPixels, width, height);
+
+  const bool keyFrame = this->Reference->GetNumberOfComponents() != numComps ||
+    this->Reference->GetNumberOfTuples() != numPixels || this->ReferenceWidth != width ||
+    this->ReferenceHeight != height || this->FramesSinceKeyFrame + 1 >= this->KeyFrameInterval;
+  if (keyFrame)
+  {
+    // key frames are encoded against a black frame.
+    this->Reference->SetNumberOfComponents(numComps);
+    this->Reference->SetNumberOfTuples(numPixels);
+    this->Reference->FillValue(0);
+    this->ReferenceWidth = width;
+    this->ReferenceHeight = height;
+    this->FramesSinceKeyFrame = 0;
+  }
+  else
+  {
+    ++this->FramesSinceKeyFrame;
+  }
+  this->LastFrameWasKeyFrame = keyFrame;
+
+  unsigned char compress_masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
+    { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
+    { 0xE0, 0xF0, 0xE0, 0xE0 } };
+  const int compress_level = this->LossLessMode ? 0 : this->Quality;
+  const bool useMask = compress_level > 0 && numComps == 4;
+  vtkTypeUInt32 compress_mask;
+  memcpy(&compress_mask, &compress_masks[compress_level], 4);
+
+  const vtkTileLayout layout(width, height, this->TileSize, numComps);
+  const vtkIdType numTiles = layout.GetNumberOfTiles();
+  unsigned char* input = this->Input->GetPointer(0);
+  unsigned char* reference = this->Reference->GetPointer(0);
+
+  // Apply the color mask and find the tiles that changed since the previous
+  // frame.
+  std::vector<unsigned char> dirty(numTiles, keyFrame ? 1 : 0);
+  vtkSMPTools::For(0, numTiles, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<unsigned char> row;
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      layout.ForEachRow(tile, input, nullptr, [&](char*, unsigned char* src, vtkIdType rowBytes) {
+        if (dirty[tile])
+        {
+          return;
+        }
+        const unsigned char* values = src;
+        if (useMask)
+        {
+          row.resize(rowBytes);
+          vtkTypeUInt32 pixel;
+          for (vtkIdType cc = 0; cc < rowBytes; cc += 4)
+          {
+            memcpy(&pixel, src + cc, 4);
+            pixel &= compress_mask;
+            memcpy(&row[cc], &pixel, 4);
+          }
+          values = row.data();
+        }
+        if (memcmp(values, reference + (src - input), rowBytes) != 0)
+        {
+          dirty[tile] = 1;
+        }
+      });
+    }
+  });
+
+  const vtkIdType residualSize = vtkComputeTileOffsets(layout, dirty, this->TileOffsets);
+  this->Residual.resize(static_cast<size_t>(residualSize));
+
+  // XOR the changed tiles against the previous frame and update the
+  // reference.
+  char* residual = this->Residual.data();
+  vtkSMPTools::For(0, numTiles, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      if (!dirty[tile])
+      {
+        continue;
+      }
+      layout.ForEachRow(tile, input, residual + this->TileOffsets[tile],
+        [&](char* dst, unsigned char* src, vtkIdType rowBytes) {
+          unsigned char* ref = reference + (src - input);
+          if (useMask)
+          {
+            vtkTypeUInt32 pixel, previous;
+            for (vtkIdType cc = 0; cc < rowBytes; cc += 4)
+            {
+              memcpy(&pixel, src + cc, 4);
+              memcpy(&previous, ref + cc, 4);
+              pixel &= compress_mask;
+              previous ^= pixel;
+              memcpy(dst + cc, &previous, 4);
+              memcpy(ref + cc, &pixel, 4);
+            }
+          }
+          else
+          {
+            for (vtkIdType cc = 0; cc < rowBytes; ++cc)
+            {
+              dst[cc] = static_cast<char>(src[cc] ^ ref[cc]);
+            }
+            memcpy(ref, src, rowBytes);
+          }
+        });
+    }
+  });
+
+  vtkFrameHeader header;
+  memset(&header, 0, sizeof(header));
+  header.Magic = vtkTemporalImageMagic;
+  header.FrameId = ++this->FrameId;
+  header.Width = static_cast<vtkTypeUInt32>(width);
+  header.Height = static_cast<vtkTypeUInt32>(height);
+  header.TileSize = static_cast<vtkTypeUInt32>(this->TileSize);
+  header.ResidualSize = static_cast<vtkTypeUInt32>(residualSize);
+  header.KeyFrame = keyFrame ? 1 : 0;
+  header.NumberOfComponents = static_cast<vtkTypeUInt8>(numComps);
+
+  // dirty tiles are sent as a bit mask, except for key frames.
+  const vtkIdType maskSize = keyFrame ? 0 : (numTiles + 7) / 8;
+  const int maxPayload = residualSize > 0 ? LZ4_compressBound(static_cast<int>(residualSize)) : 0;
+  const vtkIdType maxSize = static_cast<vtkIdType>(sizeof(header)) + maskSize + maxPayload;
+  char* out = reinterpret_cast<char*>(this->Output->WritePointer(0, maxSize));
+  memcpy(out, &header, sizeof(header));
+  char* mask = out + sizeof(header);
+  std::fill(mask, mask + maskSize, 0);
+  for (vtkIdType tile = 0; maskSize > 0 && tile < numTiles; ++tile)
+  {
+    if (dirty[tile])
+    {
+      mask[tile / 8] |= static_cast<char>(1 << (tile % 8));
+    }
+  }
+
+  int payloadSize = 0;
+  if (residualSize > 0)
+  {
+    payloadSize = LZ4_compress_default(
+      residual, mask + maskSize, static_cast<int>(residualSize), maxPayload);
+    if (payloadSize <= 0)
+    {
+      // the reference is out of sync with the receiver, start over.
+      this->Reset();
+      return VTK_ERROR;
+    }
+  }
+  this->Output->SetNumberOfTuples(static_cast<vtkIdType>(sizeof(header)) + maskSize + payloadSize);
+  return VTK_OK;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot decompress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  // cleared once this frame is decompressed.
+  this->NeedsKeyFrame = true;
+
+  const vtkIdType inputSize = this->Input->GetNumberOfTuples();
+  const char* in = reinterpret_cast<const char*>(this->Input->GetPointer(0));
+  vtkFrameHeader header;
+  if (inputSize < static_cast<vtkIdType>(sizeof(header)))
+  {
+    vtkErrorMacro("Invalid compressed frame.");
+    return VTK_ERROR;
+  }
+  memcpy(&header, in, sizeof(header));
+  if (header.Magic != vtkTemporalImageMagic || header.NumberOfComponents == 0 ||
+    header.Width == 0 || header.Height == 0 || header.TileSize == 0)
+  {
+    vtkErrorMacro("Invalid compressed frame.");
+    return VTK_ERROR;
+  }
+
+  const int numComps = header.NumberOfComponents;
+  const int width = static_cast<int>(header.Width);
+  const int height = static_cast<int>(header.Height);
+  const vtkIdType numPixels = static_cast<vtkIdType>(width) * height;
+  if (header.KeyFrame)
+  {
+    this->Reference->SetNumberOfComponents(numComps);
+    this->Reference->SetNumberOfTuples(numPixels);
+    this->Reference->FillValue(0);
+    this->ReferenceWidth = width;
+    this->ReferenceHeight = height;
+  }
+  else if (header.FrameId != this->FrameId + 1 || this->ReferenceWidth != width ||
+    this->ReferenceHeight != height || this->Reference->GetNumberOfComponents() != numComps)
+  {
+    vtkErrorMacro("Frame " << header.FrameId << " does not follow the last decompressed frame ("
+                           << this->FrameId << "). Waiting for the next key frame.");
+    return VTK_ERROR;
+  }
+  this->LastFrameWasKeyFrame = header.KeyFrame != 0;
+
+  const vtkTileLayout layout(width, height, static_cast<int>(header.TileSize), numComps);
+  const vtkIdType numTiles = layout.GetNumberOfTiles();
+  const vtkIdType maskSize = header.KeyFrame ? 0 : (numTiles + 7) / 8;
+  if (inputSize < static_cast<vtkIdType>(sizeof(header)) + maskSize)
+  {
+    vtkErrorMacro("Invalid compressed frame.");
+    return VTK_ERROR;
+  }
+  const char* mask = in + sizeof(header);
+  std::vector<unsigned char> dirty(numTiles, 1);
+  for (vtkIdType tile = 0; maskSize > 0 && tile < numTiles; ++tile)
+  {
+    dirty[tile] = (mask[tile / 8] >> (tile % 8)) & 1;
+  }
+  const vtkIdType residualSize = vtkComputeTileOffsets(layout, dirty, this->TileOffsets);
+  if (residualSize != static_cast<vtkIdType>(header.ResidualSize))
+  {
+    vtkErrorMacro("Invalid compressed frame.");
+    return VTK_ERROR;
+  }
+
+  this->Residual.resize(static_cast<size_t>(residualSize));
+  if (residualSize > 0)
+  {
+    const int payloadSize =
+      static_cast<int>(inputSize - static_cast<vtkIdType>(sizeof(header)) - maskSize);
+    const int decompressedSize = LZ4_decompress_safe(
+      mask + maskSize, this->Residual.data(), payloadSize, static_cast<int>(residualSize));
+    if (decompressedSize != static_cast<int>(residualSize))
+    {
+      vtkErrorMacro("Failed to decompress frame.");
+      return VTK_ERROR;
+    }
+  }
+
+  unsigned char* reference = this->Reference->GetPointer(0);
+  char* residual = this->Residual.data();
+  vtkSMPTools::For(0, numTiles, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      if (dirty[tile])
+      {
+        layout.ForEachRow(tile, reference, residual + this->TileOffsets[tile],
+          [](char* src, unsigned char* ref, vtkIdType rowBytes) {
+            for (vtkIdType cc = 0; cc < rowBytes; ++cc)
+            {
+              ref[cc] ^= static_cast<unsigned char>(src[cc]);
+            }
+          });
+      }
+    }
+  });
+  this->FrameId = header.FrameId;
+  this->NeedsKeyFrame = false;
+
+  if (this->Output->GetNumberOfComponents() != numComps ||
+    this->Output->GetNumberOfTuples() != numPixels)
+  {
+    this->Output->SetNumberOfComponents(numComps);
+    this->Output->SetNumberOfTuples(numPixels);
+  }
+  memcpy(this->Output->GetPointer(0), reference, static_cast<size_t>(numPixels) * numComps);
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalImageCompressor::SaveConfiguration(vtkMultiProcessStream* stream)
+{
+  this->Superclass::SaveConfiguration(stream);
+  *stream << this->Quality << this->KeyFrameInterval;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTemporalImageCompressor::RestoreConfiguration(vtkMultiProcessStream* stream)
+{
+  if (this->Superclass::RestoreConfiguration(stream))
+  {
+    int quality, interval;
+    *stream >> quality >> interval;
+    this->SetQuality(quality);
+    this->SetKeyFrameInterval(interval);
+    this->Reset();
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkTemporalImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss << this->Superclass::SaveConfiguration() << " " << this->Quality << " "
+      << this->KeyFrameInterval;
+  this->SetConfiguration(oss.str().c_str());
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkTemporalImageCompressor::RestoreConfiguration(const char* stream)
+{
+  stream = this->Superclass::RestoreConfiguration(stream);
+  if (stream)
+  {
+    std::istringstream iss(stream);
+    int quality, interval;
+    iss >> quality >> interval;
+    this->SetQuality(quality);
+    this->SetKeyFrameInterval(interval);
+    this->Reset();
+    return stream + iss.tellg();
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Quality: " << this->Quality << endl;
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << endl;
+  os << indent << "TileSize: " << this->TileSize << endl;
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTemporalImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkTemporalImageCompressor
+ * @brief   Image compressor/decompressor that encodes differences between
+ * consecutive frames.
+ *
+ * vtkTemporalImageCompressor exploits the similarity of consecutive frames
+ * during interaction. The image is split into square tiles; only tiles that
+ * changed since the previous frame are sent, as the XOR of the new and the
+ * previous pixels, compressed with LZ4. Unchanged pixels in a changed tile
+ * XOR to zero and compress very well.
+ *
+ * Every KeyFrameInterval frames, and whenever the image size changes, a key
+ * frame that does not depend on the previous frame is sent.
+ *
+ * Both the compressing and the decompressing instance keep a copy of the
+ * last frame, so an instance must be used for either compression or
+ * decompression, and all frames must be decompressed in the order they were
+ * compressed. Key frames are always decompressed; a difference frame that
+ * does not follow the last decompressed frame is rejected. The decompressing
+ * side then reports GetNeedsKeyFrame() until a key frame arrives; the caller
+ * is expected to forward this to the compressing side, which calls Reset()
+ * to send a key frame right away.
+ *
+ * Quality has the same meaning as in vtkLZ4Compressor: values > 0 mask the
+ * low bits of each color for better compression at the cost of image
+ * quality.
+ *
+ * The configuration stream is
+ * `vtkTemporalImageCompressor <LossLessMode> <Quality> <KeyFrameInterval>`.
+*/
+
+#ifndef vtkTemporalImageCompressor_h
+#define vtkTemporalImageCompressor_h
+
+#include "vtkImageCompressor.h"
+#include "vtkNew.h"                                   // needed for vtkNew
+#include "vtkPVVTKExtensionsFiltersRenderingModule.h" // needed for exports
+
+#include <vector> // needed for std::vector
+
+class vtkMultiProcessStream;
+
+class VTKPVVTKEXTENSIONSFILTERSRENDERING_EXPORT vtkTemporalImageCompressor
+  : public vtkImageCompressor
+{
+public:
+  static vtkTemporalImageCompressor* New();
+  vtkTypeMacro(vtkTemporalImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set the quality measure. The value can be between 0 and 5. 0 means preserve
+   * input image quality while 5 means improve compression at the cost of image
+   * quality.
+   */
+  vtkSetClampMacro(Quality, int, 0, 5);
+  vtkGetMacro(Quality, int);
+  //@}
+
+  //@{
+  /**
+   * Number of frames after which a key frame is sent. Default is 100.
+   */
+  vtkSetClampMacro(KeyFrameInterval, int, 1, VTK_INT_MAX);
+  vtkGetMacro(KeyFrameInterval, int);
+  //@}
+
+  //@{
+  /**
+   * Size, in pixels, of the square tiles used to detect changed regions.
+   * Default is 32.
+   */
+  vtkSetClampMacro(TileSize, int, 4, 1024);
+  vtkGetMacro(TileSize, int);
+  //@}
+
+  /**
+   * Forget the previous frame. The next compressed frame is a key frame.
+   */
+  void Reset();
+
+  /**
+   * Returns true if the last compressed or decompressed frame was a key frame.
+   */
+  bool GetLastFrameWasKeyFrame() const { return this->LastFrameWasKeyFrame; }
+
+  /**
+   * Returns true if the last frame could not be decompressed. Difference
+   * frames are rejected until the next key frame.
+   */
+  bool GetNeedsKeyFrame() const { return this->NeedsKeyFrame; }
+
+  /**
+   * Communicates the next expected image resolution, used to lay out the tiles.
+   */
+  void SetImageResolution(int width, int height) override;
+
+  //@{
+  /**
+   * Compress/Decompress data array on the objects input with results
+   * in the objects output. See also Set/GetInput/Output.
+   */
+  int Compress() override;
+  int Decompress() override;
+  //@}
+
+  //@{
+  /**
+   * Serialize/Restore compressor configuration (but not the data) into the stream.
+   */
+  void SaveConfiguration(vtkMultiProcessStream* stream) override;
+  bool RestoreConfiguration(vtkMultiProcessStream* stream) override;
+  const char* SaveConfiguration() override;
+  const char* RestoreConfiguration(const char* stream) override;
+  //@}
+
+protected:
+  vtkTemporalImageCompressor();
+  ~vtkTemporalImageCompressor() override;
+
+  int Quality;
+  int KeyFrameInterval;
+  int TileSize;
+
+private:
+  vtkTemporalImageCompressor(const vtkTemporalImageCompressor&) = delete;
+  void operator=(const vtkTemporalImageCompressor&) = delete;
+
+  // Computes the tile layout for an image of `numberOfPixels` pixels.
+  void ComputeLayout(vtkIdType numberOfPixels, int& width, int& height) const;
+
+  int ImageWidth;
+  int ImageHeight;
+
+  // Previous frame, as seen by the decompressor.
+  vtkNew<vtkUnsignedCharArray> Reference;
+  int ReferenceWidth;
+  int ReferenceHeight;
+  unsigned int FrameId;
+  int FramesSinceKeyFrame;
+  bool LastFrameWasKeyFrame;
+  bool NeedsKeyFrame;
+
+  // Scratch buffers for the residuals.
+  std::vector<char> Residual;
+  std::vector<vtkIdType> TileOffsets;
+};
+
+#endif
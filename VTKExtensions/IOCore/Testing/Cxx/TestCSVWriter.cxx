@@ -14,13 +14,19 @@
 #include <vtkCSVWriter.h>
 #include <vtkDelimitedTextReader.h>
 #include <vtkDoubleArray.h>
+#include <vtkErrorCode.h>
 #include <vtkIntArray.h>
 #include <vtkLogger.h>
 #include <vtkMPIController.h>
 #include <vtkNew.h>
+#include <vtkStringArray.h>
 #include <vtkTable.h>
 #include <vtkTesting.h>
+#include <vtkTypeInt64Array.h>
 
+#include <chrono>
+#include <cmath>
+#include <sstream>
 #include <string>
 
 namespace
@@ -111,6 +117,79 @@ bool ReadAndVerifyCSV(const std::string& fname, int rank, int numRanks)
   return true;
 }
 
+// benchmarks writing a table with mixed integer, floating point and string
+// columns, with the rows gathered on the root or written as shards.
+bool WriteMixedCSV(
+  const std::string& fname, int rank, int numRanks, vtkIdType numRows, bool shards)
+{
+  vtkNew<vtkTable> table;
+  vtkNew<vtkTypeInt64Array> ids;
+  ids->SetName("Id");
+  ids->SetNumberOfTuples(numRows);
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Value");
+  values->SetNumberOfComponents(3);
+  values->SetNumberOfTuples(numRows);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Label");
+  labels->SetNumberOfTuples(numRows);
+  for (vtkIdType cc = 0; cc < numRows; ++cc)
+  {
+    const vtkIdType row = cc + rank * numRows;
+    ids->SetValue(cc, -row);
+    const double tuple[3] = { row * 0.5, row * 0.25, -row * 0.125 };
+    values->SetTypedTuple(cc, tuple);
+    labels->SetValue(cc, "label-" + std::to_string(row % 7));
+  }
+  table->AddColumn(ids);
+  table->AddColumn(values);
+  table->AddColumn(labels);
+
+  vtkNew<vtkCSVWriter> writer;
+  writer->SetFileName(fname.c_str());
+  writer->SetPrecision(10);
+  writer->SetWriteShards(shards);
+  writer->SetInputDataObject(table);
+  const auto start = std::chrono::steady_clock::now();
+  writer->Write();
+  const double seconds =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (rank == 0)
+  {
+    vtkLogF(INFO, "wrote %lld rows (shards: %d) in %g s", static_cast<long long>(numRows) * numRanks,
+      shards ? 1 : 0, seconds);
+  }
+  return writer->GetErrorCode() == vtkErrorCode::NoError;
+}
+
+bool ReadAndVerifyMixedCSV(const std::string& fname, int rank, int numRanks, vtkIdType numRows)
+{
+  if (rank != 0)
+  {
+    return true;
+  }
+
+  vtkNew<vtkDelimitedTextReader> reader;
+  reader->SetFileName(fname.c_str());
+  reader->SetHaveHeaders(true);
+  reader->SetDetectNumericColumns(true);
+  reader->Update();
+
+  auto table = reader->GetOutput();
+  VERITFY_EQ(table->GetNumberOfRows(), numRows * numRanks, "incorrect row count");
+  VERITFY_EQ(table->GetNumberOfColumns(), 5, "incorrect column count");
+  for (vtkIdType row = 0; row < numRows * numRanks; row += 997)
+  {
+    VERITFY_EQ(table->GetValueByName(row, "Id").ToTypeInt64(), -row,
+      std::string("incorrect Id at row ") + std::to_string(row));
+    VERITFY_EQ(true, std::abs(table->GetValueByName(row, "Value:2").ToDouble() + row * 0.125) < 1e-6,
+      std::string("incorrect Value:2 at row ") + std::to_string(row));
+    VERITFY_EQ(table->GetValueByName(row, "Label").ToString(), "label-" + std::to_string(row % 7),
+      std::string("incorrect Label at row ") + std::to_string(row));
+  }
+  return true;
+}
+
 } // end of namespace
 
 int TestCSVWriter(int argc, char* argv[])
@@ -138,6 +217,18 @@ int TestCSVWriter(int argc, char* argv[])
     ? 1
     : 0;
 
+  const vtkIdType numRows = 100000;
+  for (const bool shards : { false, true })
+  {
+    // writing is collective, so it must happen on all ranks.
+    const std::string fname = tname + "/TestCSVWriterMixed.csv";
+    const bool written = WriteMixedCSV(fname, myRank, numRanks, numRows, shards);
+    if (!written || !ReadAndVerifyMixedCSV(fname, myRank, numRanks, numRows))
+    {
+      success = 0;
+    }
+  }
+
   int all_success;
   contr->AllReduce(&success, &all_success, 1, vtkCommunicator::LOGICAL_AND_OP);
 
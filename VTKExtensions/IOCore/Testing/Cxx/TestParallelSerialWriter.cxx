@@ -0,0 +1,262 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestParallelSerialWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkParallelSerialWriter aggregates the data of all ranks on one
+// rank per node (NumberOfIORanks = -1) or on 2 ranks, and that the index files
+// written for more than one IO rank (.pvd for VTK XML files, .pvtk for legacy
+// VTK files) reference all the partitions. The internal writers are driven
+// through the global interpreter, as in ParaView, using hand-written command
+// functions in place of the client-server wrapping.
+
+#include "vtkAppendPolyData.h"
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkClientServerStream.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkLogger.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPDataSetReader.h"
+#include "vtkPVDReader.h"
+#include "vtkParallelSerialWriter.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataWriter.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTesting.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vtksys/SystemTools.hxx>
+
+namespace
+{
+int WriterCommand(vtkClientServerInterpreter*, vtkObjectBase* ob, const char* method,
+  const vtkClientServerStream& msg, vtkClientServerStream& resultStream, void*)
+{
+  vtkXMLPolyDataWriter* xmlWriter = vtkXMLPolyDataWriter::SafeDownCast(ob);
+  vtkPolyDataWriter* legacyWriter = vtkPolyDataWriter::SafeDownCast(ob);
+  if (!strcmp("SetFileName", method) && msg.GetNumberOfArguments(0) == 3)
+  {
+    char* temp0;
+    if (msg.GetArgument(0, 2, &temp0))
+    {
+      if (xmlWriter)
+      {
+        xmlWriter->SetFileName(temp0);
+      }
+      else
+      {
+        legacyWriter->SetFileName(temp0);
+      }
+      return 1;
+    }
+  }
+  if (!strcmp("Write", method) && msg.GetNumberOfArguments(0) == 2)
+  {
+    return xmlWriter ? xmlWriter->Write() : legacyWriter->Write();
+  }
+  resultStream.Reset();
+  resultStream << vtkClientServerStream::Error << "could not find requested method"
+               << vtkClientServerStream::End;
+  return 0;
+}
+
+// Sums the points and counts the non-empty datasets of `dobj`.
+void Count(vtkDataObject* dobj, vtkIdType& numberOfPoints, int& numberOfDataSets)
+{
+  if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(dobj))
+  {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      Count(iter->GetCurrentDataObject(), numberOfPoints, numberOfDataSets);
+    }
+  }
+  else if (vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj))
+  {
+    if (ds->GetNumberOfPoints() > 0)
+    {
+      numberOfPoints += ds->GetNumberOfPoints();
+      ++numberOfDataSets;
+    }
+  }
+}
+
+// Writes a sphere split across the ranks, returns the number of points of the
+// local piece in `localPoints`.
+bool Write(vtkMultiProcessController* contr, vtkAlgorithm* internalWriter,
+  const std::string& fname, int numberOfIORanks, vtkIdType& localPoints)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+
+  vtkNew<vtkAppendPolyData> append;
+  vtkNew<vtkParallelSerialWriter> writer;
+  writer->SetController(contr);
+  writer->SetWriter(internalWriter);
+  writer->SetFileNameMethod("SetFileName");
+  writer->SetPostGatherHelper(append);
+  writer->SetPiece(contr->GetLocalProcessId());
+  writer->SetNumberOfPieces(contr->GetNumberOfProcesses());
+  writer->SetNumberOfIORanks(numberOfIORanks);
+  writer->SetFileName(fname.c_str());
+  writer->SetInputConnection(sphere->GetOutputPort());
+  const bool status = writer->Write() != 0;
+  localPoints = sphere->GetOutput()->GetNumberOfPoints();
+  contr->Barrier();
+  return status;
+}
+
+bool Verify(vtkDataObject* dobj, vtkIdType expectedPoints, int expectedDataSets, const char* name)
+{
+  vtkIdType numberOfPoints = 0;
+  int numberOfDataSets = 0;
+  Count(dobj, numberOfPoints, numberOfDataSets);
+  if (numberOfPoints != expectedPoints ||
+    (expectedDataSets > 0 && numberOfDataSets != expectedDataSets))
+  {
+    vtkLogF(ERROR, "%s: read %lld points in %d datasets, expected %lld points in %d datasets.",
+      name, static_cast<long long>(numberOfPoints), numberOfDataSets,
+      static_cast<long long>(expectedPoints), expectedDataSets);
+    return false;
+  }
+  return true;
+}
+}
+
+int TestParallelSerialWriter(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> contr;
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+  const int myRank = contr->GetLocalProcessId();
+
+  vtkNew<vtkTesting> testing;
+  testing->AddArguments(argc, argv);
+  if (!testing->GetTempDirectory())
+  {
+    vtkLogF(ERROR, "no temp directory specified!");
+    vtkMultiProcessController::SetGlobalController(nullptr);
+    contr->Finalize();
+    return EXIT_FAILURE;
+  }
+  const std::string tname = testing->GetTempDirectory();
+
+  vtkClientServerInterpreter* interp =
+    vtkClientServerInterpreterInitializer::GetGlobalInterpreter();
+  interp->AddCommandFunction("vtkXMLPolyDataWriter", WriterCommand);
+  interp->AddCommandFunction("vtkPolyDataWriter", WriterCommand);
+
+  int success = 1;
+  vtkIdType localPoints = 0;
+  vtkIdType totalPoints = 0;
+
+  // one IO rank per node: a single file, unless the ranks run on several hosts.
+  {
+    const std::string fname = tname + "/TestParallelSerialWriterPerNode.vtp";
+    const std::string index = tname + "/TestParallelSerialWriterPerNode.pvd";
+    if (myRank == 0)
+    {
+      vtksys::SystemTools::RemoveFile(index);
+    }
+    contr->Barrier();
+    vtkNew<vtkXMLPolyDataWriter> xmlWriter;
+    if (!Write(contr, xmlWriter, fname, vtkParallelSerialWriter::ONE_IO_RANK_PER_NODE, localPoints))
+    {
+      success = 0;
+    }
+    contr->AllReduce(&localPoints, &totalPoints, 1, vtkCommunicator::SUM_OP);
+    if (myRank == 0)
+    {
+      if (vtksys::SystemTools::FileExists(index, true))
+      {
+        vtkNew<vtkPVDReader> reader;
+        reader->SetFileName(index.c_str());
+        reader->Update();
+        if (!Verify(reader->GetOutputDataObject(0), totalPoints, 0, "per node .pvd"))
+        {
+          success = 0;
+        }
+      }
+      else
+      {
+        vtkNew<vtkXMLPolyDataReader> reader;
+        reader->SetFileName(fname.c_str());
+        reader->Update();
+        if (!Verify(reader->GetOutput(), totalPoints, 1, "per node .vtp"))
+        {
+          success = 0;
+        }
+      }
+    }
+  }
+
+  // 2 IO ranks: 2 XML partitions indexed by a .pvd file.
+  {
+    const std::string fname = tname + "/TestParallelSerialWriterTwoRanks.vtp";
+    vtkNew<vtkXMLPolyDataWriter> xmlWriter;
+    if (!Write(contr, xmlWriter, fname, 2, localPoints))
+    {
+      success = 0;
+    }
+    contr->AllReduce(&localPoints, &totalPoints, 1, vtkCommunicator::SUM_OP);
+    const int expected = std::min(2, contr->GetNumberOfProcesses());
+    if (myRank == 0 && expected > 1)
+    {
+      vtkNew<vtkPVDReader> reader;
+      reader->SetFileName((tname + "/TestParallelSerialWriterTwoRanks.pvd").c_str());
+      reader->Update();
+      if (!Verify(reader->GetOutputDataObject(0), totalPoints, expected, "2 ranks .pvd"))
+      {
+        success = 0;
+      }
+    }
+  }
+
+  // 2 IO ranks with a legacy writer: partitions indexed by a .pvtk file.
+  {
+    const std::string fname = tname + "/TestParallelSerialWriterTwoRanks.vtk";
+    vtkNew<vtkPolyDataWriter> legacyWriter;
+    if (!Write(contr, legacyWriter, fname, 2, localPoints))
+    {
+      success = 0;
+    }
+    contr->AllReduce(&localPoints, &totalPoints, 1, vtkCommunicator::SUM_OP);
+    if (myRank == 0 && contr->GetNumberOfProcesses() > 1)
+    {
+      vtkNew<vtkPDataSetReader> reader;
+      reader->SetFileName((tname + "/TestParallelSerialWriterTwoRanks.pvtk").c_str());
+      reader->Update();
+      if (!Verify(reader->GetOutputDataObject(0), totalPoints, 1, "2 ranks .pvtk"))
+      {
+        success = 0;
+      }
+    }
+  }
+
+  int allSuccess = 0;
+  contr->AllReduce(&success, &allSuccess, 1, vtkCommunicator::LOGICAL_AND_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
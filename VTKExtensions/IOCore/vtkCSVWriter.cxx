@@ -23,19 +23,27 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVMergeTables.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
 
 #include "vtksys/FStream.hxx"
+#include "vtksys/SystemTools.hxx"
 
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <memory>
 #include <numeric>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 vtkStandardNewMacro(vtkCSVWriter);
@@ -54,6 +62,7 @@ vtkCSVWriter::vtkCSVWriter()
   this->FieldAssociation = 0;
   this->AddMetaData = false;
   this->AddTime = false;
+  this->WriteShards = false;
   this->Controller = nullptr;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -96,96 +105,165 @@ int vtkCSVWriter::ProcessRequest(
 
 namespace
 {
+// Options used to format the values, so that the formatting does not need to
+// go through the writer from the worker threads.
+struct vtkCSVFormat
+{
+  std::string FieldDelimiter;
+  std::string StringDelimiter;
+  int Precision;
+  bool UseScientificNotation;
+
+  vtkCSVFormat(vtkCSVWriter* writer)
+    : FieldDelimiter(writer->GetFieldDelimiter() ? writer->GetFieldDelimiter() : "")
+    , StringDelimiter(writer->GetUseStringDelimiter() && writer->GetStringDelimiter()
+          ? writer->GetStringDelimiter()
+          : "")
+    , Precision(writer->GetPrecision())
+    , UseScientificNotation(writer->GetUseScientificNotation())
+  {
+  }
+};
+
 //-----------------------------------------------------------------------------
-template <class iterT>
-void vtkCSVWriterGetDataString(
-  iterT* iter, vtkIdType tupleIndex, ostream& stream, vtkCSVWriter* writer, bool* first)
+// Integers are formatted by hand, which is much faster than going through a
+// stream. Characters are written as numbers.
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type vtkCSVAppendValue(
+  std::string& buffer, T value, const vtkCSVFormat&)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  using UnsignedT = typename std::make_unsigned<T>::type;
+  const bool negative = std::is_signed<T>::value && value < static_cast<T>(0);
+  UnsignedT magnitude =
+    negative ? static_cast<UnsignedT>(0) - static_cast<UnsignedT>(value) : static_cast<UnsignedT>(value);
+
+  char digits[32];
+  char* end = digits + sizeof(digits);
+  char* cur = end;
+  do
   {
-    if (!(*first))
-    {
-      stream << writer->GetFieldDelimiter();
-    }
-    *first = false;
-    if ((index + cc) < iter->GetNumberOfValues())
-    {
-      stream << iter->GetValue(index + cc);
-    }
+    *--cur = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (negative)
+  {
+    *--cur = '-';
   }
+  buffer.append(cur, end);
 }
 
 //-----------------------------------------------------------------------------
-template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<vtkStdString>* iter, vtkIdType tupleIndex,
-  ostream& stream, vtkCSVWriter* writer, bool* first)
+// Floating point values are formatted as a stream with the writer precision
+// and notation would, i.e. with "%.*e" or "%.*g".
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type vtkCSVAppendValue(
+  std::string& buffer, T value, const vtkCSVFormat& format)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  const char* spec = format.UseScientificNotation ? "%.*e" : "%.*g";
+  const double dvalue = static_cast<double>(value);
+  char local[64];
+  const int length = snprintf(local, sizeof(local), spec, format.Precision, dvalue);
+  if (length < 0)
   {
-    if (!(*first))
-    {
-      stream << writer->GetFieldDelimiter();
-    }
-    (*first) = false;
-    if ((index + cc) < iter->GetNumberOfValues())
-    {
-      stream << writer->GetString(iter->GetValue(index + cc));
-    }
+    return;
+  }
+  if (static_cast<size_t>(length) < sizeof(local))
+  {
+    buffer.append(local, static_cast<size_t>(length));
+  }
+  else
+  {
+    // large precision.
+    const size_t offset = buffer.size();
+    buffer.resize(offset + length + 1);
+    snprintf(&buffer[offset], length + 1, spec, format.Precision, dvalue);
+    buffer.resize(offset + length);
   }
 }
 
 //-----------------------------------------------------------------------------
-template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<char>* iter, vtkIdType tupleIndex,
-  ostream& stream, vtkCSVWriter* writer, bool* first)
+void vtkCSVAppendValue(std::string& buffer, const vtkStdString& value, const vtkCSVFormat& format)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  buffer += format.StringDelimiter;
+  buffer += value;
+  buffer += format.StringDelimiter;
+}
+
+//-----------------------------------------------------------------------------
+// Other types (vtkUnicodeString, vtkVariant) go through a stream.
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value>::type vtkCSVAppendValue(
+  std::string& buffer, const T& value, const vtkCSVFormat& format)
+{
+  std::ostringstream stream;
+  if (format.UseScientificNotation)
   {
-    if (!(*first))
-    {
-      stream << writer->GetFieldDelimiter();
-    }
-    (*first) = false;
-    if ((index + cc) < iter->GetNumberOfValues())
-    {
-      stream << static_cast<int>(iter->GetValue(index + cc));
-    }
+    stream << std::scientific;
   }
+  stream << std::setprecision(format.Precision) << value;
+  buffer += stream.str();
 }
 
 //-----------------------------------------------------------------------------
-template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<unsigned char>* iter, vtkIdType tupleIndex,
-  ostream& stream, vtkCSVWriter* writer, bool* first)
+// Formats the values of a column. A column may be shared by several threads,
+// each one formatting different rows.
+class vtkCSVColumn
+{
+public:
+  virtual ~vtkCSVColumn() = default;
+
+  // Appends the components of a tuple, each one preceded by the field
+  // delimiter unless it is the first value of the row.
+  virtual void Append(std::string& buffer, vtkIdType tupleIndex, bool& first) const = 0;
+};
+
+template <class iterT>
+class vtkCSVColumnImpl : public vtkCSVColumn
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  iterT* Iterator;
+  const vtkCSVFormat& Format;
+  const int NumberOfComponents;
+  const vtkIdType NumberOfValues;
+
+public:
+  vtkCSVColumnImpl(iterT* iter, const vtkCSVFormat& format)
+    : Iterator(iter)
+    , Format(format)
+    , NumberOfComponents(iter->GetNumberOfComponents())
+    , NumberOfValues(iter->GetNumberOfValues())
   {
-    if ((index + cc) < iter->GetNumberOfValues())
+  }
+
+  void Append(std::string& buffer, vtkIdType tupleIndex, bool& first) const override
+  {
+    const vtkIdType index = tupleIndex * this->NumberOfComponents;
+    for (int cc = 0; cc < this->NumberOfComponents; cc++)
     {
-      if (*first == false)
+      if (!first)
       {
-        stream << writer->GetFieldDelimiter();
+        buffer += this->Format.FieldDelimiter;
       }
-      *first = false;
-      stream << static_cast<int>(iter->GetValue(index + cc));
-    }
-    else
-    {
-      if (*first == false)
+      first = false;
+      if ((index + cc) < this->NumberOfValues)
       {
-        stream << writer->GetFieldDelimiter();
+        vtkCSVAppendValue(buffer, this->Iterator->GetValue(index + cc), this->Format);
       }
-      *first = false;
     }
   }
+};
+
+template <class iterT>
+vtkCSVColumn* vtkCSVNewColumn(iterT* iter, const vtkCSVFormat& format)
+{
+  return new vtkCSVColumnImpl<iterT>(iter, format);
+}
+
+//-----------------------------------------------------------------------------
+std::string vtkCSVShardFileName(const char* filename, int rank)
+{
+  std::ostringstream str;
+  str << filename << "." << rank << ".shard";
+  return str.str();
 }
 
 } // end anonymous namespace
@@ -196,6 +274,9 @@ class vtkCSVWriter::CSVFile
   std::vector<std::pair<std::string, int> > ColumnInfo;
   double Time = vtkMath::Nan();
 
+  // buffers in which the rows are formatted, in parallel.
+  std::vector<std::string> Chunks;
+
 public:
   CSVFile(double time)
     : Time(time)
@@ -209,7 +290,7 @@ public:
       return vtkErrorCode::NoFileNameError;
     }
 
-    this->Stream.open(filename, ios::out);
+    this->Stream.open(filename, ios::out | ios::binary);
     if (this->Stream.fail())
     {
       return vtkErrorCode::CannotOpenFileError;
@@ -217,6 +298,21 @@ public:
     return vtkErrorCode::NoError;
   }
 
+  int Close()
+  {
+    this->Stream.close();
+    return this->Stream.fail() ? vtkErrorCode::OutOfDiskSpaceError : vtkErrorCode::NoError;
+  }
+
+  const std::vector<std::pair<std::string, int> >& GetColumnInfo() const
+  {
+    return this->ColumnInfo;
+  }
+  void SetColumnInfo(const std::vector<std::pair<std::string, int> >& info)
+  {
+    this->ColumnInfo = info;
+  }
+
   void WriteHeader(vtkTable* table, vtkCSVWriter* self)
   {
     this->WriteHeader(table->GetRowData(), self);
@@ -258,14 +354,6 @@ public:
       }
     }
     this->Stream << "\n";
-
-    // push the floating point precision/notation type.
-    if (self->GetUseScientificNotation())
-    {
-      this->Stream << std::scientific;
-    }
-
-    this->Stream << std::setprecision(self->GetPrecision());
   }
 
   void WriteData(vtkTable* table, vtkCSVWriter* self)
@@ -275,7 +363,9 @@ public:
 
   void WriteData(vtkDataSetAttributes* dsa, vtkCSVWriter* self)
   {
+    const vtkCSVFormat format(self);
     std::vector<vtkSmartPointer<vtkArrayIterator> > columnsIters;
+    std::vector<std::unique_ptr<vtkCSVColumn> > columns;
     for (const auto& cinfo : this->ColumnInfo)
     {
       auto array = dsa->GetAbstractArray(cinfo.first.c_str());
@@ -286,31 +376,83 @@ public:
       vtkArrayIterator* iter = array->NewIterator();
       columnsIters.push_back(iter);
       iter->FastDelete();
-    }
 
-    const auto num_tuples = dsa->GetNumberOfTuples();
-    for (vtkIdType cc = 0; cc < num_tuples; ++cc)
-    {
-      bool first_column = true;
-      if (!vtkMath::IsNan(this->Time))
+      vtkCSVColumn* column = nullptr;
+      switch (iter->GetDataType())
       {
-        // add a time column.
-        this->Stream << this->Time;
-        first_column = false;
+        vtkArrayIteratorTemplateMacro(
+          column = vtkCSVNewColumn(static_cast<VTK_TT*>(iter), format));
       }
-
-      for (auto& iter : columnsIters)
+      if (column)
       {
-        switch (iter->GetDataType())
+        columns.emplace_back(column);
+      }
+    }
+
+    std::string time;
+    if (!vtkMath::IsNan(this->Time))
+    {
+      vtkCSVAppendValue(time, this->Time, format);
+    }
+
+    // rows are formatted in chunks, a batch of chunks being formatted in
+    // parallel before the chunks are written in order. This bounds the memory
+    // used to a batch.
+    const vtkIdType rows_per_chunk = 4096;
+    const vtkIdType chunks_per_batch = 64;
+    const vtkIdType num_tuples = dsa->GetNumberOfTuples();
+    const vtkIdType num_chunks = (num_tuples + rows_per_chunk - 1) / rows_per_chunk;
+    this->Chunks.resize(static_cast<size_t>(std::min(num_chunks, chunks_per_batch)));
+    for (vtkIdType batch = 0; batch < num_chunks; batch += chunks_per_batch)
+    {
+      const vtkIdType batch_end = std::min(batch + chunks_per_batch, num_chunks);
+      vtkSMPTools::For(batch, batch_end, 1, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType chunk = begin; chunk < end; ++chunk)
         {
-          vtkArrayIteratorTemplateMacro(vtkCSVWriterGetDataString(
-            static_cast<VTK_TT*>(iter.GetPointer()), cc, this->Stream, self, &first_column));
+          std::string& buffer = this->Chunks[chunk - batch];
+          buffer.clear();
+          const vtkIdType row_end = std::min((chunk + 1) * rows_per_chunk, num_tuples);
+          for (vtkIdType row = chunk * rows_per_chunk; row < row_end; ++row)
+          {
+            bool first_column = true;
+            if (!time.empty())
+            {
+              // add a time column.
+              buffer += time;
+              first_column = false;
+            }
+            for (const auto& column : columns)
+            {
+              column->Append(buffer, row, first_column);
+            }
+            buffer += '\n';
+          }
         }
+      });
+
+      for (vtkIdType chunk = batch; chunk < batch_end; ++chunk)
+      {
+        const std::string& buffer = this->Chunks[chunk - batch];
+        this->Stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
       }
-      this->Stream << "\n";
     }
   }
 
+  // Appends the content of a file, such as a shard written by another rank.
+  bool Append(const std::string& filename)
+  {
+    vtksys::ifstream shard(filename.c_str(), ios::in | ios::binary);
+    if (!shard)
+    {
+      return false;
+    }
+    if (shard.peek() != EOF)
+    {
+      this->Stream << shard.rdbuf();
+    }
+    return !this->Stream.fail();
+  }
+
 private:
   CSVFile(const CSVFile&) = delete;
   void operator=(const CSVFile&) = delete;
@@ -403,7 +545,36 @@ void vtkCSVWriter::WriteData()
     // BARRIER
     controller->Barrier();
 
-    if (row_count > 0)
+    if (this->WriteShards)
+    {
+      // write the rows to a shard, that the root appends to the file.
+      vtkMultiProcessStream stream;
+      controller->Broadcast(stream, 0);
+      std::vector<std::pair<std::string, int> > column_info;
+      int num_columns;
+      stream >> num_columns;
+      for (int cc = 0; cc < num_columns; ++cc)
+      {
+        std::pair<std::string, int> info;
+        stream >> info.first >> info.second;
+        column_info.push_back(info);
+      }
+
+      int shard_error_code = vtkErrorCode::NoError;
+      if (row_count > 0)
+      {
+        vtkCSVWriter::CSVFile shard(time);
+        shard.SetColumnInfo(column_info);
+        shard_error_code = shard.Open(::vtkCSVShardFileName(this->FileName, myRank).c_str());
+        if (shard_error_code == vtkErrorCode::NoError)
+        {
+          shard.WriteData(table, this);
+          shard_error_code = shard.Close();
+        }
+      }
+      controller->Reduce(&shard_error_code, &error_code, 1, vtkCommunicator::MAX_OP, 0);
+    }
+    else if (row_count > 0)
     {
       controller->Send(table, 0, 88021);
     }
@@ -455,25 +626,61 @@ void vtkCSVWriter::WriteData()
     // first write headers.
     file.WriteHeader(tmp, this);
 
-    for (int rank = 0; rank < numRanks; ++rank)
+    if (this->WriteShards)
     {
-      if (global_row_counts[rank] > 0)
+      // let the ranks format and write their rows, and concatenate them.
+      vtkMultiProcessStream stream;
+      const auto& column_info = file.GetColumnInfo();
+      stream << static_cast<int>(column_info.size());
+      for (const auto& info : column_info)
       {
-        if (rank == 0)
+        stream << info.first << info.second;
+      }
+      controller->Broadcast(stream, 0);
+
+      if (global_row_counts[0] > 0)
+      {
+        file.WriteData(table, this);
+      }
+
+      int shard_error_code = vtkErrorCode::NoError;
+      controller->Reduce(&shard_error_code, &error_code, 1, vtkCommunicator::MAX_OP, 0);
+      for (int rank = 1; rank < numRanks; ++rank)
+      {
+        if (global_row_counts[rank] > 0)
         {
-          file.WriteData(table, this);
+          const std::string shard_name = ::vtkCSVShardFileName(this->FileName, rank);
+          if (error_code == vtkErrorCode::NoError && !file.Append(shard_name))
+          {
+            vtkErrorMacro("Failed to append shard '" << shard_name << "'.");
+            error_code = vtkErrorCode::CannotOpenFileError;
+          }
+          vtksys::SystemTools::RemoveFile(shard_name);
         }
-        else
+      }
+    }
+    else
+    {
+      for (int rank = 0; rank < numRanks; ++rank)
+      {
+        if (global_row_counts[rank] > 0)
         {
-          vtkNew<vtkTable> remote_table;
-          controller->Receive(remote_table.Get(), rank, 88021);
-          assert(remote_table->GetNumberOfRows() > 0);
-          file.WriteData(remote_table, this);
+          if (rank == 0)
+          {
+            file.WriteData(table, this);
+          }
+          else
+          {
+            vtkNew<vtkTable> remote_table;
+            controller->Receive(remote_table.Get(), rank, 88021);
+            assert(remote_table->GetNumberOfRows() > 0);
+            file.WriteData(remote_table, this);
+          }
         }
       }
+      error_code = vtkErrorCode::NoError;
     }
 
-    error_code = vtkErrorCode::NoError;
     controller->Broadcast(&error_code, 1, 0);
     this->SetErrorCode(error_code);
   }
@@ -493,6 +700,8 @@ void vtkCSVWriter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Precision: " << this->Precision << endl;
   os << indent << "FieldAssociation: " << this->FieldAssociation << endl;
   os << indent << "AddMetaData: " << this->AddMetaData << endl;
+  os << indent << "AddTime: " << this->AddTime << endl;
+  os << indent << "WriteShards: " << this->WriteShards << endl;
   if (this->Controller)
   {
     os << indent << "Controller: " << this->Controller << endl;
@@ -16,6 +16,10 @@
  * @class   vtkCSVWriter
  * @brief   CSV writer for vtkTable
  * Writes a vtkTable as a delimited text file (such as CSV).
+ *
+ * The rows are formatted in parallel, using vtkSMPTools, into buffers that
+ * are written in order. In parallel, the rows of all ranks are written by the
+ * root, unless WriteShards is set.
 */
 
 #ifndef vtkCSVWriter_h
@@ -131,6 +135,18 @@ public:
   vtkBooleanMacro(AddTime, bool);
   //@}
 
+  //@{
+  /**
+   * When set to true (default is false) and running in parallel, each rank
+   * formats and writes its rows to a temporary shard file next to FileName,
+   * which the root then appends to FileName, instead of sending its rows to the
+   * root. This requires the directory of FileName to be shared by all ranks.
+   */
+  vtkSetMacro(WriteShards, bool);
+  vtkGetMacro(WriteShards, bool);
+  vtkBooleanMacro(WriteShards, bool);
+  //@}
+
   //@{
   /**
    * Internal method: decorates the "string" with the "StringDelimiter" if
@@ -162,6 +178,7 @@ protected:
   int FieldAssociation;
   bool AddMetaData;
   bool AddTime;
+  bool WriteShards;
 
   vtkMultiProcessController* Controller;
 
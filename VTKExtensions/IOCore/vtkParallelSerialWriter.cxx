@@ -25,14 +25,18 @@
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVLogger.h"
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <sstream>
 #include <string>
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemInformation.hxx>
 #include <vtksys/SystemTools.hxx>
 
 namespace
@@ -48,6 +52,55 @@ bool vtkIsEmpty(vtkDataObject* dobj)
   }
   return true;
 }
+
+// Groups the ranks by host. Returns the number of hosts and sets `color` to
+// the index of the host of this rank, hosts being ordered by their first rank.
+int vtkGroupRanksByHost(vtkMultiProcessController* controller, int& color)
+{
+  const int hostLength = 256;
+  const int num_ranks = controller->GetNumberOfProcesses();
+  const int myid = controller->GetLocalProcessId();
+
+  vtksys::SystemInformation sysinfo;
+  const std::string host = sysinfo.GetHostname();
+  std::vector<char> localHost(hostLength, '\0');
+  host.copy(localHost.data(), hostLength - 1);
+  std::vector<char> allHosts(hostLength * num_ranks, '\0');
+  controller->AllGather(localHost.data(), allHosts.data(), hostLength);
+
+  std::vector<std::string> hosts;
+  color = 0;
+  for (int rank = 0; rank < num_ranks; ++rank)
+  {
+    const std::string name(&allHosts[hostLength * rank]);
+    auto iter = std::find(hosts.begin(), hosts.end(), name);
+    const int index = static_cast<int>(iter - hosts.begin());
+    if (iter == hosts.end())
+    {
+      hosts.push_back(name);
+    }
+    if (rank == myid)
+    {
+      color = index;
+    }
+  }
+  return static_cast<int>(hosts.size());
+}
+
+bool vtkIsXMLFileName(const std::string& fname)
+{
+  const std::string ext = vtksys::SystemTools::LowerCase(
+    vtksys::SystemTools::GetFilenameLastExtension(fname));
+  const char* xmlExtensions[] = { ".vtp", ".vtu", ".vti", ".vtr", ".vts", ".vtm", ".vtt" };
+  for (const char* xmlExt : xmlExtensions)
+  {
+    if (ext == xmlExt)
+    {
+      return true;
+    }
+  }
+  return false;
+}
 }
 
 vtkStandardNewMacro(vtkParallelSerialWriter);
@@ -61,6 +114,10 @@ vtkParallelSerialWriter::vtkParallelSerialWriter()
   , RankAssignmentMode(vtkParallelSerialWriter::ASSIGNMENT_MODE_CONTIGUOUS)
   , Controller(nullptr)
   , SubController(nullptr)
+  , SubControllerColor(-1)
+  , CurrentTime(0.0)
+  , BytesWritten(0)
+  , WriteTime(0.0)
 {
   this->SetNumberOfOutputPorts(0);
 
@@ -190,9 +247,26 @@ int vtkParallelSerialWriter::RequestData(vtkInformation* request,
     this->CurrentTimeIndex = 0;
   }
 
+  if (this->CurrentTimeIndex == 0)
+  {
+    this->IndexFiles.clear();
+    this->BytesWritten = 0;
+    this->WriteTime = 0.0;
+  }
+
   const int num_ranks = this->Controller->GetNumberOfProcesses();
-  int num_io_ranks = std::min(this->NumberOfIORanks, num_ranks);
-  num_io_ranks = num_io_ranks <= 0 ? num_ranks : num_io_ranks;
+  const int myid = this->Controller->GetLocalProcessId();
+  int num_io_ranks;
+  int node_color = -1;
+  if (this->NumberOfIORanks == ONE_IO_RANK_PER_NODE)
+  {
+    num_io_ranks = ::vtkGroupRanksByHost(this->Controller, node_color);
+  }
+  else
+  {
+    num_io_ranks = std::min(this->NumberOfIORanks, num_ranks);
+    num_io_ranks = num_io_ranks <= 0 ? num_ranks : num_io_ranks;
+  }
   if (num_io_ranks == 1)
   {
     this->SubController = nullptr;
@@ -200,8 +274,11 @@ int vtkParallelSerialWriter::RequestData(vtkInformation* request,
   }
   else
   {
-    const int myid = this->Controller->GetLocalProcessId();
-    if (this->RankAssignmentMode == ASSIGNMENT_MODE_CONTIGUOUS)
+    if (node_color >= 0)
+    {
+      this->SubControllerColor = node_color;
+    }
+    else if (this->RankAssignmentMode == ASSIGNMENT_MODE_CONTIGUOUS)
     {
       const int div = num_ranks / num_io_ranks;
       const int mod = num_ranks % num_io_ranks;
@@ -226,8 +303,18 @@ int vtkParallelSerialWriter::RequestData(vtkInformation* request,
 
   vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
   vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+  this->CurrentTime = this->CurrentTimeIndex;
+  if (input && input->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()))
+  {
+    this->CurrentTime = input->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP());
+  }
   this->WriteATimestep(input);
 
+  if (this->SubController && myid == 0)
+  {
+    this->WriteIndexFiles();
+  }
+
   if (write_all)
   {
     this->CurrentTimeIndex++;
@@ -261,7 +348,7 @@ void vtkParallelSerialWriter::WriteATimestep(vtkDataObject* input)
       std::string ext = vtksys::SystemTools::GetFilenameLastExtension(this->FileName);
       std::ostringstream fname;
       fname << path << "/" << fnamenoext << idx << ext;
-      this->WriteAFile(fname.str(), curObj);
+      this->WriteAFile(fname.str(), curObj, idx);
     }
   }
   else if (input)
@@ -269,17 +356,16 @@ void vtkParallelSerialWriter::WriteATimestep(vtkDataObject* input)
     vtkSmartPointer<vtkDataObject> inputCopy;
     inputCopy.TakeReference(input->NewInstance());
     inputCopy->ShallowCopy(input);
-    this->WriteAFile(this->FileName, inputCopy);
+    this->WriteAFile(this->FileName, inputCopy, -1);
   }
 }
 
 //----------------------------------------------------------------------------
-void vtkParallelSerialWriter::WriteAFile(const std::string& filename_arg, vtkDataObject* input)
+void vtkParallelSerialWriter::WriteAFile(
+  const std::string& filename_arg, vtkDataObject* input, int group)
 {
   auto controller = this->SubController ? this->SubController.GetPointer() : this->Controller;
 
-  const auto filename = this->GetPartitionFileName(filename_arg);
-
   vtkSmartPointer<vtkReductionFilter> reductionFilter = vtkSmartPointer<vtkReductionFilter>::New();
   reductionFilter->SetController(controller);
   reductionFilter->SetPreGatherHelper(this->PreGatherHelper);
@@ -292,37 +378,194 @@ void vtkParallelSerialWriter::WriteAFile(const std::string& filename_arg, vtkDat
   outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), this->GhostLevel);
   reductionFilter->Update();
 
+  // partition written by this rank, its size and the time spent writing it.
+  double stats[3] = { -1, 0, 0 };
   if (controller->GetLocalProcessId() == 0)
   {
     vtkDataObject* output = reductionFilter->GetOutputDataObject(0);
     if (vtkIsEmpty(output) == false)
     {
-      std::ostringstream fname;
-      if (this->WriteAllTimeSteps)
+      const std::string fname = this->GetTimeStepFileName(
+        this->GetPartitionFileName(filename_arg, this->SubControllerColor));
+      this->Writer->SetInputDataObject(output);
+      this->SetWriterFileName(fname.c_str());
+      const auto start = std::chrono::steady_clock::now();
+      this->WriteInternal();
+      const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      this->Writer->SetInputConnection(0);
+
+      const vtkTypeInt64 bytes =
+        static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fname));
+      this->BytesWritten += bytes;
+      this->WriteTime += seconds;
+      vtkVLogF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "wrote '%s': %lld bytes in %g s (%g MB/s)",
+        fname.c_str(), static_cast<long long>(bytes), seconds,
+        seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0);
+      stats[0] = this->SubControllerColor;
+      stats[1] = static_cast<double>(bytes);
+      stats[2] = seconds;
+    }
+  }
+
+  if (!this->SubController)
+  {
+    return;
+  }
+
+  // Collect the partitions written, to index them and report the throughput
+  // of each rank doing IO.
+  const int num_ranks = this->Controller->GetNumberOfProcesses();
+  const bool isRoot = (this->Controller->GetLocalProcessId() == 0);
+  std::vector<double> allStats(isRoot ? 3 * num_ranks : 0);
+  this->Controller->Gather(stats, allStats.data(), 3, 0);
+  if (!isRoot)
+  {
+    return;
+  }
+
+  const std::string dataType = input ? input->GetClassName() : "";
+  const std::string indexName = this->GetIndexFileName(filename_arg, dataType);
+  IndexFile* index = indexName.empty() ? nullptr : &this->IndexFiles[indexName];
+  if (index)
+  {
+    index->DataType = dataType;
+    index->Modified = true;
+  }
+
+  double totalBytes = 0;
+  double maxSeconds = 0;
+  for (int rank = 0; rank < num_ranks; ++rank)
+  {
+    const int partition = static_cast<int>(allStats[3 * rank]);
+    if (partition < 0)
+    {
+      continue;
+    }
+    const double bytes = allStats[3 * rank + 1];
+    const double seconds = allStats[3 * rank + 2];
+    totalBytes += bytes;
+    maxSeconds = std::max(maxSeconds, seconds);
+    vtkVLogF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(),
+      "IO rank %d (partition %d): %.0f bytes in %g s (%g MB/s)", rank, partition, bytes, seconds,
+      seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0);
+
+    if (!index)
+    {
+      continue;
+    }
+    const std::string fname = vtksys::SystemTools::GetFilenameName(
+      this->GetTimeStepFileName(this->GetPartitionFileName(filename_arg, partition)));
+    std::ostringstream entry;
+    if (vtksys::SystemTools::GetFilenameLastExtension(indexName) == ".pvd")
+    {
+      entry << "<DataSet timestep=\"" << this->CurrentTime << "\"";
+      if (group >= 0)
       {
-        std::string path = vtksys::SystemTools::GetFilenamePath(filename);
-        std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
-        std::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
-        if (this->FileNameSuffix && vtkFileSeriesWriter::SuffixValidation(this->FileNameSuffix))
-        {
-          // Print this->CurrentTimeIndex to a string using this->FileNameSuffix as format
-          char suffix[100];
-          snprintf(suffix, 100, this->FileNameSuffix, this->CurrentTimeIndex);
-          fname << path << "/" << fnamenoext << suffix << ext;
-        }
-        else
-        {
-          fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
-        }
+        entry << " group=\"" << group << "\"";
       }
-      else
+      entry << " part=\"" << partition << "\" file=\"" << fname << "\"/>";
+    }
+    else
+    {
+      entry << "<Piece fileName=\"" << fname << "\" />";
+    }
+    index->Entries.push_back(entry.str());
+  }
+  vtkVLogF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "aggregate: %.0f bytes in %g s (%g MB/s)",
+    totalBytes, maxSeconds, maxSeconds > 0 ? totalBytes / maxSeconds / (1024 * 1024) : 0.0);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkParallelSerialWriter::GetTimeStepFileName(const std::string& filename)
+{
+  if (!this->WriteAllTimeSteps)
+  {
+    return filename;
+  }
+
+  std::ostringstream fname;
+  std::string path = vtksys::SystemTools::GetFilenamePath(filename);
+  std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
+  std::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
+  if (this->FileNameSuffix && vtkFileSeriesWriter::SuffixValidation(this->FileNameSuffix))
+  {
+    // Print this->CurrentTimeIndex to a string using this->FileNameSuffix as format
+    char suffix[100];
+    snprintf(suffix, 100, this->FileNameSuffix, this->CurrentTimeIndex);
+    fname << path << "/" << fnamenoext << suffix << ext;
+  }
+  else
+  {
+    fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
+  }
+  return fname.str();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkParallelSerialWriter::GetIndexFileName(
+  const std::string& filename, const std::string& dataType)
+{
+  if (::vtkIsXMLFileName(this->FileName))
+  {
+    // a single collection for all time steps and blocks.
+    std::string path = vtksys::SystemTools::GetFilenamePath(this->FileName);
+    std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(this->FileName);
+    return path + "/" + fnamenoext + ".pvd";
+  }
+
+  // vtkPDataSetReader needs the extents of the pieces of structured datasets.
+  std::string ext =
+    vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(filename));
+  if (ext == ".vtk" && (dataType == "vtkPolyData" || dataType == "vtkUnstructuredGrid"))
+  {
+    std::string path = vtksys::SystemTools::GetFilenamePath(filename);
+    std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
+    return this->GetTimeStepFileName(path + "/" + fnamenoext + ".pvtk");
+  }
+  return std::string();
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelSerialWriter::WriteIndexFiles()
+{
+  for (auto& item : this->IndexFiles)
+  {
+    IndexFile& index = item.second;
+    if (!index.Modified || index.Entries.empty())
+    {
+      continue;
+    }
+    index.Modified = false;
+
+    vtksys::ofstream file(item.first.c_str());
+    if (!file)
+    {
+      vtkErrorMacro("Could not open '" << item.first << "' for writing.");
+      continue;
+    }
+    if (vtksys::SystemTools::GetFilenameLastExtension(item.first) == ".pvd")
+    {
+      file << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"Collection\" version=\"0.1\">\n"
+           << "  <Collection>\n";
+      for (const std::string& entry : index.Entries)
       {
-        fname << filename;
+        file << "    " << entry << "\n";
       }
-      this->Writer->SetInputDataObject(output);
-      this->SetWriterFileName(fname.str().c_str());
-      this->WriteInternal();
-      this->Writer->SetInputConnection(0);
+      file << "  </Collection>\n"
+           << "</VTKFile>\n";
+    }
+    else
+    {
+      file << "<File version=\"pvtk-1.0\"\n"
+           << "      dataType=\"" << index.DataType << "\"\n"
+           << "      numberOfPieces=\"" << index.Entries.size() << "\" >\n";
+      for (const std::string& entry : index.Entries)
+      {
+        file << "  " << entry << "\n";
+      }
+      file << "</File>\n";
     }
   }
 }
@@ -358,14 +601,14 @@ void vtkParallelSerialWriter::WriteInternal()
 }
 
 //-----------------------------------------------------------------------------
-std::string vtkParallelSerialWriter::GetPartitionFileName(const std::string& fname)
+std::string vtkParallelSerialWriter::GetPartitionFileName(const std::string& fname, int partition)
 {
-  if (this->SubController != nullptr && this->SubControllerColor >= 0)
+  if (this->SubController != nullptr && partition >= 0)
   {
     std::string path = vtksys::SystemTools::GetFilenamePath(fname);
     std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(fname);
     std::string ext = vtksys::SystemTools::GetFilenameLastExtension(fname);
-    return path + "/" + fnamenoext + "-" + std::to_string(this->SubControllerColor) + ext;
+    return path + "/" + fnamenoext + "-" + std::to_string(partition) + ext;
   }
   return fname;
 }
@@ -387,4 +630,8 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfIORanks: " << this->NumberOfIORanks << endl;
+  os << indent << "RankAssignmentMode: " << this->RankAssignmentMode << endl;
+  os << indent << "BytesWritten: " << this->BytesWritten << endl;
+  os << indent << "WriteTime: " << this->WriteTime << endl;
 }
@@ -21,7 +21,10 @@
  * and invokes the internal writer. The reduction is controlled by the
  * PreGatherHelper and PostGatherHelper. Instead of collecting all the data to
  * the root node the filter supports reducing down to a target number of ranks
- * which ranks chosen in either round-robin or contiguous fashion.
+ * which ranks chosen in either round-robin or contiguous fashion, or to one rank
+ * per node. When the data is written by more than one rank, the written
+ * partitions are indexed by a .pvd file for VTK XML formats, or by a .pvtk file
+ * (see vtkPDataSetReader) for legacy VTK polydata and unstructured grids.
  *
  * This also makes it possible to write time-series for temporal datasets using
  * simple non-time-aware writers.
@@ -33,7 +36,9 @@
 #include "vtkDataObjectAlgorithm.h"
 #include "vtkPVVTKExtensionsIOCoreModule.h" //needed for exports
 #include "vtkSmartPointer.h"                // needed for vtkSmartPointer
+#include <map>                              // for std::map
 #include <string>                           // for std::string
+#include <vector>                           // for std::vector
 
 class vtkClientServerInterpreter;
 class vtkMultiProcessController;
@@ -152,15 +157,23 @@ public:
   vtkSetStringMacro(FileNameSuffix);
   //@}
 
+  enum
+  {
+    ONE_IO_RANK_PER_NODE = -1
+  };
+
   //@{
   /**
    * In parallel runs, this writer can consolidate output from multiple ranks to
    * a subset of ranks. This specifies the number of ranks that will do the final writing
    * to disk. If NumberOfIORanks is 0, then all ranks will save the local data.
    * If set to 1 (default), the root node alone will write to disk. All data from all ranks will
-   * be gathered to the root node before being written out.
+   * be gathered to the root node before being written out. If set to
+   * ONE_IO_RANK_PER_NODE, the ranks running on the same host are grouped and
+   * the first one of each group writes to disk, RankAssignmentMode is then
+   * ignored.
    */
-  vtkSetClampMacro(NumberOfIORanks, int, 0, VTK_INT_MAX);
+  vtkSetClampMacro(NumberOfIORanks, int, ONE_IO_RANK_PER_NODE, VTK_INT_MAX);
   vtkGetMacro(NumberOfIORanks, int);
   //@}
 
@@ -200,6 +213,18 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   //@}
 
+  //@{
+  /**
+   * Number of bytes written to disk by this rank, and time in seconds spent
+   * writing them, during the last write. When writing all time steps, these
+   * are accumulated over the time steps. The throughput of each rank doing
+   * IO is also logged with PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY, by the root
+   * node when the data is written by more than one rank.
+   */
+  vtkGetMacro(BytesWritten, vtkTypeInt64);
+  vtkGetMacro(WriteTime, double);
+  //@}
+
 protected:
   vtkParallelSerialWriter();
   ~vtkParallelSerialWriter() override;
@@ -216,12 +241,25 @@ private:
   void operator=(const vtkParallelSerialWriter&) = delete;
 
   void WriteATimestep(vtkDataObject* input);
-  void WriteAFile(const std::string& fname, vtkDataObject* input);
+  void WriteAFile(const std::string& fname, vtkDataObject* input, int group);
 
   void SetWriterFileName(const char* fname);
   void WriteInternal();
 
-  std::string GetPartitionFileName(const std::string& fname);
+  std::string GetPartitionFileName(const std::string& fname, int partition);
+  std::string GetTimeStepFileName(const std::string& fname);
+
+  /**
+   * Returns the name of the file indexing the partitions of `fname`, or an
+   * empty string if the format cannot be indexed.
+   */
+  std::string GetIndexFileName(const std::string& fname, const std::string& dataType);
+
+  /**
+   * Writes the index files modified since the last call. Only called on the
+   * root node.
+   */
+  void WriteIndexFiles();
 
   vtkAlgorithm* PreGatherHelper;
   vtkAlgorithm* PostGatherHelper;
@@ -248,6 +286,18 @@ private:
   vtkMultiProcessController* Controller;
   vtkSmartPointer<vtkMultiProcessController> SubController;
   int SubControllerColor;
+
+  double CurrentTime;
+
+  struct IndexFile
+  {
+    std::string DataType;
+    std::vector<std::string> Entries;
+    bool Modified = false;
+  };
+  std::map<std::string, IndexFile> IndexFiles;
+  vtkTypeInt64 BytesWritten;
+  double WriteTime;
 };
 
 #endif
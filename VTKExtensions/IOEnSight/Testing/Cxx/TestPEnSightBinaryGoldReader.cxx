@@ -1,34 +1,150 @@
+#include "vtkCellData.h"
 #include "vtkCellTypes.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkMPIController.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkNew.h"
 #include "vtkPGenericEnSightReader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
 #include "vtkTestUtilities.h"
 #include "vtkUnstructuredGrid.h"
 
-int TestPEnSightBinaryGoldReader(int argc, char* argv[])
-{
-  char* fname =
-    vtkTestUtilities::ExpandDataFileName(argc, argv, "Testing/Data/EnSight/TEST_bin.case");
+#include <vector>
 
+namespace
+{
+vtkSmartPointer<vtkUnstructuredGrid> Read(const char* fname, bool useMemoryMapping)
+{
   vtkNew<vtkPGenericEnSightReader> reader;
   reader->SetCaseFileName(fname);
+  reader->SetUseMemoryMapping(useMemoryMapping);
   reader->Update();
   vtkMultiBlockDataSet* mb = reader->GetOutput();
-  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(mb->GetBlock(0));
+  return vtkUnstructuredGrid::SafeDownCast(mb->GetBlock(0));
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfValues(); ++i)
+  {
+    const int nc = a->GetNumberOfComponents();
+    if (a->GetComponent(i / nc, i % nc) != b->GetComponent(i / nc, i % nc))
+    {
+      return false;
+    }
+  }
+  return true;
+}
 
-  vtkNew<vtkCellTypes> types;
-  ug->GetCellTypes(types);
+bool SameAttributes(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = a->GetArray(i);
+    if (array && !SameArrays(array, b->GetArray(array->GetName())))
+    {
+      std::cerr << "Array " << array->GetName() << " differs." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
 
-  auto nbOfTypes = types->GetNumberOfTypes();
-  if (nbOfTypes != 2)
+// Checks that both reads, with and without memory mapping, give the same data.
+bool SameGrids(vtkUnstructuredGrid* mapped, vtkUnstructuredGrid* streamed)
+{
+  if (!mapped || !streamed)
   {
-    std::cerr << "Wrong number of cell types. Expects 2 ( has " << nbOfTypes << ")." << std::endl;
-    return EXIT_FAILURE;
+    return mapped == streamed;
+  }
+  if (mapped->GetNumberOfPoints() != streamed->GetNumberOfPoints() ||
+    mapped->GetNumberOfCells() != streamed->GetNumberOfCells())
+  {
+    std::cerr << "Different number of points or cells." << std::endl;
+    return false;
+  }
+  if (mapped->GetNumberOfPoints() > 0 &&
+    !SameArrays(mapped->GetPoints()->GetData(), streamed->GetPoints()->GetData()))
+  {
+    std::cerr << "Different points." << std::endl;
+    return false;
+  }
+  vtkNew<vtkIdList> mappedIds;
+  vtkNew<vtkIdList> streamedIds;
+  for (vtkIdType i = 0; i < mapped->GetNumberOfCells(); ++i)
+  {
+    mapped->GetCellPoints(i, mappedIds);
+    streamed->GetCellPoints(i, streamedIds);
+    bool same = mapped->GetCellType(i) == streamed->GetCellType(i) &&
+      mappedIds->GetNumberOfIds() == streamedIds->GetNumberOfIds();
+    for (vtkIdType j = 0; same && j < mappedIds->GetNumberOfIds(); ++j)
+    {
+      same = mappedIds->GetId(j) == streamedIds->GetId(j);
+    }
+    if (!same)
+    {
+      std::cerr << "Cell " << i << " differs." << std::endl;
+      return false;
+    }
+  }
+  return SameAttributes(mapped->GetPointData(), streamed->GetPointData()) &&
+    SameAttributes(mapped->GetCellData(), streamed->GetCellData());
+}
+}
+
+int TestPEnSightBinaryGoldReader(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> contr;
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  char* fname =
+    vtkTestUtilities::ExpandDataFileName(argc, argv, "Testing/Data/EnSight/TEST_bin.case");
+  vtkSmartPointer<vtkUnstructuredGrid> ug = Read(fname, true);
+  vtkSmartPointer<vtkUnstructuredGrid> streamed = Read(fname, false);
+  delete[] fname;
+
+  int success = SameGrids(ug, streamed) ? 1 : 0;
+  if (!success)
+  {
+    std::cerr << "Data read with and without memory mapping differ." << std::endl;
+  }
+
+  // the cell types of all the processes.
+  std::vector<int> localTypes(VTK_NUMBER_OF_CELL_TYPES, 0);
+  if (ug)
+  {
+    vtkNew<vtkCellTypes> types;
+    ug->GetCellTypes(types);
+    for (vtkIdType i = 0; i < types->GetNumberOfTypes(); i++)
+    {
+      localTypes[types->GetCellType(i)] = 1;
+    }
   }
+  std::vector<int> globalTypes(VTK_NUMBER_OF_CELL_TYPES, 0);
+  contr->AllReduce(
+    localTypes.data(), globalTypes.data(), VTK_NUMBER_OF_CELL_TYPES, vtkCommunicator::MAX_OP);
 
-  for (vtkIdType i = 0; i < nbOfTypes; i++)
+  int nbOfTypes = 0;
+  for (int type = 0; type < VTK_NUMBER_OF_CELL_TYPES; type++)
   {
-    auto type = ug->GetCellType(i);
+    if (!globalTypes[type])
+    {
+      continue;
+    }
+    ++nbOfTypes;
     switch (type)
     {
       case VTK_QUAD:
@@ -39,9 +155,19 @@ int TestPEnSightBinaryGoldReader(int argc, char* argv[])
       default:
         std::cerr << "Unexpected cell type (" << vtkCellTypes::GetClassNameFromTypeId(type) << ")."
                   << std::endl;
-        return EXIT_FAILURE;
+        success = 0;
     }
   }
+  if (nbOfTypes != 2)
+  {
+    std::cerr << "Wrong number of cell types. Expects 2 ( has " << nbOfTypes << ")." << std::endl;
+    success = 0;
+  }
+
+  int allSuccess = 0;
+  contr->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
 
-  return EXIT_SUCCESS;
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -3,6 +3,7 @@
 #include "vtkByteSwap.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkEndian.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
@@ -11,25 +12,184 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include "vtksys/Encoding.hxx"
 #include "vtksys/FStream.hxx"
 #include "vtksys/SystemTools.hxx"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <ctype.h>
+#include <ctime>
+#include <streambuf>
 #include <string>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+//----------------------------------------------------------------------------
+// Read-only stream buffer over a memory mapped file. The mapping is kept
+// until another file is mapped or the update completes, so that a file opened
+// several times during an update is only mapped once.
+class vtkPEnSightGoldBinaryReader::vtkMappedFile : public std::streambuf
+{
+public:
+  ~vtkMappedFile() override { this->Unmap(); }
+
+  // Maps the file, unless it is already mapped and was not modified since.
+  // Returns false if the file cannot be mapped.
+  bool Map(const char* filename, const vtksys::SystemTools::Stat_t& fs)
+  {
+    if (this->Data && this->FileName == filename &&
+      this->Size == static_cast<size_t>(fs.st_size) && this->ModifiedTime == fs.st_mtime)
+    {
+      this->setg(this->Data, this->Data, this->Data + this->Size);
+      return true;
+    }
+
+    this->Unmap();
+    if (fs.st_size <= 0)
+    {
+      return false;
+    }
+    const size_t size = static_cast<size_t>(fs.st_size);
+#ifdef _WIN32
+    this->File = CreateFileW(vtksys::Encoding::ToWide(filename).c_str(), GENERIC_READ,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->File == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+    this->Mapping = CreateFileMappingW(this->File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data =
+      this->Mapping ? MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+      this->Unmap();
+      return false;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+      return false;
+    }
+#endif
+    this->FileName = filename;
+    this->ModifiedTime = fs.st_mtime;
+    this->Data = static_cast<char*>(data);
+    this->Size = size;
+    this->setg(this->Data, this->Data, this->Data + this->Size);
+    return true;
+  }
+
+  void Unmap()
+  {
+#ifdef _WIN32
+    if (this->Data)
+    {
+      UnmapViewOfFile(this->Data);
+    }
+    if (this->Mapping)
+    {
+      CloseHandle(this->Mapping);
+      this->Mapping = nullptr;
+    }
+    if (this->File != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(this->File);
+      this->File = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (this->Data)
+    {
+      munmap(this->Data, this->Size);
+    }
+#endif
+    this->Data = nullptr;
+    this->Size = 0;
+    this->FileName.clear();
+    this->setg(nullptr, nullptr, nullptr);
+  }
+
+  const char* GetData() const { return this->Data; }
+  size_t GetSize() const { return this->Size; }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+  {
+    off_type base = 0;
+    if (dir == std::ios_base::cur)
+    {
+      base = this->gptr() - this->eback();
+    }
+    else if (dir == std::ios_base::end)
+    {
+      base = static_cast<off_type>(this->Size);
+    }
+    return this->seekpos(pos_type(base + off), which);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    const off_type offset = pos;
+    if (!this->Data || !(which & std::ios_base::in) || offset < 0 ||
+      offset > static_cast<off_type>(this->Size))
+    {
+      return pos_type(off_type(-1));
+    }
+    this->setg(this->Data, this->Data + offset, this->Data + this->Size);
+    return pos;
+  }
+
+  std::streamsize xsgetn(char* s, std::streamsize n) override
+  {
+    n = std::min<std::streamsize>(n, this->egptr() - this->gptr());
+    if (n > 0)
+    {
+      memcpy(s, this->gptr(), static_cast<size_t>(n));
+      this->setg(this->eback(), this->gptr() + n, this->egptr());
+    }
+    return n;
+  }
+
+private:
+  std::string FileName;
+  time_t ModifiedTime = 0;
+  char* Data = nullptr;
+  size_t Size = 0;
+#ifdef _WIN32
+  HANDLE File = INVALID_HANDLE_VALUE;
+  HANDLE Mapping = nullptr;
+#endif
+};
+
 //----------------------------------------------------------------------------
 vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 {
   this->IFile = NULL;
+  this->MappedFile = nullptr;
   this->FileSize = 0;
   this->Fortran = 0;
   this->NodeIdsListed = 0;
@@ -50,12 +210,32 @@ vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
 {
   delete this->IFile;
+  delete this->MappedFile;
   delete[] this->FloatBuffer[2];
   delete[] this->FloatBuffer[1];
   delete[] this->FloatBuffer[0];
   free(this->FloatBuffer);
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::RequestData(
+  vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  int result = this->Superclass::RequestData(request, inputVector, outputVector);
+
+  // Do not keep the files mapped between updates.
+  if (this->MappedFile)
+  {
+    if (this->IFile && this->IFile->rdbuf() == this->MappedFile)
+    {
+      delete this->IFile;
+      this->IFile = NULL;
+    }
+    this->MappedFile->Unmap();
+  }
+  return result;
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
 {
@@ -77,11 +257,29 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
+    if (this->UseMemoryMapping)
+    {
+      if (!this->MappedFile)
+      {
+        this->MappedFile = new vtkMappedFile;
+      }
+      if (this->MappedFile->Map(filename, fs))
+      {
+        this->IFile = new std::istream(this->MappedFile);
+      }
+      else
+      {
+        vtkDebugMacro(<< "Could not map " << filename << ", reading it instead.");
+      }
+    }
+    if (!this->IFile)
+    {
 #ifdef _WIN32
-    this->IFile = new vtksys::ifstream(filename, ios::in | ios::binary);
+      this->IFile = new vtksys::ifstream(filename, ios::in | ios::binary);
 #else
-    this->IFile = new vtksys::ifstream(filename, ios::in);
+      this->IFile = new vtksys::ifstream(filename, ios::in);
 #endif
+    }
   }
   else
   {
@@ -1273,7 +1471,8 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
   char line[80];
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray* scalars;
-  float* scalarsRead;
+  const float* scalarsRead;
+  std::vector<float> scalarsBuffer;
   vtkDataSet* output;
 
   // Initialize
@@ -1389,8 +1588,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
       scalars = vtkFloatArray::New();
       scalars->SetNumberOfComponents(numberOfComponents);
       scalars->SetNumberOfTuples(this->GetPointIds(partId)->GetLocalNumberOfIds());
-      scalarsRead = new float[numPts];
-      this->ReadFloatArray(scalarsRead, numPts);
+      scalarsRead = this->ReadFloatBlock(numPts, scalarsBuffer);
       // Why are we setting only one component here?
       // Only one component is set because scalars are single-component arrays.
       // For complex scalars, there is a file for the real part and another
@@ -1408,7 +1606,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
         output->GetPointData()->SetScalars(scalars);
       }
       scalars->Delete();
-      delete[] scalarsRead;
     }
 
     delete this->IFile;
@@ -1441,8 +1638,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
         scalars = (vtkFloatArray*)(output->GetPointData()->GetArray(description));
       }
 
-      scalarsRead = new float[numPts];
-      this->ReadFloatArray(scalarsRead, numPts);
+      scalarsRead = this->ReadFloatBlock(numPts, scalarsBuffer);
 
       for (i = 0; i < numPts; i++)
       {
@@ -1463,7 +1659,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
       {
         output->GetPointData()->AddArray(scalars);
       }
-      delete[] scalarsRead;
     }
 
     this->IFile->peek();
@@ -1489,7 +1684,8 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(const char* fileName, const
   int partId, realId, numPts, i, lineRead;
   vtkFloatArray* vectors;
   float tuple[3];
-  float *comp1, *comp2, *comp3;
+  const float *comp1, *comp2, *comp3;
+  std::vector<float> buffer1, buffer2, buffer3;
   float* vectorsRead;
   vtkDataSet* output;
 
@@ -1647,12 +1843,9 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(const char* fileName, const
       this->ReadLine(line); // "coordinates" or "block"
       vectors->SetNumberOfComponents(3);
       vectors->SetNumberOfTuples(this->GetPointIds(realId)->GetLocalNumberOfIds());
-      comp1 = new float[numPts];
-      comp2 = new float[numPts];
-      comp3 = new float[numPts];
-      this->ReadFloatArray(comp1, numPts);
-      this->ReadFloatArray(comp2, numPts);
-      this->ReadFloatArray(comp3, numPts);
+      comp1 = this->ReadFloatBlock(numPts, buffer1);
+      comp2 = this->ReadFloatBlock(numPts, buffer2);
+      comp3 = this->ReadFloatBlock(numPts, buffer3);
       for (i = 0; i < numPts; i++)
       {
         tuple[0] = comp1[i];
@@ -1667,9 +1860,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(const char* fileName, const
         output->GetPointData()->SetVectors(vectors);
       }
       vectors->Delete();
-      delete[] comp1;
-      delete[] comp2;
-      delete[] comp3;
     }
 
     this->IFile->peek();
@@ -1854,7 +2044,8 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
   char line[80];
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray* scalars;
-  float* scalarsRead;
+  const float* scalarsRead;
+  std::vector<float> scalarsBuffer;
   int lineRead, elementType;
   vtkDataSet* output;
 
@@ -2002,8 +2193,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
       {
-        scalarsRead = new float[numCells];
-        this->ReadFloatArray(scalarsRead, numCells);
+        scalarsRead = this->ReadFloatBlock(numCells, scalarsBuffer);
         for (i = 0; i < numCells; i++)
         {
           this->InsertVariableComponent(
@@ -2017,7 +2207,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
         {
           lineRead = this->ReadLine(line);
         }
-        delete[] scalarsRead;
       }
       else
       {
@@ -2038,8 +2227,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
           }
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement = this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          scalarsRead = new float[numCellsPerElement];
-          this->ReadFloatArray(scalarsRead, numCellsPerElement);
+          scalarsRead = this->ReadFloatBlock(numCellsPerElement, scalarsBuffer);
           for (i = 0; i < numCellsPerElement; i++)
           {
             this->InsertVariableComponent(
@@ -2054,7 +2242,6 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
           {
             lineRead = this->ReadLine(line);
           }
-          delete[] scalarsRead;
         } // end while
       }   // end else
       if (component == 0)
@@ -2099,7 +2286,8 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
   char line[80];
   int partId, realId, numCells, numCellsPerElement, i, idx;
   vtkFloatArray* vectors;
-  float *comp1, *comp2, *comp3;
+  const float *comp1, *comp2, *comp3;
+  std::vector<float> buffer1, buffer2, buffer3;
   int lineRead, elementType;
   float tuple[3];
   vtkDataSet* output;
@@ -2241,12 +2429,9 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
       // type (and what their ids are) -- IF THIS IS NOT A BLOCK SECTION
       if (strncmp(line, "block", 5) == 0)
       {
-        comp1 = new float[numCells];
-        comp2 = new float[numCells];
-        comp3 = new float[numCells];
-        this->ReadFloatArray(comp1, numCells);
-        this->ReadFloatArray(comp2, numCells);
-        this->ReadFloatArray(comp3, numCells);
+        comp1 = this->ReadFloatBlock(numCells, buffer1);
+        comp2 = this->ReadFloatBlock(numCells, buffer2);
+        comp3 = this->ReadFloatBlock(numCells, buffer3);
         for (i = 0; i < numCells; i++)
         {
           tuple[0] = comp1[i];
@@ -2263,9 +2448,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
         {
           lineRead = this->ReadLine(line);
         }
-        delete[] comp1;
-        delete[] comp2;
-        delete[] comp3;
       }
       else
       {
@@ -2282,12 +2464,9 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
           }
           idx = this->UnstructuredPartIds->IsId(realId);
           numCellsPerElement = this->GetCellIds(idx, elementType)->GetNumberOfIds();
-          comp1 = new float[numCellsPerElement];
-          comp2 = new float[numCellsPerElement];
-          comp3 = new float[numCellsPerElement];
-          this->ReadFloatArray(comp1, numCellsPerElement);
-          this->ReadFloatArray(comp2, numCellsPerElement);
-          this->ReadFloatArray(comp3, numCellsPerElement);
+          comp1 = this->ReadFloatBlock(numCellsPerElement, buffer1);
+          comp2 = this->ReadFloatBlock(numCellsPerElement, buffer2);
+          comp3 = this->ReadFloatBlock(numCellsPerElement, buffer3);
           for (i = 0; i < numCellsPerElement; i++)
           {
             tuple[0] = comp1[i];
@@ -2305,9 +2484,6 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
           {
             lineRead = this->ReadLine(line);
           }
-          delete[] comp1;
-          delete[] comp2;
-          delete[] comp3;
         } // end while
       }   // end else
       vectors->SetName(description);
@@ -2936,17 +3112,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[6];
         nodeIdList = new int[numElements * 6];
-        this->ReadIntArray(nodeIdList, numElements * 6);
+        this->ReadConnectivityArray(nodeIdList, numElements, 6);
       }
       else
       {
         nodeIds = new vtkIdType[3];
         nodeIdList = new int[numElements * 3];
-        this->ReadIntArray(nodeIdList, numElements * 3);
+        this->ReadConnectivityArray(nodeIdList, numElements, 3);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::TRIA6)
         {
           for (j = 0; j < 6; j++)
@@ -3037,17 +3222,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[8];
         nodeIdList = new int[numElements * 8];
-        this->ReadIntArray(nodeIdList, numElements * 8);
+        this->ReadConnectivityArray(nodeIdList, numElements, 8);
       }
       else
       {
         nodeIds = new vtkIdType[4];
         nodeIdList = new int[numElements * 4];
-        this->ReadIntArray(nodeIdList, numElements * 4);
+        this->ReadConnectivityArray(nodeIdList, numElements, 4);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::QUAD8)
         {
           for (j = 0; j < 8; j++)
@@ -3251,17 +3445,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[10];
         nodeIdList = new int[numElements * 10];
-        this->ReadIntArray(nodeIdList, numElements * 10);
+        this->ReadConnectivityArray(nodeIdList, numElements, 10);
       }
       else
       {
         nodeIds = new vtkIdType[4];
         nodeIdList = new int[numElements * 4];
-        this->ReadIntArray(nodeIdList, numElements * 4);
+        this->ReadConnectivityArray(nodeIdList, numElements, 4);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::TETRA10)
         {
           for (j = 0; j < 10; j++)
@@ -3352,17 +3555,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[13];
         nodeIdList = new int[numElements * 13];
-        this->ReadIntArray(nodeIdList, numElements * 13);
+        this->ReadConnectivityArray(nodeIdList, numElements, 13);
       }
       else
       {
         nodeIds = new vtkIdType[5];
         nodeIdList = new int[numElements * 5];
-        this->ReadIntArray(nodeIdList, numElements * 5);
+        this->ReadConnectivityArray(nodeIdList, numElements, 5);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::PYRAMID13)
         {
           for (j = 0; j < 13; j++)
@@ -3452,17 +3664,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[20];
         nodeIdList = new int[numElements * 20];
-        this->ReadIntArray(nodeIdList, numElements * 20);
+        this->ReadConnectivityArray(nodeIdList, numElements, 20);
       }
       else
       {
         nodeIds = new vtkIdType[8];
         nodeIdList = new int[numElements * 8];
-        this->ReadIntArray(nodeIdList, numElements * 8);
+        this->ReadConnectivityArray(nodeIdList, numElements, 8);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::HEXA20)
         {
           for (j = 0; j < 20; j++)
@@ -3552,17 +3773,26 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       {
         nodeIds = new vtkIdType[15];
         nodeIdList = new int[numElements * 15];
-        this->ReadIntArray(nodeIdList, numElements * 15);
+        this->ReadConnectivityArray(nodeIdList, numElements, 15);
       }
       else
       {
         nodeIds = new vtkIdType[6];
         nodeIdList = new int[numElements * 6];
-        this->ReadIntArray(nodeIdList, numElements * 6);
+        this->ReadConnectivityArray(nodeIdList, numElements, 6);
       }
 
+      vtkIdType localBegin, localEnd;
+      this->GetLocalElementRange(numElements, localBegin, localEnd);
       for (i = 0; i < numElements; i++)
       {
+        if (i < localBegin || i >= localEnd)
+        {
+          // inserted by another process, its node ids were not read.
+          this->InsertNextCellAndId(
+            output, VTK_EMPTY_CELL, 0, nodeIds, idx, cellType, i, numElements);
+          continue;
+        }
         if (cellType == vtkPEnSightReader::PENTA15)
         {
           for (j = 0; j < 15; j++)
@@ -4295,6 +4525,102 @@ int vtkPEnSightGoldBinaryReader::ReadFloatArray(float* result, int numFloats)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::ReadConnectivityArray(
+  int* result, int numElements, int nodesPerElement)
+{
+  if (numElements <= 0 || nodesPerElement <= 0)
+  {
+    return 1;
+  }
+
+  char dummy[4];
+  if (this->Fortran)
+  {
+    if (!this->IFile->read(dummy, 4).good())
+    {
+      vtkErrorMacro("Read (fortran) failed.");
+      return 0;
+    }
+  }
+
+  const std::streamoff start = this->IFile->tellg();
+  vtkIdType begin, end;
+  this->GetLocalElementRange(numElements, begin, end);
+  begin = std::min<vtkIdType>(begin, numElements);
+  end = std::min<vtkIdType>(end, numElements);
+  const vtkIdType numInts = (end - begin) * nodesPerElement;
+  if (numInts > 0)
+  {
+    int* local = result + begin * nodesPerElement;
+    this->IFile->seekg(start + static_cast<std::streamoff>(sizeof(int) * begin * nodesPerElement));
+    if (!this->IFile->read((char*)local, sizeof(int) * numInts).good())
+    {
+      vtkErrorMacro("Read failed.");
+      return 0;
+    }
+
+    const bool littleEndian = (this->ByteOrder == FILE_LITTLE_ENDIAN);
+    auto swap = [local, littleEndian](vtkIdType first, vtkIdType last) {
+      if (littleEndian)
+      {
+        vtkByteSwap::Swap4LERange(local + first, last - first);
+      }
+      else
+      {
+        vtkByteSwap::Swap4BERange(local + first, last - first);
+      }
+    };
+    vtkSMPTools::For(0, numInts, swap);
+  }
+  this->IFile->seekg(
+    start + static_cast<std::streamoff>(sizeof(int)) * numElements * nodesPerElement);
+
+  if (this->Fortran)
+  {
+    if (!this->IFile->read(dummy, 4).good())
+    {
+      vtkErrorMacro("Read (fortran) failed.");
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+const float* vtkPEnSightGoldBinaryReader::ReadFloatBlock(int numFloats, std::vector<float>& buffer)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const bool nativeByteOrder = (this->ByteOrder != FILE_LITTLE_ENDIAN);
+#else
+  const bool nativeByteOrder = (this->ByteOrder == FILE_LITTLE_ENDIAN);
+#endif
+  if (numFloats > 0 && nativeByteOrder && this->MappedFile &&
+    this->IFile->rdbuf() == this->MappedFile)
+  {
+    const std::streamoff marker = this->Fortran ? 4 : 0;
+    const std::streamoff position = this->IFile->tellg();
+    const std::streamoff end =
+      position + 2 * marker + static_cast<std::streamoff>(sizeof(float)) * numFloats;
+    const char* data = this->MappedFile->GetData() + position + marker;
+    if (position >= 0 && end <= static_cast<std::streamoff>(this->MappedFile->GetSize()) &&
+      reinterpret_cast<std::uintptr_t>(data) % alignof(float) == 0)
+    {
+      // no copy nor byte swap needed, use the values in place.
+      this->IFile->seekg(end);
+      return reinterpret_cast<const float*>(data);
+    }
+  }
+
+  buffer.assign(numFloats > 0 ? numFloats : 1, 0.0f);
+  if (!this->ReadFloatArray(buffer.data(), numFloats))
+  {
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+  }
+  return buffer.data();
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(
   vtkPoints* points, long offset, int partId, bool skip)
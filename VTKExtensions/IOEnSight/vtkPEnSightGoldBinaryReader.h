@@ -35,6 +35,8 @@
 #include "vtkPEnSightReader.h"
 #include "vtkPVVTKExtensionsIOEnSightModule.h" //needed for exports
 
+#include <vector> // for std::vector
+
 class vtkMultiBlockDataSet;
 class vtkUnstructuredGrid;
 class vtkPoints;
@@ -50,6 +52,11 @@ protected:
   vtkPEnSightGoldBinaryReader();
   ~vtkPEnSightGoldBinaryReader() override;
 
+  /**
+   * Releases the memory mapped file once the data is read.
+   */
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
   // Returns 1 if successful.  Sets file size as a side action.
   int OpenFile(const char* filename);
 
@@ -170,6 +177,23 @@ protected:
    */
   int ReadFloatArray(float* result, int numFloats);
 
+  /**
+   * Internal function to read the connectivity of numElements elements of
+   * nodesPerElement nodes each. Only the connectivity of the elements
+   * inserted by this process (see GetLocalElementRange()) is read and stored
+   * at its place in result, the rest is skipped.
+   * Returns zero if there was an error.
+   */
+  int ReadConnectivityArray(int* result, int numElements, int nodesPerElement);
+
+  /**
+   * Internal function to read a block of floats. When the file is memory
+   * mapped and the values are stored with the native byte order, returns a
+   * pointer into the mapping. Otherwise the values are read into buffer, and
+   * are zero if there was an error.
+   */
+  const float* ReadFloatBlock(int numFloats, std::vector<float>& buffer);
+
   /**
    * Read Coordinates, or just skip the part in the file.
    */
@@ -205,6 +229,8 @@ protected:
   int Fortran;
 
   istream* IFile;
+  class vtkMappedFile;
+  vtkMappedFile* MappedFile;
   // The size of the file could be used to choose byte order.
   long FileSize;
 
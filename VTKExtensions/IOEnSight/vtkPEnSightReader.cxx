@@ -2260,9 +2260,20 @@ vtkIdType vtkPEnSightReader::GetLocalTotalNumberOfCellIds(int index)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::GetLocalElementRange(
+  vtkIdType numElements, vtkIdType& begin, vtkIdType& end)
+{
+  int mpiLocalProcessId = this->GetMultiProcessLocalProcessId();
+  int mpiNumberOfProcesses = this->GetMultiProcessNumberOfProcesses();
+  vtkIdType numElnts = (numElements / mpiNumberOfProcesses) + 1;
+  begin = mpiLocalProcessId * numElnts;
+  end = begin + numElnts;
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightReader::InsertVariableComponent(vtkFloatArray* array, int i, int component,
-  float* content, int partId, int ensightCellType, int insertionType)
+  const float* content, int partId, int ensightCellType, int insertionType)
 {
 
   vtkIdType realId;
@@ -2324,12 +2335,10 @@ void vtkPEnSightReader::InsertNextCellAndId(vtkUnstructuredGrid* output, int vtk
 {
   // Reader is Distributed. Insert If necessary, and keep global Id trace
   // Should be based on pointIds, aka points, but for now it is based on globalId
-  int mpiLocalProcessId = this->GetMultiProcessLocalProcessId();
-  int mpiNumberOfProcesses = this->GetMultiProcessNumberOfProcesses();
-  vtkIdType numElnts = (numElements / mpiNumberOfProcesses) + 1;
-  vtkIdType begin = mpiLocalProcessId * numElnts;
+  vtkIdType begin, end;
+  this->GetLocalElementRange(numElements, begin, end);
 
-  if ((globalId >= begin) && (globalId < (begin + numElnts)))
+  if ((globalId >= begin) && (globalId < end))
   {
     // First note the points : they will be injected later
     vtkIdType* newPoints = new vtkIdType[numPoints];
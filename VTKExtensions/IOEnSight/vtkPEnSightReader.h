@@ -784,10 +784,17 @@ protected:
   void InsertNextCellAndId(vtkUnstructuredGrid*, int vtkCellType, vtkIdType numPoints,
     vtkIdType* points, int partId, int ensightCellType, vtkIdType globalId, vtkIdType numElements,
     const std::vector<vtkIdType>& faces = {});
-  void InsertVariableComponent(vtkFloatArray* array, int i, int component, float* content,
+  void InsertVariableComponent(vtkFloatArray* array, int i, int component, const float* content,
     int partId, int ensightCellType, int insertionType);
   //@}
 
+  /**
+   * Returns the range [begin, end) of the elements, in a block of numElements
+   * elements, that this process inserts in InsertNextCellAndId(). The other
+   * elements are only given a "-1" id, their node ids need not be read.
+   */
+  void GetLocalElementRange(vtkIdType numElements, vtkIdType& begin, vtkIdType& end);
+
   /**
    * Convenience method to map the point ids from current rank to global ids.
    */
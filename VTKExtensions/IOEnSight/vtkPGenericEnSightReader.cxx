@@ -44,6 +44,7 @@ vtkPGenericEnSightReader::vtkPGenericEnSightReader()
   // -2 is the default starting value
   this->MultiProcessLocalProcessId = -2;
   this->MultiProcessNumberOfProcesses = -2;
+  this->UseMemoryMapping = true;
 }
 
 //----------------------------------------------------------------------------
@@ -139,6 +140,7 @@ int vtkPGenericEnSightReader::RequestInformation(
   if (reader)
   {
     // this dynamic cast never should fail
+    reader->SetUseMemoryMapping(this->UseMemoryMapping);
     reader->RequestInformation(request, inputVector, outputVector);
   }
   this->Reader->SetParticleCoordinatesByIndex(this->ParticleCoordinatesByIndex);
@@ -203,4 +205,5 @@ void vtkPGenericEnSightReader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "MultiProcessLocalProcessId: " << this->MultiProcessLocalProcessId << endl;
   os << indent << "MultiProcessNumberOfProcesses: " << this->MultiProcessNumberOfProcesses << endl;
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << endl;
 }
@@ -38,6 +38,16 @@ public:
   vtkTypeMacro(vtkPGenericEnSightReader, vtkGenericEnSightReader);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  //@{
+  /**
+   * When set, EnSight Gold binary files are memory mapped, when supported by
+   * the platform, rather than read through file streams. Default is true.
+   */
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+  //@}
+
 protected:
   vtkPGenericEnSightReader();
   ~vtkPGenericEnSightReader() override;
@@ -55,6 +65,7 @@ protected:
 
   int MultiProcessLocalProcessId;
   int MultiProcessNumberOfProcesses;
+  bool UseMemoryMapping;
 
 private:
   vtkPGenericEnSightReader(const vtkPGenericEnSightReader&) = delete;
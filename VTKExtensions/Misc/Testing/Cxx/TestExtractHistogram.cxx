@@ -16,10 +16,15 @@
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkExtractHistogram.h"
-#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
 #include "vtkSphereSource.h"
 #include "vtkTable.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnsignedCharArray.h"
 
 /// Test the output of the vtkExtractHistogram filter in a simple serial case
 int TestExtractHistogram(int, char* [])
@@ -59,8 +64,8 @@ int TestExtractHistogram(int, char* [])
     return 1;
   }
 
-  vtkIntArray* const bin_values =
-    vtkIntArray::SafeDownCast(histogram->GetRowData()->GetArray((int)1));
+  vtkTypeInt64Array* const bin_values =
+    vtkTypeInt64Array::SafeDownCast(histogram->GetRowData()->GetArray((int)1));
   if (!bin_values)
   {
     vtkGenericWarningMacro("cell data missing.");
@@ -92,5 +97,57 @@ int TestExtractHistogram(int, char* [])
     vtkGenericWarningMacro("incorrect bin value.");
     return 1;
   }
+
+  // Duplicate ghost points are not counted, and the other arrays are
+  // averaged per bin.
+  vtkNew<vtkPolyData> polydata;
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(4);
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("values");
+  vtkNew<vtkDoubleArray> other;
+  other->SetName("other");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (int i = 0; i < 4; ++i)
+  {
+    points->SetPoint(i, i, 0, 0);
+    values->InsertNextValue(i);
+    other->InsertNextValue(10 * (i + 1));
+    ghosts->InsertNextValue(i == 3 ? vtkDataSetAttributes::DUPLICATEPOINT : 0);
+  }
+  polydata->SetPoints(points);
+  polydata->GetPointData()->AddArray(values);
+  polydata->GetPointData()->AddArray(other);
+  polydata->GetPointData()->AddArray(ghosts);
+
+  extraction->SetInputData(polydata);
+  extraction->SetInputArrayToProcess(
+    0, 0, 0, vtkDataSet::FIELD_ASSOCIATION_POINTS_THEN_CELLS, "values");
+  extraction->SetBinCount(2);
+  extraction->UseCustomBinRangesOn();
+  extraction->SetCustomBinRanges(0, 4);
+  extraction->CalculateAveragesOn();
+  extraction->Update();
+
+  vtkDataArray* const counts = extraction->GetOutput()->GetRowData()->GetArray("bin_values");
+  vtkDataArray* const averages =
+    extraction->GetOutput()->GetRowData()->GetArray("other_average");
+  if (!counts || !averages ||
+    extraction->GetOutput()->GetRowData()->GetArray("vtkGhostType_average"))
+  {
+    vtkGenericWarningMacro("missing or unexpected arrays.");
+    return 1;
+  }
+  if (counts->GetTuple1(0) != 2 || counts->GetTuple1(1) != 1)
+  {
+    vtkGenericWarningMacro("incorrect bin value with ghost points.");
+    return 1;
+  }
+  if (averages->GetTuple1(0) != 15 || averages->GetTuple1(1) != 30)
+  {
+    vtkGenericWarningMacro("incorrect average.");
+    return 1;
+  }
   return 0;
 }
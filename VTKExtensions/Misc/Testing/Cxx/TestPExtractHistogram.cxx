@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPExtractHistogram.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPExtractHistogram reduces the counts and the averages of all
+// the ranks on the root, including when a rank has no data.
+
+#include "vtkDoubleArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPExtractHistogram.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTable.h"
+#include "vtkTypeInt64Array.h"
+
+namespace
+{
+const int NUMBER_OF_POINTS = 10;
+const int BIN_COUNT = 5;
+
+bool CheckHistogram(vtkTable* histogram, int numRanks)
+{
+  vtkTypeInt64Array* counts =
+    vtkTypeInt64Array::SafeDownCast(histogram->GetRowData()->GetArray("bin_values"));
+  vtkDataArray* averages = histogram->GetRowData()->GetArray("other_average");
+  if (!counts || !averages || counts->GetNumberOfTuples() != BIN_COUNT)
+  {
+    cerr << "ERROR: missing histogram arrays." << endl;
+    return false;
+  }
+
+  // the last rank has no data; each of the others puts 2 values in each bin,
+  // with `other` equal to its rank plus 1.
+  const int numRanksWithData = numRanks > 1 ? numRanks - 1 : 1;
+  const double average = (numRanksWithData + 1) / 2.0;
+  for (int bin = 0; bin < BIN_COUNT; ++bin)
+  {
+    if (counts->GetValue(bin) != 2 * numRanksWithData)
+    {
+      cerr << "ERROR: bin " << bin << " has " << counts->GetValue(bin) << " values instead of "
+           << 2 * numRanksWithData << endl;
+      return false;
+    }
+    if (averages->GetTuple1(bin) != average)
+    {
+      cerr << "ERROR: bin " << bin << " has an average of " << averages->GetTuple1(bin)
+           << " instead of " << average << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestPExtractHistogram(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> contr;
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int myRank = contr->GetLocalProcessId();
+  const int numRanks = contr->GetNumberOfProcesses();
+
+  vtkNew<vtkPolyData> polydata;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("values");
+  vtkNew<vtkDoubleArray> other;
+  other->SetName("other");
+  if (numRanks == 1 || myRank < numRanks - 1)
+  {
+    for (int i = 0; i < NUMBER_OF_POINTS; ++i)
+    {
+      points->InsertNextPoint(i, myRank, 0);
+      values->InsertNextValue(i);
+      other->InsertNextValue(myRank + 1);
+    }
+  }
+  polydata->SetPoints(points);
+  polydata->GetPointData()->AddArray(values);
+  polydata->GetPointData()->AddArray(other);
+
+  vtkNew<vtkPExtractHistogram> histogram;
+  histogram->SetInputData(polydata);
+  histogram->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS, "values");
+  histogram->SetBinCount(BIN_COUNT);
+  histogram->UseCustomBinRangesOn();
+  histogram->SetCustomBinRanges(0, NUMBER_OF_POINTS);
+  histogram->CalculateAveragesOn();
+  histogram->Update();
+
+  int success = myRank == 0 ? (CheckHistogram(histogram->GetOutput(), numRanks) ? 1 : 0) : 1;
+  int allSuccess;
+  contr->AllReduce(&success, &allSuccess, 1, vtkCommunicator::LOGICAL_AND_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
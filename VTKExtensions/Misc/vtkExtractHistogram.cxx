@@ -14,23 +14,29 @@
 =========================================================================*/
 #include "vtkExtractHistogram.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkGraph.h"
 #include "vtkIOStream.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnsignedCharArray.h"
 
+#include <cmath>
 #include <map>
 #include <string>
 #include <vector>
@@ -43,15 +49,227 @@ struct vtkEHInternals
   }
   struct ArrayValuesType
   {
-    // The total of the values per bin - the second vector
-    // is for arrays with multiple components
-    std::vector<std::vector<double> > TotalValues;
+    int NumberOfComponents = 0;
+    // The total of the values per bin, with the components of a bin stored
+    // contiguously.
+    std::vector<double> TotalValues;
   };
   typedef std::map<std::string, ArrayValuesType> ArrayMapType;
   ArrayMapType ArrayValues;
   int FieldAssociation;
 };
 
+namespace
+{
+struct vtkHistogramBinning
+{
+  // Component to bin, the magnitude when equal to the number of components.
+  int Component;
+  int BinCount;
+  double Min;
+  double Delta;
+  // half of Delta when the bins are centered around min and max.
+  double Offset;
+
+  int GetBin(double value) const
+  {
+    const double index = (value - this->Min + this->Offset) / this->Delta;
+    if (!(index >= 0.0))
+    {
+      return 0;
+    }
+    // If the value is equal to max, include it in the last bin.
+    return index >= this->BinCount ? this->BinCount - 1 : static_cast<int>(index);
+  }
+};
+
+// Counts the tuples of the binned array per bin, with per thread counts
+// merged at the end. The bin of each tuple is stored in Bins when not null,
+// -1 for the skipped ghost tuples.
+class vtkBinArrayFunctor
+{
+public:
+  std::vector<vtkTypeInt64> Counts;
+
+  vtkBinArrayFunctor(const vtkHistogramBinning& binning, const unsigned char* ghosts, int* bins)
+    : Binning(binning)
+    , Ghosts(ghosts)
+    , Bins(bins)
+  {
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    Worker<ArrayT> worker(array, *this);
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), worker);
+    this->Counts = std::move(worker.Counts);
+  }
+
+private:
+  const vtkHistogramBinning& Binning;
+  const unsigned char* Ghosts;
+  int* Bins;
+
+  template <typename ArrayT>
+  class Worker
+  {
+    ArrayT* Array;
+    const vtkBinArrayFunctor& Self;
+    vtkSMPThreadLocal<std::vector<vtkTypeInt64> > LocalCounts;
+
+  public:
+    std::vector<vtkTypeInt64> Counts;
+
+    Worker(ArrayT* array, const vtkBinArrayFunctor& self)
+      : Array(array)
+      , Self(self)
+    {
+    }
+
+    void Initialize() { this->LocalCounts.Local().assign(this->Self.Binning.BinCount, 0); }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const vtkHistogramBinning& binning = this->Self.Binning;
+      const unsigned char* ghosts = this->Self.Ghosts;
+      int* bins = this->Self.Bins;
+      vtkTypeInt64* counts = this->LocalCounts.Local().data();
+      const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
+      const int numComps = tuples.GetTupleSize();
+      const bool magnitude = (binning.Component == numComps);
+      for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+      {
+        // DUPLICATEPOINT and DUPLICATECELL are the same bit.
+        if (ghosts && (ghosts[tupleIdx] & vtkDataSetAttributes::DUPLICATEPOINT))
+        {
+          if (bins)
+          {
+            bins[tupleIdx] = -1;
+          }
+          continue;
+        }
+        const auto tuple = tuples[tupleIdx - begin];
+        double value;
+        if (magnitude)
+        {
+          value = 0.0;
+          for (int comp = 0; comp < numComps; ++comp)
+          {
+            const double compValue = static_cast<double>(tuple[comp]);
+            value += compValue * compValue;
+          }
+          value = std::sqrt(value);
+        }
+        else
+        {
+          value = static_cast<double>(tuple[binning.Component]);
+        }
+        const int bin = binning.GetBin(value);
+        ++counts[bin];
+        if (bins)
+        {
+          bins[tupleIdx] = bin;
+        }
+      }
+    }
+
+    void Reduce()
+    {
+      this->Counts.assign(this->Self.Binning.BinCount, 0);
+      for (const std::vector<vtkTypeInt64>& local : this->LocalCounts)
+      {
+        for (size_t cc = 0; cc < local.size(); ++cc)
+        {
+          this->Counts[cc] += local[cc];
+        }
+      }
+    }
+  };
+};
+
+// Adds the tuples of an array to the totals of their bin, given by Bins,
+// with per thread totals merged at the end.
+class vtkBinTotalsFunctor
+{
+public:
+  vtkBinTotalsFunctor(const int* bins, int binCount, double* totals)
+    : Bins(bins)
+    , BinCount(binCount)
+    , Totals(totals)
+  {
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    Worker<ArrayT> worker(array, *this);
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), worker);
+  }
+
+private:
+  const int* Bins;
+  int BinCount;
+  double* Totals;
+
+  template <typename ArrayT>
+  class Worker
+  {
+    ArrayT* Array;
+    const vtkBinTotalsFunctor& Self;
+    int NumberOfComponents;
+    vtkSMPThreadLocal<std::vector<double> > LocalTotals;
+
+  public:
+    Worker(ArrayT* array, const vtkBinTotalsFunctor& self)
+      : Array(array)
+      , Self(self)
+      , NumberOfComponents(array->GetNumberOfComponents())
+    {
+    }
+
+    void Initialize()
+    {
+      this->LocalTotals.Local().assign(
+        static_cast<size_t>(this->Self.BinCount) * this->NumberOfComponents, 0.0);
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const int numComps = this->NumberOfComponents;
+      const int* bins = this->Self.Bins;
+      double* totals = this->LocalTotals.Local().data();
+      const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
+      for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+      {
+        const int bin = bins[tupleIdx];
+        if (bin < 0)
+        {
+          continue;
+        }
+        const auto tuple = tuples[tupleIdx - begin];
+        double* binTotals = totals + static_cast<size_t>(bin) * numComps;
+        for (int comp = 0; comp < numComps; ++comp)
+        {
+          binTotals[comp] += static_cast<double>(tuple[comp]);
+        }
+      }
+    }
+
+    void Reduce()
+    {
+      for (const std::vector<double>& local : this->LocalTotals)
+      {
+        for (size_t cc = 0; cc < local.size(); ++cc)
+        {
+          this->Self.Totals[cc] += local[cc];
+        }
+      }
+    }
+  };
+};
+}
+
 vtkStandardNewMacro(vtkExtractHistogram);
 //-----------------------------------------------------------------------------
 vtkExtractHistogram::vtkExtractHistogram()
@@ -276,16 +494,9 @@ void vtkExtractHistogram::FillBinExtents(vtkDoubleArray* bin_extents, double min
   }
 }
 
-inline int vtkExtractHistogramClamp(int value, int min, int max)
-{
-  value = value < min ? min : value;
-  value = value > max ? max : value;
-  return value;
-}
-
 //-----------------------------------------------------------------------------
-void vtkExtractHistogram::BinAnArray(
-  vtkDataArray* data_array, vtkIntArray* bin_values, double min, double max, vtkFieldData* field)
+void vtkExtractHistogram::BinAnArray(vtkDataArray* data_array, vtkTypeInt64Array* bin_values,
+  double min, double max, vtkFieldData* field)
 {
   // If the requested component is out-of-range for the input,
   // the bin_values will be 0, so no need to do any actual counting.
@@ -295,64 +506,78 @@ void vtkExtractHistogram::BinAnArray(
     return;
   }
 
-  int num_of_tuples = data_array->GetNumberOfTuples();
-  double bin_delta =
+  const vtkIdType num_of_tuples = data_array->GetNumberOfTuples();
+  vtkHistogramBinning binning;
+  binning.Component = this->Component;
+  binning.BinCount = this->BinCount;
+  binning.Min = min;
+  binning.Delta =
     (max - min) / (this->CenterBinsAroundMinAndMax ? (this->BinCount - 1) : this->BinCount);
-  double half_delta = bin_delta / 2.0;
+  binning.Offset = this->CenterBinsAroundMinAndMax ? binning.Delta / 2.0 : 0.0;
+
+  // Duplicate ghost points or cells are counted by the process that owns them.
+  vtkUnsignedCharArray* ghostArray = field
+    ? vtkUnsignedCharArray::SafeDownCast(field->GetArray(vtkDataSetAttributes::GhostArrayName()))
+    : nullptr;
+  const unsigned char* ghosts = nullptr;
+  if (ghostArray && ghostArray->GetNumberOfTuples() == num_of_tuples)
+  {
+    ghosts = ghostArray->GetPointer(0);
+  }
+
+  // The bin of each tuple is needed to compute the averages of the other
+  // arrays.
+  std::vector<int> bins;
+  if (this->CalculateAverages && field)
+  {
+    bins.resize(num_of_tuples);
+  }
 
-  for (int i = 0; i != num_of_tuples; ++i)
+  vtkBinArrayFunctor binner(binning, ghosts, bins.empty() ? nullptr : bins.data());
+  if (!vtkArrayDispatch::Dispatch::Execute(data_array, binner))
+  {
+    binner(data_array);
+  }
+  vtkTypeInt64* counts = bin_values->GetPointer(0);
+  for (size_t i = 0; i < binner.Counts.size(); ++i)
   {
-    if (i % 1000 == 0)
+    counts[i] += binner.Counts[i];
+  }
+
+  if (bins.empty())
+  {
+    return;
+  }
+
+  // Add the values of all other arrays to the totals of the bins. The
+  // averages are computed from the totals and the counts at the end.
+  const int num_arrays = field->GetNumberOfArrays();
+  for (int idx = 0; idx < num_arrays; idx++)
+  {
+    vtkDataArray* array = field->GetArray(idx);
+    if (!array || array == data_array || array == ghostArray || !array->GetName() ||
+      array->GetNumberOfTuples() != num_of_tuples)
     {
-      this->UpdateProgress(0.10 + 0.90 * i / num_of_tuples);
+      continue;
     }
-    double value;
-    // if component is equal to the number of components, then the magnitude was requested.
-    if (this->Component == data_array->GetNumberOfComponents())
+    vtkEHInternals::ArrayValuesType& arrayValues = this->Internal->ArrayValues[array->GetName()];
+    const int numComps = array->GetNumberOfComponents();
+    if (arrayValues.TotalValues.empty())
     {
-      value = 0;
-      double comp;
-      for (int j = 0; j < data_array->GetNumberOfComponents(); ++j)
-      {
-        comp = data_array->GetComponent(i, j);
-        value += comp * comp;
-      }
-      value = sqrt(value);
+      arrayValues.NumberOfComponents = numComps;
+      arrayValues.TotalValues.assign(static_cast<size_t>(this->BinCount) * numComps, 0.0);
     }
-    else
+    else if (arrayValues.NumberOfComponents != numComps)
     {
-      value = data_array->GetComponent(i, this->Component);
+      vtkWarningMacro("Array " << array->GetName() << " has a different number of components "
+                               << "in some blocks, it is not averaged for these blocks.");
+      continue;
     }
-    int index = static_cast<int>(
-      (value - min + (this->CenterBinsAroundMinAndMax ? half_delta : 0.)) / bin_delta);
-
-    // If the value is equal to max, include it in the last bin.
-    index = ::vtkExtractHistogramClamp(index, 0, this->BinCount - 1);
-    bin_values->SetValue(index, bin_values->GetValue(index) + 1);
 
-    if (this->CalculateAverages)
+    vtkBinTotalsFunctor totaler(bins.data(), this->BinCount, arrayValues.TotalValues.data());
+    if (!vtkArrayDispatch::Dispatch::Execute(array, totaler))
     {
-      // Get all other arrays, add their value to the bin
-      // For each bin, we will need 2 values per array ->
-      // total, num. elements
-      // at the end, divide each total by num. elements
-      int num_arrays = field->GetNumberOfArrays();
-      for (int idx = 0; idx < num_arrays; idx++)
-      {
-        vtkDataArray* array = field->GetArray(idx);
-        if (array && array != data_array && array->GetName())
-        {
-          vtkEHInternals::ArrayValuesType& arrayValues =
-            this->Internal->ArrayValues[array->GetName()];
-          arrayValues.TotalValues.resize(this->BinCount);
-          int numComps = array->GetNumberOfComponents();
-          arrayValues.TotalValues[index].resize(numComps);
-          for (int comp = 0; comp < numComps; comp++)
-          {
-            arrayValues.TotalValues[index][comp] += array->GetComponent(i, comp);
-          }
-        }
-      }
+      totaler(array);
     }
   }
 }
@@ -383,11 +608,11 @@ int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
   bin_extents->FillComponent(0, 0.0);
 
   // Insert values into bins ...
-  vtkSmartPointer<vtkIntArray> bin_values = vtkSmartPointer<vtkIntArray>::New();
+  vtkSmartPointer<vtkTypeInt64Array> bin_values = vtkSmartPointer<vtkTypeInt64Array>::New();
   bin_values->SetNumberOfComponents(1);
   bin_values->SetNumberOfTuples(this->BinCount);
   bin_values->SetName("bin_values");
-  bin_values->FillComponent(0, 0.0);
+  bin_values->FillValue(0);
 
   // Initializes the bin_extents array.
   double min, max;
@@ -434,33 +659,20 @@ int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
       vtkSmartPointer<vtkDoubleArray> aa = vtkSmartPointer<vtkDoubleArray>::New();
       std::string newname2 = iter->first + "_average";
       aa->SetName(newname2.c_str());
-      int numComps = static_cast<int>(iter->second.TotalValues[0].size());
+      const int numComps = iter->second.NumberOfComponents;
       da->SetNumberOfComponents(numComps);
       da->SetNumberOfTuples(this->BinCount);
       aa->SetNumberOfComponents(numComps);
       aa->SetNumberOfTuples(this->BinCount);
+      const double* totals = iter->second.TotalValues.data();
       for (vtkIdType i = 0; i < this->BinCount; i++)
       {
+        const vtkTypeInt64 count = bin_values->GetValue(i);
         for (int j = 0; j < numComps; j++)
         {
-          if (iter->second.TotalValues[i].size() == (unsigned int)numComps)
-          {
-            da->SetValue(i * numComps + j, iter->second.TotalValues[i][j]);
-            if (bin_values->GetValue(i))
-            {
-              aa->SetValue(
-                i * numComps + j, iter->second.TotalValues[i][j] / bin_values->GetValue(i));
-            }
-            else
-            {
-              aa->SetValue(i * numComps + j, 0);
-            }
-          }
-          else
-          {
-            da->SetValue(i * numComps + j, 0);
-            aa->SetValue(i * numComps + j, 0);
-          }
+          const double total = totals[i * numComps + j];
+          da->SetValue(i * numComps + j, total);
+          aa->SetValue(i * numComps + j, count ? total / count : 0.0);
         }
       }
       output_data->GetRowData()->AddArray(da);
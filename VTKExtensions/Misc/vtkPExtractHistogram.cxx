@@ -14,21 +14,23 @@
 =========================================================================*/
 #include "vtkPExtractHistogram.h"
 
-#include "vtkAttributeDataReductionFilter.h"
 #include "vtkCellData.h"
 #include "vtkCommunicator.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkIntArray.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
-#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
+#include "vtkTypeInt64Array.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 
 vtkStandardNewMacro(vtkPExtractHistogram);
@@ -87,70 +89,140 @@ int vtkPExtractHistogram::RequestData(
   }
 
   vtkTable* output = vtkTable::GetData(outputVector, 0);
-  vtkSmartPointer<vtkDataArray> oldExtents = output->GetRowData()->GetArray("bin_extents");
-  if (oldExtents == NULL)
+  vtkTypeInt64Array* bin_values =
+    vtkTypeInt64Array::SafeDownCast(output->GetRowData()->GetArray("bin_values"));
+  if (bin_values == NULL)
   {
-    // Nothing to do if there is no data
+    // Nothing to do if there is no data. The range is reduced, so this is
+    // the case on all processes.
     return 1;
   }
-  // Now we need to collect and reduce data from all nodes on the root.
-  vtkSmartPointer<vtkReductionFilter> reduceFilter = vtkSmartPointer<vtkReductionFilter>::New();
-  reduceFilter->SetController(this->Controller);
 
-  bool isRoot = (this->Controller->GetLocalProcessId() == 0);
-  if (isRoot)
-  {
-    // PostGatherHelper needs to be set only on the root node.
-    vtkSmartPointer<vtkAttributeDataReductionFilter> rf =
-      vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
-    rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
-    rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
-    reduceFilter->SetPostGatherHelper(rf);
-  }
+  const int numProcs = this->Controller->GetNumberOfProcesses();
+  const int myId = this->Controller->GetLocalProcessId();
 
-  vtkSmartPointer<vtkTable> copy = vtkSmartPointer<vtkTable>::New();
-  copy->ShallowCopy(output);
-  reduceFilter->SetInputData(copy);
-  reduceFilter->Update();
-  if (isRoot)
+  // The arrays averaged, with their number of components. Processes without
+  // data have none, use the ones of the first process that has some.
+  std::vector<std::pair<std::string, int> > averaged;
+  if (this->CalculateAverages)
   {
-    // We save the old bin_extents and then revert to be restored later since
-    // the reduction reduces the bin_extents as well.
-    output->ShallowCopy(reduceFilter->GetOutput());
-    if (output->GetRowData()->GetNumberOfArrays() == 0)
+    vtksys::RegularExpression reg_ex("^(.*)_total$");
+    const int numArrays = output->GetRowData()->GetNumberOfArrays();
+    for (int i = 0; i < numArrays; i++)
     {
-      vtkErrorMacro(<< "Reduced data has 0 arrays");
-      return 0;
+      vtkDataArray* array = output->GetRowData()->GetArray(i);
+      if (array && array->GetName() && reg_ex.find(array->GetName()))
+      {
+        averaged.push_back(std::make_pair(reg_ex.match(1), array->GetNumberOfComponents()));
+      }
     }
-    output->GetRowData()->GetArray("bin_extents")->DeepCopy(oldExtents);
-    if (this->CalculateAverages)
+
+    int source = averaged.empty() ? numProcs : myId;
+    int firstSource = numProcs;
+    this->Controller->AllReduce(&source, &firstSource, 1, vtkCommunicator::MIN_OP);
+    if (firstSource < numProcs)
     {
-      vtkDataArray* bin_values = output->GetRowData()->GetArray("bin_values");
-      vtksys::RegularExpression reg_ex("^(.*)_average$");
-      int numArrays = output->GetRowData()->GetNumberOfArrays();
-      for (int i = 0; i < numArrays; i++)
+      vtkMultiProcessStream stream;
+      if (myId == firstSource)
+      {
+        stream << static_cast<int>(averaged.size());
+        for (const auto& item : averaged)
+        {
+          stream << item.first << item.second;
+        }
+      }
+      this->Controller->Broadcast(stream, firstSource);
+      if (myId != firstSource)
       {
-        vtkDataArray* array = output->GetRowData()->GetArray(i);
-        if (array && reg_ex.find(array->GetName()))
+        int count;
+        stream >> count;
+        averaged.resize(count);
+        for (auto& item : averaged)
         {
-          int numComps = array->GetNumberOfComponents();
-          std::string name = reg_ex.match(1) + "_total";
-          vtkDataArray* tarray = output->GetRowData()->GetArray(name.c_str());
-          for (vtkIdType idx = 0; idx < this->BinCount; idx++)
-          {
-            for (int j = 0; j < numComps; j++)
-            {
-              array->SetComponent(
-                idx, j, tarray->GetComponent(idx, j) / bin_values->GetTuple1(idx));
-            }
-          }
+          stream >> item.first >> item.second;
         }
       }
     }
   }
-  else
+
+  // Reduce the counts on the root as 64-bit integers, so that they stay exact,
+  // then the totals of all the averaged arrays with a single reduction.
+  const vtkIdType binCount = this->BinCount;
+  std::vector<vtkTypeInt64> counts(binCount, 0);
+  if (!this->Controller->Reduce(
+        bin_values->GetPointer(0), counts.data(), binCount, vtkCommunicator::SUM_OP, 0))
+  {
+    vtkErrorMacro("Parallel communication error. Could not reduce bins.");
+    return 0;
+  }
+
+  vtkIdType bufferSize = 0;
+  for (const auto& item : averaged)
+  {
+    bufferSize += binCount * item.second;
+  }
+  std::vector<double> localBuffer(bufferSize, 0.0);
+  std::vector<double> buffer(bufferSize, 0.0);
+  vtkIdType offset = 0;
+  for (const auto& item : averaged)
+  {
+    const std::string name = item.first + "_total";
+    vtkDataArray* total = output->GetRowData()->GetArray(name.c_str());
+    const vtkIdType size = binCount * item.second;
+    if (total && total->GetNumberOfComponents() == item.second &&
+      total->GetNumberOfTuples() == binCount)
+    {
+      for (vtkIdType i = 0; i < size; i++)
+      {
+        localBuffer[offset + i] = total->GetComponent(i / item.second, i % item.second);
+      }
+    }
+    offset += size;
+  }
+
+  if (bufferSize > 0 &&
+    !this->Controller->Reduce(
+      localBuffer.data(), buffer.data(), bufferSize, vtkCommunicator::SUM_OP, 0))
+  {
+    vtkErrorMacro("Parallel communication error. Could not reduce bin totals.");
+    return 0;
+  }
+
+  if (myId != 0)
   {
     output->Initialize();
+    return 1;
+  }
+
+  std::copy(counts.begin(), counts.end(), bin_values->GetPointer(0));
+  offset = 0;
+  for (const auto& item : averaged)
+  {
+    const int numComps = item.second;
+    vtkSmartPointer<vtkDoubleArray> da = vtkSmartPointer<vtkDoubleArray>::New();
+    std::string newname = item.first + "_total";
+    da->SetName(newname.c_str());
+    vtkSmartPointer<vtkDoubleArray> aa = vtkSmartPointer<vtkDoubleArray>::New();
+    std::string newname2 = item.first + "_average";
+    aa->SetName(newname2.c_str());
+    da->SetNumberOfComponents(numComps);
+    da->SetNumberOfTuples(binCount);
+    aa->SetNumberOfComponents(numComps);
+    aa->SetNumberOfTuples(binCount);
+    for (vtkIdType i = 0; i < binCount; i++)
+    {
+      const double count = static_cast<double>(counts[i]);
+      for (int j = 0; j < numComps; j++)
+      {
+        const double total = buffer[offset + i * numComps + j];
+        da->SetValue(i * numComps + j, total);
+        aa->SetValue(i * numComps + j, count ? total / count : 0.0);
+      }
+    }
+    // replaces the local arrays with the same name.
+    output->GetRowData()->AddArray(da);
+    output->GetRowData()->AddArray(aa);
+    offset += binCount * numComps;
   }
 
   return 1;
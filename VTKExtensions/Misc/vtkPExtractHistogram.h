@@ -17,7 +17,8 @@
  * @brief   Extract histogram for parallel dataset.
  *
  * vtkPExtractHistogram is vtkExtractHistogram subclass for parallel datasets.
- * It gathers the histogram data on the root node.
+ * It reduces the histogram data on the root node, the bin counts and the
+ * totals of the averaged arrays being summed by a single reduction.
 */
 
 #ifndef vtkPExtractHistogram_h